@@ -39,6 +39,9 @@
 #include "PatternList.h"
 #include "Collection.h"
 #include "Categories.h"
+#include "MelderThread.h"
+
+#include <vector>
 
 static void bookkeeping (FFNet me);
 
@@ -90,12 +93,10 @@ static double sigmoid (FFNet /*me*/, double x, double *out_deriv) {
 		if target < activity ==> error < 0
 */
 
-static double minimumSquaredError (FFNet me, constVEC& target) {
-	Melder_assert (my numberOfOutputs == target.size);
-	integer k = my numberOfNodes - my numberOfOutputs + 1;
+static double getMinimumSquaredError (constVECVU const& target, constVECVU const& output, VECVU const& error) {
 	double cost = 0.0;
-	for (integer i = 1; i <= my numberOfOutputs; i ++, k ++) {
-		double e = my error [k] = target [i] - my activity [k];
+	for (integer i = 1; i <= target.size; i ++) {
+		const double e = error [i] = target [i] - output [i];
 		cost += e * e;
 	}
 	return 0.5 * cost;
@@ -104,20 +105,31 @@ static double minimumSquaredError (FFNet me, constVEC& target) {
 /* E = - sum (i=1; i=numberOfPatterns; sum (k=1;k=numberOfOutputs; t [k]*ln (o [k]) + (1-t [k])ln (1-o [k]))) */
 /* dE/do [k] = -(1-t [k])/ (1-o [k]) + t [k]/o [k] */
 /* werkt niet bij (grote?) netten */
-static double minimumCrossEntropy (FFNet me, constVEC& target) {
-	Melder_assert (my numberOfOutputs == target.size);
-	integer k = my numberOfNodes - my numberOfOutputs + 1;
+static double getMinimumCrossEntropy (constVECVU const& target, constVECVU const& output, VECVU const& error) {
 	double cost = 0.0;
-
-	for (integer i = 1; i <= my numberOfOutputs; i ++, k ++) {
+	for (integer i = 1; i <= target.size; i ++) {
 		const double t1 = 1.0 - target [i];
-		const double o1 = 1.0 - my activity [k];
-		cost -= target [i] * log (my activity [k]) + t1 * log (o1);
-		my error [k] = -t1 / o1 + target [i] / my activity [k];
+		const double o1 = 1.0 - output [i];
+		cost -= target [i] * log (output [i]) + t1 * log (o1);
+		error [i] = -t1 / o1 + target [i] / output [i];
 	}
 	return cost;
 }
 
+static double minimumSquaredError (FFNet me, constVEC& target) {
+	Melder_assert (my numberOfOutputs == target.size);
+	const integer firstOutputNode = my numberOfNodes - my numberOfOutputs + 1;
+	return getMinimumSquaredError (target, my activity.part (firstOutputNode, my numberOfNodes),
+		my error.part (firstOutputNode, my numberOfNodes));
+}
+
+static double minimumCrossEntropy (FFNet me, constVEC& target) {
+	Melder_assert (my numberOfOutputs == target.size);
+	const integer firstOutputNode = my numberOfNodes - my numberOfOutputs + 1;
+	return getMinimumCrossEntropy (target, my activity.part (firstOutputNode, my numberOfNodes),
+		my error.part (firstOutputNode, my numberOfNodes));
+}
+
 
 /* *********************************************************************** */
 
@@ -414,23 +426,238 @@ void FFNet_computeDerivative (FFNet me) {
 
 /******* end operation ******************************************************/
 
+/******* operation on many patterns at once *********************************/
+
+/*
+	The weights of the connections into a layer are stored contiguously in w, unit by unit,
+	every unit with the weights from all the units in the previous layer followed by its bias.
+	The weights of a layer therefore form a dense matrix with numberOfUnitsInLayer [layer] rows
+	and numberOfUnitsInPreviousLayer + 1 columns, so that a block of patterns can be propagated
+	through a layer with a single matrix multiplication.
+*/
+static integer FFNet_getNumberOfUnitsInPreviousLayer (FFNet me, integer layer) {
+	return ( layer == 1 ? my numberOfInputs : my numberOfUnitsInLayer [layer - 1] );
+}
+
+static MAT FFNet_getWeightsOfLayer (FFNet me, VEC const& w, integer layer) {
+	Melder_assert (w.size == my numberOfWeights);
+	integer firstWeight = 1;
+	for (integer ilayer = 1; ilayer < layer; ilayer ++)
+		firstWeight += my numberOfUnitsInLayer [ilayer] * (FFNet_getNumberOfUnitsInPreviousLayer (me, ilayer) + 1);
+	return MAT (& w [firstWeight], my numberOfUnitsInLayer [layer], FFNet_getNumberOfUnitsInPreviousLayer (me, layer) + 1);
+}
+
+/*
+	The activities, derivatives and errors of all the units in the net for a block of at most blockSize patterns,
+	one pattern per row, and the derivative of the cost accumulated over the blocks.
+	Every thread has its own FFNetBatch, initialized on the main thread, so that propagate () and addCost ()
+	do not have to allocate memory; the matrix multiplications inside them do not start threads of their own.
+*/
+struct FFNetBatch {
+	static constexpr integer blockSize = 128;
+	std::vector <autoMAT> activities, derivatives, errors;   // [layer], with layer running from 1 to numberOfLayers
+	autoMAT layerDerivative;   // units x units in previous layer, big enough for every layer
+	autoVEC dw;
+	double cost;
+
+	void init (FFNet net, bool wantErrors, bool wantDerivative) {
+		activities. resize (size_t (net -> numberOfLayers + 1));
+		derivatives. resize (size_t (net -> numberOfLayers + 1));
+		errors. resize (size_t (net -> numberOfLayers + 1));
+		integer maximumNumberOfUnits = 0, maximumNumberOfInputs = 0;
+		for (integer layer = 1; layer <= net -> numberOfLayers; layer ++) {
+			const integer numberOfUnits = net -> numberOfUnitsInLayer [layer];
+			activities [layer] = newMATraw (blockSize, numberOfUnits);
+			if (wantDerivative)
+				derivatives [layer] = newMATraw (blockSize, numberOfUnits);
+			if (wantDerivative || (wantErrors && layer == net -> numberOfLayers))
+				errors [layer] = newMATraw (blockSize, numberOfUnits);
+			maximumNumberOfUnits = std::max (maximumNumberOfUnits, numberOfUnits);
+			maximumNumberOfInputs = std::max (maximumNumberOfInputs, FFNet_getNumberOfUnitsInPreviousLayer (net, layer));
+		}
+		if (wantDerivative) {
+			layerDerivative = newMATraw (maximumNumberOfUnits, maximumNumberOfInputs);
+			dw = newVECzero (net -> numberOfWeights);
+		}
+		cost = 0.0;
+	}
+
+	/*
+		Step (1) for all the rows of input (at most blockSize) at once, up to and including lastLayer.
+	*/
+	void propagate (FFNet net, constMATVU const& input, integer lastLayer, bool wantDerivative) noexcept {
+		const integer numberOfPatterns = input.nrow;
+		constMATVU previousActivities = input;
+		for (integer layer = 1; layer <= lastLayer; layer ++) {
+			const integer numberOfInputs = FFNet_getNumberOfUnitsInPreviousLayer (net, layer);
+			const constMAT weights = FFNet_getWeightsOfLayer (net, net -> w.get(), layer);
+			const MATVU activity = activities [layer].part (1, numberOfPatterns, 1, weights.nrow);
+			MATmul_fast_singleThread (activity, previousActivities, weights.verticalBand (1, numberOfInputs).transpose ());
+			const bool isLinear = ( layer == net -> numberOfLayers && net -> outputsAreLinear );
+			for (integer ipattern = 1; ipattern <= numberOfPatterns; ipattern ++) {
+				for (integer iunit = 1; iunit <= weights.nrow; iunit ++) {
+					const double act = activity [ipattern] [iunit] + weights [iunit] [numberOfInputs + 1];   // the bias
+					if (isLinear) {
+						activity [ipattern] [iunit] = act;
+						if (wantDerivative)
+							derivatives [layer] [ipattern] [iunit] = 1.0;
+					} else {
+						activity [ipattern] [iunit] = net -> nonLinearity (net, act,
+							wantDerivative ? & derivatives [layer] [ipattern] [iunit] : nullptr);
+					}
+				}
+			}
+			previousActivities = activity;
+		}
+	}
+
+	/*
+		Steps (1) and (2), and if wanted (3) and (4), for all the rows of input at once;
+		the costs and the derivatives are added to those of the earlier blocks.
+	*/
+	void addCost (FFNet net, constMATVU const& input, constMATVU const& target, bool wantDerivative) noexcept {
+		const integer numberOfPatterns = input.nrow, numberOfLayers = net -> numberOfLayers;
+		propagate (net, input, numberOfLayers, wantDerivative);
+		/*
+			Compute the errors at the output layer.
+		*/
+		const MATVU outputErrors = errors [numberOfLayers].part (1, numberOfPatterns, 1, net -> numberOfOutputs);
+		for (integer ipattern = 1; ipattern <= numberOfPatterns; ipattern ++) {
+			const constVECVU output = activities [numberOfLayers].row (ipattern);
+			cost += ( net -> costFunctionType == 2 ?
+				getMinimumCrossEntropy (target.row (ipattern), output, outputErrors.row (ipattern)) :
+				getMinimumSquaredError (target.row (ipattern), output, outputErrors.row (ipattern))
+			);
+		}
+		if (! wantDerivative)
+			return;
+		/*
+			Backpropagate the errors from the output layer to the first hidden layer,
+			and compute the derivatives of the weights on the way.
+		*/
+		for (integer layer = numberOfLayers; layer >= 1; layer --) {
+			const integer numberOfInputs = FFNet_getNumberOfUnitsInPreviousLayer (net, layer);
+			const constMAT weights = FFNet_getWeightsOfLayer (net, net -> w.get(), layer);
+			const MAT dweights = FFNet_getWeightsOfLayer (net, dw.get(), layer);
+			const MATVU error = errors [layer].part (1, numberOfPatterns, 1, weights.nrow);
+			const constMATVU derivative = derivatives [layer].part (1, numberOfPatterns, 1, weights.nrow);
+			for (integer ipattern = 1; ipattern <= numberOfPatterns; ipattern ++)
+				for (integer iunit = 1; iunit <= weights.nrow; iunit ++)
+					error [ipattern] [iunit] *= derivative [ipattern] [iunit];
+			const constMATVU previousActivities = ( layer == 1 ? input :
+					constMATVU (activities [layer - 1].part (1, numberOfPatterns, 1, numberOfInputs)) );
+			const MATVU derivativeOfWeights = layerDerivative.part (1, weights.nrow, 1, numberOfInputs);
+			MATmul_fast_singleThread (derivativeOfWeights, error.transpose (), previousActivities);
+			for (integer iunit = 1; iunit <= weights.nrow; iunit ++) {
+				for (integer iinput = 1; iinput <= numberOfInputs; iinput ++)
+					dweights [iunit] [iinput] -= derivativeOfWeights [iunit] [iinput];
+				double biasDerivative = 0.0;
+				for (integer ipattern = 1; ipattern <= numberOfPatterns; ipattern ++)
+					biasDerivative += error [ipattern] [iunit];
+				dweights [iunit] [numberOfInputs + 1] -= biasDerivative;   // the activity of a bias node is 1
+			}
+			if (layer > 1)
+				MATmul_fast_singleThread (errors [layer - 1].part (1, numberOfPatterns, 1, numberOfInputs),
+						error, weights.verticalBand (1, numberOfInputs));
+		}
+	}
+};
+
+static constMATVU constMATVUrows (constMATVU const& x, integer firstRow, integer lastRow) {
+	return constMATVU (& x [firstRow] [1], lastRow - firstRow + 1, x.ncol, x.rowStride, x.colStride);
+}
+
+void FFNet_propagateRows (FFNet me, constMATVU const& input, MATVU const& output, integer layer) {
+	Melder_require (layer > 0 && layer <= my numberOfLayers,
+		U"The layer number should be between 1 and ", my numberOfLayers, U".");
+	Melder_assert (input.ncol == my numberOfInputs);
+	Melder_assert (output.nrow == input.nrow && output.ncol == my numberOfUnitsInLayer [layer]);
+	const integer numberOfThreads = MelderThread_getNumberOfThreads (input.nrow, double (input.nrow) * double (my numberOfWeights));
+	std::vector <FFNetBatch> batches ((size_t) numberOfThreads);
+	for (FFNetBatch& batch : batches)
+		batch. init (me, false, false);
+	MelderThread_runStretches (numberOfThreads, input.nrow, [&] (integer ithread, integer firstRow, integer lastRow) {
+		FFNetBatch& batch = batches [(size_t) ithread];
+		for (integer irow = firstRow; irow <= lastRow; irow += FFNetBatch::blockSize) {
+			const integer lastRowOfBlock = std::min (irow + FFNetBatch::blockSize - 1, lastRow);
+			batch. propagate (me, constMATVUrows (input, irow, lastRowOfBlock), layer, false);
+			for (integer jrow = irow; jrow <= lastRowOfBlock; jrow ++)
+				output.row (jrow)  <<=  batch. activities [layer].row (jrow - irow + 1);
+		}
+	});
+}
+
+double FFNet_computeCostOfRows (FFNet me, constMATVU const& input, constMATVU const& target, bool wantDerivative) {
+	Melder_assert (input.ncol == my numberOfInputs && target.ncol == my numberOfOutputs);
+	Melder_assert (target.nrow == input.nrow);
+	if (Melder_debug == -3) {
+		/*
+			Pattern by pattern, with steps (1) to (4) above, as a reference for the computation in blocks.
+		*/
+		autoVEC inputRow = newVECraw (input.ncol), targetRow = newVECraw (target.ncol);
+		longdouble cost = 0.0;
+		if (wantDerivative)
+			my dw.all()  <<=  0.0;
+		for (integer irow = 1; irow <= input.nrow; irow ++) {
+			inputRow.all()  <<=  input.row (irow);
+			targetRow.all()  <<=  target.row (irow);
+			FFNet_propagate (me, inputRow.get(), nullptr);
+			cost += FFNet_computeError (me, targetRow.get());
+			if (wantDerivative) {
+				FFNet_computeDerivative (me);
+				my dw.all()  +=  my dwi.all();
+			}
+		}
+		return (double) cost;
+	}
+	const double numberOfOperations = ( wantDerivative ? 3.0 : 1.0 ) * double (input.nrow) * double (my numberOfWeights);
+	const integer numberOfThreads = MelderThread_getNumberOfThreads (input.nrow, numberOfOperations);
+	std::vector <FFNetBatch> batches ((size_t) numberOfThreads);
+	for (FFNetBatch& batch : batches)
+		batch. init (me, true, wantDerivative);
+	MelderThread_runStretches (numberOfThreads, input.nrow, [&] (integer ithread, integer firstRow, integer lastRow) {
+		FFNetBatch& batch = batches [(size_t) ithread];
+		for (integer irow = firstRow; irow <= lastRow; irow += FFNetBatch::blockSize) {
+			const integer lastRowOfBlock = std::min (irow + FFNetBatch::blockSize - 1, lastRow);
+			batch. addCost (me, constMATVUrows (input, irow, lastRowOfBlock), constMATVUrows (target, irow, lastRowOfBlock), wantDerivative);
+		}
+	});
+	/*
+		Add the costs and the derivatives of the threads in a fixed order,
+		so that the result does not depend on which thread finishes first.
+	*/
+	longdouble cost = 0.0;
+	if (wantDerivative)
+		my dw.all()  <<=  0.0;
+	for (FFNetBatch& batch : batches) {
+		cost += batch. cost;
+		if (wantDerivative)
+			my dw.all()  +=  batch. dw.all();
+	}
+	return (double) cost;
+}
+
 integer FFNet_getWinningUnit (FFNet me, integer labeling) {
-	const integer k = my numberOfNodes - my numberOfOutputs;
+	return FFNet_getWinningUnitOfOutputs (me, my activity.part (my numberOfNodes - my numberOfOutputs + 1, my numberOfNodes), labeling);
+}
+
+integer FFNet_getWinningUnitOfOutputs (FFNet me, constVECVU const& outputs, integer labeling) {
+	Melder_assert (outputs.size == my numberOfOutputs);
 	integer winningUnit = 1;
 	if (labeling == 2) { /* stochastic */
 		double sum = 0.0;
 		for (integer ioutput = 1; ioutput <= my numberOfOutputs; ioutput ++)
-			sum += my activity [k + ioutput];
+			sum += outputs [ioutput];
 
 		const double random = NUMrandomUniform (0.0, sum);
 		for (winningUnit = my numberOfOutputs; winningUnit >= 2; winningUnit--)
-			if (random > (sum -= my activity [k + winningUnit]))
+			if (random > (sum -= outputs [winningUnit]))
 				break;
 	} else { /* winner-takes-all */
-		double max = my activity [k + 1];
+		double max = outputs [1];
 		for (integer ioutput = 2; ioutput <= my numberOfOutputs; ioutput ++)
-			if (my activity [k + ioutput] > max) {
-				max = my activity [k + ioutput];
+			if (outputs [ioutput] > max) {
+				max = outputs [ioutput];
 				winningUnit = ioutput;
 			}
 	}
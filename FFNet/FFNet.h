@@ -178,6 +178,22 @@ integer FFNet_getWinningUnit (FFNet me, integer labeling);
 /* labeling = 1 : winner-takes-all */
 /* labeling = 2 : stochastic */
 
+integer FFNet_getWinningUnitOfOutputs (FFNet me, constVECVU const& outputs, integer labeling);
+/* as FFNet_getWinningUnit, but for the output activities in outputs instead of those in my activity */
+
+void FFNet_propagateRows (FFNet me, constMATVU const& input, MATVU const& output, integer layer);
+/* step (1) for every row of input at once:
+ * output [i] gets the activities of the units in layer for the input pattern input [i].
+ * The patterns go through the net in blocks, a layer at a time, and the blocks are divided over threads.
+ * my activity is not used.
+ */
+
+double FFNet_computeCostOfRows (FFNet me, constMATVU const& input, constMATVU const& target, bool wantDerivative);
+/* steps (1) and (2) for every row of input at once, as FFNet_propagateRows;
+ * returns the cost summed over all the patterns.
+ * If wantDerivative, also steps (3) and (4): my dw gets the derivative summed over all the patterns.
+ */
+
 void FFNet_selectAllWeights (FFNet me);
 
 void FFNet_selectBiasesInLayer (FFNet me, integer layer);
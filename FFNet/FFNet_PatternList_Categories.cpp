@@ -76,11 +76,14 @@ autoCategories FFNet_PatternList_to_Categories (FFNet me, PatternList thee, int
 		Melder_require (_PatternList_checkElements (thee),
 			U"All PatternList elements should be in the interval [0, 1].\nYou could use \"Formula...\" to scale the PatternList values first.");
 
+		autoMAT outputs = newMATraw (thy ny, my numberOfOutputs);
+		FFNet_propagateRows (me, thy z.get(), outputs.get(), my numberOfLayers);
+		/*
+			The winners are chosen in pattern order, so that stochastic labeling draws its random numbers in the same order as before.
+		*/
 		autoCategories him = Categories_create ();
-
 		for (integer k = 1; k <= thy ny; k ++) {
-			FFNet_propagate (me, thy z.row (k), nullptr);
-			const integer index = FFNet_getWinningUnit (me, labeling);
+			const integer index = FFNet_getWinningUnitOfOutputs (me, outputs.row (k), labeling);
 			autoSimpleString item = Data_copy (my outputCategories->at [index]);
 			his addItem_move (item.move());
 		}
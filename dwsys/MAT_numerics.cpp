@@ -27,11 +27,29 @@ void MAT_getEigenSystemFromSymmetricMatrix_preallocated (MAT eigenvectors, VEC e
 	Melder_assert (eigenvectors.nrow == eigenvectors.ncol);
 	Melder_assert (m.nrow == eigenvectors.nrow);
 
+	eigenvectors <<= m;
+	#ifdef EXTERNAL_LAPACK
+	{
+		/*
+			Divide and conquer; the eigenvectors come in the same (row-wise) layout as with dsyev.
+		*/
+		const int n = NUMlapack_fortranInteger (m.ncol);
+		int lwork = -1, liwork = -1, info = 0, iwt [1];
+		double wt [1];
+		dsyevd_ ("V", "U", & n, & eigenvectors [1] [1], & n, eigenvalues.begin(), wt, & lwork, iwt, & liwork, & info, 1, 1);
+		Melder_require (info == 0, U"dsyevd initialization code = ", info, U").");
+		lwork = NUMlapack_fortranInteger (Melder_iceiling (wt [0]));
+		liwork = iwt [0];
+		autoVEC work = newVECraw (lwork);
+		std::vector <int> iwork (liwork);
+		dsyevd_ ("V", "U", & n, & eigenvectors [1] [1], & n, eigenvalues.begin(), work.begin(), & lwork, iwork.data(), & liwork, & info, 1, 1);
+		Melder_require (info == 0, U"dsyevd code = ", info, U").");
+	}
+	#else
 	char jobz = 'V', uplo = 'U';
 	integer workSize = -1, info, ncol = m.ncol;
 	double wt [1];
 	
-	eigenvectors <<= m;
 	/*
 		0. No need to transpose a because it is a symmetric matrix
 		1. Query for the size of the work array
@@ -46,6 +64,7 @@ void MAT_getEigenSystemFromSymmetricMatrix_preallocated (MAT eigenvectors, VEC e
 	*/
 	(void) NUMlapack_dsyev (& jobz, & uplo, & ncol, & eigenvectors [1] [1], & ncol, eigenvalues.begin(), work.begin(), & workSize, & info);
 	Melder_require (info == 0, U"dsyev code = ", info, U").");
+	#endif
 	/*
 		3. Eigenvalues are returned in ascending order
 	*/
@@ -175,4 +194,92 @@ autoMAT newMATpseudoInverse (constMATVU const& mat, double tolerance) {
 	return result;
 }
 
+void MATorthonormalizeColumns_inplace (MAT const& m) {
+	Melder_assert (m.nrow >= m.ncol);
+	if (m.ncol == 0)
+		return;
+	/*
+		In Fortran storage, the rows of m are the columns of an m.ncol x m.nrow matrix,
+		whose LQ decomposition gives orthonormal rows there, i.e. orthonormal columns here.
+	*/
+	integer nrow = m.ncol, ncol = m.nrow, lda = m.ncol, info, workSize = -1;
+	double wt [1];
+	autoVEC tau = newVECraw (m.ncol);
+	(void) NUMlapack_dgelqf (& nrow, & ncol, & m [1] [1], & lda, tau.begin(), wt, & workSize, & info);
+	Melder_require (info == 0, U"dgelqf initialization code = ", info, U").");
+	workSize = Melder_iceiling (wt [0]);
+	autoVEC work = newVECraw (workSize);
+	(void) NUMlapack_dgelqf (& nrow, & ncol, & m [1] [1], & lda, tau.begin(), work.begin(), & workSize, & info);
+	Melder_require (info == 0, U"dgelqf code = ", info, U").");
+	workSize = -1;
+	(void) NUMlapack_dorglq (& nrow, & ncol, & nrow, & m [1] [1], & lda, tau.begin(), wt, & workSize, & info);
+	Melder_require (info == 0, U"dorglq initialization code = ", info, U").");
+	workSize = Melder_iceiling (wt [0]);
+	work = newVECraw (workSize);
+	(void) NUMlapack_dorglq (& nrow, & ncol, & nrow, & m [1] [1], & lda, tau.begin(), work.begin(), & workSize, & info);
+	Melder_require (info == 0, U"dorglq code = ", info, U").");
+}
+
+/*
+	target := (m - 1.c').x
+*/
+static void MATmul_centred (MAT const& target, constMATVU const& m, constVECVU const& centroid, constMATVU const& x) {
+	MATmul_fast (target, m, x);
+	if (centroid.size > 0) {
+		autoVEC cx = newVECmul (centroid, x);
+		for (integer irow = 1; irow <= target.nrow; irow ++)
+			target.row (irow)  -=  cx.all();
+	}
+}
+
+/*
+	target := (m - 1.c')'.y
+*/
+static void MATmul_centred_transposed (MAT const& target, constMATVU const& m, constVECVU const& centroid, constMATVU const& y) {
+	MATmul_fast (target, m.transpose(), y);
+	if (centroid.size > 0) {
+		autoVEC columnSums = newVECzero (y.ncol);
+		for (integer irow = 1; irow <= y.nrow; irow ++)
+			columnSums.all()  +=  y.row (irow);
+		for (integer irow = 1; irow <= target.nrow; irow ++)
+			for (integer icol = 1; icol <= target.ncol; icol ++)
+				target [irow] [icol] -= centroid [irow] * columnSums [icol];
+	}
+}
+
+void MAT_getTruncatedSVD_randomized (constMATVU const& m, constVECVU const& centroid, integer numberOfComponents,
+	integer numberOfPowerIterations, autoMAT *out_rightSingularVectors, autoVEC *out_singularValues)
+{
+	Melder_assert (numberOfComponents >= 1 && numberOfComponents <= std::min (m.nrow, m.ncol));
+	Melder_assert (centroid.size == 0 || centroid.size == m.ncol);
+	const integer numberOfSamples = std::min (numberOfComponents + 10, std::min (m.nrow, m.ncol));
+	/*
+		Q (nrow x numberOfSamples) is an orthonormal basis for the range of M.Omega,
+		refined by power iterations with M.M' (orthonormalized in between to keep the small singular values).
+	*/
+	autoMAT omega = newMATrandomGauss (m.ncol, numberOfSamples, 0.0, 1.0);
+	autoMAT q = newMATraw (m.nrow, numberOfSamples);
+	autoMAT z = newMATraw (m.ncol, numberOfSamples);
+	MATmul_centred (q.get(), m, centroid, omega.get());
+	MATorthonormalizeColumns_inplace (q.get());
+	for (integer iteration = 1; iteration <= numberOfPowerIterations; iteration ++) {
+		MATmul_centred_transposed (z.get(), m, centroid, q.get());
+		MATorthonormalizeColumns_inplace (z.get());
+		MATmul_centred (q.get(), m, centroid, z.get());
+		MATorthonormalizeColumns_inplace (q.get());
+	}
+	/*
+		M ~ Q.Q'.M = Q.B; the small matrix B' = M'.Q = U.D.V' has the right singular vectors of M in U.
+	*/
+	MATmul_centred_transposed (z.get(), m, centroid, q.get());
+	autoSVD svd = SVD_createFromGeneralMatrix (z.get());
+	Melder_assert (! svd -> isTransposed);
+	if (out_rightSingularVectors) {
+		autoMAT rightSingularVectors = newMATtranspose (svd -> u.verticalBand (1, numberOfComponents));
+		*out_rightSingularVectors = rightSingularVectors.move();
+	}
+	if (out_singularValues)
+		*out_singularValues = newVECcopy (svd -> d.part (1, numberOfComponents));
+}
+
 /* End of file MAT_numerics.cpp */
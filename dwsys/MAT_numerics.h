@@ -77,4 +77,23 @@ autoMAT newMATpseudoInverse (constMATVU const& mat, double tolerance);
 	Returns a [1..ncol][1..nrow] matrix
 */
 
+void MATorthonormalizeColumns_inplace (MAT const& m);
+/*
+	Replaces the columns of m (m.nrow >= m.ncol) by an orthonormal basis of the space they span,
+	by Householder reflections.
+*/
+
+void MAT_getTruncatedSVD_randomized (constMATVU const& m, constVECVU const& centroid, integer numberOfComponents,
+	integer numberOfPowerIterations, autoMAT *out_rightSingularVectors, autoVEC *out_singularValues);
+/*
+	The largest numberOfComponents singular values (sorted descending) and the corresponding
+	right singular vectors (stored row-wise) of the matrix m with the centroid subtracted from each row
+	(an empty centroid means no centring).
+	A randomized range finder (Halko, Martinsson & Tropp 2011) with 10 extra dimensions
+	and numberOfPowerIterations power iterations; the centred matrix is never formed, and the extra memory
+	is only of the order of m.nrow x (numberOfComponents + 10).
+	The result approaches that of the full SVD quickly with the number of power iterations,
+	the more so if the singular values decrease fast.
+*/
+
 /* End of file MAT_numerics.h */
@@ -21,6 +21,10 @@
 #include "NUMmachar.h"
 #include "NUM2.h"
 #include "SVD.h"
+#include "MelderThread.h"
+
+#include <vector>
+#include <algorithm>
 
 #include "oo_DESTROY.h"
 #include "NMF_def.h"
@@ -186,6 +190,177 @@ double NMF_getItakuraSaitoDivergence (NMF me, constMATVU const& data) {
 	return MATgetDivergence_ItakuraSaito (data, synthesis.get());
 }
 
+void SparseNonnegativeMatrix_init (SparseNonnegativeMatrix *me, integer numberOfRows, integer numberOfColumns,
+	constINTVEC const& rows, constINTVEC const& columns, constVEC const& values)
+{
+	Melder_assert (rows.size == columns.size && rows.size == values.size);
+	/*
+		Sort the non-zero cells by row (counting sort), then by column within each row, adding the values of equal cells.
+	*/
+	autoINTVEC rowStart = newINTVECzero (numberOfRows + 1);
+	for (integer k = 1; k <= rows.size; k ++) {
+		Melder_require (rows [k] >= 1 && rows [k] <= numberOfRows && columns [k] >= 1 && columns [k] <= numberOfColumns,
+			U"Cell ", k, U" should lie within the matrix.");
+		Melder_require (isdefined (values [k]) && values [k] >= 0.0,
+			U"Cell ", k, U": the value should be defined and not negative.");
+		if (values [k] > 0.0)
+			rowStart [rows [k]] ++;
+	}
+	integer position = 1;
+	for (integer irow = 1; irow <= numberOfRows; irow ++) {
+		const integer numberOfCells = rowStart [irow];
+		rowStart [irow] = position;
+		position += numberOfCells;
+	}
+	rowStart [numberOfRows + 1] = position;
+	std::vector <std::pair <integer, double>> cells ((size_t) (position - 1));
+	autoINTVEC fill = newINTVECcopy (rowStart.part (1, numberOfRows));
+	for (integer k = 1; k <= rows.size; k ++)
+		if (values [k] > 0.0)
+			cells [(size_t) (fill [rows [k]] ++ - 1)] = { columns [k], values [k] };
+	my numberOfRows = numberOfRows;
+	my numberOfColumns = numberOfColumns;
+	my rowStart = newINTVECraw (numberOfRows + 1);
+	my rowColumn = newINTVECraw (position - 1);
+	my rowValue = newVECraw (position - 1);
+	integer numberOfNonzeros = 0;
+	for (integer irow = 1; irow <= numberOfRows; irow ++) {
+		my rowStart [irow] = numberOfNonzeros + 1;
+		std::sort (cells.begin () + (rowStart [irow] - 1), cells.begin () + (rowStart [irow + 1] - 1));
+		for (integer k = rowStart [irow]; k < rowStart [irow + 1]; k ++) {
+			const std::pair <integer, double>& cell = cells [(size_t) (k - 1)];
+			if (numberOfNonzeros >= my rowStart [irow] && my rowColumn [numberOfNonzeros] == cell.first) {
+				my rowValue [numberOfNonzeros] += cell.second;
+			} else {
+				numberOfNonzeros ++;
+				my rowColumn [numberOfNonzeros] = cell.first;
+				my rowValue [numberOfNonzeros] = cell.second;
+			}
+		}
+	}
+	my rowStart [numberOfRows + 1] = numberOfNonzeros + 1;
+	my rowColumn.resize (numberOfNonzeros);
+	my rowValue.resize (numberOfNonzeros);
+	/*
+		The same cells by column; within a column they come out in row order.
+	*/
+	my columnStart = newINTVECzero (numberOfColumns + 1);
+	for (integer k = 1; k <= numberOfNonzeros; k ++)
+		my columnStart [my rowColumn [k]] ++;
+	position = 1;
+	for (integer icol = 1; icol <= numberOfColumns; icol ++) {
+		const integer numberOfCells = my columnStart [icol];
+		my columnStart [icol] = position;
+		position += numberOfCells;
+	}
+	my columnStart [numberOfColumns + 1] = position;
+	my columnRow = newINTVECraw (numberOfNonzeros);
+	my columnValue = newVECraw (numberOfNonzeros);
+	fill = newINTVECcopy (my columnStart.part (1, numberOfColumns));
+	for (integer irow = 1; irow <= numberOfRows; irow ++)
+		for (integer k = my rowStart [irow]; k < my rowStart [irow + 1]; k ++) {
+			const integer kcol = fill [my rowColumn [k]] ++;
+			my columnRow [kcol] = irow;
+			my columnValue [kcol] = my rowValue [k];
+		}
+}
+
+void SparseNonnegativeMatrix_initFromMatrix (SparseNonnegativeMatrix *me, constMATVU const& data) {
+	integer numberOfNonzeros = 0;
+	for (integer irow = 1; irow <= data.nrow; irow ++)
+		for (integer icol = 1; icol <= data.ncol; icol ++)
+			if (data [irow] [icol] != 0.0)
+				numberOfNonzeros ++;
+	autoINTVEC rows = newINTVECraw (numberOfNonzeros), columns = newINTVECraw (numberOfNonzeros);
+	autoVEC values = newVECraw (numberOfNonzeros);
+	integer k = 0;
+	for (integer irow = 1; irow <= data.nrow; irow ++)
+		for (integer icol = 1; icol <= data.ncol; icol ++)
+			if (data [irow] [icol] != 0.0) {
+				k ++;
+				rows [k] = irow;
+				columns [k] = icol;
+				values [k] = data [irow] [icol];
+			}
+	SparseNonnegativeMatrix_init (me, data.nrow, data.ncol, rows.get(), columns.get(), values.get());
+}
+
+double NUMfractionOfNonzeros (constMATVU const& data) {
+	if (data.nrow == 0 || data.ncol == 0)
+		return 0.0;
+	integer numberOfNonzeros = 0;
+	for (integer irow = 1; irow <= data.nrow; irow ++)
+		for (integer icol = 1; icol <= data.ncol; icol ++)
+			if (data [irow] [icol] != 0.0)
+				numberOfNonzeros ++;
+	return double (numberOfNonzeros) / (double (data.nrow) * data.ncol);
+}
+
+/*
+	The data enter the multiplicative and ALS updates only in F'*D, D*W' and trace (D'*D).
+	They are either dense (sparse == nullptr) or sparse.
+*/
+static void mul_FtD (MATVU const& target, constMATVU const& features, constMATVU const& data, SparseNonnegativeMatrix *sparse) {
+	if (! sparse) {
+		MATmul_fast (target, features.transpose(), data);
+		return;
+	}
+	/*
+		Column j of F'*D is the sum of the rows of F that are weighed by the non-zero cells in column j of D;
+		the columns are independent.
+	*/
+	const integer numberOfFeatures = features.ncol;
+	MelderThread_runStretches (MelderThread_getNumberOfThreads (sparse -> numberOfColumns, 2.0 * sparse -> columnRow.size * numberOfFeatures), sparse -> numberOfColumns,
+		[&] (integer /* ithread */, integer firstColumn, integer lastColumn) {
+			for (integer icol = firstColumn; icol <= lastColumn; icol ++) {
+				for (integer kf = 1; kf <= numberOfFeatures; kf ++)
+					target [kf] [icol] = 0.0;
+				for (integer k = sparse -> columnStart [icol]; k < sparse -> columnStart [icol + 1]; k ++) {
+					const double value = sparse -> columnValue [k];
+					const constVECVU featuresRow = features.row (sparse -> columnRow [k]);
+					for (integer kf = 1; kf <= numberOfFeatures; kf ++)
+						target [kf] [icol] += value * featuresRow [kf];
+				}
+			}
+		}
+	);
+}
+
+static void mul_DWt (MATVU const& target, constMATVU const& data, constMATVU const& weights, SparseNonnegativeMatrix *sparse, MATVU const& weightsTransposed) {
+	if (! sparse) {
+		MATmul_fast (target, data, weights.transpose());
+		return;
+	}
+	/*
+		Row i of D*W' is the sum of the columns of W that are weighed by the non-zero cells in row i of D.
+		The columns of W are copied to rows first, for contiguous access.
+	*/
+	weightsTransposed  <<=  weights.transpose();
+	const integer numberOfFeatures = weights.nrow;
+	MelderThread_runStretches (MelderThread_getNumberOfThreads (sparse -> numberOfRows, 2.0 * sparse -> rowColumn.size * numberOfFeatures), sparse -> numberOfRows,
+		[&] (integer /* ithread */, integer firstRow, integer lastRow) {
+			for (integer irow = firstRow; irow <= lastRow; irow ++) {
+				for (integer kf = 1; kf <= numberOfFeatures; kf ++)
+					target [irow] [kf] = 0.0;
+				for (integer k = sparse -> rowStart [irow]; k < sparse -> rowStart [irow + 1]; k ++) {
+					const double value = sparse -> rowValue [k];
+					const constVECVU weightsColumn = weightsTransposed.row (sparse -> rowColumn [k]);
+					for (integer kf = 1; kf <= numberOfFeatures; kf ++)
+						target [irow] [kf] += value * weightsColumn [kf];
+				}
+			}
+		}
+	);
+}
+
+static double getSumOfSquares (constMATVU const& data, SparseNonnegativeMatrix *sparse) {
+	return ( sparse ? NUMsum2 (sparse -> rowValue.get()) : NUMtrace2 (data.transpose(), data) );
+}
+
+static double getMaximum (constMATVU const& data, SparseNonnegativeMatrix *sparse) {
+	return ( sparse ? ( sparse -> rowValue.size > 0 ? NUMmax (sparse -> rowValue.get()) : 0.0 ) : NUMmax (data) );
+}
+
 static double getMaximumChange (constMATVU const& m, MATVU const& m0, const double sqrteps) {
 	double min = NUMmin (m0);
 	double max = NUMmax (m0);
@@ -233,12 +408,8 @@ static const void update (MATVU const& m, constMATVU const& m0, constMATVU const
 		Computing and informatics% #30: 205--224.
 
 */
-void NMF_improveFactorization_mu (NMF me, constMATVU const& data, integer maximumNumberOfIterations, double changeTolerance, double approximationTolerance, bool info) {
+static void improveFactorization_mu (NMF me, constMATVU const& data, SparseNonnegativeMatrix *sparse, integer maximumNumberOfIterations, double changeTolerance, double approximationTolerance, bool info) {
 	try {
-		Melder_require (my numberOfColumns == data.ncol,
-			U"The number of columns should be equal.");
-		Melder_require (my numberOfRows == data.nrow,
-			U"The number of rows should be equal.");
 		
 		autoMAT productFtD = newMATzero (my numberOfFeatures, my numberOfColumns); // calculations of F'D
 		autoMAT productFtFW = newMATzero (my numberOfFeatures, my numberOfColumns); // calculations of F'F W
@@ -250,8 +421,9 @@ void NMF_improveFactorization_mu (NMF me, constMATVU const& data, integer maximu
 		
 		autoMAT productWWt = newMATzero (my numberOfFeatures, my numberOfFeatures); // calculations of WW'
 		autoMAT productFtF = newMATzero (my numberOfFeatures, my numberOfFeatures); // calculations of F'F
+		autoMAT weightsTransposed = newMATzero (( sparse ? my numberOfColumns : 0 ), my numberOfFeatures);
 		
-		const double traceDtD = NUMtrace2 (data.transpose(), data); // for distance calculation
+		const double traceDtD = getSumOfSquares (data, sparse); // for distance calculation
 		features0.get() <<= my features.get();
 		weights0.get() <<= my weights.get();
 		
@@ -260,7 +432,7 @@ void NMF_improveFactorization_mu (NMF me, constMATVU const& data, integer maximu
 		
 		const double eps = NUMfpp -> eps;
 		const double sqrteps = sqrt (eps);
-		const double maximum = NUMmax (data);
+		const double maximum = getMaximum (data, sparse);
 		double dnorm0 = 0.0;
 		integer iter = 1;
 		bool convergence = false;	
@@ -277,15 +449,15 @@ void NMF_improveFactorization_mu (NMF me, constMATVU const& data, integer maximu
 			// 1. Update W matrix
 			features0.get() <<= my features.get();
 			weights0.get() <<= my weights.get();
-			MATmul (productFtD.get(), features0.transpose(), data);
-			MATmul (productFtF.get(), features0.transpose(), features0.get());
-			MATmul (productFtFW.get(), productFtF.get(), weights0.get());
+			mul_FtD (productFtD.get(), features0.get(), data, sparse);
+			MATmul_fast (productFtF.get(), features0.transpose(), features0.get());
+			MATmul_fast (productFtFW.get(), productFtF.get(), weights0.get());
 			update (my weights.get(), weights0.get(), productFtD.get(), productFtFW.get(), eps, maximum);
 
 			// 2. Update F matrix
-			MATmul (productDWt.get(), data, my weights.transpose()); // productDWt = data*weights'
-			MATmul (productWWt.get(), my weights.get(), my weights.transpose()); // work1 = weights*weights'
-			MATmul (productFWWt.get(), features0.get(), productWWt.get()); // productFWWt = features0 * work1
+			mul_DWt (productDWt.get(), data, my weights.get(), sparse, weightsTransposed.get()); // productDWt = data*weights'
+			MATmul_fast (productWWt.get(), my weights.get(), my weights.transpose()); // work1 = weights*weights'
+			MATmul_fast (productFWWt.get(), features0.get(), productWWt.get()); // productFWWt = features0 * work1
 			update (my features.get(), features0.get(), productDWt.get(), productFWWt.get(), eps, maximum);
 			
 			/* 3. Convergence test:
@@ -318,13 +490,32 @@ void NMF_improveFactorization_mu (NMF me, constMATVU const& data, integer maximu
 	}
 }
 
-void NMF_improveFactorization_als (NMF me, constMATVU const& data, integer maximumNumberOfIterations, double changeTolerance, double approximationTolerance, bool info) {
+void NMF_improveFactorization_mu (NMF me, constMATVU const& data, integer maximumNumberOfIterations, double changeTolerance, double approximationTolerance, bool info) {
+	Melder_require (my numberOfColumns == data.ncol,
+		U"The number of columns should be equal.");
+	Melder_require (my numberOfRows == data.nrow,
+		U"The number of rows should be equal.");
+	if (NUMfractionOfNonzeros (data) < 0.1) {
+		SparseNonnegativeMatrix sparse;
+		SparseNonnegativeMatrix_initFromMatrix (& sparse, data);
+		improveFactorization_mu (me, data, & sparse, maximumNumberOfIterations, changeTolerance, approximationTolerance, info);
+	} else
+		improveFactorization_mu (me, data, nullptr, maximumNumberOfIterations, changeTolerance, approximationTolerance, info);
+}
+
+void NMF_improveFactorization_mu_sparse (NMF me, SparseNonnegativeMatrix *data, integer maximumNumberOfIterations, double changeTolerance, double approximationTolerance, bool info) {
+	Melder_require (my numberOfColumns == data -> numberOfColumns,
+		U"The number of columns should be equal.");
+	Melder_require (my numberOfRows == data -> numberOfRows,
+		U"The number of rows should be equal.");
+	improveFactorization_mu (me, constMATVU (), data, maximumNumberOfIterations, changeTolerance, approximationTolerance, info);
+}
+
+static void improveFactorization_als (NMF me, constMATVU const& data, SparseNonnegativeMatrix *sparse, integer maximumNumberOfIterations, double changeTolerance, double approximationTolerance, bool info) {
 	try {
-		Melder_require (my numberOfColumns == data.ncol, U"The number of columns should be equal.");
-		Melder_require (my numberOfRows == data.nrow, U"The number of rows should be equal.");
-		
 		autoMAT productFtD = newMATzero (my numberOfFeatures, my numberOfColumns); // calculations of F'D
-		autoMAT productWDt = newMATzero (my numberOfFeatures, my numberOfRows); // calculations of WD'
+		autoMAT productDWt = newMATzero (my numberOfRows, my numberOfFeatures); // calculations of DW' = (WD')'
+		autoMAT weightsTransposed = newMATzero (( sparse ? my numberOfColumns : 0 ), my numberOfFeatures);
 		
 		autoMAT weights0 = newMATzero (my numberOfFeatures, my numberOfColumns);
 		autoMAT features0 = newMATzero (my numberOfRows, my numberOfFeatures);
@@ -335,7 +526,7 @@ void NMF_improveFactorization_als (NMF me, constMATVU const& data, integer maxim
 		autoSVD svd_WWt = SVD_create (my numberOfFeatures, my numberOfFeatures); // solving W*W'*F' = W*D'
 		autoSVD svd_FtF = SVD_create (my numberOfFeatures, my numberOfFeatures); // solving F´*F*W = F'*D
 				
-		const double traceDtD = NUMtrace2 (data.transpose(), data); // for distance calculation
+		const double traceDtD = getSumOfSquares (data, sparse); // for distance calculation
 		
 		if (! NUMfpp)
 			NUMmachar ();
@@ -358,8 +549,8 @@ void NMF_improveFactorization_als (NMF me, constMATVU const& data, integer maxim
 			
 			// 1. Solve equations for new W:  F´*F*W = F'*D.
 			weights0.get() <<= my weights.get(); // save previous weigts for convergence test
-			MATmul (productFtD.get(), my features.transpose(), data);
-			MATmul (productFtF.get(), my features.transpose(), my features.get());
+			mul_FtD (productFtD.get(), my features.get(), data, sparse);
+			MATmul_fast (productFtF.get(), my features.transpose(), my features.get());
 
 			svd_FtF -> u.get() <<= productFtF.get();
 			SVD_compute (svd_FtF.get());
@@ -368,12 +559,12 @@ void NMF_improveFactorization_als (NMF me, constMATVU const& data, integer maxim
 			
 			// 2. Solve equations for new F:  W*W'*F' = W*D'
 			features0.get() <<= my features.get(); // save previous features for convergence test
-			MATmul  (productWDt.get(), my weights.get(), data.transpose());
-			MATmul (productWWt.get(), my weights.get(), my weights.transpose());
+			mul_DWt (productDWt.get(), data, my weights.get(), sparse, weightsTransposed.get());
+			MATmul_fast (productWWt.get(), my weights.get(), my weights.transpose());
 
 			svd_WWt -> u.get() <<= productWWt.get();
 			SVD_compute (svd_WWt.get());
-			SVD_solve_preallocated (svd_WWt.get(), productWDt.get(), my features.transpose());
+			SVD_solve_preallocated (svd_WWt.get(), productDWt.transpose(), my features.transpose());
 
 			// 3. Convergence test
 			const double traceWtFtD  = NUMtrace2 (my weights.transpose(), productFtD.get());
@@ -397,12 +588,54 @@ void NMF_improveFactorization_als (NMF me, constMATVU const& data, integer maxim
 	}
 }
 
+void NMF_improveFactorization_als (NMF me, constMATVU const& data, integer maximumNumberOfIterations, double changeTolerance, double approximationTolerance, bool info) {
+	Melder_require (my numberOfColumns == data.ncol, U"The number of columns should be equal.");
+	Melder_require (my numberOfRows == data.nrow, U"The number of rows should be equal.");
+	if (NUMfractionOfNonzeros (data) < 0.1) {
+		SparseNonnegativeMatrix sparse;
+		SparseNonnegativeMatrix_initFromMatrix (& sparse, data);
+		improveFactorization_als (me, data, & sparse, maximumNumberOfIterations, changeTolerance, approximationTolerance, info);
+	} else
+		improveFactorization_als (me, data, nullptr, maximumNumberOfIterations, changeTolerance, approximationTolerance, info);
+}
+
+void NMF_improveFactorization_als_sparse (NMF me, SparseNonnegativeMatrix *data, integer maximumNumberOfIterations, double changeTolerance, double approximationTolerance, bool info) {
+	Melder_require (my numberOfColumns == data -> numberOfColumns, U"The number of columns should be equal.");
+	Melder_require (my numberOfRows == data -> numberOfRows, U"The number of rows should be equal.");
+	improveFactorization_als (me, constMATVU (), data, maximumNumberOfIterations, changeTolerance, approximationTolerance, info);
+}
+
 static void VECinvertAndScale (VECVU const& target, constVECVU const& source, double scaleFactor) {
 	Melder_assert (target.size == source.size);
 	for (integer i = 1; i <= target.size; i ++)
 		target [i] = scaleFactor / source [i];
 }
 
+/*
+	As MATgetDivergence_ItakuraSaito, computed by row on several threads.
+*/
+static double getDivergence_ItakuraSaito (constMATVU const& ref, constMATVU const& x, VEC const& rowDivergence) {
+	const integer numberOfThreads = MelderThread_getNumberOfThreads (ref.nrow, 30.0 * ref.nrow * ref.ncol);
+	MelderThread_runStretches (numberOfThreads, ref.nrow, [&] (integer /* ithread */, integer firstRow, integer lastRow) {
+		for (integer irow = firstRow; irow <= lastRow; irow ++) {
+			double sum = 0.0;
+			for (integer icol = 1; icol <= ref.ncol; icol ++) {
+				const double refval = ref [irow] [icol];
+				if (refval == 0.0) {
+					sum = undefined;
+					break;
+				}
+				sum += x [irow] [icol] / refval - log (x [irow] [icol] / refval) - 1.0;
+			}
+			rowDivergence [irow] = sum;
+		}
+	});
+	double divergence = 0.0;
+	for (integer irow = 1; irow <= ref.nrow; irow ++)
+		divergence += rowDivergence [irow];   // undefined if any of them is
+	return divergence;
+}
+
 void NMF_improveFactorization_is (NMF me, constMATVU const& data, integer maximumNumberOfIterations, double changeTolerance, double approximationTolerance, bool info) {
 	try {
 		Melder_require (my numberOfColumns == data.ncol, U"The number of columns should be equal.");
@@ -411,14 +644,18 @@ void NMF_improveFactorization_is (NMF me, constMATVU const& data, integer maximu
 			U"The data matrix should not have cells that are zero.");
 		autoMAT vk = newMATraw (data.nrow, data.ncol);
 		autoMAT fw = newMATraw (data.nrow, data.ncol);
-		autoMAT fcol_x_wrow = newMATraw (data.nrow, data.ncol);
 		autoVEC fcolumn_inv = newVECraw (data.nrow); // feature column
 		autoVEC wrow_inv = newVECraw (data.ncol); // weight row
-		MATmul (fw.get(), my features.get(), my weights.get());
-		double divergence = MATgetDivergence_ItakuraSaito (data, fw.get());
+		autoVEC fcolumn_old = newVECraw (data.nrow), wrow_old = newVECraw (data.ncol);
+		autoVEC rowDivergence = newVECraw (data.nrow);
+		MATmul_fast (fw.get(), my features.get(), my weights.get());
+		double divergence = getDivergence_ItakuraSaito (data, fw.get(), rowDivergence.get());
 		const double divergence0 = divergence;
 		if (info)
 			MelderInfo_writeLine (U"Iteration: 0", U" divergence: ", divergence, U" delta: ", divergence);
+		const double numberOfOperationsPerPass = 5.0 * data.nrow * data.ncol;
+		const integer numberOfRowThreads = MelderThread_getNumberOfThreads (data.nrow, numberOfOperationsPerPass);
+		const integer numberOfColumnThreads = MelderThread_getNumberOfThreads (data.ncol, numberOfOperationsPerPass);
 		integer iter = 1;
 		bool convergence = false;
 		while (iter <= maximumNumberOfIterations && not convergence) {
@@ -436,33 +673,51 @@ void NMF_improveFactorization_is (NMF me, constMATVU const& data, integer maximu
 						F.H - old(fcol(k) x wrow(k)) + new(fcol(k) x wrow(k))    (6)
 					}
 				}
-				There is no need to calculate G(k) explicitly as in (1).
-				We can calculate the elements of G(k) while we are doing (2).
+				There is no need to calculate G(k) or the outer products explicitly:
+				we can calculate their elements while we are doing (2) and (6).
+				All steps except (5) are divided over threads by row or by column.
 			*/
 			for (integer kf = 1; kf <= my numberOfFeatures; kf ++) {
+				fcolumn_old.all() <<= my features.column (kf);
+				wrow_old.all() <<= my weights.row (kf);
 				// (1) and (2)
-				MATouter (fcol_x_wrow.get(), my features.column (kf), my weights.row (kf));
-				for (integer irow = 1; irow <= data.nrow; irow ++)
-					for (integer icol = 1; icol <= data.ncol; icol ++) {
-						double gk = fcol_x_wrow [irow] [icol] / fw [irow] [icol];
-						vk [irow] [icol] = gk * gk * data [irow] [icol] + (1.0 - gk) * fcol_x_wrow [irow] [icol];
-					}
+				MelderThread_runStretches (numberOfRowThreads, data.nrow, [&] (integer /* ithread */, integer firstRow, integer lastRow) {
+					for (integer irow = firstRow; irow <= lastRow; irow ++)
+						for (integer icol = 1; icol <= data.ncol; icol ++) {
+							const double fcol_x_wrow = fcolumn_old [irow] * wrow_old [icol];
+							const double gk = fcol_x_wrow / fw [irow] [icol];
+							vk [irow] [icol] = gk * gk * data [irow] [icol] + (1.0 - gk) * fcol_x_wrow;
+						}
+				});
 				// (3)
-				VECinvertAndScale (fcolumn_inv.get(), my features.column (kf), 1.0 / my numberOfRows);	
-				VECmul (my weights.row (kf), fcolumn_inv.get(), vk.get());
+				VECinvertAndScale (fcolumn_inv.get(), fcolumn_old.get(), 1.0 / my numberOfRows);
+				MelderThread_runStretches (numberOfColumnThreads, data.ncol, [&] (integer /* ithread */, integer firstColumn, integer lastColumn) {
+					for (integer icol = firstColumn; icol <= lastColumn; icol ++)
+						my weights [kf] [icol] = 0.0;
+					for (integer irow = 1; irow <= data.nrow; irow ++)
+						for (integer icol = firstColumn; icol <= lastColumn; icol ++)
+							my weights [kf] [icol] += fcolumn_inv [irow] * vk [irow] [icol];
+				});
 				// (4)
 				VECinvertAndScale (wrow_inv.get(), my weights.row (kf), 1.0 / my numberOfColumns);
-				VECmul (my features.column (kf), vk.get(), wrow_inv.get());
+				MelderThread_runStretches (numberOfRowThreads, data.nrow, [&] (integer /* ithread */, integer firstRow, integer lastRow) {
+					for (integer irow = firstRow; irow <= lastRow; irow ++)
+						my features [irow] [kf] = NUMinner (vk.row (irow), wrow_inv.get());
+				});
 				// (5)
 				double fcolumn_norm = NUMnorm (my features.column (kf), 2.0);
 				my features.column (kf)  /=  fcolumn_norm;
 				my weights.row (kf)  *=  fcolumn_norm;
 				// (6)
-				fw.get()  -=  fcol_x_wrow.get();
-				MATouter (fcol_x_wrow.get(), my features.column (kf), my weights.row (kf));
-				fw.get()  +=  fcol_x_wrow.get();
+				MelderThread_runStretches (numberOfRowThreads, data.nrow, [&] (integer /* ithread */, integer firstRow, integer lastRow) {
+					for (integer irow = firstRow; irow <= lastRow; irow ++) {
+						const double fnew = my features [irow] [kf], fold = fcolumn_old [irow];
+						for (integer icol = 1; icol <= data.ncol; icol ++)
+							fw [irow] [icol] += fnew * my weights [kf] [icol] - fold * wrow_old [icol];
+					}
+				});
 			}
-			const double divergence_update = MATgetDivergence_ItakuraSaito (data, fw.get());
+			const double divergence_update = getDivergence_ItakuraSaito (data, fw.get(), rowDivergence.get());
 			const double delta = divergence - divergence_update;
 			convergence = ( iter > 1 && (fabs (delta) < changeTolerance || divergence_update < divergence0 * approximationTolerance) );
 			if (info)
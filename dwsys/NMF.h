@@ -38,6 +38,27 @@ autoNMF NMF_create (integer numberOfRows, integer numberOfColumns, integer numbe
 
 autoNMF NMF_createFromGeneralMatrix (constMATVU const& data, integer numberOfFeatures);
 
+/*
+	A non-negative data matrix of which most cells are zero, stored both by rows and by columns:
+	the non-zero cells of row i are at the positions rowStart [i] .. rowStart [i + 1] - 1 of rowColumn and rowValue,
+	those of column j at the positions columnStart [j] .. columnStart [j + 1] - 1 of columnRow and columnValue.
+*/
+struct SparseNonnegativeMatrix {
+	integer numberOfRows = 0, numberOfColumns = 0;
+	autoINTVEC rowStart, rowColumn, columnStart, columnRow;
+	autoVEC rowValue, columnValue;
+};
+
+void SparseNonnegativeMatrix_init (SparseNonnegativeMatrix *me, integer numberOfRows, integer numberOfColumns,
+	constINTVEC const& rows, constINTVEC const& columns, constVEC const& values);
+/*
+	The cells (rows [k], columns [k]) get the values [k]; values for the same cell are added, zeros are left out.
+*/
+
+void SparseNonnegativeMatrix_initFromMatrix (SparseNonnegativeMatrix *me, constMATVU const& data);
+
+double NUMfractionOfNonzeros (constMATVU const& data);
+
 void NMF_initializeFactorization (NMF me, constMATVU const& data, kNMF_Initialization initializationMethod);
 
 /*
@@ -51,6 +72,14 @@ void NMF_initializeFactorization (NMF me, constMATVU const& data, kNMF_Initializ
 */
 void NMF_improveFactorization_mu (NMF me, constMATVU const& data, integer maximumNumberOfIterations, double changeTolerance, double approximationTolerance, bool info);
 
+/*
+	As NMF_improveFactorization_mu and NMF_improveFactorization_als, for data that are mostly zero.
+	The data enter only in D*W' and F'*D, which take a time proportional to the number of non-zero cells.
+	The dense versions switch to these if less than a tenth of the cells are non-zero.
+*/
+void NMF_improveFactorization_mu_sparse (NMF me, SparseNonnegativeMatrix *data, integer maximumNumberOfIterations, double changeTolerance, double approximationTolerance, bool info);
+void NMF_improveFactorization_als_sparse (NMF me, SparseNonnegativeMatrix *data, integer maximumNumberOfIterations, double changeTolerance, double approximationTolerance, bool info);
+
 /*
 	Factorize D as F*W, where D, F and W >= 0
 	
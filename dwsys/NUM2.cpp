@@ -203,10 +203,9 @@ double NUMmultivariateKurtosis (constMATVU const& m, int method) {
 	Kruskal's algorithm for monotone regression (and much simpler).
 	Regression is ascending
 */
-autoVEC newVECmonotoneRegression (constVEC x) {
-	autoVEC fit = newVECcopy (x);
+void VECmonotoneRegression_inplace (VEC const& fit) {
 	double xt = undefined;   // only to stop gcc from complaining "may be used uninitialized"
-	for (integer i = 2; i <= x.size; i ++) {
+	for (integer i = 2; i <= fit.size; i ++) {
 		if (fit [i] >= fit [i - 1])
 			continue;
 		longdouble sum = fit [i];
@@ -221,6 +220,11 @@ autoVEC newVECmonotoneRegression (constVEC x) {
 		for (integer j = i - nt + 1; j <= i; j ++)
 			fit [j] = xt;
 	}
+}
+
+autoVEC newVECmonotoneRegression (constVEC x) {
+	autoVEC fit = newVECcopy (x);
+	VECmonotoneRegression_inplace (fit.get());
 	return fit;
 }
 
@@ -234,9 +238,9 @@ double NUMdeterminant_fromSymmetricMatrix (constMAT m) {
 	*/
 	char uplo = 'U';
 	integer lda = m.nrow, info;
-	NUMlapack_dpotf2 (& uplo, & a.nrow, & a [1] [1], & lda, & info);
+	NUMlapack_dpotrf (& uplo, & a.nrow, & a [1] [1], & lda, & info);
 	Melder_require (info == 0,
-		U"dpotf2 cannot determine Cholesky decomposition.");
+		U"dpotrf cannot determine Cholesky decomposition.");
 	longdouble lnd = 0.0;
 	for (integer i = 1; i <= a.nrow; i ++)
 		lnd += log (a [i] [i]);
@@ -252,9 +256,9 @@ void MATlowerCholeskyInverse_inplace (MAT a, double *out_lnd) {
 		Cholesky decomposition in lower, leave upper intact
 		Fortran storage -> use uplo='U' to get 'L'.
 	*/
-	(void) NUMlapack_dpotf2 (& uplo, & a.nrow, & a [1] [1], & a.nrow, & info);
+	(void) NUMlapack_dpotrf (& uplo, & a.nrow, & a [1] [1], & a.nrow, & info);
 	Melder_require (info == 0,
-		U"dpotf2 fails with code ", info, U".");
+		U"dpotrf fails with code ", info, U".");
 	/*
 		Determinant from diagonal, diagonal is now sqrt (a [i] [i]) !
 	*/
@@ -461,9 +465,9 @@ void NUMsolveConstrainedLSQuadraticRegression (constMAT const& x, constVEC const
 	*/
 	char uplo = 'U';
 	integer info;
-	(void) NUMlapack_dpotf2 (& uplo, & n3, & ftinv [1] [1], & n3, & info);
+	(void) NUMlapack_dpotrf (& uplo, & n3, & ftinv [1] [1], & n3, & info);
 	Melder_require (info == 0,
-		U"dpotf2 fails.");
+		U"dpotrf fails.");
 	
 	ftinv [1] [2] = ftinv [1] [3] = ftinv [2] [3] = 0.0;
 	/*
@@ -304,6 +304,7 @@ void NUMstatistics_huber (constVEC x, double *inout_location, bool wantlocation,
 */
 
 autoVEC newVECmonotoneRegression (constVEC x);
+void VECmonotoneRegression_inplace (VEC const& x);
 /*
 	Find numbers xs[1..n] that have a monotone relationship with
 	the numbers in x[1..n].
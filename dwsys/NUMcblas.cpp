@@ -21,6 +21,9 @@
 #include "NUMcblas.h"
 #include "NUMf2c.h"
 #include "NUM2.h"
+#ifdef EXTERNAL_LAPACK
+	#include "NUMclapack.h"
+#endif
 
 #define MAX(m,n) ((m) > (n) ? (m) : (n))
 #define MIN(m,n) ((m) < (n) ? (m) : (n))
@@ -226,6 +229,42 @@ L60:
 	return ret_val;
 }								/* NUMblas_ddot */
 
+/*
+	Large matrix products are handed to the cache-blocked multiplication in MAT.cpp,
+	which is many times faster than the column-oriented loops below;
+	the blocked LAPACK routines (dgebrd, dsytrd, dorgqr, dpotrf...) spend most of their time here.
+	With EXTERNAL_LAPACK, they go to the external dgemm instead.
+	A column-major matrix A with leading dimension lda is a matrix view with
+	row stride 1 and column stride lda; its transpose has row stride lda and column stride 1.
+	C is never an alias of A or B in LAPACK.
+*/
+static bool dgemm_isLarge (integer m, integer n, integer k) {
+	return double (m) * double (n) * double (k) >= 1e5;
+}
+
+static void dgemm_blocked (bool nota, bool notb, integer m, integer n, integer k, double alpha,
+	const double *a, integer lda, const double *b, integer ldb, double beta, double *c, integer ldc)
+{
+	#ifdef EXTERNAL_LAPACK
+		const int fm = NUMlapack_fortranInteger (m), fn = NUMlapack_fortranInteger (n), fk = NUMlapack_fortranInteger (k);
+		const int flda = NUMlapack_fortranInteger (lda), fldb = NUMlapack_fortranInteger (ldb), fldc = NUMlapack_fortranInteger (ldc);
+		dgemm_ (nota ? "N" : "T", notb ? "N" : "T", & fm, & fn, & fk, & alpha, a, & flda, b, & fldb, & beta, c, & fldc, 1, 1);
+		return;
+	#endif
+	const constMATVU opa = ( nota ? constMATVU (a, m, k, 1, lda) : constMATVU (a, m, k, lda, 1) );
+	const constMATVU opb = ( notb ? constMATVU (b, k, n, 1, ldb) : constMATVU (b, k, n, ldb, 1) );
+	const MATVU cview (c, m, n, 1, ldc);
+	if (alpha == 1.0 && beta == 0.0) {
+		MATmul_fast_ (cview, opa, opb);
+		return;
+	}
+	autoMAT product = newMATraw (m, n);
+	MATmul_fast_ (product.get(), opa, opb);
+	for (integer i = 1; i <= m; i ++)
+		for (integer j = 1; j <= n; j ++)
+			cview [i] [j] = ( beta == 0.0 ? alpha * product [i] [j] : alpha * product [i] [j] + beta * cview [i] [j] );
+}
+
 int NUMblas_dgemm (const char *transa, const char *transb, integer *m, integer *n, integer *k, double *alpha, double *a, integer *lda,
                    double *b, integer *ldb, double *beta, double *c__, integer *ldc) {
 	/* System generated locals */
@@ -321,6 +360,10 @@ int NUMblas_dgemm (const char *transa, const char *transb, integer *m, integer *
 		}
 		return 0;
 	}
+	if (dgemm_isLarge (*m, *n, *k)) {
+		dgemm_blocked (nota, notb, *m, *n, *k, *alpha, & a_ref (1, 1), *lda, & b_ref (1, 1), *ldb, *beta, & c___ref (1, 1), *ldc);
+		return 0;
+	}
 	/* Start the operations. */
 	if (notb) {
 		if (nota) {
@@ -2034,6 +2077,26 @@ int NUMblas_dsyr2k (const char *uplo, const char *trans, integer *n, integer *k,
 		}
 		return 0;
 	}
+	if (dgemm_isLarge (*n, *n, *k)) {
+		/*
+			One blocked product P = op(A).op(B)', of which B.A' (or B'.A) is the transpose,
+			costs as many operations as the triangle loops below.
+		*/
+		const bool notrans = lsame_ (trans, "N");
+		const double *a1 = & a_ref (1, 1), *b1 = & b_ref (1, 1);
+		const constMATVU opa = ( notrans ? constMATVU (a1, *n, *k, 1, *lda) : constMATVU (a1, *n, *k, *lda, 1) );
+		const constMATVU opbt = ( notrans ? constMATVU (b1, *k, *n, *ldb, 1) : constMATVU (b1, *k, *n, 1, *ldb) );
+		autoMAT product = newMATraw (*n, *n);
+		MATmul_fast_ (product.get(), opa, opbt);
+		for (j = 1; j <= *n; ++ j) {
+			const integer ifrom = ( upper ? 1 : j ), ito = ( upper ? j : *n );
+			for (i__ = ifrom; i__ <= ito; ++ i__) {
+				const double update = *alpha * (product [i__] [j] + product [j] [i__]);
+				c___ref (i__, j) = ( *beta == 0. ? update : update + *beta * c___ref (i__, j) );
+			}
+		}
+		return 0;
+	}
 	/* Start the operations. */
 	if (lsame_ (trans, "N")) {
 		/* Form C := alpha*A*B' + alpha*B*A' + C. */
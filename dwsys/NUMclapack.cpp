@@ -13819,36 +13819,24 @@ int NUMlapack_dlasr (const char *side, const char *pivot, const char *direct, in
 		/* Form P * A */
 
 		if (lsame_ (pivot, "V")) {
-			if (lsame_ (direct, "F")) {
-				i__1 = *m - 1;
-				for (j = 1; j <= i__1; ++j) {
-					ctemp = c__[j];
-					stemp = s[j];
-					if (ctemp != 1. || stemp != 0.) {
-						i__2 = *n;
-						for (i__ = 1; i__ <= i__2; ++i__) {
-							temp = a_ref (j + 1, i__);
-							a_ref (j + 1, i__) = ctemp * temp - stemp * a_ref (j, i__);
-							a_ref (j, i__) = stemp * temp + ctemp * a_ref (j, i__);
-							/* L10: */
+			/*
+				The rotations act on each column of A independently, so we apply all of them
+				to a few columns at a time, which then stay in the cache;
+				the order of the operations on each element is unchanged.
+			*/
+			const bool forward = lsame_ (direct, "F");
+			for (integer ifirst = 1; ifirst <= *n; ifirst += 16) {
+				const integer ilast = MIN (ifirst + 15, *n);
+				for (integer jj = 1; jj <= *m - 1; jj ++) {
+					const integer jrot = ( forward ? jj : *m - jj );
+					const double cj = c__[jrot], sj = s[jrot];
+					if (cj != 1. || sj != 0.) {
+						for (integer icol = ifirst; icol <= ilast; icol ++) {
+							const double t = a_ref (jrot + 1, icol);
+							a_ref (jrot + 1, icol) = cj * t - sj * a_ref (jrot, icol);
+							a_ref (jrot, icol) = sj * t + cj * a_ref (jrot, icol);
 						}
 					}
-					/* L20: */
-				}
-			} else if (lsame_ (direct, "B")) {
-				for (j = *m - 1; j >= 1; --j) {
-					ctemp = c__[j];
-					stemp = s[j];
-					if (ctemp != 1. || stemp != 0.) {
-						i__1 = *n;
-						for (i__ = 1; i__ <= i__1; ++i__) {
-							temp = a_ref (j + 1, i__);
-							a_ref (j + 1, i__) = ctemp * temp - stemp * a_ref (j, i__);
-							a_ref (j, i__) = stemp * temp + ctemp * a_ref (j, i__);
-							/* L30: */
-						}
-					}
-					/* L40: */
 				}
 			}
 		} else if (lsame_ (pivot, "T")) {
@@ -16841,6 +16829,86 @@ L40:
 	return 0;
 }				/* NUMlapack_dpotf2_ */
 
+int NUMlapack_dpotrf (const char *uplo, integer *n, double *a, integer *lda, integer *info) {
+	static double c_one = 1.0, c_zero = 0.0, c_minusOne = -1.0;
+
+	*info = 0;
+	const bool upper = lsame_ (uplo, "U");
+	if (! upper && ! lsame_ (uplo, "L")) {
+		*info = -1;
+	} else if (*n < 0) {
+		*info = -2;
+	} else if (*lda < MAX (1, *n)) {
+		*info = -4;
+	}
+	if (*info != 0) {
+		integer i__1 = - (*info);
+		xerbla_ ("DPOTRF", &i__1);
+		return 0;
+	}
+	if (*n == 0)
+		return 0;
+	#ifdef EXTERNAL_LAPACK
+	{
+		const int fn = NUMlapack_fortranInteger (*n), flda = NUMlapack_fortranInteger (*lda);
+		int finfo = 0;
+		dpotrf_ (uplo, & fn, a, & flda, & finfo, 1);
+		*info = finfo;
+		return 0;
+	}
+	#endif
+
+	integer nb = NUMlapack_ilaenv (&c__1, "DPOTRF", uplo, n, &c_n1, &c_n1, &c_n1, 6, 1);
+	if (nb <= 1 || nb >= *n)
+		return NUMlapack_dpotf2 (uplo, n, a, lda, info);
+
+	#define A(i,j)  a [((j) - 1) * *lda + (i) - 1]
+	autoVEC work = newVECraw (nb * nb);   // the update of one diagonal block
+	for (integer j = 1; j <= *n; j += nb) {
+		integer jb = MIN (nb, *n - j + 1), jm1 = j - 1;
+		/*
+			Update the diagonal block with the part of the factor computed so far,
+			touching only the triangle that is referenced, then factor the block.
+		*/
+		if (jm1 > 0) {
+			double *w = work.begin();
+			if (upper) {
+				NUMblas_dgemm ("T", "N", &jb, &jb, &jm1, &c_one, &A (1, j), lda, &A (1, j), lda, &c_zero, w, &jb);
+				for (integer icol = 1; icol <= jb; icol ++)
+					for (integer irow = 1; irow <= icol; irow ++)
+						A (j + irow - 1, j + icol - 1) -= w [(icol - 1) * jb + irow - 1];
+			} else {
+				NUMblas_dgemm ("N", "T", &jb, &jb, &jm1, &c_one, &A (j, 1), lda, &A (j, 1), lda, &c_zero, w, &jb);
+				for (integer icol = 1; icol <= jb; icol ++)
+					for (integer irow = icol; irow <= jb; irow ++)
+						A (j + irow - 1, j + icol - 1) -= w [(icol - 1) * jb + irow - 1];
+			}
+		}
+		NUMlapack_dpotf2 (uplo, &jb, &A (j, j), lda, info);
+		if (*info != 0) {
+			*info += jm1;
+			return 0;
+		}
+		/*
+			Compute the current block row (or column) of the factor.
+		*/
+		if (j + jb <= *n) {
+			integer rest = *n - j - jb + 1;
+			if (upper) {
+				if (jm1 > 0)
+					NUMblas_dgemm ("T", "N", &jb, &rest, &jm1, &c_minusOne, &A (1, j), lda, &A (1, j + jb), lda, &c_one, &A (j, j + jb), lda);
+				NUMblas_dtrsm ("L", "U", "T", "N", &jb, &rest, &c_one, &A (j, j), lda, &A (j, j + jb), lda);
+			} else {
+				if (jm1 > 0)
+					NUMblas_dgemm ("N", "T", &rest, &jb, &jm1, &c_minusOne, &A (j + jb, 1), lda, &A (j, 1), lda, &c_one, &A (j + jb, j), lda);
+				NUMblas_dtrsm ("R", "L", "T", "N", &rest, &jb, &c_one, &A (j, j), lda, &A (j + jb, j), lda);
+			}
+		}
+	}
+	#undef A
+	return 0;
+}								/* NUMlapack_dpotrf */
+
 int NUMlapack_drscl (integer *n, double *sa, double *sx, integer *incx) {
 	static double cden;
 	static integer done;
@@ -5569,6 +5569,17 @@ int NUMlapack_dpotf2 (const char *uplo, integer *n, double *a, integer *lda, int
 
 */
 
+int NUMlapack_dpotrf (const char *uplo, integer *n, double *a, integer *lda, integer *info);
+/*
+    NUMlapack_dpotrf computes the Cholesky factorization of a real symmetric
+    positive definite matrix A, with the same arguments and results as NUMlapack_dpotf2.
+
+    This is the blocked version of the algorithm: blocks of the factor are computed
+    with matrix-matrix products (NUMblas_dgemm) and triangular solves (NUMblas_dtrsm),
+    and only the diagonal blocks are factored by NUMlapack_dpotf2.
+    The triangle of A that is not referenced is left intact.
+*/
+
 int NUMlapack_drscl (integer *n, double *sa, double *sx,	integer *incx);
 /*  Purpose
     =======
@@ -6610,4 +6621,30 @@ integer NUMlapack_ilaenv (integer *ispec, const char *name, const char *opts, in
     =====================================================================
 */
 
+#ifdef EXTERNAL_LAPACK
+/*
+	Compiling with -DEXTERNAL_LAPACK in COMMONFLAGS and linking with an optimized BLAS and LAPACK
+	(e.g. LIBS += -llapack -lblas -lgfortran, or -lopenblas) makes large matrix products (NUMblas_dgemm),
+	Cholesky factorizations (NUMlapack_dpotrf), SVD_compute and the symmetric eigensystem
+	use the external library, the latter two with the divide-and-conquer routines dgesdd and dsyevd.
+	The external routines take Fortran integers (32 bits) and trailing string lengths.
+*/
+extern "C" {
+	void dgemm_ (const char *transa, const char *transb, const int *m, const int *n, const int *k,
+		const double *alpha, const double *a, const int *lda, const double *b, const int *ldb,
+		const double *beta, double *c, const int *ldc, size_t transa_len, size_t transb_len);
+	void dpotrf_ (const char *uplo, const int *n, double *a, const int *lda, int *info, size_t uplo_len);
+	void dsyevd_ (const char *jobz, const char *uplo, const int *n, double *a, const int *lda, double *w,
+		double *work, const int *lwork, int *iwork, const int *liwork, int *info, size_t jobz_len, size_t uplo_len);
+	void dgesdd_ (const char *jobz, const int *m, const int *n, double *a, const int *lda, double *s,
+		double *u, const int *ldu, double *vt, const int *ldvt, double *work, const int *lwork, int *iwork,
+		int *info, size_t jobz_len);
+}
+inline int NUMlapack_fortranInteger (integer value) {
+	Melder_require (value >= std::numeric_limits <int>::min() && value <= std::numeric_limits <int>::max(),
+		U"Matrix dimension ", value, U" too large for the external LAPACK.");
+	return (int) value;
+}
+#endif
+
 #endif /* _NUMclapack_h_ */
@@ -142,6 +142,29 @@ double SVD_getTolerance (SVD me) {
 */
 void SVD_compute (SVD me) {
 	try {
+		#ifdef EXTERNAL_LAPACK
+		{
+			/*
+				Divide and conquer, on the same transposed problem as below.
+				The rows of V' cannot overwrite A (dgesdd does that only if m < n),
+				so they are computed into a separate matrix with the layout of u.
+			*/
+			const int m = NUMlapack_fortranInteger (my numberOfColumns), n = NUMlapack_fortranInteger (my numberOfRows);
+			int lwork = -1, info = 0;
+			double wt [1];
+			autoMAT vt = newMATraw (my u.nrow, my u.ncol);
+			std::vector <int> iwork (8 * std::min (m, n));
+			dgesdd_ ("S", & m, & n, & my u [1] [1], & m, my d.begin(), & my v [1] [1], & m, & vt [1] [1], & m, wt, & lwork, iwork.data(), & info, 1);
+			Melder_require (info == 0, U"SVD could not be precomputed.");
+			lwork = NUMlapack_fortranInteger (Melder_iceiling (wt [0]));
+			autoVEC work = newVECraw (lwork);
+			dgesdd_ ("S", & m, & n, & my u [1] [1], & m, my d.begin(), & my v [1] [1], & m, & vt [1] [1], & m, work.begin(), & lwork, iwork.data(), & info, 1);
+			Melder_require (info == 0, U"SVD could not be computed.");
+			my u.all() <<= vt.all();
+			MATtranspose_inplace_mustBeSquare (my v.get());
+			return;
+		}
+		#endif
 		char jobu = 'S'; // the first min(m,n) columns of U are returned in the array U;
 		char jobvt = 'O'; // the first min(m,n) rows of V**T are overwritten on the array A;
 		integer m = my numberOfColumns; // number of rows of input matrix 
@@ -23,6 +23,8 @@
 
 #include "Distance.h"
 #include "TableOfReal_extensions.h"
+#include "MelderThread.h"
+#include <functional>
 
 Thing_implement (Distance, Proximity, 0);
 
@@ -42,37 +44,168 @@ double Distance_getMaximumDistance (Distance me) {
 	return NUMmax (my data.get());
 }
 
-static void VECpow (VECVU const& v, double power) {
-	for (integer i = 1; i <= v.size; i++)
-		v [i] = pow (v [i], power);
+/*
+	The distance between rows i and j of x, scaled by the largest coordinate difference
+	to prevent overflow and underflow in the powers.
+*/
+static double scaledMinkowskiDistance (constVEC const& xi, constVEC const& xj, integer metric, constVEC const& weights) {
+	double dmax = 0.0;
+	for (integer k = 1; k <= xi.size; k ++)
+		dmax = std::max (dmax, fabs (xi [k] - xj [k]));
+	if (dmax == 0.0)
+		return 0.0;
+	double sum = 0.0;
+	for (integer k = 1; k <= xi.size; k ++)
+		sum += weights [k] * pow (fabs (xi [k] - xj [k]) / dmax, metric);
+	return dmax * pow (sum, 1.0 / metric);   // scale back
+}
+
+void VECminkowskiDistancesOfRow (VEC const& target, constMAT const& x, integer irow, integer metric, constVEC const& weights) noexcept {
+	Melder_assert (target.size == x.nrow - irow);
+	Melder_assert (weights.size == x.ncol);
+	const constVEC xi = x.row (irow);
+	for (integer j = irow + 1; j <= x.nrow; j ++) {
+		const constVEC xj = x.row (j);
+		double d;
+		if (metric == 1) {
+			double sum = 0.0;
+			for (integer k = 1; k <= x.ncol; k ++)
+				sum += weights [k] * fabs (xi [k] - xj [k]);
+			d = ( isfinite (sum) ? sum : scaledMinkowskiDistance (xi, xj, metric, weights) );
+		} else if (metric == 2) {
+			double sum = 0.0;
+			for (integer k = 1; k <= x.ncol; k ++) {
+				const double difference = xi [k] - xj [k];
+				sum += weights [k] * difference * difference;
+			}
+			/*
+				Only squares that overflow or underflow need the slow scaled computation.
+			*/
+			d = ( isfinite (sum) && sum > 1e-280 ? sqrt (sum) : scaledMinkowskiDistance (xi, xj, metric, weights) );
+		} else
+			d = scaledMinkowskiDistance (xi, xj, metric, weights);
+		target [j - irow] = d;
+	}
+}
+
+/*
+	Rows in the order 1, n, 2, n-1, ..., so that equal stretches of items contain about equal numbers of pairs.
+*/
+static integer balancedRow (integer item, integer numberOfRows) {
+	return ( item % 2 == 1 ? (item + 1) / 2 : numberOfRows + 1 - item / 2 );
+}
+
+/*
+	Euclidean distances with many dimensions as |x_i|^2 + |x_j|^2 - 2 x_i.x_j, with the inner products
+	computed by blocks of rows with the fast matrix multiplication. After centring, cancellation can only be
+	serious for distances that are small with respect to the norms; those are computed directly.
+	Returns false if the coordinates are too large for squaring.
+*/
+static bool getEuclideanDistancesByInnerProducts (constMAT const& x, constVEC const& weights, std::function <VEC (integer)> const& targetOfRow) {
+	const integer numberOfPoints = x.nrow, numberOfDimensions = x.ncol;
+	autoMAT y = newMATcopy (x);
+	MATcentreEachColumn_inplace (y.get());
+	for (integer k = 1; k <= numberOfDimensions; k ++)
+		y.column (k)  *=  sqrt (weights [k]);
+	autoVEC squaredNorms = newVECraw (numberOfPoints);
+	for (integer i = 1; i <= numberOfPoints; i ++) {
+		squaredNorms [i] = NUMsum2 (y.row (i));
+		if (! isfinite (squaredNorms [i]) || squaredNorms [i] > 1e300)
+			return false;
+	}
+	constexpr integer blockSize = 128;
+	autoMAT innerProducts = newMATraw (blockSize, numberOfPoints);
+	for (integer firstRow = 1; firstRow < numberOfPoints; firstRow += blockSize) {
+		const integer lastRow = std::min (firstRow + blockSize - 1, numberOfPoints - 1);
+		const integer blockRows = lastRow - firstRow + 1;
+		/*
+			Only the columns to the right of the first row of the block are needed.
+		*/
+		MATVU const block = innerProducts.part (1, blockRows, 1, numberOfPoints - firstRow);
+		MATmul_fast (block, y.horizontalBand (firstRow, lastRow), y.horizontalBand (firstRow + 1, numberOfPoints).transpose ());
+		for (integer i = firstRow; i <= lastRow; i ++) {
+			VEC const target = targetOfRow (i);
+			for (integer j = i + 1; j <= numberOfPoints; j ++) {
+				const double sumOfNorms = squaredNorms [i] + squaredNorms [j];
+				double dsq = sumOfNorms - 2.0 * block [i - firstRow + 1] [j - firstRow];
+				if (dsq <= 1e-4 * sumOfNorms) {
+					dsq = 0.0;
+					for (integer k = 1; k <= numberOfDimensions; k ++) {
+						const double difference = x [i] [k] - x [j] [k];   // not y, which has the rounding errors of the centring
+						dsq += weights [k] * difference * difference;
+					}
+				}
+				target [j - i] = sqrt (std::max (dsq, 0.0));
+			}
+		}
+	}
+	return true;
+}
+
+/*
+	The distances between row i and the later rows go to targetOfRow (i),
+	which is called from several threads at the same time, but for different rows.
+*/
+static void getMinkowskiDistances (constMAT const& x, integer metric, constVEC const& weights, std::function <VEC (integer)> const& targetOfRow) {
+	const integer numberOfPoints = x.nrow, numberOfDimensions = x.ncol;
+	if (numberOfPoints < 2)
+		return;
+	bool hasNegativeWeights = false;
+	for (integer k = 1; k <= numberOfDimensions; k ++)
+		if (weights [k] < 0.0)
+			hasNegativeWeights = true;
+	if (metric == 2 && numberOfDimensions >= 16 && ! hasNegativeWeights &&
+		getEuclideanDistancesByInnerProducts (x, weights, targetOfRow))
+	{
+		return;
+	}
+	const double numberOfOperations = 0.5 * numberOfPoints * (numberOfPoints - 1) * numberOfDimensions * ( metric <= 2 ? 3.0 : 30.0 );
+	MelderThread_runStretches (MelderThread_getNumberOfThreads (numberOfPoints, numberOfOperations), numberOfPoints,
+		[&] (integer /* ithread */, integer firstItem, integer lastItem) {
+			for (integer item = firstItem; item <= lastItem; item ++) {
+				const integer i = balancedRow (item, numberOfPoints);
+				if (i < numberOfPoints)
+					VECminkowskiDistancesOfRow (targetOfRow (i), x, i, metric, weights);
+			}
+		}
+	);
 }
 
 autoDistance Configuration_to_Distance (Configuration me) {
 	try {
 		autoDistance thee = Distance_create (my numberOfRows);
 		TableOfReal_copyLabels (me, thee.get(), 1, -1);
-		autoVEC dist = newVECraw (my numberOfColumns);
-		for (integer i = 1; i <= thy numberOfRows - 1; i ++) {
-			for (integer j = i + 1; j <= thy numberOfColumns; j ++) {
-				dist <<= my data.row (i)  -  my data.row (j);
-				VECabs_inplace (dist.get());
-				const double dmax = NUMmax (dist.get());
-				double d = 0.0;
-				if (dmax > 0.0) {
-					dist  /=  dmax; // prevent overflow
-					VECpow (dist.get(), my metric);
-					d = NUMinner (my w, dist.get());
-					d = dmax * pow (d, 1.0 / my metric); // scale back
-				}
-				thy data [i] [j] = thy data [j] [i] = d;
-			}
-		}
+		const integer numberOfPoints = my numberOfRows;
+		MAT const distance = thy data.get();
+		getMinkowskiDistances (my data.get(), my metric, my w.get(),
+			[&] (integer irow) -> VEC { return distance.row (irow).part (irow + 1, numberOfPoints); }
+		);
+		for (integer i = 1; i <= numberOfPoints - 1; i ++)
+			for (integer j = i + 1; j <= numberOfPoints; j ++)
+				distance [j] [i] = distance [i] [j];
 		return thee;
 	} catch (MelderError) {
 		Melder_throw (me, U": no Distance created.");
 	}
 }
 
+autoVEC Configuration_listPairwiseDistances (Configuration me) {
+	try {
+		const integer numberOfPoints = my numberOfRows;
+		autoVEC result = newVECraw (numberOfPoints * (numberOfPoints - 1) / 2);
+		VEC const distances = result.get();
+		getMinkowskiDistances (my data.get(), my metric, my w.get(),
+			[&] (integer irow) -> VEC {
+				const integer offset = (irow - 1) * (2 * numberOfPoints - irow) / 2;   // the pairs of the earlier rows
+				return distances.part (offset + 1, offset + numberOfPoints - irow);
+			}
+		);
+		return result;
+	} catch (MelderError) {
+		Melder_throw (me, U": pairwise distances not computed.");
+	}
+}
+
 void Distance_drawDendogram (Distance me, Graphics g, int method) {
 	(void) me;
 	(void) g;
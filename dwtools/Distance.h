@@ -29,6 +29,18 @@ autoDistance Distance_create (integer numberOfPoints);
 
 autoDistance Configuration_to_Distance (Configuration me);
 
+autoVEC Configuration_listPairwiseDistances (Configuration me);
+/*
+	The distances of the pairs (1,2), (1,3), ..., (1,n), (2,3), ..., (n-1,n):
+	the upper triangle of Configuration_to_Distance, in half the memory.
+*/
+
+void VECminkowskiDistancesOfRow (VEC const& target, constMAT const& x, integer irow, integer metric, constVEC const& weights) noexcept;
+/*
+	The weighted Minkowski distances between row irow of x and the rows irow+1 .. x.nrow,
+	as in Configuration_to_Distance. Allocates nothing, so that several threads can do their own rows.
+*/
+
 void Distance_drawDendogram (Distance me, Graphics g, int method);
 
 double Distance_getMaximumDistance (Distance me);
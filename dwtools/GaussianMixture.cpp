@@ -23,7 +23,11 @@
 #include "GaussianMixture.h"
 #include "NUMmachar.h"
 #include "NUM2.h"
+#include "Strings_.h"
 #include "Strings_extensions.h"
+#include "MelderThread.h"
+
+#include <vector>
 
 #include "oo_DESTROY.h"
 #include "GaussianMixture_def.h"
@@ -67,41 +71,18 @@ static integer GaussianMixture_getNumberOfParametersInComponent (GaussianMixture
 	return ( thy numberOfRows == 1 ? 2 * thy numberOfColumns : thy numberOfColumns * (thy numberOfColumns + 3) / 2 );
 }
 
-static double GaussianMixture_getLikelihoodValue (GaussianMixture me, constMAT const& probabilities, kGaussianMixtureCriterion criterion) {
-	Melder_require (probabilities.ncol == my numberOfComponents,
-		U"The number of columns in the probabilities should equal the number of components.");
-	const integer numberOfData = probabilities.nrow;
+/*
+	The criterion from the log-likelihood lnp and the complete-data log-likelihood lnpcd of numberOfData data.
+	Bishop eq. 9.40 (we rewrote ln(a)+ln(b) = ln (a*b)):
+		lnpcd = ln(p(X,Z|μ,S,π)) = sum(n=1...N, sum (k=1...K, gamma [n][k])*ln (π [k]*N(x [n]|μ [k],S [k])),
+	where gamma[n][k] = π [k]*N(x [n]|μ [k],S [k]) / sum(1...K, π [k]*N(x [n]|μ [k],S [k])), and Bishop eq. 9.28:
+		lnp = sum(n=1...N, ln (sum (k=1...K, π [k]*N(x [n]|μ [k],S [k]))))
+*/
+static double GaussianMixture_getCriterionValue (GaussianMixture me, double lnp, double lnpcd, integer numberOfData, kGaussianMixtureCriterion criterion) {
 	Melder_require (numberOfData > my numberOfComponents,
-		U"The number of rows in the probabilities should be larger than the number of components.");
-	if (criterion == kGaussianMixtureCriterion::CompleteDataML) {
-		/*
-			Bishop eq. 9.40 (we rewrote ln(a)+ln(b) = ln (a*b)):
-			ln(p(X,Z|μ,S,π)= sum(n=1...N, sum (k=1...K, gamma [n][k])*ln (π [k]*N(x [n]|μ [k],S [k])),
-			where gamma[n][k] = mixingProbablities[k]*probabilities[n][k]/sum(1...K, mixingProbablities[k]*probabilities[n][k])
-		*/
-		longdouble lnpcd = 0.0;
-		for (integer irow = 1; irow <= numberOfData; irow ++) {
-			longdouble psum = 0.0, lnsum = 0.0;
-			for (integer icol = 1; icol <= my numberOfComponents; icol ++) {
-				const longdouble pp = my mixingProbabilities [icol] * probabilities [irow] [icol];
-				psum += pp;
-				lnsum += pp * log (pp); // scaling outside the loop
-			}
-			if (psum > 0)
-				lnpcd += lnsum / psum; // scaling: as reponsibilities
-		}
+		U"The number of data should be larger than the number of components.");
+	if (criterion == kGaussianMixtureCriterion::CompleteDataML)
 		return lnpcd;
-	}
-	/*
-		The common factor for the following criteria is the log(likelihood), Bishop eq. 9.28
-	*/
-	longdouble lnp = 0.0;
-	for (integer irow = 1; irow <= numberOfData; irow ++) {
-		double psum = NUMinner (my mixingProbabilities.get(), probabilities.row (irow));
-		if (psum > 0.0)
-			lnp += (longdouble) log (psum);
-	}
-
 	if (criterion == kGaussianMixtureCriterion::Likelihood)
 		return lnp;
 
@@ -138,66 +119,340 @@ static double GaussianMixture_getLikelihoodValue (GaussianMixture me, constMAT c
 	return lnp;
 }
 
-static void GaussianMixture_getResponsibilities (GaussianMixture me, constMATVU const& probabilities, integer componentToUpdate, MAT const& responsibilities) {
-	Melder_require (responsibilities.nrow == probabilities.nrow && responsibilities.ncol == probabilities.ncol,
+/*
+	ln (π [k]), undefined for a component with zero mixing probability, which then does not take part.
+*/
+static autoVEC GaussianMixture_getLogMixingProbabilities (GaussianMixture me) {
+	autoVEC logMixingProbabilities = newVECraw (my numberOfComponents);
+	for (integer component = 1; component <= my numberOfComponents; component ++)
+		logMixingProbabilities [component] = ( my mixingProbabilities [component] > 0.0 ? log (my mixingProbabilities [component]) : undefined );
+	return logMixingProbabilities;
+}
+
+/*
+	ln (sum (k=1...K, π [k]*N(x|μ [k],S [k]))) from ln (π [k]) and ln (N(x|μ [k],S [k])).
+	The largest term is taken out of the sum, so that nothing underflows if x is far away from all the components.
+*/
+static double getLogSumOfRow (constVECVU const& logMixingProbabilities, constVECVU const& logProbabilities) noexcept {
+	double maximum = -INFINITY;
+	for (integer component = 1; component <= logProbabilities.size; component ++)
+		if (isdefined (logMixingProbabilities [component]))
+			maximum = std::max (maximum, logMixingProbabilities [component] + logProbabilities [component]);
+	if (maximum == -INFINITY)
+		return maximum;
+	double sum = 0.0;
+	for (integer component = 1; component <= logProbabilities.size; component ++)
+		if (isdefined (logMixingProbabilities [component]))
+			sum += exp (logMixingProbabilities [component] + logProbabilities [component] - maximum);
+	return maximum + log (sum);
+}
+
+static double GaussianMixture_getLikelihoodValue (GaussianMixture me, constMATVU const& logProbabilities, kGaussianMixtureCriterion criterion) {
+	Melder_require (logProbabilities.ncol == my numberOfComponents,
+		U"The number of columns in the probabilities should equal the number of components.");
+	autoVEC logMixingProbabilities = GaussianMixture_getLogMixingProbabilities (me);
+	longdouble lnp = 0.0, lnpcd = 0.0;
+	for (integer irow = 1; irow <= logProbabilities.nrow; irow ++) {
+		const double logSum = getLogSumOfRow (logMixingProbabilities.get(), logProbabilities.row (irow));
+		if (logSum == -INFINITY)
+			continue;
+		lnp += logSum;
+		if (criterion == kGaussianMixtureCriterion::CompleteDataML)
+			for (integer component = 1; component <= my numberOfComponents; component ++)
+				if (isdefined (logMixingProbabilities [component])) {
+					const double logTerm = logMixingProbabilities [component] + logProbabilities [irow] [component];
+					lnpcd += exp (logTerm - logSum) * logTerm;
+				}
+	}
+	return GaussianMixture_getCriterionValue (me, (double) lnp, (double) lnpcd, logProbabilities.nrow, criterion);
+}
+
+/*
+	(x - μ)' S^-1 (x - μ) from the lower inverse Cholesky factor L^-1 (S = L.L'), as expanded by SSCP_expandLowerCholeskyInverse ():
+	the squared norm of L^-1 (x - μ). For a diagonal covariance the first row contains the inverse standard deviations.
+*/
+static double Covariance_getMahalanobisDistanceSquared_expanded (Covariance me, constVECVU const& x) noexcept {
+	const constVEC centroid = my centroid.get();
+	double chisq = 0.0;
+	if (my numberOfRows == 1) {
+		for (integer icol = 1; icol <= x.size; icol ++) {
+			const double t = my lowerCholeskyInverse [1] [icol] * (x [icol] - centroid [icol]);
+			chisq += t * t;
+		}
+	} else {
+		for (integer irow = 1; irow <= x.size; irow ++) {
+			double t = 0.0;
+			for (integer icol = 1; icol <= irow; icol ++)
+				t += my lowerCholeskyInverse [irow] [icol] * (x [icol] - centroid [icol]);
+			chisq += t * t;
+		}
+	}
+	return chisq;
+}
+
+/*
+	ln (N(x|μ [k],S [k])); the inverse Cholesky factor of the component should have been expanded.
+*/
+static double GaussianMixture_getComponentLogProbability (GaussianMixture me, integer component, constVECVU const& x) noexcept {
+	const Covariance cov = my covariances->at [component];
+	return -0.5 * (my dimension * log (NUM2pi) + cov -> lnd + Covariance_getMahalanobisDistanceSquared_expanded (cov, x));
+}
+
+/*
+	The Cholesky factors of the covariances change only when the parameters change:
+	they are computed here once for all the data, and not again for every row.
+*/
+static void GaussianMixture_expandLowerCholeskyInverses (GaussianMixture me, integer fromComponent, integer toComponent) {
+	for (integer component = fromComponent; component <= toComponent; component ++)
+		SSCP_expandLowerCholeskyInverse (my covariances->at [component]);
+}
+
+static constMATVU constMATVUrows (constMATVU const& x, integer firstRow, integer lastRow) {
+	return constMATVU (& x [firstRow] [1], lastRow - firstRow + 1, x.ncol, x.rowStride, x.colStride);
+}
+
+/*
+	Get ln (N(x [n]|μ [k],S [k])) for the rows of the data and the components fromComponent .. toComponent.
+*/
+static void GaussianMixture_getComponentLogProbabilities (GaussianMixture me, constMATVU const& data, integer fromComponent, integer toComponent, MATVU const& logProbabilities) {
+	Melder_assert (logProbabilities.nrow == data.nrow && logProbabilities.ncol == my numberOfComponents);
+	GaussianMixture_expandLowerCholeskyInverses (me, fromComponent, toComponent);
+	const double numberOfOperations = double (data.nrow) * double (toComponent - fromComponent + 1) * double (my dimension) * double (my dimension);
+	const integer numberOfThreads = MelderThread_getNumberOfThreads (data.nrow, numberOfOperations);
+	MelderThread_runStretches (numberOfThreads, data.nrow, [&] (integer /* ithread */, integer firstRow, integer lastRow) {
+		for (integer irow = firstRow; irow <= lastRow; irow ++)
+			for (integer component = fromComponent; component <= toComponent; component ++)
+				logProbabilities [irow] [component] = GaussianMixture_getComponentLogProbability (me, component, data.row (irow));
+	});
+}
+
+/*
+	The responsibilities π [k]*N(x [n]|μ [k],S [k]) / sum(1...K, π [k]*N(x [n]|μ [k],S [k])) from the log probabilities,
+	for all components (componentToUpdate == 0), or for one component only.
+	The responsibilities may overwrite the log probabilities.
+*/
+static void GaussianMixture_getResponsibilities (GaussianMixture me, constMATVU const& logProbabilities, integer componentToUpdate, MATVU const& responsibilities) {
+	Melder_require (responsibilities.nrow == logProbabilities.nrow && responsibilities.ncol == logProbabilities.ncol,
 			U"The responsibilities and the probabilities should have the same dimensions.");
 	Melder_require (responsibilities.ncol == my numberOfComponents,
 			U"The number of columns of the responsbilities should equal the number of components.");
 	const integer fromComponent = componentToUpdate == 0 ? 1 : componentToUpdate;
 	const integer toComponent = componentToUpdate == 0 ? my numberOfComponents : componentToUpdate;
-	
-	for (integer irow = 1; irow <= probabilities.nrow; irow ++) {
-		responsibilities.row (irow).part (fromComponent, toComponent) <<= probabilities.row (irow).part (fromComponent, toComponent)  *  my mixingProbabilities.part (fromComponent, toComponent);
+	autoVEC logMixingProbabilities = GaussianMixture_getLogMixingProbabilities (me);
+	const integer numberOfThreads = MelderThread_getNumberOfThreads (logProbabilities.nrow, 30.0 * logProbabilities.nrow * my numberOfComponents);
+	MelderThread_runStretches (numberOfThreads, logProbabilities.nrow, [&] (integer /* ithread */, integer firstRow, integer lastRow) {
+		for (integer irow = firstRow; irow <= lastRow; irow ++) {
+			const double logSum = getLogSumOfRow (logMixingProbabilities.get(), logProbabilities.row (irow));
+			for (integer component = fromComponent; component <= toComponent; component ++)
+				responsibilities [irow] [component] = ( isdefined (logMixingProbabilities [component]) && logSum > -INFINITY ?
+						exp (logMixingProbabilities [component] + logProbabilities [irow] [component] - logSum) : 0.0 );
+		}
+	});
+}
+
+/*
+	Merge a second weighted accumulation (weight2, mean2, scatter2) into a first one, both as weighted means and
+	weighted sums of squares and cross products about the mean. With delta = mean2 - mean1 and w = w1 + w2:
+		scatter = scatter1 + scatter2 + (w1 w2 / w) delta delta'
+		mean = mean1 + (w2 / w) delta
+	A scatter with one row contains only the diagonal.
+*/
+static void mergeWeightedAccumulations (double *weight1, VECVU const& mean1, MATVU const& scatter1,
+	double weight2, constVECVU const& mean2, constMATVU const& scatter2) noexcept
+{
+	if (weight2 <= 0.0)
+		return;
+	if (*weight1 <= 0.0) {
+		*weight1 = weight2;
+		mean1  <<=  mean2;
+		scatter1  <<=  scatter2;
+		return;
+	}
+	const double weight = *weight1 + weight2;
+	const double factor = *weight1 * weight2 / weight;
+	if (scatter1.nrow == 1) {
+		for (integer icol = 1; icol <= scatter1.ncol; icol ++) {
+			const double delta = mean2 [icol] - mean1 [icol];
+			scatter1 [1] [icol] += scatter2 [1] [icol] + factor * delta * delta;
+		}
+	} else {
+		for (integer irow = 1; irow <= scatter1.nrow; irow ++) {
+			const double deltaRow = mean2 [irow] - mean1 [irow];
+			for (integer icol = 1; icol <= scatter1.ncol; icol ++)
+				scatter1 [irow] [icol] += scatter2 [irow] [icol] + factor * deltaRow * (mean2 [icol] - mean1 [icol]);
+		}
+	}
+	const double fraction2 = weight2 / weight;
+	for (integer icol = 1; icol <= mean1.size; icol ++)
+		mean1 [icol] += fraction2 * (mean2 [icol] - mean1 [icol]);
+	*weight1 = weight;
+}
+
+/*
+	The sufficient statistics of the M-step as accumulated by one thread: per component the sum of the responsibilities,
+	and the responsibility-weighted mean and sums of squares and cross products about that mean.
+	Blocks of rows are summarized first and then merged into the totals, so that no large sums of squares are subtracted.
+	All the memory is allocated beforehand (on the main thread), so that the accumulation can run on any thread.
+*/
+struct GaussianMixtureAccumulator {
+	static constexpr integer blockSize = 256;   // rows whose responsibilities are computed at a time
+	integer numberOfScatterRows;   // 1 for diagonal covariances
+	longdouble lnp, lnpcd;   // as in GaussianMixture_getCriterionValue ()
+	autoVEC weights;
+	autoMAT means, scatters;   // the scatter of component k is in rows (k - 1) * numberOfScatterRows + 1 ...
+	autoMAT logProbabilities, responsibilities;
+	autoVEC blockMean;
+	autoMAT blockScatter;
+
+	void init (GaussianMixture gm, integer maximumNumberOfRows) {
+		const integer numberOfComponents = gm -> numberOfComponents, dimension = gm -> dimension;
+		numberOfScatterRows = gm -> covariances->at [1] -> numberOfRows;
+		lnp = lnpcd = 0.0;
+		weights = newVECzero (numberOfComponents);
+		means = newMATzero (numberOfComponents, dimension);
+		scatters = newMATzero (numberOfComponents * numberOfScatterRows, dimension);
+		const integer numberOfBlockRows = std::max (integer (1), std::min (blockSize, maximumNumberOfRows));
+		logProbabilities = newMATraw (numberOfBlockRows, numberOfComponents);
+		responsibilities = newMATraw (numberOfBlockRows, numberOfComponents);
+		blockMean = newVECraw (dimension);
+		blockScatter = newMATraw (numberOfScatterRows, dimension);
+	}
+	MATVU scatter (integer component) {
+		return scatters.horizontalBand ((component - 1) * numberOfScatterRows + 1, component * numberOfScatterRows);
+	}
+	void addWeightedRows (integer component, constMATVU const& rows, constVECVU const& rowWeights) noexcept {
+		const double blockWeight = NUMsum (rowWeights);
+		if (blockWeight <= 0.0)
+			return;
+		blockMean.get()  <<=  0.0;
+		for (integer irow = 1; irow <= rows.nrow; irow ++)
+			blockMean.get()  +=  rowWeights [irow]  *  rows.row (irow);
+		blockMean.get()  *=  1.0 / blockWeight;
+		blockScatter.get()  <<=  0.0;
+		for (integer irow = 1; irow <= rows.nrow; irow ++) {
+			const double weight = rowWeights [irow];
+			if (weight == 0.0)
+				continue;
+			const constVECVU x = rows.row (irow);
+			if (numberOfScatterRows == 1) {
+				for (integer icol = 1; icol <= x.size; icol ++) {
+					const double delta = x [icol] - blockMean [icol];
+					blockScatter [1] [icol] += weight * delta * delta;
+				}
+			} else {
+				for (integer i = 1; i <= x.size; i ++) {
+					const double weightedDelta = weight * (x [i] - blockMean [i]);
+					for (integer j = 1; j <= i; j ++)
+						blockScatter [i] [j] += weightedDelta * (x [j] - blockMean [j]);
+				}
+			}
+		}
+		if (numberOfScatterRows > 1)
+			for (integer i = 1; i <= blockScatter.nrow; i ++)
+				for (integer j = 1; j < i; j ++)
+					blockScatter [j] [i] = blockScatter [i] [j];
+		mergeWeightedAccumulations (& weights [component], means.row (component), scatter (component),
+				blockWeight, blockMean.get(), blockScatter.get());
 	}
 	/*
-		Maintain the invariant.
+		The E-step for the rows, followed by the accumulation of the statistics; the responsibilities are not kept.
 	*/
-	MATnormalizeRows_inplace (responsibilities, 1.0, 1.0);
+	void addRows (GaussianMixture gm, constVEC const& logMixingProbabilities, constMATVU const& rows) noexcept {
+		const integer numberOfComponents = gm -> numberOfComponents;
+		for (integer ifirst = 1; ifirst <= rows.nrow; ifirst += blockSize) {
+			const integer ilast = std::min (ifirst + blockSize - 1, rows.nrow), numberOfBlockRows = ilast - ifirst + 1;
+			const constMATVU block = constMATVUrows (rows, ifirst, ilast);
+			for (integer irow = 1; irow <= numberOfBlockRows; irow ++)
+				for (integer component = 1; component <= numberOfComponents; component ++)
+					if (isdefined (logMixingProbabilities [component]))
+						logProbabilities [irow] [component] = GaussianMixture_getComponentLogProbability (gm, component, block.row (irow));
+			for (integer irow = 1; irow <= numberOfBlockRows; irow ++) {
+				const double logSum = getLogSumOfRow (logMixingProbabilities, logProbabilities.row (irow));
+				for (integer component = 1; component <= numberOfComponents; component ++)
+					responsibilities [irow] [component] = 0.0;
+				if (logSum == -INFINITY)
+					continue;
+				lnp += logSum;
+				for (integer component = 1; component <= numberOfComponents; component ++)
+					if (isdefined (logMixingProbabilities [component])) {
+						const double logTerm = logMixingProbabilities [component] + logProbabilities [irow] [component];
+						const double responsibility = exp (logTerm - logSum);
+						responsibilities [irow] [component] = responsibility;
+						lnpcd += responsibility * logTerm;
+					}
+			}
+			for (integer component = 1; component <= numberOfComponents; component ++)
+				if (isdefined (logMixingProbabilities [component]))
+					addWeightedRows (component, block, responsibilities.column (component).part (1, numberOfBlockRows));
+		}
+	}
+	void merge (GaussianMixtureAccumulator& other) noexcept {
+		lnp += other.lnp;
+		lnpcd += other.lnpcd;
+		for (integer component = 1; component <= weights.size; component ++)
+			mergeWeightedAccumulations (& weights [component], means.row (component), scatter (component),
+					other.weights [component], other.means.row (component), other.scatter (component));
+	}
+};
+
+/*
+	E-step over all the rows with the current parameters, together with the sums that the M-step needs,
+	so that the responsibilities of all the rows never have to be stored at the same time.
+	The rows are spread over threads, each with its own accumulator.
+*/
+static GaussianMixtureAccumulator GaussianMixture_accumulate (GaussianMixture me, constMATVU const& data) {
+	GaussianMixture_expandLowerCholeskyInverses (me, 1, my numberOfComponents);
+	autoVEC logMixingProbabilities = GaussianMixture_getLogMixingProbabilities (me);
+	const double numberOfOperations = 2.0 * double (data.nrow) * double (my numberOfComponents) * double (my dimension) * double (my dimension);
+	const integer numberOfThreads = MelderThread_getNumberOfThreads (data.nrow / GaussianMixtureAccumulator::blockSize + 1, numberOfOperations);
+	std::vector <GaussianMixtureAccumulator> accumulators ((size_t) numberOfThreads);
+	for (integer ithread = 0; ithread < numberOfThreads; ithread ++)
+		accumulators [(size_t) ithread]. init (me, data.nrow / numberOfThreads + 1);
+	MelderThread_runStretches (numberOfThreads, data.nrow, [&] (integer ithread, integer firstRow, integer lastRow) {
+		accumulators [(size_t) ithread]. addRows (me, logMixingProbabilities.get(), constMATVUrows (data, firstRow, lastRow));
+	});
+	for (integer ithread = 1; ithread < numberOfThreads; ithread ++)
+		accumulators [0]. merge (accumulators [(size_t) ithread]);
+	return std::move (accumulators [0]);
+}
+
+/*
+	M-step for one component: the new mean and covariance (Bishop eqs. 9.24 and 9.25) from the accumulated statistics.
+	A component without support keeps its parameters.
+*/
+static void GaussianMixture_setComponent (GaussianMixture me, integer component, GaussianMixtureAccumulator& statistics) {
+	const double weight = statistics.weights [component];
+	if (weight <= 0.0)
+		return;
+	const Covariance thee = my covariances->at [component];
+	Melder_assert (thy numberOfRows == statistics.numberOfScatterRows);
+	thy centroid.all()  <<=  statistics.means.row (component);
+	thy data.all()  <<=  statistics.scatter (component);
+	thy data.all()  *=  1.0 / weight;
 }
 
-static void GaussianMixture_updateComponent (GaussianMixture me, integer component, MATVU const& data, MATVU const& responsibilities) {
-	integer numberOfData = data.nrow;
+static void GaussianMixture_updateComponent (GaussianMixture me, integer component, constMATVU const& data, constVECVU const& responsibilities) {
 	Melder_require (my dimension == data.ncol,
 		U"The number of columns in the data and the dimension of the GaussianMixture should be equal.");
-	Melder_require (my numberOfComponents == responsibilities.ncol,
-		U"The number of components and the number of columns in the responsibilities should conform.");
-	Melder_require (responsibilities.nrow == data.nrow,
+	Melder_require (responsibilities.size == data.nrow,
 		U"The number of rows in the data and the responsibilities should conform.");
 	Melder_require (component > 0 && component <= my numberOfComponents,
 		U"The component number should be in the range from 1 to ", my numberOfComponents, U".");
-	
-	const Covariance thee = my covariances->at [component];
-	/*
-		Update the means: Bishop eq. 9.24
-	*/
-	thy centroid.get() <<= 0.0;
-	for (integer irow = 1; irow <= numberOfData; irow ++)
-		thy centroid.get()  +=  responsibilities [irow] [component]  *  data.row (irow);
-	
-	const double totalComponentResponsibility = NUMsum (responsibilities.column (component));
-	thy centroid.get ()  /=  totalComponentResponsibility;
-	/*
-		update covariance with the new mean: Bishop eq. 9.25
-	*/
-	thy data.get() <<= 0.0;
-	autoVEC dif = newVECraw (thy numberOfColumns);
-	if (thy numberOfRows == 1) { // 1xn covariance
-		autoVEC variance = newVECraw (thy numberOfColumns);
-		for (integer irow = 1; irow <= numberOfData; irow ++) {
-			dif.get() <<= data.row (irow)  -  thy centroid.get();
-			variance.get() <<= dif.get()  *  dif.get();
-			thy data.row (1)  +=  responsibilities [irow] [component]  *  variance.get();
-		}
-	} else { // nxn covariance
-		autoMAT covar = newMATraw (thy numberOfColumns, thy numberOfColumns);
-		for (integer irow = 1; irow <= numberOfData; irow ++) {
-			dif.get() <<= data.row (irow)  -  thy centroid.get();
-			MATouter (covar.get(), dif.get(), dif.get());
-			thy data.get()  +=  responsibilities [irow] [component]  *  covar.get();
+	const double numberOfOperations = double (data.nrow) * double (my dimension) * double (my dimension);
+	const integer numberOfThreads = MelderThread_getNumberOfThreads (data.nrow / GaussianMixtureAccumulator::blockSize + 1, numberOfOperations);
+	std::vector <GaussianMixtureAccumulator> accumulators ((size_t) numberOfThreads);
+	for (integer ithread = 0; ithread < numberOfThreads; ithread ++)
+		accumulators [(size_t) ithread]. init (me, 1);
+	MelderThread_runStretches (numberOfThreads, data.nrow, [&] (integer ithread, integer firstRow, integer lastRow) {
+		for (integer ifirst = firstRow; ifirst <= lastRow; ifirst += GaussianMixtureAccumulator::blockSize) {
+			const integer ilast = std::min (ifirst + GaussianMixtureAccumulator::blockSize - 1, lastRow);
+			accumulators [(size_t) ithread]. addWeightedRows (component, constMATVUrows (data, ifirst, ilast), responsibilities.part (ifirst, ilast));
 		}
-	}
-	thy data.get()  /=  totalComponentResponsibility;
-	thy numberOfObservations = my mixingProbabilities [component] * numberOfData;
+	});
+	for (integer ithread = 1; ithread < numberOfThreads; ithread ++)
+		accumulators [0]. merge (accumulators [(size_t) ithread]);
+	GaussianMixture_setComponent (me, component, accumulators [0]);
+	my covariances->at [component] -> numberOfObservations = my mixingProbabilities [component] * data.nrow;
 }
 
 static void GaussianMixture_setDefaultMixtureNames (GaussianMixture me) {
@@ -798,20 +1053,14 @@ void GaussianMixture_TableOfReal_getComponentProbabilities (GaussianMixture me,
 			U"The number of columns in the TableOfReal and the dimension of the GaussianMixture should be equal.");
 		Melder_require (componentToUpdate >= 0 && componentToUpdate <= my numberOfComponents,
 			U"The component number should be in the interval from 0 to ", my numberOfComponents);
-		const double ln2pid = my dimension * log (NUM2pi);
 
 		const integer fromComponent = componentToUpdate == 0 ? 1 : componentToUpdate;
 		const integer toComponent = componentToUpdate == 0 ? my numberOfComponents : componentToUpdate;
 		
-		for (integer component = fromComponent; component <= toComponent; component ++) {
-			const Covariance covi = my covariances->at [component];
-			SSCP_expandLowerCholeskyInverse (covi);
-
-			for (integer irow = 1; irow <= thy numberOfRows; irow++) {
-				const double dsq = NUMmahalanobisDistanceSquared (covi -> lowerCholeskyInverse.get(), thy data.row (irow), covi -> centroid.get());
-				probabilities [irow] [component] = std::max (1e-300, exp (- 0.5 * (ln2pid + covi -> lnd + dsq))); // prevent probabilities from being zero
-			}
-		}
+		GaussianMixture_getComponentLogProbabilities (me, thy data.get(), fromComponent, toComponent, probabilities);
+		for (integer irow = 1; irow <= thy numberOfRows; irow ++)
+			for (integer component = fromComponent; component <= toComponent; component ++)
+				probabilities [irow] [component] = std::max (1e-300, exp (probabilities [irow] [component])); // prevent probabilities from being zero
 	} catch (MelderError) {
 		Melder_throw (me, U" & ", thee, U": no component probabilies could be calculated.");
 	}
@@ -824,9 +1073,8 @@ void GaussianMixture_TableOfReal_getResponsilities (GaussianMixture me, TableOfR
 			U"The number of columns in the TableOfReal and the responsibilities should be equal.");
 		Melder_require (my dimension == thy numberOfColumns,
 			U"The number of columns in the TableOfReal and the dimension of the GaussianMixture should be equal.");
-		autoMAT probabilities = newMATraw (responsibilities.nrow, responsibilities.ncol);
-		GaussianMixture_TableOfReal_getComponentProbabilities (me, thee, 0, probabilities);
-		GaussianMixture_getResponsibilities (me, probabilities.get(), 0, responsibilities);
+		GaussianMixture_getComponentLogProbabilities (me, thy data.get(), 1, my numberOfComponents, responsibilities);
+		GaussianMixture_getResponsibilities (me, responsibilities, 0, responsibilities);
 }
 
 autoTableOfReal GaussianMixture_TableOfReal_to_TableOfReal_probabilities (GaussianMixture me, TableOfReal thee) {
@@ -845,8 +1093,12 @@ autoTableOfReal GaussianMixture_TableOfReal_to_TableOfReal_probabilities (Gaussi
 
 autoTableOfReal GaussianMixture_TableOfReal_to_TableOfReal_responsibilities (GaussianMixture me, TableOfReal thee) {
 	try {
-		autoTableOfReal him = GaussianMixture_TableOfReal_to_TableOfReal_probabilities (me, thee);
-		GaussianMixture_getResponsibilities (me, his data.get(), 0, his data.get());
+		Melder_require (my dimension == thy numberOfColumns,
+			U"The number of columns in the TableOfReal and the dimension of the GaussianMixture should be equal.");
+		autoTableOfReal him = TableOfReal_create (thy numberOfRows, my numberOfComponents);
+		his rowLabels.all() <<= thy rowLabels.all();
+		TableOfReal_setSequentialColumnLabels (him.get(), 1, my numberOfComponents, U"c", 1, 1);
+		GaussianMixture_TableOfReal_getResponsilities (me, thee, his data.get());
 		return him;
 	} catch (MelderError) {
 		Melder_throw (me, U" & ", thee, U": no responsibilities could be calculated.");
@@ -868,6 +1120,20 @@ void GaussianMixture_unExpandPCA (GaussianMixture me) {
 	}
 }
 
+/*
+	During EM, covariances were underestimated by a factor of (n-1)/n. Correction now.
+	The expanded Cholesky factors are brought up to date with the final covariances.
+*/
+static void GaussianMixture_correctCovariances (GaussianMixture me, integer numberOfData) {
+	for (integer component = 1; component <= my numberOfComponents; component ++) {
+		const Covariance cov = my covariances->at [component];
+		cov -> numberOfObservations = my mixingProbabilities [component] * numberOfData;
+		if (cov -> numberOfObservations > 1.5)
+			cov -> data.all()  *=  cov -> numberOfObservations / (cov -> numberOfObservations - 1.0);
+	}
+	GaussianMixture_expandLowerCholeskyInverses (me, 1, my numberOfComponents);
+}
+
 void GaussianMixture_TableOfReal_improveLikelihood (GaussianMixture me, TableOfReal thee, double delta_lnp, integer maxNumberOfIterations, double lambda, kGaussianMixtureCriterion criterion) {
 	try {
 		Melder_require (thy numberOfColumns == my dimension,
@@ -881,67 +1147,213 @@ void GaussianMixture_TableOfReal_improveLikelihood (GaussianMixture me, TableOfR
 		// mixture covariances to prevent numerical instabilities.
 
 		autoCovariance covg = TableOfReal_to_Covariance (thee);
-		autoMAT probabilities = newMATraw (thy numberOfRows, my numberOfComponents);
-		autoMAT responsibilities = newMATraw (thy numberOfRows, my numberOfComponents);
-		
-		GaussianMixture_TableOfReal_getComponentProbabilities (me, thee, 0, probabilities);
-
-		double lnp = GaussianMixture_getLikelihoodValue (me, probabilities.get(), criterion);
+		/*
+			E-step: get responsibilities (gamma) with current parameters
+			See C. Bishop (2006), Pattern reconition and machine learning, Springer, page 439...
+			The responsibilities are not stored: only their sums over the rows, which is what the M-step needs.
+		*/
+		GaussianMixtureAccumulator statistics = GaussianMixture_accumulate (me, thy data.get());
+		double lnp = GaussianMixture_getCriterionValue (me, (double) statistics.lnp, (double) statistics.lnpcd, thy numberOfRows, criterion);
 		integer iter = 0;
 		autoMelderProgress progress (U"Improve likelihood...");
 		try {
 			double lnp_prev, lnp_start = lnp / thy numberOfRows;
 			do {
 				iter ++;
-				/*
-					E-step: get responsibilities (gamma) with current parameters
-					See C. Bishop (2006), Pattern reconition and machine learning, Springer, page 439...
-				*/
-				GaussianMixture_getResponsibilities (me, probabilities.get(), 0, responsibilities.get());
-
 				lnp_prev = lnp;
 				
 				/*
 					M-step: 1. new means & covariances
 				*/
 				for (integer component = 1; component <= my numberOfComponents; component ++) {
-					GaussianMixture_updateComponent (me, component, thy data.get(), responsibilities.get());
+					GaussianMixture_setComponent (me, component, statistics);
+					my covariances->at [component] -> numberOfObservations = my mixingProbabilities [component] * thy numberOfRows;
 					GaussianMixture_addCovarianceFraction (me, component, covg.get(), lambda);
 				}
 
 				/*
 					M-step: 2. new mixingProbabilities
 				*/
-				autoVEC totalResponsibilities = newVECcolumnSums (responsibilities.get());
-				my mixingProbabilities.all() <<= totalResponsibilities.get();
-				my mixingProbabilities.all()  *=  1.0 / responsibilities.nrow;
-				
-				GaussianMixture_TableOfReal_getComponentProbabilities (me, thee, 0, probabilities);
+				my mixingProbabilities.all() <<= statistics.weights.all();
+				my mixingProbabilities.all()  *=  1.0 / thy numberOfRows;
+				/*
+					E-step with the new parameters, which also gives their likelihood.
+				*/
+				statistics = GaussianMixture_accumulate (me, thy data.get());
 				
-				lnp = GaussianMixture_getLikelihoodValue (me, probabilities.get(), criterion);
+				lnp = GaussianMixture_getCriterionValue (me, (double) statistics.lnp, (double) statistics.lnpcd, thy numberOfRows, criterion);
 				Melder_progress ((double) iter / (double) maxNumberOfIterations, criterionText, U": ", lnp / thy numberOfRows, U", L0: ", lnp_start);
 			} while (fabs ((lnp - lnp_prev) / lnp_prev) > delta_lnp && iter < maxNumberOfIterations);
 		} catch (MelderError) {
 			Melder_clearError ();
 		}
+		GaussianMixture_correctCovariances (me, thy numberOfRows);
+	} catch (MelderError) {
+		Melder_throw (me, U" & ", thee, U": likelihood cannot be improved.");
+	}
+}
 
-		// During EM, covariances were underestimated by a factor of (n-1)/n. Correction now.
+/*
+	Stepwise EM (Cappé & Moulines 2009; Liang & Klein 2009). After each batch of rows, the statistics per datum
+	are interpolated with those of the batch with a step size of (step + 1)^-stepSizeExponent,
+	and the parameters are estimated anew from them. Only one batch needs to be in memory.
+*/
+struct GaussianMixtureStepwiseEM {
+	GaussianMixtureAccumulator statistics;
+	autoMAT batch;
+	integer numberOfRowsInBatch = 0, numberOfSteps = 0;
+	double stepSizeExponent, lambda;
+	Covariance globalCovariance;   // may be null
+
+	void init (GaussianMixture gm, integer batchSize, double stepSizeExponent_, Covariance globalCovariance_, double lambda_) {
+		statistics. init (gm, 1);
+		batch = newMATraw (batchSize, gm -> dimension);
+		stepSizeExponent = stepSizeExponent_;
+		globalCovariance = globalCovariance_;
+		lambda = lambda_;
+	}
+	void addRowsInRandomOrder (GaussianMixture gm, constMATVU const& rows) {
+		autoINTVEC order = newINTVECraw (rows.nrow);
+		for (integer irow = 1; irow <= rows.nrow; irow ++)
+			order [irow] = irow;
+		for (integer irow = rows.nrow; irow > 1; irow --)
+			std::swap (order [irow], order [NUMrandomInteger (1, irow)]);
+		for (integer irow = 1; irow <= rows.nrow; irow ++) {
+			batch.row (++ numberOfRowsInBatch)  <<=  rows.row (order [irow]);
+			if (numberOfRowsInBatch == batch.nrow)
+				step (gm);
+		}
+	}
+	void step (GaussianMixture gm) {
+		if (numberOfRowsInBatch == 0)
+			return;
+		const constMATVU rows = batch.horizontalBand (1, numberOfRowsInBatch);
+		numberOfRowsInBatch = 0;
+		GaussianMixtureAccumulator batchStatistics = GaussianMixture_accumulate (gm, rows);
+		const double stepSize = pow (numberOfSteps + 1.0, - stepSizeExponent);
+		numberOfSteps ++;
+		for (integer component = 1; component <= gm -> numberOfComponents; component ++) {
+			statistics.weights [component] *= 1.0 - stepSize;
+			statistics.scatter (component)  *=  1.0 - stepSize;
+			batchStatistics.weights [component] *= stepSize / rows.nrow;
+			batchStatistics.scatter (component)  *=  stepSize / rows.nrow;
+		}
+		statistics. merge (batchStatistics);
+		for (integer component = 1; component <= gm -> numberOfComponents; component ++) {
+			GaussianMixture_setComponent (gm, component, statistics);
+			if (globalCovariance && lambda > 0.0)
+				GaussianMixture_addCovarianceFraction (gm, component, globalCovariance, lambda);
+		}
+		gm -> mixingProbabilities.all()  <<=  statistics.weights.all();
+		VECnormalize_inplace (gm -> mixingProbabilities.get(), 1.0, 1.0);
+	}
+};
+
+static void checkMiniBatchParameters (GaussianMixture me, integer batchSize, integer numberOfEpochs, double stepSizeExponent, double lambda) {
+	Melder_require (batchSize > my numberOfComponents,
+		U"The batch size should be larger than the number of components.");
+	Melder_require (numberOfEpochs > 0,
+		U"The number of epochs should be positive.");
+	Melder_require (stepSizeExponent > 0.5 && stepSizeExponent <= 1.0,
+		U"The step size exponent should be in the interval (0.5, 1].");
+	Melder_require (lambda >= 0.0 && lambda < 1.0,
+		U"Lambda should be in the interval [0, 1).");
+}
 
-		for (integer component = 1; component <= my numberOfComponents; component ++) {
-			const Covariance cov = my covariances->at [component];
-			if (cov -> numberOfObservations > 1.5)
-				cov -> data.row (1)  *=  cov -> numberOfObservations / (cov -> numberOfObservations - 1.0);
+void GaussianMixture_TableOfReal_improveLikelihood_miniBatch (GaussianMixture me, TableOfReal thee, integer batchSize, integer numberOfEpochs, double stepSizeExponent, double lambda) {
+	try {
+		Melder_require (thy numberOfColumns == my dimension,
+			U"The number of columns and the dimension of the model should agree.");
+		checkMiniBatchParameters (me, batchSize, numberOfEpochs, stepSizeExponent, lambda);
+		autoCovariance covg = TableOfReal_to_Covariance (thee);
+		GaussianMixtureStepwiseEM em;
+		em. init (me, std::min (batchSize, thy numberOfRows), stepSizeExponent, covg.get(), lambda);
+		autoMelderProgress progress (U"Improve likelihood (mini-batch)...");
+		try {
+			for (integer epoch = 1; epoch <= numberOfEpochs; epoch ++) {
+				em. addRowsInRandomOrder (me, thy data.get());
+				em. step (me);
+				Melder_progress ((double) epoch / (double) numberOfEpochs, U"Epoch ", epoch, U" of ", numberOfEpochs);
+			}
+		} catch (MelderError) {
+			Melder_clearError ();
 		}
+		GaussianMixture_correctCovariances (me, thy numberOfRows);
 	} catch (MelderError) {
 		Melder_throw (me, U" & ", thee, U": likelihood cannot be improved.");
 	}
 }
 
+void GaussianMixture_improveLikelihood_miniBatchFromFolder (GaussianMixture me, conststring32 folderWithDataFiles, conststring32 dataFileExtension,
+	integer batchSize, integer numberOfEpochs, double stepSizeExponent, double lambda)
+{
+	try {
+		checkMiniBatchParameters (me, batchSize, numberOfEpochs, stepSizeExponent, lambda);
+		autoStrings fileList = Strings_createAsFileList (Melder_cat (folderWithDataFiles, U"/*.", dataFileExtension));
+		if (fileList -> numberOfStrings == 0)
+			Melder_throw (U"No files found.");
+		autoCovariance covg;
+		if (lambda > 0.0) {
+			autoSSCP sscp = SSCP_createFromFolder (folderWithDataFiles, dataFileExtension);
+			Melder_require (sscp -> numberOfColumns == my dimension,
+				U"The number of columns in the data and the dimension of the model should agree.");
+			covg = SSCP_to_Covariance (sscp.get(), 1);
+		}
+		GaussianMixtureStepwiseEM em;
+		em. init (me, batchSize, stepSizeExponent, covg.get(), lambda);
+		integer numberOfRowsInFirstEpoch = 0;
+		autoMelderProgress progress (U"Improve likelihood (mini-batch)...");
+		/*
+			One file at a time is in memory; the files are visited in a different random order in every epoch.
+		*/
+		autoINTVEC fileOrder = newINTVECraw (fileList -> numberOfStrings);
+		for (integer ifile = 1; ifile <= fileOrder.size; ifile ++)
+			fileOrder [ifile] = ifile;
+		for (integer epoch = 1; epoch <= numberOfEpochs; epoch ++) {
+			for (integer ifile = fileOrder.size; ifile > 1; ifile --)
+				std::swap (fileOrder [ifile], fileOrder [NUMrandomInteger (1, ifile)]);
+			for (integer ifile = 1; ifile <= fileOrder.size; ifile ++) {
+				conststring32 fileName = fileList -> strings [fileOrder [ifile]].get();
+				try {
+					structMelderFile file { };
+					Melder_relativePathToFile (Melder_cat (folderWithDataFiles, U"/", fileName), & file);
+					autoDaata data = Data_readFromFile (& file);
+					constMATVU rows;
+					if (Thing_isa (data.get(), classTableOfReal))
+						rows = static_cast <TableOfReal> (data.get()) -> data.get();
+					else if (Thing_isa (data.get(), classMatrix))
+						rows = static_cast <Matrix> (data.get()) -> z.get();   // the rows of the matrix are the observations
+					else
+						Melder_throw (U"Contains a ", Thing_className (data.get()), U" instead of a TableOfReal or Matrix.");
+					Melder_require (rows.ncol == my dimension,
+						U"The number of columns should be ", my dimension, U".");
+					em. addRowsInRandomOrder (me, rows);
+					if (epoch == 1)
+						numberOfRowsInFirstEpoch += rows.nrow;
+				} catch (MelderError) {
+					Melder_throw (U"File ", fileName, U" not used.");
+				}
+			}
+			em. step (me);
+			try {
+				Melder_progress ((double) epoch / (double) numberOfEpochs, U"Epoch ", epoch, U" of ", numberOfEpochs);
+			} catch (MelderError) {
+				Melder_clearError ();   // interrupted: keep what we have
+				break;
+			}
+		}
+		GaussianMixture_correctCovariances (me, numberOfRowsInFirstEpoch);
+	} catch (MelderError) {
+		Melder_throw (me, U": likelihood cannot be improved from folder ", folderWithDataFiles, U".");
+	}
+}
 
 double GaussianMixture_TableOfReal_getLikelihoodValue (GaussianMixture me, TableOfReal thee, kGaussianMixtureCriterion criterion) {
-	autoMAT probabilities = newMATraw (thy numberOfRows, my numberOfComponents);
-	GaussianMixture_TableOfReal_getComponentProbabilities (me, thee, 0, probabilities.get());
-	return GaussianMixture_getLikelihoodValue (me, probabilities.get(), criterion);
+	Melder_require (my dimension == thy numberOfColumns,
+		U"The number of columns in the TableOfReal and the dimension of the GaussianMixture should be equal.");
+	autoMAT logProbabilities = newMATraw (thy numberOfRows, my numberOfComponents);
+	GaussianMixture_getComponentLogProbabilities (me, thy data.get(), 1, my numberOfComponents, logProbabilities.get());
+	return GaussianMixture_getLikelihoodValue (me, logProbabilities.get(), criterion);
 }
 
 autoMAT newMATremoveColumn (constMAT const& m, integer columnToRemove) {
@@ -979,7 +1391,7 @@ autoGaussianMixture GaussianMixture_TableOfReal_to_GaussianMixture_CEMM (Gaussia
 		const conststring32 criterionText = GaussianMixture_criterionText (criterion);
 		const bool deleteWeakComponents = minimumNumberOfComponents > 0;
 		autoGaussianMixture him = Data_copy (me);
-		autoMAT probabilities = newMATzero (thy numberOfRows, his numberOfComponents);
+		autoMAT logProbabilities = newMATzero (thy numberOfRows, his numberOfComponents);
 		autoMAT responsibilities = newMATzero (thy numberOfRows, his numberOfComponents);
 
 		autoCovariance covg = TableOfReal_to_Covariance (thee);
@@ -989,10 +1401,10 @@ autoGaussianMixture GaussianMixture_TableOfReal_to_GaussianMixture_CEMM (Gaussia
 
 		// Initial E-step: Update all component probabilities.
 
-		GaussianMixture_TableOfReal_getComponentProbabilities (him.get(), thee, 0, probabilities.get());
-		GaussianMixture_getResponsibilities (me, probabilities.get(), 0, responsibilities.get());
+		GaussianMixture_getComponentLogProbabilities (him.get(), thy data.get(), 1, his numberOfComponents, logProbabilities.get());
+		GaussianMixture_getResponsibilities (him.get(), logProbabilities.get(), 0, responsibilities.get());
 
-		double lnew = GaussianMixture_getLikelihoodValue (him.get(), probabilities.get(), criterion);
+		double lnew = GaussianMixture_getLikelihoodValue (him.get(), logProbabilities.get(), criterion);
 
 		autoMelderProgress progress (U"Gaussian mixture...");
 		autoGaussianMixture best = Data_copy (me);
@@ -1008,7 +1420,7 @@ autoGaussianMixture GaussianMixture_TableOfReal_to_GaussianMixture_CEMM (Gaussia
 				lprev = lnew;
 				for (integer icomponent = 1; icomponent <= his numberOfComponents; icomponent ++) {
 
-					GaussianMixture_getResponsibilities (him.get(), probabilities.get(), icomponent, responsibilities.get());
+					GaussianMixture_getResponsibilities (him.get(), logProbabilities.get(), icomponent, responsibilities.get());
 					// Now check if enough support for a component exists
 					
 					const double componentSupport = NUMsum (responsibilities.column (icomponent)) - nparsd2;
@@ -1022,17 +1434,17 @@ autoGaussianMixture GaussianMixture_TableOfReal_to_GaussianMixture_CEMM (Gaussia
 
 					if (his mixingProbabilities [icomponent] > 0.0) {
 						// update probabilities for component
-						GaussianMixture_updateComponent (him.get(), icomponent, thy data.get(), responsibilities.get());
+						GaussianMixture_updateComponent (him.get(), icomponent, thy data.get(), responsibilities.column (icomponent));
 						//if (lambda > 0)
 						//	GaussianMixture_addCovarianceFraction (him.get(), icomponent, covg.get(), lambda);
-						GaussianMixture_TableOfReal_getComponentProbabilities (him.get(), thee, icomponent, probabilities.get());
+						GaussianMixture_getComponentLogProbabilities (him.get(), thy data.get(), icomponent, icomponent, logProbabilities.get());
 					} else {
 						/*
-							"Remove" the component from GaussianMixture, the probabilities and responsibilities
+							"Remove" the component from GaussianMixture and the responsibilities;
+							with a zero mixing probability it does not take part in the probabilities any more
 						*/
 						if (numberOfNonzeroComponents > minimumNumberOfComponents) {
 							numberOfNonzeroComponents --;
-							probabilities.column (icomponent) <<= 0.0;
 							responsibilities.column (icomponent) <<= 0.0;
 							MATnormalizeRows_inplace (responsibilities.get(), 1.0, 1.0); // Maintain invariant
 							if (info)
@@ -1044,7 +1456,7 @@ autoGaussianMixture GaussianMixture_TableOfReal_to_GaussianMixture_CEMM (Gaussia
 				// L(theta,Y)=N/2 sum(m=1..k, log(n*mixingP [m]/12))+k/2log(n/12)+k/2(N+1)-loglikelihood reduces to:
 				// k/2 (N+1){log(n/12)+1}+N/2sum(m=1..k,mixingP [m]) - loglikelihood
 
-				lnew = GaussianMixture_getLikelihoodValue (him.get(), probabilities.get(), criterion);
+				lnew = GaussianMixture_getLikelihoodValue (him.get(), logProbabilities.get(), criterion);
 				if (info)
 					MelderInfo_writeLine (U"iter = ", iter, U", ML = ", lnew);
 			} while (lnew > lprev && fabs ((lprev - lnew) / lnew) > tolerance && iter < maxNumberOfIterations);
@@ -1066,7 +1478,6 @@ autoGaussianMixture GaussianMixture_TableOfReal_to_GaussianMixture_CEMM (Gaussia
 				}
 				his mixingProbabilities [componentToDelete] = 0.0;
 				numberOfNonzeroComponents --;
-				probabilities.column (componentToDelete) <<= 0.0;
 				responsibilities.column (componentToDelete) <<= 0.0;
 				MATnormalizeRows_inplace (responsibilities.get(), 1.0, 1.0); // Maintain invariant
 				if (info)
@@ -96,6 +96,17 @@ autoGaussianMixture TableOfReal_to_GaussianMixture (TableOfReal me, integer numb
 
 void GaussianMixture_TableOfReal_improveLikelihood (GaussianMixture me, TableOfReal thee, double delta_lnp, integer maxNumberOfIterations, double lambda, kGaussianMixtureCriterion criterion);
 
+/*
+	Stepwise EM on batches of rows in random order (Cappé & Moulines 2009; Liang & Klein 2009).
+	The sufficient statistics are updated after every batch with a step size (step + 1)^-stepSizeExponent,
+	0.5 < stepSizeExponent <= 1, so that only one batch needs to be in memory at a time.
+	The folder version reads the TableOfReal or Matrix files with the given extension one at a time.
+*/
+void GaussianMixture_TableOfReal_improveLikelihood_miniBatch (GaussianMixture me, TableOfReal thee, integer batchSize, integer numberOfEpochs, double stepSizeExponent, double lambda);
+
+void GaussianMixture_improveLikelihood_miniBatchFromFolder (GaussianMixture me, conststring32 folderWithDataFiles, conststring32 dataFileExtension,
+	integer batchSize, integer numberOfEpochs, double stepSizeExponent, double lambda);
+
 /*
 	Learn a GaussiamMixture from multivariate data (unsupervised).
 	1) it is capable of selecting the number of components and 
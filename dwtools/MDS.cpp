@@ -36,6 +36,10 @@
 #include "Proximity_and_Distance.h"
 #include "SSCP.h"
 #include "PCA.h"
+#include "MAT_numerics.h"
+#include "MelderThread.h"
+
+#include <vector>
 
 #include "enums_getText.h"
 #undef _MDS_enums_h_
@@ -155,6 +159,58 @@ autoSimilarity DistanceList_to_Similarity_cc (DistanceList me, Weight w) {
 
 /***************** Transformator **********************************************/
 
+/*
+	Monotone regression of the distances on the proximities, into 'fit'; the pairs without a proximity
+	get the largest fitted value. 'distances' has one element per proximity. Does not allocate, so it can run in threads.
+*/
+static void MDSVec_monotoneRegression_into (MDSVec me, constMAT distance, kMDS_TiesHandling tiesHandling, VEC distances, MAT fit) {
+	const integer numberOfProximities = my numberOfProximities;
+	for (integer i = 1; i <= numberOfProximities; i ++)
+		distances [i] = distance [my rowIndex [i]] [my columnIndex [i]];
+
+	if (tiesHandling == kMDS_TiesHandling::PrimaryApproach || tiesHandling == kMDS_TiesHandling::SecondaryApproach) {
+		/*
+			Kruskal's primary approach to tie-blocks:
+				Sort corresponding distances, with rowIndex, and columnIndex.
+			Kruskal's secondary approach:
+				Substitute average distance in each tie block
+		*/
+		integer ib = 1;
+		for (integer i = 2; i <= numberOfProximities; i ++) {
+			if (my proximity [i] == my proximity [i - 1])
+				continue;
+			if (i - ib > 1) {
+				if (tiesHandling == kMDS_TiesHandling::PrimaryApproach) {
+					// all equal
+				} else if (tiesHandling == kMDS_TiesHandling::SecondaryApproach) {
+					const double mean = NUMmean (distances.part (ib, i - 1));
+					distances.part (ib, i - 1) <<= mean;
+				}
+			}
+			ib = i;
+		}
+	}
+
+	VECmonotoneRegression_inplace (distances);
+	/*
+		Fill Distance with monotone regressed distances
+	*/
+	fit <<= 0.0;
+	for (integer i = 1; i <= numberOfProximities; i ++) {
+		const integer irow = my rowIndex [i], icol = my columnIndex [i];
+		fit [irow] [icol] = fit [icol] [irow] = distances [i];
+	}
+	/*
+		Make rest of distances equal to the maximum fit.
+	*/
+	for (integer i = 1; i <= fit.nrow - 1; i ++) {
+		for (integer j = i + 1; j <= fit.ncol; j ++) {
+			if (fit [i] [j] == 0.0)
+				fit [i] [j] = fit [j] [i] = distances [numberOfProximities];
+		}
+	}
+}
+
 autoDistance structTransformator :: v_transform (MDSVec vec, Distance dist, Weight /* w */) {
 	try {
 		autoDistance thee = Distance_create (numberOfPoints);
@@ -173,6 +229,16 @@ autoDistance structTransformator :: v_transform (MDSVec vec, Distance dist, Weig
 	}
 }
 
+bool structTransformator :: v_transformInto (MDSVec vec, constMAT /* distance */, constMAT /* weight */, MAT fit, VEC /* workspace */) {
+	fit <<= 0.0;
+	for (integer i = 1; i <= vec -> numberOfProximities; i ++) {
+		const integer ii = vec -> rowIndex [i];
+		const integer jj = vec -> columnIndex [i];
+		fit [ii] [jj] = fit [jj] [ii] = vec -> proximity [i];
+	}
+	return true;
+}
+
 void Transformator_init (Transformator me, integer numberOfPoints) {
 	my numberOfPoints = numberOfPoints;
 	my normalization = 1;
@@ -200,29 +266,40 @@ autoDistance Transformator_transform (Transformator me, MDSVec vec, Distance d,
 	}
 }
 
-autoDistance structRatioTransformator :: v_transform (MDSVec vec, Distance d, Weight w) {
-	autoDistance thee = Distance_create (numberOfPoints);
-	TableOfReal_copyLabels (d, thee.get(), 1, 1);
+static void smacofNormalize (MAT distance, constMAT weight) {
+	longdouble sumsq = 0.0;
+	for (integer i = 1; i <= distance.nrow - 1; i ++)
+		for (integer j = i + 1; j <= distance.nrow; j ++)
+			sumsq += weight [i] [j] * distance [i] [j] * distance [i] [j];
 
-	// Determine ratio (eq. 9.4)
+	const double scale = sqrt (distance.nrow * (distance.nrow - 1) / double (2.0 * sumsq));
+	distance  *=  scale;
+}
 
+/*
+	The ratio of eq. 9.4; undefined if eta squared is zero.
+*/
+static double getRatio (MDSVec vec, constMAT distance, constMAT weight) {
 	longdouble etaSq = 0.0, rho = 0.0;
 	for (integer i = 1; i <= vec -> numberOfProximities; i ++) {
 		const integer ii = vec -> rowIndex [i];
 		const integer jj = vec -> columnIndex [i];
 		const double delta_ij = vec -> proximity [i];
-		const double d_ij = d -> data [ii] [jj];
-		const double tmp = w -> data [ii] [jj] * delta_ij * delta_ij;
+		const double d_ij = distance [ii] [jj];
+		const double tmp = weight [ii] [jj] * delta_ij * delta_ij;
 		etaSq += tmp;
 		rho += tmp * d_ij * d_ij;
 	}
+	return ( etaSq > 0.0 ? double (rho / etaSq) : undefined );
+}
 
-	// transform
+autoDistance structRatioTransformator :: v_transform (MDSVec vec, Distance d, Weight w) {
+	autoDistance thee = Distance_create (numberOfPoints);
+	TableOfReal_copyLabels (d, thee.get(), 1, 1);
 
-	Melder_require (etaSq > 0.0,
+	our ratio = getRatio (vec, d -> data.get(), w -> data.get());
+	Melder_require (isdefined (our ratio),
 		U"Eta squared should not be zero.");
-	
-	our ratio = rho / etaSq;
 	for (integer i = 1; i <= vec -> numberOfProximities; i ++) {
 		const integer ii = vec -> rowIndex [i];
 		const integer jj = vec -> columnIndex [i];
@@ -234,6 +311,21 @@ autoDistance structRatioTransformator :: v_transform (MDSVec vec, Distance d, We
 	return thee;
 }
 
+bool structRatioTransformator :: v_transformInto (MDSVec vec, constMAT distance, constMAT weight, MAT fit, VEC /* workspace */) {
+	const double localRatio = getRatio (vec, distance, weight);
+	if (isundef (localRatio))
+		return false;
+	fit <<= 0.0;
+	for (integer i = 1; i <= vec -> numberOfProximities; i ++) {
+		const integer ii = vec -> rowIndex [i];
+		const integer jj = vec -> columnIndex [i];
+		fit [ii] [jj] = fit [jj] [ii] = localRatio * vec -> proximity [i];
+	}
+	if (our normalization)
+		smacofNormalize (fit, weight);
+	return true;
+}
+
 autoRatioTransformator RatioTransformator_create (integer numberOfPoints) {
 	try {
 		autoRatioTransformator me = Thing_new (RatioTransformator);
@@ -255,6 +347,13 @@ autoDistance structMonotoneTransformator :: v_transform (MDSVec vec, Distance d,
 	}
 }
 
+bool structMonotoneTransformator :: v_transformInto (MDSVec vec, constMAT distance, constMAT weight, MAT fit, VEC workspace) {
+	MDSVec_monotoneRegression_into (vec, distance, tiesHandling, workspace, fit);
+	if (normalization)
+		smacofNormalize (fit, weight);
+	return true;
+}
+
 autoMonotoneTransformator MonotoneTransformator_create (integer numberOfPoints) {
 	try {
 		autoMonotoneTransformator me = Thing_new (MonotoneTransformator);
@@ -311,7 +410,7 @@ autoDistance structISplineTransformator :: v_transform (MDSVec vec, Distance dis
 		}
 	}
 
-	b = newVECsolveNonnegativeLeastSquaresRegression (m.get(), d.get(), tol, itermax, 0);
+	b = newVECsolveNonnegativeLeastSquaresRegression (m.get(), d.get(), itermax, tol, 0);
 
 	for (integer iprox = 1; iprox <= numberOfProximities; iprox ++) {
 		const integer ii = vec->rowIndex [iprox];
@@ -324,6 +423,10 @@ autoDistance structISplineTransformator :: v_transform (MDSVec vec, Distance dis
 	return thee;
 }
 
+bool structISplineTransformator :: v_transformInto (MDSVec /* vec */, constMAT /* distance */, constMAT /* weight */, MAT /* fit */, VEC /* workspace */) {
+	return false;   // the regression changes the spline coefficients and can fail
+}
+
 autoISplineTransformator ISplineTransformator_create (integer numberOfPoints, integer numberOfInteriorKnots, integer order) {
 	try {
 		autoISplineTransformator me = Thing_new (ISplineTransformator);
@@ -928,54 +1031,10 @@ autoDistance MDSVec_Distance_monotoneRegression (MDSVec me, Distance thee, kMDS_
 			U"The dimensions of the Distance and the MDSVec should agree.");
 		Melder_require (thy numberOfRows == my numberOfPoints,
 			U"Distance and MDSVVec dimensions should agreee.");
-		const integer numberOfProximities = my numberOfProximities;
-		autoVEC distances = newVECraw (numberOfProximities);
+		autoVEC distances = newVECraw (my numberOfProximities);
 		autoDistance him = Distance_create (thy numberOfRows);
 		TableOfReal_copyLabels (thee, him.get(), 1, 1);
-
-		for (integer i = 1; i <= numberOfProximities; i ++)
-			distances [i] = thy data [my rowIndex [i]] [my columnIndex [i]];
-
-		if (tiesHandling == kMDS_TiesHandling::PrimaryApproach || tiesHandling == kMDS_TiesHandling::SecondaryApproach) {
-			/*
-				Kruskal's primary approach to tie-blocks:
-					Sort corresponding distances, with rowIndex, and columnIndex.
-				Kruskal's secondary approach:
-					Substitute average distance in each tie block
-			*/
-			integer ib = 1;
-			for (integer i = 2; i <= numberOfProximities; i ++) {
-				if (my proximity [i] == my proximity [i - 1])
-					continue;
-				if (i - ib > 1) {
-					if (tiesHandling == kMDS_TiesHandling::PrimaryApproach) {
-						// all equal
-					} else if (tiesHandling == kMDS_TiesHandling::SecondaryApproach) {
-						const double mean = NUMmean (distances.part (ib, i - 1));
-						distances.part (ib, i - 1) <<= mean;
-					}
-				}
-				ib = i;
-			}
-		}
-
-		autoVEC fit = newVECmonotoneRegression (distances.get());
-		/*
-			Fill Distance with monotone regressed distances
-		*/
-		for (integer i = 1; i <= numberOfProximities; i ++) {
-			const integer irow = my rowIndex [i], icol = my columnIndex [i];
-			his data [irow] [icol] = his data [icol] [irow] = fit [i];
-		}
-		/*
-			Make rest of distances equal to the maximum fit.
-		*/
-		for (integer i = 1; i <= his numberOfRows - 1; i ++) {
-			for (integer j = i + 1; j <= his numberOfColumns; j ++) {
-				if (his data [i] [j] == 0.0)
-					his data [i] [j] = his data [j] [i] = fit [numberOfProximities];
-			}
-		}
+		MDSVec_monotoneRegression_into (me, thy data.get(), tiesHandling, distances.get(), his data.get());
 		return him;
 	} catch (MelderError) {
 		Melder_throw (U"Distance not created.");
@@ -1157,12 +1216,56 @@ autoDissimilarityList DistanceList_to_DissimilarityList (DistanceList me) {
 	}
 }
 
+/*
+	The rows of a symmetric matrix in an order that alternates short and long upper triangles (1, n, 2, n-1, ...),
+	so that equal stretches of items contain about equal numbers of pairs.
+*/
+static integer MDS_balancedRow (integer item, integer numberOfRows) {
+	return ( item % 2 == 1 ? (item + 1) / 2 : numberOfRows + 1 - item / 2 );
+}
+
+/*
+	The Minkowski distances between the rows of x, as in Configuration_to_Distance,
+	for the pairs in the upper triangles of the items firstItem .. lastItem in the order of MDS_balancedRow.
+*/
+static void MDS_getDistances (constMAT x, integer metric, constVEC dimensionWeights, MAT distance, integer firstItem, integer lastItem) {
+	const integer numberOfPoints = x.nrow;
+	for (integer item = firstItem; item <= lastItem; item ++) {
+		const integer i = MDS_balancedRow (item, numberOfPoints);
+		distance [i] [i] = 0.0;
+		VECminkowskiDistancesOfRow (distance.row (i).part (i + 1, numberOfPoints), x, i, metric, dimensionWeights);
+		for (integer j = i + 1; j <= numberOfPoints; j ++)
+			distance [j] [i] = distance [i] [j];
+	}
+}
+
 /*****************  Kruskal *****************************************/
 
+/*
+	The Moore-Penrose inverse of V (eq. 8.19). V is row and column centered and therefore: rank(V) <= nPoints-1,
+	so that V^-1 does not exist.
+*/
+static autoMAT smacof_getVplus (constMAT weight) {
+	const integer nPoints = weight.nrow;
+	autoMAT v = newMATraw (nPoints, nPoints);
+	for (integer irow = 1; irow <= nPoints; irow ++) {
+		longdouble wsum = 0.0;
+		for (integer icol = 1; icol <= nPoints; icol ++) {
+			if (irow != icol) {
+				v [irow] [icol] = - weight [irow] [icol];
+				wsum += weight [irow] [icol];
+			}
+		}
+		v [irow] [irow] = (double) wsum;
+	}
+	constexpr double tol = 1e-6;
+	return newMATpseudoInverse (v.get(), tol);
+}
+
 static void smacof_guttmanTransform (Configuration cx, Configuration cz, Distance disp, Weight weight, constMAT vplus) {
-	const integer nPoints = cx -> numberOfRows, nDimensions = cx -> numberOfColumns;
+	const integer nPoints = cx -> numberOfRows;
 
-	autoMAT b = newMATraw (nPoints, nPoints);
+	autoMAT b = newMATzero (nPoints, nPoints);
 	autoDistance distZ = Configuration_to_Distance (cz);
 	/*
 		compute B(Z) (eq. 8.25)
@@ -1179,19 +1282,10 @@ static void smacof_guttmanTransform (Configuration cx, Configuration cz, Distanc
 		b [i] [i] = - (double) sum;
 	}
 	/*
-		Guttman transform: Xu = (V+)B(Z)Z (eq. 8.29)
+		Guttman transform: Xu = (V+)B(Z)Z (eq. 8.29), as two matrix products
 	*/
-	for (integer i = 1; i <= nPoints; i ++) {
-		for (integer j = 1; j <= nDimensions; j ++) {
-			longdouble xij = 0.0;
-			for (integer k = 1;  k <= nPoints; k ++) {
-				for (integer l = 1; l <= nPoints; l ++) {
-					xij += vplus [i] [k] * b [k] [l] * cz -> data [l] [j];
-				}
-			}
-			cx -> data [i] [j] = (double) xij;
-		}
-	}
+	autoMAT bz = newMATmul (b.get(), cz -> data.get());
+	MATmul (cx -> data.get(), vplus, bz.get());
 }
 
 double Distance_Weight_stress (Distance fit, Distance conf, Weight weight, kMDS_stressMeasure stressMeasure) {
@@ -1249,14 +1343,13 @@ double Distance_Weight_stress (Distance fit, Distance conf, Weight weight, kMDS_
 	return stress;
 }
 
-void Distance_Weight_rawStressComponents (Distance fit, Distance conf, Weight weight, double *out_etafit, double *out_etaconf, double *out_rho)
-{
-	const integer nPoints = conf -> numberOfRows;
+static void getRawStressComponents (constMAT fit, constMAT conf, constMAT weight, double *out_etafit, double *out_etaconf, double *out_rho) {
+	const integer nPoints = conf.nrow;
 	longdouble etafit = 0.0, etaconf = 0.0, rho = 0.0;
 	for (integer i = 1; i <= nPoints - 1; i ++) {
-		constVEC wi = weight -> data.row (i);
-		constVEC fiti = fit -> data.row (i);
-		constVEC confi = conf -> data.row (i);
+		constVEC wi = weight.row (i);
+		constVEC fiti = fit.row (i);
+		constVEC confi = conf.row (i);
 		for (integer j = i + 1; j <= nPoints; j ++) {
 			etafit += wi [j] * fiti [j] * fiti [j];
 			etaconf += wi [j] * confi [j] * confi [j];
@@ -1271,6 +1364,11 @@ void Distance_Weight_rawStressComponents (Distance fit, Distance conf, Weight we
 		*out_rho = (double) rho;
 }
 
+void Distance_Weight_rawStressComponents (Distance fit, Distance conf, Weight weight, double *out_etafit, double *out_etaconf, double *out_rho)
+{
+	getRawStressComponents (fit -> data.get(), conf -> data.get(), weight -> data.get(), out_etafit, out_etaconf, out_rho);
+}
+
 double Dissimilarity_Configuration_Transformator_Weight_stress (Dissimilarity d, Configuration c, Transformator t, Weight w, kMDS_stressMeasure stressMeasure) {
 	const integer nPoints = d -> numberOfRows;
 	double stress = undefined;
@@ -1323,13 +1421,7 @@ double Dissimilarity_Configuration_Weight_ispline_stress (Dissimilarity d, Confi
 }
 
 void Distance_Weight_smacofNormalize (Distance me, Weight w) {
-	longdouble sumsq = 0.0;
-	for (integer i = 1; i <= my numberOfRows - 1; i ++)
-		for (integer j = i + 1; j <= my numberOfRows; j ++)
-			sumsq += w -> data [i] [j] * my data [i] [j] * my data [i] [j];
-
-	const double scale = sqrt (my numberOfRows * (my numberOfRows - 1) / double (2.0 * sumsq));
-	my data.all()  *=  scale;
+	smacofNormalize (my data.get(), w -> data.get());
 }
 
 double Distance_Weight_congruenceCoefficient (Distance x, Distance y, Weight w) {
@@ -1363,32 +1455,13 @@ autoConfiguration Dissimilarity_Configuration_Weight_Transformator_smacof (Dissi
 			aw = Weight_create (nPoints);
 			weight = aw.get();
 		}
-		autoMAT v = newMATraw (nPoints, nPoints);
 		autoConfiguration z = Data_copy (conf);
 		autoMDSVec vec = Dissimilarity_to_MDSVec (me);
 
 		if (showProgress)
 			Melder_progress (0.0, U"MDS analysis");
 
-		// Get V (eq. 8.19).
-
-		for (integer irow = 1; irow <= nPoints; irow ++) {
-			longdouble wsum = 0.0;
-			for (integer icol = 1; icol <= nPoints; icol ++) {
-				if (irow != icol) {
-					v [irow] [icol] = -  weight -> data [irow] [icol];
-					wsum +=  weight -> data [irow] [icol];
-				}
-			}
-			v [irow] [irow] = (double) wsum;
-		}
-
-		/*
-			V is row and column centered and therefore: rank(V) <= nPoints-1.
-			V^-1 does not exist -> get Moore-Penrose inverse.
-		*/
-		constexpr double tol = 1e-6;
-		autoMAT vplus = newMATpseudoInverse (v.get(), tol);
+		autoMAT vplus = smacof_getVplus (weight -> data.get());
 		double stressp = 1e308, stress = 0.0;
 		for (integer iter = 1; iter <= numberOfIterations; iter ++) {
 			autoDistance dist = Configuration_to_Distance (conf);
@@ -1431,28 +1504,188 @@ autoConfiguration Dissimilarity_Configuration_Weight_Transformator_smacof (Dissi
 	}
 }
 
+/*
+	The starting configuration of repetition 'run' (from 2 on) of multiSmacof: uniformly random and centred.
+	The random numbers depend only on the seed and the run, not on the thread that does the run.
+*/
+static void smacof_setRandomStart (MAT x, uint64 seed, integer run, int threadNumber) {
+	NUMrandom_initializeWithSeed_mt (threadNumber, seed + (uint64) run);
+	for (integer irow = 1; irow <= x.nrow; irow ++)
+		for (integer icol = 1; icol <= x.ncol; icol ++)
+			x [irow] [icol] = NUMrandomUniform_mt (threadNumber, -1.0, 1.0);
+	MATcentreEachColumn_inplace (x);
+}
+
+/*
+	SMACOF from several starting configurations, one after the other, within one thread;
+	the same iteration as Dissimilarity_Configuration_Weight_Transformator_smacof,
+	but without objects, so that several of these can run at the same time.
+*/
+struct SmacofRunner {
+	autoMAT x, z, bz, best;   // nPoints x nDimensions
+	autoMAT distance, fit;   // nPoints x nPoints
+	autoVEC workspace;   // one element per proximity
+	double bestStress = undefined;
+	integer bestRun = 0;
+	bool failed = false;
+
+	void init (integer nPoints, integer nDimensions, integer numberOfProximities) {
+		x = newMATraw (nPoints, nDimensions);
+		z = newMATraw (nPoints, nDimensions);
+		bz = newMATraw (nPoints, nDimensions);
+		best = newMATraw (nPoints, nDimensions);
+		distance = newMATraw (nPoints, nPoints);
+		fit = newMATraw (nPoints, nPoints);
+		workspace = newVECraw (numberOfProximities);
+	}
+
+	/*
+		Iterate from the configuration in x; the result is in z.
+	*/
+	bool run (Transformator t, MDSVec vec, constMAT weight, constMAT vplus, integer metric, constVEC dimensionWeights,
+		double tolerance, integer numberOfIterations, double *out_stress)
+	{
+		const integer nPoints = x.nrow, nDimensions = x.ncol;
+		z.all() <<= x.all();
+		MDS_getDistances (x.get(), metric, dimensionWeights, distance.get(), 1, nPoints);
+		double stressp = 1e308, stress = 0.0;
+		for (integer iter = 1; iter <= numberOfIterations; iter ++) {
+			if (! t -> v_transformInto (vec, distance.get(), weight, fit.get(), workspace.get()))
+				return false;
+			/*
+				Guttman transform: X = (V+)B(Z)Z (eq. 8.29), where the distances of Z are those of the current X,
+				and row i of B(Z)Z is sum over j of b [i] [j] (z [j] - z [i]) (eq. 8.25).
+			*/
+			for (integer i = 1; i <= nPoints; i ++) {
+				const VEC bzi = bz.row (i);
+				bzi <<= 0.0;
+				for (integer j = 1; j <= nPoints; j ++) {
+					const double dzij = distance [i] [j];
+					if (i == j || dzij == 0.0)
+						continue;
+					const double bij = - weight [i] [j] * fit [i] [j] / dzij;
+					for (integer k = 1; k <= nDimensions; k ++)
+						bzi [k] += bij * (z [j] [k] - z [i] [k]);
+				}
+			}
+			MATmul (x.get(), vplus, bz.get());
+			MDS_getDistances (x.get(), metric, dimensionWeights, distance.get(), 1, nPoints);
+			double etafit, etaconf, rho;
+			getRawStressComponents (fit.get(), distance.get(), weight, & etafit, & etaconf, & rho);
+			stress = ( etafit * etaconf > 0.0 ? 1.0 - rho * rho / (etafit * etaconf) : undefined );
+			if (fabs (stress - stressp) / stressp < tolerance)
+				break;
+			z.all() <<= x.all();
+			stressp = stress;
+		}
+		*out_stress = stress;
+		return true;
+	}
+};
+
 autoConfiguration Dissimilarity_Configuration_Weight_Transformator_multiSmacof (Dissimilarity me, Configuration conf,  Weight w, Transformator t, double tolerance, integer numberOfIterations, integer numberOfRepetitions, bool showProgress) {
 	bool showMulti = showProgress && numberOfRepetitions > 1;
 	try {
 		const bool showSingle = showProgress && numberOfRepetitions == 1;
-		autoConfiguration cstart = Data_copy (conf);
-		autoConfiguration  cbest = Data_copy (conf);
+		if (numberOfRepetitions == 1)
+			return Dissimilarity_Configuration_Weight_Transformator_smacof (me, conf, w, t, tolerance, numberOfIterations, showSingle, nullptr);
+
+		const integer nPoints = conf -> numberOfRows, nDimensions = conf -> numberOfColumns;
+		Melder_require (my numberOfRows == nPoints && t -> numberOfPoints == nPoints && (! w || w -> numberOfRows == nPoints),
+			U"Dimensions should agree.");
+		autoWeight aw;
+		if (! w) {
+			aw = Weight_create (nPoints);
+			w = aw.get();
+		}
+		/*
+			The repetitions from 2 on start from random configurations, each from its own seed,
+			so that the result does not depend on how the repetitions are divided over threads.
+		*/
+		const uint64 seed = (uint64 (NUMrandomFraction () * 4294967296.0) << 32) | uint64 (NUMrandomFraction () * 4294967296.0);
 
 		if (showMulti)
 			Melder_progress (0.0, U"MDS many times");
 
-		double stress, stressmax = 1e308;
-		for (integer i = 1; i <= numberOfRepetitions; i ++) {
-			autoConfiguration cresult = Dissimilarity_Configuration_Weight_Transformator_smacof (me, cstart.get(), w, t, tolerance, numberOfIterations, showSingle, &stress);
-			if (stress < stressmax) {
-				stressmax = stress;
-				cbest = cresult.move();
+		autoConfiguration cbest = Data_copy (conf);
+		autoMDSVec vec = Dissimilarity_to_MDSVec (me);
+		autoMAT vplus = smacof_getVplus (w -> data.get());
+		/*
+			Transformators that can work without objects have the repetitions run at the same time.
+			Each thread needs two nPoints x nPoints matrices; let them take no more than about a gigabyte.
+		*/
+		SmacofRunner probe;
+		probe.init (nPoints, nDimensions, vec -> numberOfProximities);
+		MDS_getDistances (conf -> data.get(), conf -> metric, conf -> w.get(), probe.distance.get(), 1, nPoints);
+		if (t -> v_transformInto (vec.get(), probe.distance.get(), w -> data.get(), probe.fit.get(), probe.workspace.get())) {
+			integer numberOfThreads = MelderThread_getNumberOfThreads (numberOfRepetitions,
+					double (numberOfRepetitions) * numberOfIterations * nPoints * nPoints * nDimensions);
+			const double numberOfBytesPerThread = 2.0 * nPoints * nPoints * sizeof (double);
+			numberOfThreads = std::max (integer (1), std::min (numberOfThreads, integer (1e9 / numberOfBytesPerThread)));
+			std::vector <SmacofRunner> runners ((size_t) numberOfThreads);
+			runners [0] = std::move (probe);
+			for (integer ithread = 1; ithread < numberOfThreads; ithread ++)
+				runners [(size_t) ithread]. init (nPoints, nDimensions, vec -> numberOfProximities);
+			/*
+				One repetition per thread at a time, so that the progress window can be updated,
+				and the user can cancel, from this (the main) thread after every batch of repetitions.
+			*/
+			for (integer firstRunOfBatch = 1; firstRunOfBatch <= numberOfRepetitions; firstRunOfBatch += numberOfThreads) {
+				const integer numberOfRunsInBatch = std::min (numberOfThreads, numberOfRepetitions - firstRunOfBatch + 1);
+				MelderThread_runStretches (numberOfRunsInBatch, numberOfRunsInBatch,
+					[&] (integer ithread, integer firstRunInBatch, integer lastRunInBatch) {
+						SmacofRunner& runner = runners [(size_t) ithread];
+						for (integer irun = firstRunOfBatch + firstRunInBatch - 1; irun <= firstRunOfBatch + lastRunInBatch - 1; irun ++) {
+							if (irun == 1)
+								runner.x.all() <<= conf -> data.all();
+							else
+								smacof_setRandomStart (runner.x.get(), seed, irun, int (ithread + 1));
+							double stress;
+							if (! runner.run (t, vec.get(), w -> data.get(), vplus.get(), conf -> metric, conf -> w.get(),
+								tolerance, numberOfIterations, & stress))
+							{
+								runner.failed = true;
+								return;
+							}
+							if (runner.bestRun == 0 || stress < runner.bestStress) {   // the earliest run of equal stresses
+								runner.bestStress = stress;
+								runner.bestRun = irun;
+								runner.best.all() <<= runner.z.all();
+							}
+						}
+					}
+				);
+				for (const SmacofRunner& runner : runners)
+					Melder_require (! runner.failed,
+						U"The dissimilarities could not be transformed.");
+				if (showMulti) {
+					const integer lastRunOfBatch = firstRunOfBatch + numberOfRunsInBatch - 1;
+					Melder_progress ((double) lastRunOfBatch / (numberOfRepetitions + 1), lastRunOfBatch, U" from ", numberOfRepetitions);
+				}
+			}
+			const SmacofRunner *bestRunner = nullptr;
+			for (const SmacofRunner& runner : runners)
+				if (runner.bestRun > 0 && (! bestRunner || runner.bestStress < bestRunner -> bestStress ||
+					runner.bestStress == bestRunner -> bestStress && runner.bestRun < bestRunner -> bestRun))   // the earliest run of equal stresses
+				{
+					bestRunner = & runner;
+				}
+			Melder_assert (bestRunner);
+			cbest -> data.all() <<= bestRunner -> best.all();
+		} else {
+			autoConfiguration cstart = Data_copy (conf);
+			double stress, stressmax = 1e308;
+			for (integer irun = 1; irun <= numberOfRepetitions; irun ++) {
+				if (irun > 1)
+					smacof_setRandomStart (cstart -> data.get(), seed, irun, 1);
+				autoConfiguration cresult = Dissimilarity_Configuration_Weight_Transformator_smacof (me, cstart.get(), w, t, tolerance, numberOfIterations, false, & stress);
+				if (stress < stressmax) {
+					stressmax = stress;
+					cbest = cresult.move();
+				}
+				if (showMulti)
+					Melder_progress ((double) irun / (numberOfRepetitions + 1), irun, U" from ", numberOfRepetitions);
 			}
-			Configuration_randomize (cstart.get());
-			TableOfReal_centreColumns (cstart.get());
-
-			if (showMulti)
-				Melder_progress ((double) i / (numberOfRepetitions + 1), i, U" from ", numberOfRepetitions);
 		}
 		if (showMulti)
 			Melder_progress (1.0);
@@ -1460,7 +1693,399 @@ autoConfiguration Dissimilarity_Configuration_Weight_Transformator_multiSmacof (
 	} catch (MelderError) {
 		if (showMulti)
 			Melder_progress (1.0);
-		Melder_throw (me, U": no improved Configuration created (smacodf method).");
+		Melder_throw (me, U": no improved Configuration created (smacof method).");
+	}
+}
+
+/********************** Sparse and landmark SMACOF *****************************/
+
+/*
+	Dissimilarities that are known for only some of the pairs of points, stored as compressed rows:
+	the neighbours of point i are in the positions rowStart [i] .. rowStart [i + 1] - 1.
+	Every pair is stored in the rows of both its points, so that the rows can be handled independently.
+*/
+struct SparseDissimilarities {
+	integer numberOfPoints = 0;
+	autoINTVEC rowStart, neighbour;
+	autoVEC dissimilarity, weight;
+};
+
+static void SparseDissimilarities_initFromTable (SparseDissimilarities *me, Table table,
+	conststring32 firstPointColumnLabel, conststring32 secondPointColumnLabel,
+	conststring32 dissimilarityColumnLabel, conststring32 weightColumnLabel)
+{
+	const integer firstPointColumn = Table_getColumnIndexFromColumnLabel (table, firstPointColumnLabel);
+	const integer secondPointColumn = Table_getColumnIndexFromColumnLabel (table, secondPointColumnLabel);
+	const integer dissimilarityColumn = Table_getColumnIndexFromColumnLabel (table, dissimilarityColumnLabel);
+	const integer weightColumn = ( weightColumnLabel && weightColumnLabel [0] != U'\0' ?
+			Table_getColumnIndexFromColumnLabel (table, weightColumnLabel) : 0 );
+	const integer numberOfRows = table -> rows.size;
+	Melder_require (numberOfRows > 0,
+		U"The table should contain dissimilarities.");
+	autoINTVEC first = newINTVECraw (numberOfRows), second = newINTVECraw (numberOfRows);
+	integer numberOfPoints = 0;
+	for (integer irow = 1; irow <= numberOfRows; irow ++) {
+		const double point1 = Table_getNumericValue_Assert (table, irow, firstPointColumn);
+		const double point2 = Table_getNumericValue_Assert (table, irow, secondPointColumn);
+		Melder_require (isdefined (point1) && point1 >= 1.0 && point1 == round (point1) &&
+				isdefined (point2) && point2 >= 1.0 && point2 == round (point2),
+			U"Row ", irow, U": the point numbers should be positive integers.");
+		const double dissimilarity = Table_getNumericValue_Assert (table, irow, dissimilarityColumn);
+		Melder_require (isdefined (dissimilarity) && dissimilarity >= 0.0,
+			U"Row ", irow, U": the dissimilarity should be defined and not negative.");
+		if (weightColumn != 0) {
+			const double weight = Table_getNumericValue_Assert (table, irow, weightColumn);
+			Melder_require (isdefined (weight) && weight >= 0.0,
+				U"Row ", irow, U": the weight should be defined and not negative.");
+		}
+		first [irow] = integer (point1);
+		second [irow] = integer (point2);
+		numberOfPoints = std::max (numberOfPoints, std::max (first [irow], second [irow]));
+	}
+	/*
+		Count the neighbours of each point, then fill the rows.
+	*/
+	my numberOfPoints = numberOfPoints;
+	my rowStart = newINTVECzero (numberOfPoints + 1);
+	for (integer irow = 1; irow <= numberOfRows; irow ++)
+		if (first [irow] != second [irow]) {
+			my rowStart [first [irow]] ++;
+			my rowStart [second [irow]] ++;
+		}
+	integer position = 1;
+	for (integer ipoint = 1; ipoint <= numberOfPoints; ipoint ++) {
+		Melder_require (my rowStart [ipoint] > 0,
+			U"Point ", ipoint, U" has no dissimilarities with other points.");
+		const integer numberOfNeighbours = my rowStart [ipoint];
+		my rowStart [ipoint] = position;
+		position += numberOfNeighbours;
+	}
+	my rowStart [numberOfPoints + 1] = position;
+	const integer numberOfEntries = position - 1;
+	my neighbour = newINTVECraw (numberOfEntries);
+	my dissimilarity = newVECraw (numberOfEntries);
+	my weight = newVECraw (numberOfEntries);
+	autoINTVEC fill = newINTVECcopy (my rowStart.part (1, numberOfPoints));
+	for (integer irow = 1; irow <= numberOfRows; irow ++) {
+		const integer point1 = first [irow], point2 = second [irow];
+		if (point1 == point2)
+			continue;
+		const double dissimilarity = Table_getNumericValue_Assert (table, irow, dissimilarityColumn);
+		const double weight = ( weightColumn != 0 ? Table_getNumericValue_Assert (table, irow, weightColumn) : 1.0 );
+		const integer position1 = fill [point1] ++, position2 = fill [point2] ++;
+		my neighbour [position1] = point2;
+		my neighbour [position2] = point1;
+		my dissimilarity [position1] = my dissimilarity [position2] = dissimilarity;
+		my weight [position1] = my weight [position2] = weight;
+	}
+}
+
+static integer SparseDissimilarities_getNumberOfThreads (SparseDissimilarities *me, double numberOfOperationsPerEntry) {
+	return MelderThread_getNumberOfThreads (my numberOfPoints, numberOfOperationsPerEntry * my neighbour.size);
+}
+
+/*
+	y = B(x) x, where B(x) is the sum over the pairs of w δ / d(x) (e_i - e_j)(e_i - e_j)' (eq. 8.25);
+	rowStress [i] receives the sum of w (δ - d(x))^2 over the pairs of point i.
+*/
+static void SparseDissimilarities_multiplyByB (SparseDissimilarities *me, constMAT const& x, MAT const& y, VEC const& rowStress) {
+	MelderThread_runStretches (SparseDissimilarities_getNumberOfThreads (me, 4.0 * x.ncol), my numberOfPoints,
+		[&] (integer /* ithread */, integer firstPoint, integer lastPoint) {
+			for (integer ipoint = firstPoint; ipoint <= lastPoint; ipoint ++) {
+				const constVEC xi = x.row (ipoint);
+				const VEC yi = y.row (ipoint);
+				yi  <<=  0.0;
+				double stress = 0.0;
+				for (integer k = my rowStart [ipoint]; k < my rowStart [ipoint + 1]; k ++) {
+					const constVEC xj = x.row (my neighbour [k]);
+					double dsq = 0.0;
+					for (integer idim = 1; idim <= x.ncol; idim ++)
+						dsq += (xi [idim] - xj [idim]) * (xi [idim] - xj [idim]);
+					const double d = sqrt (dsq), delta = my dissimilarity [k], w = my weight [k];
+					stress += w * (delta - d) * (delta - d);
+					if (d == 0.0)
+						continue;
+					const double b = w * delta / d;
+					for (integer idim = 1; idim <= x.ncol; idim ++)
+						yi [idim] += b * (xi [idim] - xj [idim]);
+				}
+				rowStress [ipoint] = stress;
+			}
+		}
+	);
+}
+
+/*
+	y = V x, where V is the sum over the pairs of w (e_i - e_j)(e_i - e_j)' (eq. 8.19).
+*/
+static void SparseDissimilarities_multiplyByV (SparseDissimilarities *me, constMAT const& x, MAT const& y) {
+	MelderThread_runStretches (SparseDissimilarities_getNumberOfThreads (me, 2.0 * x.ncol), my numberOfPoints,
+		[&] (integer /* ithread */, integer firstPoint, integer lastPoint) {
+			for (integer ipoint = firstPoint; ipoint <= lastPoint; ipoint ++) {
+				const constVEC xi = x.row (ipoint);
+				const VEC yi = y.row (ipoint);
+				yi  <<=  0.0;
+				for (integer k = my rowStart [ipoint]; k < my rowStart [ipoint + 1]; k ++) {
+					const constVEC xj = x.row (my neighbour [k]);
+					const double w = my weight [k];
+					for (integer idim = 1; idim <= x.ncol; idim ++)
+						yi [idim] += w * (xi [idim] - xj [idim]);
+				}
+			}
+		}
+	);
+}
+
+/*
+	Solve V x = rhs with conjugate gradients, each column on its own, starting from the x that is given.
+	V is singular (its rows sum to zero), but rhs is centred and so is x, which keeps the iteration
+	in the space where V is positive definite; V^+ is never formed.
+*/
+static void SparseDissimilarities_solveV (SparseDissimilarities *me, MAT const& x, constMAT const& rhs,
+	integer maximumNumberOfIterations, MAT const& residual, MAT const& direction, MAT const& vDirection)
+{
+	MATcentreEachColumn_inplace (x);
+	SparseDissimilarities_multiplyByV (me, x, vDirection);
+	residual  <<=  rhs;
+	residual  -=  vDirection;
+	direction  <<=  residual;
+	const integer numberOfDimensions = x.ncol;
+	autoVEC residualNormSquared = newVECraw (numberOfDimensions), rhsNormSquared = newVECraw (numberOfDimensions);
+	for (integer idim = 1; idim <= numberOfDimensions; idim ++) {
+		residualNormSquared [idim] = NUMsum2 (residual.column (idim));
+		rhsNormSquared [idim] = NUMsum2 (rhs.column (idim));
+	}
+	for (integer iter = 1; iter <= maximumNumberOfIterations; iter ++) {
+		bool converged = true;
+		for (integer idim = 1; idim <= numberOfDimensions; idim ++)
+			if (residualNormSquared [idim] > 1e-12 * rhsNormSquared [idim])
+				converged = false;
+		if (converged)
+			break;
+		SparseDissimilarities_multiplyByV (me, direction, vDirection);
+		for (integer idim = 1; idim <= numberOfDimensions; idim ++) {
+			const double curvature = NUMinner (direction.column (idim), vDirection.column (idim));
+			if (curvature <= 0.0)
+				continue;
+			const double alpha = residualNormSquared [idim] / curvature;
+			for (integer ipoint = 1; ipoint <= x.nrow; ipoint ++) {
+				x [ipoint] [idim] += alpha * direction [ipoint] [idim];
+				residual [ipoint] [idim] -= alpha * vDirection [ipoint] [idim];
+			}
+			const double newResidualNormSquared = NUMsum2 (residual.column (idim));
+			const double beta = newResidualNormSquared / residualNormSquared [idim];
+			residualNormSquared [idim] = newResidualNormSquared;
+			for (integer ipoint = 1; ipoint <= x.nrow; ipoint ++)
+				direction [ipoint] [idim] = residual [ipoint] [idim] + beta * direction [ipoint] [idim];
+		}
+	}
+}
+
+/*
+	Dijkstra's algorithm for the lengths of the shortest paths from one point to all others,
+	with the dissimilarities as the lengths of the edges; points that cannot be reached get infinity.
+	heap and heapPosition are workspaces of numberOfPoints elements; heapPosition is 0 for points
+	that have not been seen yet and -1 for points whose distance is final.
+*/
+static void SparseDissimilarities_getShortestPaths (SparseDissimilarities *me, integer source, VECVU const& distance,
+	INTVEC const& heap, INTVEC const& heapPosition) noexcept
+{
+	distance  <<=  std::numeric_limits <double>::infinity ();
+	for (integer ipoint = 1; ipoint <= heapPosition.size; ipoint ++)
+		heapPosition [ipoint] = 0;
+	integer heapSize = 0;
+	auto siftUp = [&] (integer position) {
+		const integer point = heap [position];
+		while (position > 1 && distance [heap [position / 2]] > distance [point]) {
+			heap [position] = heap [position / 2];
+			heapPosition [heap [position]] = position;
+			position /= 2;
+		}
+		heap [position] = point;
+		heapPosition [point] = position;
+	};
+	auto siftDown = [&] (integer position) {
+		const integer point = heap [position];
+		for (;;) {
+			integer child = 2 * position;
+			if (child > heapSize)
+				break;
+			if (child < heapSize && distance [heap [child + 1]] < distance [heap [child]])
+				child ++;
+			if (distance [heap [child]] >= distance [point])
+				break;
+			heap [position] = heap [child];
+			heapPosition [heap [position]] = position;
+			position = child;
+		}
+		heap [position] = point;
+		heapPosition [point] = position;
+	};
+	distance [source] = 0.0;
+	heap [++ heapSize] = source;
+	heapPosition [source] = heapSize;
+	while (heapSize > 0) {
+		const integer point = heap [1];
+		heapPosition [point] = -1;
+		heap [1] = heap [heapSize --];
+		if (heapSize > 0)
+			siftDown (1);
+		for (integer k = my rowStart [point]; k < my rowStart [point + 1]; k ++) {
+			const integer other = my neighbour [k];
+			if (heapPosition [other] < 0)
+				continue;
+			const double newDistance = distance [point] + my dissimilarity [k];
+			if (newDistance >= distance [other])
+				continue;
+			distance [other] = newDistance;
+			if (heapPosition [other] == 0)
+				heap [heapPosition [other] = ++ heapSize] = other;
+			siftUp (heapPosition [other]);
+		}
+	}
+}
+
+/*
+	Landmark MDS (De Silva & Tenenbaum 2004): classical MDS on the shortest-path distances
+	between a random set of landmarks, after which every point is placed by its distances to the landmarks.
+*/
+static void SparseDissimilarities_getLandmarkConfiguration (SparseDissimilarities *me, integer numberOfLandmarks, MAT const& x) {
+	const integer numberOfPoints = my numberOfPoints;
+	numberOfLandmarks = std::min (numberOfLandmarks, numberOfPoints);
+	autoINTVEC landmarks = newINTVECraw (numberOfPoints);
+	for (integer ipoint = 1; ipoint <= numberOfPoints; ipoint ++)
+		landmarks [ipoint] = ipoint;
+	for (integer ilandmark = 1; ilandmark <= numberOfLandmarks; ilandmark ++)
+		std::swap (landmarks [ilandmark], landmarks [NUMrandomInteger (ilandmark, numberOfPoints)]);
+	/*
+		The shortest paths from each landmark, the landmarks divided over the threads.
+	*/
+	autoMAT landmarkDistances = newMATraw (numberOfLandmarks, numberOfPoints);
+	const integer numberOfThreads = MelderThread_getNumberOfThreads (numberOfLandmarks,
+			double (numberOfLandmarks) * double (my neighbour.size) * (1.0 + log2 (numberOfPoints)));
+	autoINTMAT heaps = newINTMATraw (numberOfThreads, numberOfPoints), heapPositions = newINTMATraw (numberOfThreads, numberOfPoints);
+	MelderThread_runStretches (numberOfThreads, numberOfLandmarks,
+		[&] (integer ithread, integer firstLandmark, integer lastLandmark) {
+			for (integer ilandmark = firstLandmark; ilandmark <= lastLandmark; ilandmark ++)
+				SparseDissimilarities_getShortestPaths (me, landmarks [ilandmark], landmarkDistances.row (ilandmark),
+						heaps.row (ithread + 1), heapPositions.row (ithread + 1));
+		}
+	);
+	for (integer ilandmark = 1; ilandmark <= numberOfLandmarks; ilandmark ++) {
+		/*
+			Points in another component than the landmark are put at the largest distance that was found.
+		*/
+		const VEC distances = landmarkDistances.row (ilandmark);
+		double maximum = 0.0;
+		for (integer ipoint = 1; ipoint <= numberOfPoints; ipoint ++)
+			if (isfinite (distances [ipoint]))
+				maximum = std::max (maximum, distances [ipoint]);
+		for (integer ipoint = 1; ipoint <= numberOfPoints; ipoint ++)
+			distances [ipoint] = ( isfinite (distances [ipoint]) ? distances [ipoint] * distances [ipoint] : maximum * maximum );
+	}
+	/*
+		Classical MDS of the landmarks: the double-centred -1/2 D^2.
+	*/
+	autoMAT scalarProducts = newMATraw (numberOfLandmarks, numberOfLandmarks);
+	for (integer i = 1; i <= numberOfLandmarks; i ++)
+		for (integer j = 1; j <= numberOfLandmarks; j ++)
+			scalarProducts [i] [j] = -0.25 * (landmarkDistances [i] [landmarks [j]] + landmarkDistances [j] [landmarks [i]]);
+	autoVEC meanSquaredDistance = newVECcolumnMeans (scalarProducts.get());
+	meanSquaredDistance.all()  *=  -2.0;
+	MATdoubleCentre_inplace (scalarProducts.get());
+	autoMAT eigenvectors;
+	autoVEC eigenvalues;
+	MAT_getEigenSystemFromSymmetricMatrix (scalarProducts.get(), & eigenvectors, & eigenvalues, false);
+	/*
+		Place every point (the landmarks included) by its squared distances to the landmarks (eq. 4 of De Silva & Tenenbaum):
+			x [i] [k] = -1/2 sum over landmarks l of v [k] [l] / sqrt (lambda [k]) * (delta [l] [i]^2 - mean over landmarks of delta [l]^2)
+	*/
+	x  <<=  0.0;
+	for (integer idim = 1; idim <= std::min (x.ncol, numberOfLandmarks); idim ++) {
+		if (eigenvalues [idim] <= 0.0)
+			continue;
+		const double scale = -0.5 / sqrt (eigenvalues [idim]);
+		for (integer ilandmark = 1; ilandmark <= numberOfLandmarks; ilandmark ++) {
+			const double factor = scale * eigenvectors [idim] [ilandmark];
+			const constVEC squaredDistances = landmarkDistances.row (ilandmark);
+			for (integer ipoint = 1; ipoint <= numberOfPoints; ipoint ++)
+				x [ipoint] [idim] += factor * (squaredDistances [ipoint] - meanSquaredDistance [ilandmark]);
+		}
+	}
+	/*
+		Dimensions that the landmarks do not span get small random coordinates, so that SMACOF can use them.
+	*/
+	const double spread = 1e-3 * sqrt (NUMmean (meanSquaredDistance.all()));
+	for (integer idim = 1; idim <= x.ncol; idim ++)
+		if (idim > numberOfLandmarks || eigenvalues [idim] <= 0.0)
+			for (integer ipoint = 1; ipoint <= numberOfPoints; ipoint ++)
+				x [ipoint] [idim] = NUMrandomGauss (0.0, spread);
+}
+
+autoConfiguration Table_to_Configuration_sparseMds (Table me,
+	conststring32 firstPointColumnLabel, conststring32 secondPointColumnLabel,
+	conststring32 dissimilarityColumnLabel, conststring32 weightColumnLabel,
+	integer numberOfDimensions, integer numberOfLandmarks, double tolerance, integer numberOfIterations,
+	bool showProgress, double *out_stress)
+{
+	try {
+		SparseDissimilarities sparse;
+		SparseDissimilarities_initFromTable (& sparse, me, firstPointColumnLabel, secondPointColumnLabel,
+				dissimilarityColumnLabel, weightColumnLabel);
+		const integer numberOfPoints = sparse.numberOfPoints;
+		Melder_require (numberOfDimensions < numberOfPoints,
+			U"The number of dimensions should be less than the number of points (", numberOfPoints, U").");
+		Melder_require (numberOfLandmarks == 0 || numberOfLandmarks > numberOfDimensions,
+			U"The number of landmarks should be zero or larger than the number of dimensions.");
+		double sumOfWeightedSquares = 0.0;
+		for (integer k = 1; k <= sparse.neighbour.size; k ++)
+			sumOfWeightedSquares += sparse.weight [k] * sparse.dissimilarity [k] * sparse.dissimilarity [k];
+		Melder_require (sumOfWeightedSquares > 0.0,
+			U"There should be positive dissimilarities with positive weights.");
+
+		autoConfiguration thee = Configuration_create (numberOfPoints, numberOfDimensions);
+		const MAT x = thy data.get();
+		if (numberOfLandmarks > 0)
+			SparseDissimilarities_getLandmarkConfiguration (& sparse, numberOfLandmarks, x);
+		else
+			Configuration_randomize (thee.get());
+
+		autoMAT bx = newMATraw (numberOfPoints, numberOfDimensions);
+		autoMAT residual = newMATraw (numberOfPoints, numberOfDimensions);
+		autoMAT direction = newMATraw (numberOfPoints, numberOfDimensions);
+		autoMAT vDirection = newMATraw (numberOfPoints, numberOfDimensions);
+		autoVEC rowStress = newVECraw (numberOfPoints);
+		constexpr integer numberOfConjugateGradientIterations = 10;
+		if (showProgress)
+			Melder_progress (0.0, U"Sparse MDS");
+		double stress = undefined, previousStress = undefined;
+		for (integer iter = 1; iter <= numberOfIterations + 1; iter ++) {
+			/*
+				The stress of the current configuration comes for free with B(X) X.
+			*/
+			SparseDissimilarities_multiplyByB (& sparse, x, bx.get(), rowStress.get());
+			stress = NUMsum (rowStress.all()) / sumOfWeightedSquares;   // every pair twice in both sums
+			if (iter > numberOfIterations ||
+				(isdefined (previousStress) && previousStress - stress <= tolerance * previousStress))
+				break;
+			/*
+				Guttman transform: solve V X = B(Z) Z, starting from Z.
+			*/
+			SparseDissimilarities_solveV (& sparse, x, bx.get(), numberOfConjugateGradientIterations,
+					residual.get(), direction.get(), vDirection.get());
+			previousStress = stress;
+			if (showProgress)
+				Melder_progress ((double) iter / (numberOfIterations + 1), U"Sparse MDS: stress ", stress);
+		}
+		if (showProgress)
+			Melder_progress (1.0);
+		if (out_stress)
+			*out_stress = stress;
+		return thee;
+	} catch (MelderError) {
+		if (showProgress)
+			Melder_progress (1.0);
+		Melder_throw (me, U": no Configuration created (sparse mds).");
 	}
 }
 
@@ -1757,7 +2382,12 @@ static double func (Daata object, VEC const& p) {
 	/*
 		Calculate interpoint distances from the configuration
 	*/
-	autoDistance dist = Configuration_to_Distance (my configuration.get());
+	autoDistance dist = Distance_create (numberOfPoints);
+	MelderThread_runStretches (MelderThread_getNumberOfThreads (numberOfPoints, 1.5 * numberOfPoints * numberOfPoints * numberOfDimensions),
+		numberOfPoints, [&] (integer /* ithread */, integer firstItem, integer lastItem) {
+			MDS_getDistances (x, my configuration -> metric, my configuration -> w.get(), dist -> data.get(), firstItem, lastItem);
+		}
+	);
 	/*
 		Monotone regression
 	*/
@@ -1770,19 +2400,33 @@ static double func (Daata object, VEC const& p) {
 		Prevent overflow when stress is small
 	*/
 	if (stress >= 1e-6) {
-		my dx.get() <<= 0.0;
-		for (integer i = 1; i <= his numberOfProximities; i ++) {
-			const integer ii = my vec -> rowIndex [i], jj = my vec -> columnIndex [i];
-			const double g1 = stress * ((dist -> data [ii] [jj] - fit -> data [ii] [jj]) / s - (dist -> data [ii] [jj] - dbar) / t);
-			for (integer j = 1; j <= numberOfDimensions; j ++) {
-				const double dj = x [ii] [j] - x [jj] [j];
-				double g2 = g1 * pow (fabs (dj) / dist -> data [ii] [jj], my configuration -> metric - 1.0);
-				if (dj < 0.0)
-					g2 = -g2;
-				my dx [ii] [j] += g2;
-				my dx [jj] [j] -= g2;
+		/*
+			Every thread adds the gradients of its stretch of proximities into its own copy of dx;
+			the copies are summed afterwards.
+		*/
+		const integer numberOfThreads = MelderThread_getNumberOfThreads (his numberOfProximities,
+				10.0 * his numberOfProximities * numberOfDimensions);
+		autoMAT partialGradients = newMATzero (numberOfThreads * numberOfPoints, numberOfDimensions);
+		MelderThread_runStretches (numberOfThreads, his numberOfProximities,
+			[&] (integer ithread, integer firstProximity, integer lastProximity) {
+				const MATVU dx = partialGradients.horizontalBand (ithread * numberOfPoints + 1, (ithread + 1) * numberOfPoints);
+				for (integer i = firstProximity; i <= lastProximity; i ++) {
+					const integer ii = my vec -> rowIndex [i], jj = my vec -> columnIndex [i];
+					const double g1 = stress * ((dist -> data [ii] [jj] - fit -> data [ii] [jj]) / s - (dist -> data [ii] [jj] - dbar) / t);
+					for (integer j = 1; j <= numberOfDimensions; j ++) {
+						const double dj = x [ii] [j] - x [jj] [j];
+						double g2 = g1 * pow (fabs (dj) / dist -> data [ii] [jj], my configuration -> metric - 1.0);
+						if (dj < 0.0)
+							g2 = -g2;
+						dx [ii] [j] += g2;
+						dx [jj] [j] -= g2;
+					}
+				}
 			}
-		}
+		);
+		my dx.all() <<= partialGradients.horizontalBand (1, numberOfPoints);
+		for (integer ithread = 1; ithread < numberOfThreads; ithread ++)
+			my dx.all()  +=  partialGradients.horizontalBand (ithread * numberOfPoints + 1, (ithread + 1) * numberOfPoints);
 	}
 	(my minimizer -> numberOfFunctionCalls) ++;
 	return stress;
@@ -1854,29 +2498,38 @@ static void indscal_iteration_tenBerge (ScalarProductList zc, Configuration xc,
 	const double tolerance = 1e-4; // reasonable for dominant eigenvector estimation.
 	autoMAT wsih = newMATraw (nPoints, nPoints);
 	autoVEC solution = newVECraw (nPoints);
+	autoVEC c = newVECraw (nDimensions), xhxj = newVECraw (nDimensions);
+	const MAT x = xc -> data.get();
 
 	for (integer h = 1; h <= nDimensions; h ++) {
-		autoScalarProductList sprc = Data_copy (zc);
-		wsih.all() <<= 0.0;
-		for (integer i = 1; i <= nSources; i ++) {
-			const ScalarProduct sih = sprc -> at [i];
-			/*
-				Construct the Sih matrices (eq. 6)
-			*/
-			for (integer j = 1; j <= nDimensions; j ++) {
-				if (j != h) {
-					for (integer k = 1; k <= nPoints; k ++)
-						for (integer l = 1; l <= nPoints; l ++)
-							sih -> data [k] [l] -= xc -> data [k] [j] * xc -> data [l] [j] * weights -> data [i] [j];
+		/*
+			The Sih matrices (eq. 6) are Sih = Zi - sum (j != h) wij xj xj', so that the weighted S matrix (eq. 8),
+			sum (i) wih Sih, is sum (i) wih Zi - sum (j != h) cj xj xj', with cj = sum (i) wih wij.
+			This spares us a copy of all the Zi per dimension. The rows are independent.
+		*/
+		for (integer j = 1; j <= nDimensions; j ++) {
+			longdouble cj = 0.0;
+			if (j != h)
+				for (integer i = 1; i <= nSources; i ++)
+					cj += weights -> data [i] [h] * weights -> data [i] [j];
+			c [j] = double (cj);
+		}
+		MelderThread_runStretches (MelderThread_getNumberOfThreads (nPoints, double (nSources + nDimensions) * nPoints * nPoints), nPoints,
+			[&] (integer /* ithread */, integer firstRow, integer lastRow) {
+				for (integer k = firstRow; k <= lastRow; k ++) {
+					const VEC wsihk = wsih.row (k);
+					wsihk <<= 0.0;
+					for (integer i = 1; i <= nSources; i ++)
+						wsihk  +=  zc -> at [i] -> data.row (k)  *  weights -> data [i] [h];
+					for (integer j = 1; j <= nDimensions; j ++)
+						if (j != h)
+							for (integer l = 1; l <= nPoints; l ++)
+								wsihk [l] -= c [j] * x [k] [j] * x [l] [j];
 				}
 			}
-			/*
-				the weighted S matrix (eq. 8)
-			*/
-			wsih.all()  +=  sih -> data.all()  *  weights -> data [i] [h];
-		}
+		);
 
-		solution.all() <<= xc -> data.column (h); // initial guess
+		solution.all() <<= x.column (h); // initial guess
 		/*
 			largest eigenvalue of wsih (nonsymmetric matrix!!) is optimal solution for this dimension
 		*/
@@ -1890,22 +2543,33 @@ static void indscal_iteration_tenBerge (ScalarProductList zc, Configuration xc,
 			continue;
 		VECnormalize_inplace (solution.get(), 2.0, 1.0);
 
-		for (integer k = 1; k <= nPoints; k ++)
-			xc -> data [k] [h] = solution [k];
+		x.column (h) <<= solution.all();
 		/*
-			update weights. Make negative weights zero.
+			update weights: wih = xh' Sih xh = xh' Zi xh - sum (j != h) wij (xh' xj)^2.
+			Make negative weights zero.
 		*/
-		for (integer i = 1; i <= nSources; i ++) {
-			const ScalarProduct spr = sprc -> at [i];
-			longdouble wih = 0.0;
-			for (integer k = 1; k <= nPoints; k ++) {
-				for (integer l = 1; l <= nPoints; l ++)
-					wih += xc -> data [k] [h] * spr -> data [k] [l] * xc -> data [l] [h];
+		for (integer j = 1; j <= nDimensions; j ++)
+			xhxj [j] = NUMinner (x.column (h), x.column (j));
+		MelderThread_runStretches (MelderThread_getNumberOfThreads (nSources, double (nSources) * nPoints * nPoints), nSources,
+			[&] (integer /* ithread */, integer firstSource, integer lastSource) {
+				for (integer i = firstSource; i <= lastSource; i ++) {
+					const constMAT zi = zc -> at [i] -> data.get();
+					longdouble wih = 0.0;
+					for (integer k = 1; k <= nPoints; k ++) {
+						longdouble zxk = 0.0;
+						for (integer l = 1; l <= nPoints; l ++)
+							zxk += zi [k] [l] * x [l] [h];
+						wih += x [k] [h] * zxk;
+					}
+					for (integer j = 1; j <= nDimensions; j ++)
+						if (j != h)
+							wih -= weights -> data [i] [j] * xhxj [j] * xhxj [j];
+					if (wih < 0.0)
+						wih = 0.0;
+					weights -> data [i] [h] = double (wih);
+				}
 			}
-			if (wih < 0.0)
-				wih = 0.0;
-			weights -> data [i] [h] = double (wih);
-		}
+		);
 	}
 }
 
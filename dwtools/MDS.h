@@ -31,6 +31,7 @@
 #include "ContingencyTable.h"
 #include "MDSVec.h"
 #include "TableOfReal_extensions.h"
+#include "Table.h"
 #include "Proximity.h"
 #include "Distance.h"
 #include "Configuration.h"
@@ -96,6 +97,12 @@ Thing_define (Transformator, Thing) {
 	integer normalization;
 
 	virtual autoDistance v_transform (MDSVec vec, Distance dist, Weight w);
+	/*
+		Put the transformed dissimilarities in 'fit' without creating objects, throwing or changing the Transformator,
+		so that several threads can transform at the same time. 'workspace' has one element per proximity.
+		Returns false if the transformation cannot be done in this way.
+	*/
+	virtual bool v_transformInto (MDSVec vec, constMAT distance, constMAT weight, MAT fit, VEC workspace);
 };
 
 void Transformator_init (Transformator me, integer numberOfPoints);
@@ -113,6 +120,8 @@ Thing_define (ISplineTransformator, Transformator) {
 
 	autoDistance v_transform (MDSVec vec, Distance dist, Weight w)
 		override;
+	bool v_transformInto (MDSVec vec, constMAT distance, constMAT weight, MAT fit, VEC workspace)
+		override;
 };
 
 autoISplineTransformator ISplineTransformator_create (integer numberOfPoints, integer numberOfInteriorKnots, integer order);
@@ -122,6 +131,8 @@ Thing_define (RatioTransformator, Transformator) {
 
 	autoDistance v_transform (MDSVec vec, Distance dist, Weight w)
 		override;
+	bool v_transformInto (MDSVec vec, constMAT distance, constMAT weight, MAT fit, VEC workspace)
+		override;
 };
 
 autoRatioTransformator RatioTransformator_create (integer numberOfPoints);
@@ -131,6 +142,8 @@ Thing_define (MonotoneTransformator, Transformator) {
 
 	autoDistance v_transform (MDSVec vec, Distance dist, Weight w)
 		override;
+	bool v_transformInto (MDSVec vec, constMAT distance, constMAT weight, MAT fit, VEC workspace)
+		override;
 };
 
 autoMonotoneTransformator MonotoneTransformator_create (integer numberPoints);
@@ -230,6 +243,20 @@ autoConfiguration Dissimilarity_Configuration_Weight_ispline_mds (Dissimilarity
 	double tolerance, integer numberOfIterations, integer numberOfRepetitions, bool showProgress
 );
 
+autoConfiguration Table_to_Configuration_sparseMds (Table me,
+	conststring32 firstPointColumnLabel, conststring32 secondPointColumnLabel,
+	conststring32 dissimilarityColumnLabel, conststring32 weightColumnLabel,
+	integer numberOfDimensions, integer numberOfLandmarks, double tolerance, integer numberOfIterations,
+	bool showProgress, double *out_stress);
+/*
+	Absolute (metric) MDS by SMACOF for many points of which only some dissimilarities are known:
+	each row of the table has two point numbers, their dissimilarity and, if weightColumnLabel is not empty, a weight.
+	Only the given pairs are stored, and the Guttman transform is solved iteratively, so that the memory and
+	the time per iteration are proportional to the number of pairs rather than to the squared number of points.
+	With numberOfLandmarks > 0 the start configuration is landmark MDS on shortest-path distances,
+	otherwise it is random. The normalized stress is sum w (δ - d)^2 / sum w δ^2.
+*/
+
 autoConfiguration Dissimilarity_Weight_absolute_mds (Dissimilarity me, Weight w, integer numberOfDimensions, double tolerance, integer numberOfIterations, integer numberOfRepetitions, bool showProgress);
 
 autoConfiguration Dissimilarity_Weight_ratio_mds (Dissimilarity dis, Weight w,
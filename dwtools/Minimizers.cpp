@@ -176,7 +176,7 @@ Thing_implement	(SteepestDescentMinimizer, Minimizer, 0);
 
 void structSteepestDescentMinimizer :: v_minimize () {
 	autoVEC dp = newVECraw (numberOfParameters);
-	autoVEC dpp = newVECraw (numberOfParameters);
+	autoVEC dpp = newVECzero (numberOfParameters);
 	double fret = func (object, p.get());
 	while (iteration < maximumNumberOfIterations) {
 		dfunc (object, p.get(), dp.get());
@@ -36,6 +36,7 @@
 #include "Eigen_and_SSCP.h"
 #include "Eigen_and_TableOfReal.h"
 #include "Matrix_extensions.h"
+#include "MAT_numerics.h"
 #include "NUM2.h"
 #include "PCA.h"
 #include "TableOfReal_extensions.h"
@@ -192,6 +193,90 @@ autoPCA TableOfReal_to_PCA_byRows (TableOfReal me) {
 	}
 }
 
+autoPCA TableOfReal_to_PCA_byRows_randomized (TableOfReal me, integer numberOfComponents, integer numberOfPowerIterations) {
+	try {
+		const constMAT data = my data.get();
+		Melder_require (NUMdefined (data),
+			U"All the table's elements should be defined.");
+		Melder_require (data.nrow > 1,
+			U"The number of rows should be larger than 1.");
+		Melder_require (numberOfComponents >= 1 && numberOfComponents <= std::min (data.nrow, data.ncol),
+			U"The number of components should not exceed the number of rows or columns.");
+		Melder_require (numberOfPowerIterations >= 0,
+			U"The number of power iterations should not be negative.");
+		autoPCA thee = Thing_new (PCA);
+		thy centroid = newVECcolumnMeans (data);
+		autoMAT eigenvectors;
+		autoVEC singularValues;
+		MAT_getTruncatedSVD_randomized (data, thy centroid.get(), numberOfComponents, numberOfPowerIterations,
+				& eigenvectors, & singularValues);
+		Eigen_init (thee.get(), numberOfComponents, data.ncol);
+		thy eigenvectors.all() <<= eigenvectors.all();
+		for (integer i = 1; i <= numberOfComponents; i ++)
+			thy eigenvalues [i] = singularValues [i] * singularValues [i] / (data.nrow - 1);
+		thy labels = autoSTRVEC (data.ncol);
+		thy labels.all() <<= my columnLabels.all();
+		PCA_setNumberOfObservations (thee.get(), data.nrow);
+		return thee;
+	} catch (MelderError) {
+		Melder_throw (me, U": randomized PCA not created.");
+	}
+}
+
+autoPCA TableOfReal_to_PCA_byRows_onePass (TableOfReal me, integer numberOfComponents) {
+	try {
+		const constMAT data = my data.get();
+		Melder_require (NUMdefined (data),
+			U"All the table's elements should be defined.");
+		Melder_require (data.nrow > 1,
+			U"The number of rows should be larger than 1.");
+		Melder_require (numberOfComponents >= 0 && numberOfComponents <= data.ncol,
+			U"The number of components should not exceed the number of columns.");
+		if (numberOfComponents == 0)
+			numberOfComponents = data.ncol;
+		/*
+			The data are shifted by the first row, which keeps the accumulated sums small
+			(and the final centring accurate) without a first pass for the means.
+		*/
+		constexpr integer blockSize = 1024;
+		autoVEC shift = newVECcopy (data.row (1));
+		autoVEC sum = newVECzero (data.ncol);
+		autoMAT sscp = newMATzero (data.ncol, data.ncol);
+		autoMAT blockSscp = newMATraw (data.ncol, data.ncol);
+		autoMAT block = newMATraw (std::min (blockSize, data.nrow), data.ncol);
+		for (integer ifirst = 1; ifirst <= data.nrow; ifirst += blockSize) {
+			const integer ilast = std::min (ifirst + blockSize - 1, data.nrow);
+			const MATVU part = block.horizontalBand (1, ilast - ifirst + 1);
+			part  <<=  data.horizontalBand (ifirst, ilast);
+			part  -=  shift.all();
+			for (integer irow = 1; irow <= part.nrow; irow ++)
+				sum.all()  +=  part.row (irow);
+			MATmtm (blockSscp.get(), part);
+			sscp.all()  +=  blockSscp.all();
+		}
+		autoVEC mean = newVECcopy (sum.all());
+		mean.all()  *=  1.0 / data.nrow;
+		for (integer irow = 1; irow <= data.ncol; irow ++)
+			for (integer icol = 1; icol <= data.ncol; icol ++)
+				sscp [irow] [icol] -= data.nrow * mean [irow] * mean [icol];
+		sscp.all()  *=  1.0 / (data.nrow - 1);
+
+		autoMAT eigenvectors = newMATraw (data.ncol, data.ncol);
+		autoVEC eigenvalues = newVECraw (data.ncol);
+		MAT_getEigenSystemFromSymmetricMatrix_preallocated (eigenvectors.get(), eigenvalues.get(), sscp.get(), false);
+		autoPCA thee = PCA_create (numberOfComponents, data.ncol);
+		thy eigenvectors.all() <<= eigenvectors.horizontalBand (1, numberOfComponents);
+		thy eigenvalues.all() <<= eigenvalues.part (1, numberOfComponents);
+		thy centroid.all() <<= shift.all();
+		thy centroid.all()  +=  mean.all();
+		thy labels.all() <<= my columnLabels.all();
+		PCA_setNumberOfObservations (thee.get(), data.nrow);
+		return thee;
+	} catch (MelderError) {
+		Melder_throw (me, U": one-pass PCA not created.");
+	}
+}
+
 autoPCA Matrix_to_PCA_byColumns (Matrix me) {
 	try {
 		autoPCA thee = MAT_to_PCA (my z.get(), true);
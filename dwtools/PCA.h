@@ -41,6 +41,18 @@ integer PCA_getNumberOfObservations (PCA me);
 
 autoPCA TableOfReal_to_PCA_byRows (TableOfReal me);
 
+autoPCA TableOfReal_to_PCA_byRows_randomized (TableOfReal me, integer numberOfComponents, integer numberOfPowerIterations);
+/*
+	Only the first numberOfComponents principal components, from a randomized truncated SVD
+	of the centred data. For tall tables much faster than the full SVD, and without a centred copy of the data.
+*/
+
+autoPCA TableOfReal_to_PCA_byRows_onePass (TableOfReal me, integer numberOfComponents);
+/*
+	The first numberOfComponents (0 = all) principal components of the covariance matrix,
+	which is accumulated in a single pass over blocks of rows, without a copy of the data.
+*/
+
 autoEigen PCA_to_Eigen (PCA me);
 
 /* Calculate PCA of M'M */
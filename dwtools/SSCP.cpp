@@ -61,6 +61,10 @@
 #include "NUMclapack.h"
 #include "NUM2.h"
 #include "SVD.h"
+#include "Strings_.h"
+#include "MelderThread.h"
+
+#include <vector>
 
 #include "oo_DESTROY.h"
 #include "SSCP_def.h"
@@ -500,6 +504,201 @@ autoSSCP TableOfReal_to_SSCP_rowWeights (TableOfReal me, integer rowb, integer r
 	}
 }
 
+/*
+	Merge a second accumulation (numberOfObservations2, centroid2, sscp2) into a first one,
+	both as centroids and sums of squares and cross products about the centroid.
+	With delta = centroid2 - centroid1 and n = n1 + n2 (Chan, Golub & LeVeque 1983):
+		sscp = sscp1 + sscp2 + (n1 n2 / n) delta delta'
+		centroid = centroid1 + (n2 / n) delta
+	This is the pairwise form of Welford's update; it never subtracts large sums of squares.
+*/
+static void SSCP_mergeAccumulations (double *numberOfObservations1, VECVU const& centroid1, MATVU const& sscp1,
+	double numberOfObservations2, constVECVU const& centroid2, constMATVU const& sscp2) noexcept
+{
+	if (numberOfObservations2 == 0.0)
+		return;
+	if (*numberOfObservations1 == 0.0) {
+		*numberOfObservations1 = numberOfObservations2;
+		centroid1  <<=  centroid2;
+		sscp1  <<=  sscp2;
+		return;
+	}
+	const double numberOfObservations = *numberOfObservations1 + numberOfObservations2;
+	const double factor = *numberOfObservations1 * numberOfObservations2 / numberOfObservations;
+	for (integer irow = 1; irow <= sscp1.nrow; irow ++) {
+		const double deltaRow = centroid2 [irow] - centroid1 [irow];
+		for (integer icol = 1; icol <= sscp1.ncol; icol ++)
+			sscp1 [irow] [icol] += sscp2 [irow] [icol] + factor * deltaRow * (centroid2 [icol] - centroid1 [icol]);
+	}
+	const double weight2 = numberOfObservations2 / numberOfObservations;
+	for (integer icol = 1; icol <= centroid1.size; icol ++)
+		centroid1 [icol] += weight2 * (centroid2 [icol] - centroid1 [icol]);
+	*numberOfObservations1 = numberOfObservations;
+}
+
+static constMATVU constMATVUrows (constMATVU const& x, integer firstRow, integer lastRow) {
+	return constMATVU (& x [firstRow] [1], lastRow - firstRow + 1, x.ncol, x.rowStride, x.colStride);
+}
+
+/*
+	The accumulation of one thread. All the memory is allocated beforehand (on the main thread),
+	so that addRows () can run on any thread.
+*/
+struct SSCPaccumulator {
+	static constexpr integer blockSize = 1024;   // rows that are centred and multiplied at a time
+	double numberOfObservations = 0.0;
+	autoVEC centroid, blockCentroid;
+	autoMAT sscp, blockSscp, block;
+	void init (integer dimension, integer maximumNumberOfRows) {
+		centroid = newVECzero (dimension);
+		blockCentroid = newVECraw (dimension);
+		sscp = newMATzero (dimension, dimension);
+		blockSscp = newMATraw (dimension, dimension);
+		block = newMATraw (std::max (integer (1), std::min (blockSize, maximumNumberOfRows)), dimension);
+	}
+	void addRows (constMATVU const& rows) noexcept {
+		for (integer ifirst = 1; ifirst <= rows.nrow; ifirst += blockSize) {
+			const integer ilast = std::min (ifirst + blockSize - 1, rows.nrow);
+			const MATVU part = block.horizontalBand (1, ilast - ifirst + 1);
+			part  <<=  constMATVUrows (rows, ifirst, ilast);
+			VECcolumnMeans (blockCentroid.get(), part);
+			part  -=  blockCentroid.all();
+			MATmtm (blockSscp.get(), part);
+			SSCP_mergeAccumulations (& numberOfObservations, centroid.get(), sscp.get(),
+					part.nrow, blockCentroid.get(), blockSscp.get());
+		}
+	}
+};
+
+void SSCP_addRows (SSCP me, constMATVU const& rows) {
+	try {
+		Melder_require (my numberOfRows == my numberOfColumns,
+			U"The SSCP should not have reduced storage.");
+		Melder_require (rows.ncol == my numberOfColumns,
+			U"The number of columns of the data (", rows.ncol, U") should equal the dimension of the SSCP (", my numberOfColumns, U").");
+		Melder_require (NUMdefined (rows),
+			U"All the data should be defined.");
+		if (rows.nrow == 0)
+			return;
+		/*
+			Give each thread at least a few blocks, and about a million multiplications.
+			Wide data are multiplied in parallel by MATmtm () already.
+		*/
+		const double numberOfMultiplications = double (rows.nrow) * double (rows.ncol) * double (rows.ncol);
+		const integer numberOfThreads = ( rows.ncol < 256 ?
+				MelderThread_getNumberOfThreads (rows.nrow / (4 * SSCPaccumulator::blockSize), numberOfMultiplications) : 1 );
+		auto firstRowOfThread = [&] (integer ithread) {   // base-0 thread number, as in MelderThread_runStretches ()
+			return 1 + rows.nrow * ithread / numberOfThreads;
+		};
+		std::vector <SSCPaccumulator> accumulators ((size_t) numberOfThreads);
+		for (integer ithread = 0; ithread < numberOfThreads; ithread ++)
+			accumulators [(size_t) ithread]. init (rows.ncol, firstRowOfThread (ithread + 1) - firstRowOfThread (ithread));
+		MelderThread_runStretches (numberOfThreads, rows.nrow, [&] (integer ithread, integer firstRow, integer lastRow) {
+			accumulators [(size_t) ithread]. addRows (constMATVUrows (rows, firstRow, lastRow));
+		});
+		/*
+			Merge pairwise, so that the partial accumulations that are merged have similar numbers of observations.
+		*/
+		for (integer step = 1; step < numberOfThreads; step *= 2) {
+			for (integer ithread = 0; ithread + step < numberOfThreads; ithread += 2 * step) {
+				SSCPaccumulator& target = accumulators [(size_t) ithread], & source = accumulators [(size_t) (ithread + step)];
+				SSCP_mergeAccumulations (& target.numberOfObservations, target.centroid.get(), target.sscp.get(),
+						source.numberOfObservations, source.centroid.get(), source.sscp.get());
+			}
+		}
+		const SSCPaccumulator& total = accumulators [0];
+		SSCP_mergeAccumulations (& my numberOfObservations, my centroid.get(), my data.get(),
+				total.numberOfObservations, total.centroid.get(), total.sscp.get());
+		my dataChanged = 1;
+	} catch (MelderError) {
+		Melder_throw (me, U": rows not added.");
+	}
+}
+
+void SSCP_addSSCP (SSCP me, SSCP thee) {
+	try {
+		Melder_require (my numberOfRows == my numberOfColumns && thy numberOfRows == thy numberOfColumns,
+			U"The SSCPs should not have reduced storage.");
+		Melder_require (thy numberOfColumns == my numberOfColumns,
+			U"The dimensions of the SSCPs should be equal.");
+		SSCP_mergeAccumulations (& my numberOfObservations, my centroid.get(), my data.get(),
+				thy numberOfObservations, thy centroid.get(), thy data.get());
+		my dataChanged = 1;
+	} catch (MelderError) {
+		Melder_throw (me, U": ", thee, U" not added.");
+	}
+}
+
+void SSCP_TableOfReal_addRows (SSCP me, TableOfReal thee) {
+	const bool isEmpty = ( my numberOfObservations == 0.0 );
+	SSCP_addRows (me, thy data.get());
+	if (isEmpty && thy numberOfColumns == my numberOfColumns)
+		for (integer j = 1; j <= my numberOfColumns; j ++) {
+			const conststring32 label = thy columnLabels [j].get();
+			TableOfReal_setColumnLabel (me, j, label);
+			TableOfReal_setRowLabel (me, j, label);
+		}
+}
+
+void SSCP_Matrix_addRows (SSCP me, Matrix thee) {
+	SSCP_addRows (me, thy z.get());
+}
+
+autoSSCP TableOfRealList_to_SSCP_allRows (TableOfRealList me) {
+	try {
+		Melder_require (my size > 0,
+			U"There should be at least one table.");
+		autoSSCP thee = SSCP_create (my at [1] -> numberOfColumns);
+		for (integer itable = 1; itable <= my size; itable ++) {
+			const TableOfReal table = my at [itable];
+			Melder_require (table -> numberOfColumns == thy numberOfColumns,
+				U"The number of columns of table ", itable, U" should be ", thy numberOfColumns, U".");
+			SSCP_TableOfReal_addRows (thee.get(), table);
+		}
+		return thee;
+	} catch (MelderError) {
+		Melder_throw (me, U": SSCP not created.");
+	}
+}
+
+autoSSCP SSCP_createFromFolder (conststring32 folderWithDataFiles, conststring32 dataFileExtension) {
+	try {
+		autoStrings fileList = Strings_createAsFileList (Melder_cat (folderWithDataFiles, U"/*.", dataFileExtension));
+		if (fileList -> numberOfStrings == 0)
+			Melder_throw (U"No files found.");
+		autoSSCP me;
+		/*
+			Only one file is in memory at a time. Reading creates objects, which has to happen on the main thread;
+			the accumulation of the rows of each file is spread over threads by SSCP_addRows ().
+		*/
+		for (integer ifile = 1; ifile <= fileList -> numberOfStrings; ifile ++) {
+			conststring32 fileName = fileList -> strings [ifile].get();
+			try {
+				structMelderFile file { };
+				Melder_relativePathToFile (Melder_cat (folderWithDataFiles, U"/", fileName), & file);
+				autoDaata data = Data_readFromFile (& file);
+				if (Thing_isa (data.get(), classTableOfReal)) {
+					const TableOfReal table = static_cast <TableOfReal> (data.get());
+					if (! me)
+						me = SSCP_create (table -> numberOfColumns);
+					SSCP_TableOfReal_addRows (me.get(), table);
+				} else if (Thing_isa (data.get(), classMatrix)) {
+					const Matrix matrix = static_cast <Matrix> (data.get());
+					if (! me)
+						me = SSCP_create (matrix -> nx);
+					SSCP_Matrix_addRows (me.get(), matrix);
+				} else
+					Melder_throw (U"Contains a ", Thing_className (data.get()), U" instead of a TableOfReal or Matrix.");
+			} catch (MelderError) {
+				Melder_throw (U"File ", fileName, U" not added.");
+			}
+		}
+		return me;
+	} catch (MelderError) {
+		Melder_throw (U"SSCP not created from folder ", folderWithDataFiles, U".");
+	}
+}
+
 autoTableOfReal SSCP_TableOfReal_extractDistanceQuantileRange (SSCP me, TableOfReal thee, double qlow, double qhigh) {
 	try {
 		autoCovariance cov = SSCP_to_Covariance (me, 1);
@@ -1887,8 +2086,9 @@ void SSCP_unExpand (SSCP me) {
 }
 
 void SSCP_expandLowerCholeskyInverse (SSCP me) {
-	if (NUMisEmpty (my lowerCholeskyInverse.get()))
-		my lowerCholeskyInverse = newMATraw (my numberOfColumns, my numberOfColumns);
+	const integer numberOfInverseRows = ( my numberOfRows == 1 ? 1 : my numberOfColumns );   // a one-row inverse is diagonal for NUMmahalanobisDistanceSquared ()
+	if (my lowerCholeskyInverse.nrow != numberOfInverseRows || my lowerCholeskyInverse.ncol != my numberOfColumns)
+		my lowerCholeskyInverse = newMATraw (numberOfInverseRows, my numberOfColumns);
 	if (my numberOfRows == 1) {   // diagonal
 		my lnd = 0.0;
 		for (integer j = 1; j <= my numberOfColumns; j ++) {
@@ -81,6 +81,25 @@ double SSCP_getFractionVariation (SSCP me, integer from, integer to);
 autoSSCP TableOfReal_to_SSCP (TableOfReal me, integer rowb, integer rowe, integer colb, integer cole);
 autoSSCP TableOfReal_to_SSCP_rowWeights (TableOfReal me, integer rowb, integer rowe, integer colb, integer cole, integer weightColumnNumber);
 
+void SSCP_addRows (SSCP me, constMATVU const& rows);
+/*
+	Accumulate the rows as new observations: afterwards the centroid and the sums of squares and
+	cross products about the centroid are those of all the observations seen so far,
+	as if they had been in one table. Large numbers of rows are spread over threads.
+	The SSCP may be empty (zero observations) but should not have reduced storage.
+*/
+void SSCP_addSSCP (SSCP me, SSCP thee);   // as if thy observations were added with SSCP_addRows ()
+void SSCP_TableOfReal_addRows (SSCP me, TableOfReal thee);
+void SSCP_Matrix_addRows (SSCP me, Matrix thee);   // the rows of the matrix are the observations
+
+autoSSCP TableOfRealList_to_SSCP_allRows (TableOfRealList me);   // without concatenating the tables
+
+autoSSCP SSCP_createFromFolder (conststring32 folderWithDataFiles, conststring32 dataFileExtension);
+/*
+	Accumulate the rows of all the TableOfReal or Matrix files with the given extension,
+	reading one file at a time, so that the data together can be larger than the memory.
+*/
+
 autoTableOfReal SSCP_TableOfReal_extractDistanceQuantileRange (SSCP me, TableOfReal thee, double qlow, double qhigh);
 
 autoTableOfReal Covariance_TableOfReal_extractDistanceQuantileRange (Covariance me, TableOfReal thee, double qlow, double qhigh);
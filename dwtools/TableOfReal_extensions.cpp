@@ -1249,9 +1249,9 @@ autoTableOfReal TableOfReal_choleskyDecomposition (TableOfReal me, bool upper, b
 					thy data [i] [j] = 0.0;
 		}
 		char uplo = upper ? 'L' : 'U';
-		NUMlapack_dpotf2 (& uplo, & n, & thy data [1] [1], & lda, & info);
+		NUMlapack_dpotrf (& uplo, & n, & thy data [1] [1], & lda, & info);
 		Melder_require (info == 0,
-			U"dpotf2 fails");
+			U"dpotrf fails");
 		
 		if (inverse) {
 			NUMlapack_dtrtri (&uplo, &diag, &n, &thy data [1] [1], &lda, &info);
@@ -0,0 +1,82 @@
+/* Table_and_NMF.cpp
+ *
+ * Copyright (C) 2026 David Weenink
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This code is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this work. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Table_and_NMF.h"
+
+void Table_to_SparseNonnegativeMatrix (Table me, SparseNonnegativeMatrix *thee,
+	conststring32 rowNumberColumnLabel, conststring32 columnNumberColumnLabel, conststring32 valueColumnLabel)
+{
+	const integer rowNumberColumn = Table_getColumnIndexFromColumnLabel (me, rowNumberColumnLabel);
+	const integer columnNumberColumn = Table_getColumnIndexFromColumnLabel (me, columnNumberColumnLabel);
+	const integer valueColumn = Table_getColumnIndexFromColumnLabel (me, valueColumnLabel);
+	const integer numberOfCells = my rows.size;
+	Melder_require (numberOfCells > 0,
+		U"The table should contain cells.");
+	autoINTVEC rows = newINTVECraw (numberOfCells), columns = newINTVECraw (numberOfCells);
+	autoVEC values = newVECraw (numberOfCells);
+	integer numberOfRows = 0, numberOfColumns = 0;
+	for (integer icell = 1; icell <= numberOfCells; icell ++) {
+		const double rowNumber = Table_getNumericValue_Assert (me, icell, rowNumberColumn);
+		const double columnNumber = Table_getNumericValue_Assert (me, icell, columnNumberColumn);
+		Melder_require (isdefined (rowNumber) && rowNumber >= 1.0 && rowNumber == round (rowNumber) &&
+				isdefined (columnNumber) && columnNumber >= 1.0 && columnNumber == round (columnNumber),
+			U"Row ", icell, U": the row and column numbers should be positive integers.");
+		rows [icell] = integer (rowNumber);
+		columns [icell] = integer (columnNumber);
+		values [icell] = Table_getNumericValue_Assert (me, icell, valueColumn);
+		numberOfRows = std::max (numberOfRows, rows [icell]);
+		numberOfColumns = std::max (numberOfColumns, columns [icell]);
+	}
+	SparseNonnegativeMatrix_init (thee, numberOfRows, numberOfColumns, rows.get(), columns.get(), values.get());
+}
+
+autoNMF Table_to_NMF_mu (Table me, conststring32 rowNumberColumnLabel, conststring32 columnNumberColumnLabel, conststring32 valueColumnLabel,
+	integer numberOfFeatures, integer maximumNumberOfIterations, double changeTolerance, double approximationTolerance, bool info)
+{
+	try {
+		SparseNonnegativeMatrix data;
+		Table_to_SparseNonnegativeMatrix (me, & data, rowNumberColumnLabel, columnNumberColumnLabel, valueColumnLabel);
+		Melder_require (numberOfFeatures <= data.numberOfColumns,
+			U"The number of features should not exceed the number of columns (", data.numberOfColumns, U").");
+		autoNMF thee = NMF_create (data.numberOfRows, data.numberOfColumns, numberOfFeatures);
+		NMF_initializeFactorization (thee.get(), constMATVU (), kNMF_Initialization::RandomUniform);
+		NMF_improveFactorization_mu_sparse (thee.get(), & data, maximumNumberOfIterations, changeTolerance, approximationTolerance, info);
+		return thee;
+	} catch (MelderError) {
+		Melder_throw (me, U": NMF cannot be created.");
+	}
+}
+
+autoNMF Table_to_NMF_als (Table me, conststring32 rowNumberColumnLabel, conststring32 columnNumberColumnLabel, conststring32 valueColumnLabel,
+	integer numberOfFeatures, integer maximumNumberOfIterations, double changeTolerance, double approximationTolerance, bool info)
+{
+	try {
+		SparseNonnegativeMatrix data;
+		Table_to_SparseNonnegativeMatrix (me, & data, rowNumberColumnLabel, columnNumberColumnLabel, valueColumnLabel);
+		Melder_require (numberOfFeatures <= data.numberOfColumns,
+			U"The number of features should not exceed the number of columns (", data.numberOfColumns, U").");
+		autoNMF thee = NMF_create (data.numberOfRows, data.numberOfColumns, numberOfFeatures);
+		NMF_initializeFactorization (thee.get(), constMATVU (), kNMF_Initialization::RandomUniform);
+		NMF_improveFactorization_als_sparse (thee.get(), & data, maximumNumberOfIterations, changeTolerance, approximationTolerance, info);
+		return thee;
+	} catch (MelderError) {
+		Melder_throw (me, U": NMF cannot be created.");
+	}
+}
+
+/* End of file Table_and_NMF.cpp */
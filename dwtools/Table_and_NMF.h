@@ -0,0 +1,37 @@
+#ifndef _Table_and_NMF_h_
+#define _Table_and_NMF_h_
+/* Table_and_NMF.h
+ *
+ * Copyright (C) 2026 David Weenink
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This code is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this work. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Table.h"
+#include "NMF.h"
+
+/*
+	The non-zero cells of the data matrix are the rows of the table: a row number, a column number and a value.
+	The size of the matrix is given by the largest row and column numbers; cells that occur more than once are added.
+*/
+void Table_to_SparseNonnegativeMatrix (Table me, SparseNonnegativeMatrix *thee,
+	conststring32 rowNumberColumnLabel, conststring32 columnNumberColumnLabel, conststring32 valueColumnLabel);
+
+autoNMF Table_to_NMF_mu (Table me, conststring32 rowNumberColumnLabel, conststring32 columnNumberColumnLabel, conststring32 valueColumnLabel,
+	integer numberOfFeatures, integer maximumNumberOfIterations, double changeTolerance, double approximationTolerance, bool info);
+
+autoNMF Table_to_NMF_als (Table me, conststring32 rowNumberColumnLabel, conststring32 columnNumberColumnLabel, conststring32 valueColumnLabel,
+	integer numberOfFeatures, integer maximumNumberOfIterations, double changeTolerance, double approximationTolerance, bool info);
+
+#endif /* _Table_and_NMF_h_ */
@@ -36,8 +36,11 @@
 #include "Graphics_extensions.h"
 #include "Index.h"
 #include "Matrix_extensions.h"
+#include "MelderThread.h"
 #include "NUM2.h"
 #include <ctype.h>
+#include <string>
+#include <vector>
 #include "Strings_extensions.h"
 #include "SSCP.h"
 #include "Table_extensions.h"
@@ -4141,8 +4144,6 @@ void Table_boxPlotsWhere (Table me, Graphics g, conststring32 dataColumns_string
 		if (factorColumn < 1 || factorColumn > my numberOfColumns)
 			return;
 		const integer numberOfSelectedColumns = dataColumns.size;
-		Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
-		Formula_Result result;
 		const integer numberOfData = my rows.size;
 		autoStringsIndex si = Table_to_StringsIndex_column (me, factorColumn);
 		const integer numberOfLevels = si -> classes->size;
@@ -4167,17 +4168,19 @@ void Table_boxPlotsWhere (Table me, Graphics g, conststring32 dataColumns_string
 		const double spaceBetweenGroupsdiv2 = 3.0 / 2.0;
 		const double widthUnit = 1.0 / (numberOfSelectedColumns * boxWidth + (numberOfSelectedColumns - 1) * spaceBetweenBoxesInGroup + spaceBetweenGroupsdiv2 + spaceBetweenGroupsdiv2);
 		autoVEC data = newVECraw (numberOfData);
+		autoBOOLMAT selection = newmatrixraw <bool> (numberOfSelectedColumns, numberOfData);
+		for (integer icol = 1; icol <= numberOfSelectedColumns; icol ++) {
+			autoBOOLVEC selectionForColumn = Table_getRowSelectionWhere (me, formula, interpreter, dataColumns [icol]);
+			for (integer irow = 1; irow <= numberOfData; irow ++)
+				selection [icol] [irow] = selectionForColumn [irow];
+		}
 		for (integer ilevel = 1; ilevel <= numberOfLevels; ilevel ++) {
 			const double xlevel = ilevel;
 			for (integer icol = 1; icol <= numberOfSelectedColumns; icol ++) {
 				integer numberOfDataInLevelColumn = 0;
-				for (integer irow = 1; irow <= numberOfData; irow ++) {
-					if (si -> classIndex [irow] == ilevel) {
-						Formula_run (irow, dataColumns [icol], & result);
-						if (result. numericResult != 0.0)
-							data [++ numberOfDataInLevelColumn] = Table_getNumericValue_Assert (me, irow, dataColumns [icol]);
-					}
-				}
+				for (integer irow = 1; irow <= numberOfData; irow ++)
+					if (si -> classIndex [irow] == ilevel && selection [icol] [irow])
+						data [++ numberOfDataInLevelColumn] = Table_getNumericValue_Assert (me, irow, dataColumns [icol]);
 				if (numberOfDataInLevelColumn > 0) {
 					/*
 						Determine position
@@ -4205,17 +4208,14 @@ void Table_distributionPlotWhere (Table me, Graphics g, integer dataColumn, doub
 	try {
 		if (dataColumn < 1 || dataColumn > my numberOfColumns)
 			return;
-		Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
-		Formula_Result result;
+		autoBOOLVEC selection = Table_getRowSelectionWhere (me, formula, interpreter, dataColumn);
 
 		Table_numericize_Assert (me, dataColumn);
 		integer mrow = 0;
 		autoMatrix thee = Matrix_create (1.0, 1.0, 1, 1.0, 1.0, 0.0, my rows.size + 1.0, my rows.size, 1.0, 1.0);
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			Formula_run (irow, dataColumn, & result);
-			if (result. numericResult != 0.0)
+		for (integer irow = 1; irow <= my rows.size; irow ++)
+			if (selection [irow])
 				thy z [1] [++ mrow] = Table_getNumericValue_Assert (me, irow, dataColumn);
-		}
 		Matrix_drawDistribution (thee.get(), g, 0, 1, 0.5, mrow + 0.5, minimum, maximum, nBins, freqMin, freqMax, false, false);
 		if (garnish) {
 			Graphics_drawInnerBox (g);
@@ -4251,33 +4251,291 @@ static MelderColour Strings_colourToValue  (Strings me, integer index) {
 	return result;
 }
 
+/*
+	Row criteria like
+		self ["F1"] > 500
+		self$ ["Vowel"] = "a" and self [row, "F2"] <= 1500.5
+	i.e. comparisons of a cell in the current row with a literal, joined by "and" and "or",
+	are recognized in the text of the formula and evaluated without the interpreter,
+	with the interpreter's semantics: a numeric cell is read with Melder_atof,
+	undefined equals undefined but is not less or greater than anything,
+	and strings compare with str32equ and str32cmp.
+	All other formulas are run by the interpreter, which cannot run on more than one thread.
+*/
+enum class kTableRowRelation { EQ, NE, LT, LE, GT, GE };
+
+struct TableRowComparison {
+	integer column;
+	bool isString;
+	kTableRowRelation relation;
+	double number;
+	std::u32string string;
+};
+
+typedef std::vector <std::vector <TableRowComparison>> TableRowCriterion;   // an "or" of "and"s
+
+static bool scanWord (const char32 **p, conststring32 word) {
+	const integer length = str32len (word);
+	if (! str32nequ (*p, word, length))
+		return false;
+	const char32 next = (*p) [length];
+	if (Melder_isWordCharacter (next) || next == U'$')
+		return false;
+	*p += length;
+	return true;
+}
+
+static bool scanStringLiteral (const char32 **p, std::u32string *out_string) {
+	const char32 *q = *p;
+	if (*q != U'"')
+		return false;
+	q ++;
+	out_string -> clear ();
+	for (;;) {
+		if (*q == U'\0')
+			return false;
+		if (*q == U'"') {
+			if (q [1] != U'"')
+				break;
+			q ++;   // a doubled double quote stands for one double quote
+		}
+		out_string -> push_back (*q ++);
+	}
+	*p = q + 1;
+	return true;
+}
+
+/*
+	The same lexical rules as in the formula scanner: no hexadecimal numbers, an optional percent sign.
+*/
+static bool scanNumericLiteral (const char32 **p, double *out_number) {
+	const char32 *q = *p;
+	const bool negative = ( *q == U'-' );
+	if (negative) {
+		q ++;
+		Melder_skipHorizontalOrVerticalSpace (& q);
+	}
+	if (! Melder_isAsciiDecimalNumber (*q) || (q [0] == U'0' && q [1] == U'x'))
+		return false;
+	char buffer [100];
+	integer length = 0;
+	for (; length < 90; q ++) {
+		if (Melder_isAsciiDecimalNumber (*q) || *q == U'.' || *q == U'%' ||
+			*q == U'e' || *q == U'E' || ((*q == U'-' || *q == U'+') && (q [-1] == U'e' || q [-1] == U'E')))
+			buffer [length ++] = (char) *q;
+		else
+			break;
+	}
+	if (Melder_isWordCharacter (*q) || *q == U'.' || *q == U'%')
+		return false;
+	buffer [length] = '\0';
+	const char *end = buffer;
+	while (Melder_isAsciiDecimalNumber (*end))
+		end ++;
+	if (*end == '.')
+		do end ++; while (Melder_isAsciiDecimalNumber (*end));
+	if (*end == 'e' || *end == 'E') {
+		end ++;
+		if (*end == '-' || *end == '+')
+			end ++;
+		if (! Melder_isAsciiDecimalNumber (*end))
+			return false;
+		while (Melder_isAsciiDecimalNumber (*end))
+			end ++;
+	}
+	if (*end == '%')
+		end ++;
+	if (*end != '\0')
+		return false;
+	*out_number = ( negative ? - Melder_a8tof (buffer) : Melder_a8tof (buffer) );
+	*p = q;
+	return true;
+}
+
+static bool scanRelation (const char32 **p, kTableRowRelation *out_relation) {
+	const char32 *q = *p;
+	if (q [0] == U'=')
+		*out_relation = kTableRowRelation::EQ, q += ( q [1] == U'=' ? 2 : 1 );
+	else if ((q [0] == U'<' && q [1] == U'>') || ((q [0] == U'!' || q [0] == U'/') && q [1] == U'='))
+		*out_relation = kTableRowRelation::NE, q += 2;
+	else if (q [0] == U'<' && q [1] == U'=')
+		*out_relation = kTableRowRelation::LE, q += 2;
+	else if (q [0] == U'>' && q [1] == U'=')
+		*out_relation = kTableRowRelation::GE, q += 2;
+	else if (q [0] == U'<')
+		*out_relation = kTableRowRelation::LT, q += 1;
+	else if (q [0] == U'>')
+		*out_relation = kTableRowRelation::GT, q += 1;
+	else
+		return false;
+	*p = q;
+	return true;
+}
+
+/*
+	self [column] relation literal
+	self$ [column] relation literal
+	where column is "label", row, "label", a column number, or row, column number.
+*/
+static bool scanComparison (Table me, const char32 **p, TableRowComparison *out_comparison) {
+	const char32 *q = *p;
+	if (! str32nequ (q, U"self", 4))
+		return false;
+	q += 4;
+	out_comparison -> isString = ( *q == U'$' );
+	if (out_comparison -> isString)
+		q ++;
+	Melder_skipHorizontalOrVerticalSpace (& q);
+	if (*q ++ != U'[')
+		return false;
+	Melder_skipHorizontalOrVerticalSpace (& q);
+	if (scanWord (& q, U"row")) {
+		Melder_skipHorizontalOrVerticalSpace (& q);
+		if (*q ++ != U',')
+			return false;
+		Melder_skipHorizontalOrVerticalSpace (& q);
+	}
+	std::u32string columnLabel;
+	double columnNumber;
+	if (scanStringLiteral (& q, & columnLabel)) {
+		out_comparison -> column = Table_findColumnIndexFromColumnLabel (me, columnLabel.c_str ());
+	} else if (*q != U'-' && scanNumericLiteral (& q, & columnNumber) && columnNumber == Melder_iround (columnNumber)) {
+		out_comparison -> column = Melder_iround (columnNumber);
+	} else {
+		return false;
+	}
+	if (out_comparison -> column < 1 || out_comparison -> column > my numberOfColumns)
+		return false;   // let the interpreter complain
+	Melder_skipHorizontalOrVerticalSpace (& q);
+	if (*q ++ != U']')
+		return false;
+	Melder_skipHorizontalOrVerticalSpace (& q);
+	if (! scanRelation (& q, & out_comparison -> relation))
+		return false;
+	Melder_skipHorizontalOrVerticalSpace (& q);
+	if (out_comparison -> isString ?
+		! scanStringLiteral (& q, & out_comparison -> string) :
+		! scanNumericLiteral (& q, & out_comparison -> number)
+	)
+		return false;
+	*p = q;
+	return true;
+}
+
+static bool Table_compileRowCriterion (Table me, conststring32 formula, TableRowCriterion *out_criterion) {
+	out_criterion -> clear ();
+	out_criterion -> emplace_back ();
+	const char32 *p = formula;
+	for (;;) {
+		Melder_skipHorizontalOrVerticalSpace (& p);
+		TableRowComparison comparison;
+		if (! scanComparison (me, & p, & comparison))
+			return false;
+		out_criterion -> back (). push_back (std::move (comparison));
+		Melder_skipHorizontalOrVerticalSpace (& p);
+		if (*p == U'\0')
+			return true;
+		if (scanWord (& p, U"or"))
+			out_criterion -> emplace_back ();
+		else if (! scanWord (& p, U"and"))
+			return false;
+	}
+}
+
+static bool TableRowComparison_holds (const TableRowComparison *me, TableRow row) {
+	const conststring32 cell = row -> cells [my column]. string.get();
+	if (my isString) {
+		const int order = str32cmp (cell ? cell : U"", my string.c_str ());
+		switch (my relation) {
+			case kTableRowRelation::EQ: return order == 0;
+			case kTableRowRelation::NE: return order != 0;
+			case kTableRowRelation::LT: return order < 0;
+			case kTableRowRelation::LE: return order <= 0;
+			case kTableRowRelation::GT: return order > 0;
+			case kTableRowRelation::GE: return order >= 0;
+		}
+	}
+	const double x = Table_cellStringToNumber (cell), y = my number;
+	if (isundef (x) || isundef (y)) {
+		const bool bothUndefined = isundef (x) && isundef (y);
+		switch (my relation) {
+			case kTableRowRelation::EQ: case kTableRowRelation::LE: case kTableRowRelation::GE: return bothUndefined;
+			case kTableRowRelation::NE: return ! bothUndefined;
+			case kTableRowRelation::LT: case kTableRowRelation::GT: return false;
+		}
+	}
+	switch (my relation) {
+		case kTableRowRelation::EQ: return x == y;
+		case kTableRowRelation::NE: return x != y;
+		case kTableRowRelation::LT: return x < y;
+		case kTableRowRelation::LE: return x <= y;
+		case kTableRowRelation::GT: return x > y;
+		case kTableRowRelation::GE: return x >= y;
+	}
+	return false;
+}
+
+static void Table_selectRowsByCriterion (Table me, const TableRowCriterion& criterion, integer firstRow, integer lastRow, BOOLVEC selection) {
+	for (integer irow = firstRow; irow <= lastRow; irow ++) {
+		const TableRow row = my rows.at [irow];
+		bool holds = false;
+		for (const std::vector <TableRowComparison>& conjunction : criterion) {
+			holds = true;
+			for (const TableRowComparison& comparison : conjunction)
+				if (! TableRowComparison_holds (& comparison, row)) {
+					holds = false;
+					break;
+				}
+			if (holds)
+				break;
+		}
+		selection [irow] = holds;
+	}
+}
+
+autoBOOLVEC Table_getRowSelectionWhere (Table me, conststring32 formula, Interpreter interpreter, integer columnNumber) {
+	Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);   // syntax errors come from the interpreter
+	const integer numberOfRows = my rows.size;
+	autoBOOLVEC selection = newBOOLVECzero (numberOfRows);
+	TableRowCriterion criterion;
+	if (! Table_compileRowCriterion (me, formula, & criterion)) {
+		Formula_Result result;
+		for (integer irow = 1; irow <= numberOfRows; irow ++) {
+			Formula_run (irow, columnNumber, & result);
+			selection [irow] = ( result. numericResult != 0.0 );
+		}
+		return selection;
+	}
+	const integer numberOfThreads = MelderThread_getNumberOfThreads (numberOfRows, 10.0 * numberOfRows * criterion.size ());
+	MelderThread_runStretches (numberOfThreads, numberOfRows, [&] (integer /* ithread */, integer firstRow, integer lastRow) {
+		Table_selectRowsByCriterion (me, criterion, firstRow, lastRow, selection.get());
+	});
+	return selection;
+}
+
 integer Table_getNumberOfRowsWhere (Table me, conststring32 formula, Interpreter interpreter) {
+	autoBOOLVEC selection = Table_getRowSelectionWhere (me, formula, interpreter, 1);
 	integer numberOfRows = 0;
-	Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
-	Formula_Result result;
-	for (integer irow = 1; irow <= my rows.size; irow ++) {
-		Formula_run (irow, 1, & result);
-		if (result. numericResult != 0.0)
+	for (integer irow = 1; irow <= selection.size; irow ++)
+		if (selection [irow])
 			numberOfRows ++;
-	}
 	return numberOfRows;
 }
 
 autoINTVEC Table_findRowsMatchingCriterion (Table me, conststring32 formula, Interpreter interpreter) {
 	try {
-		const integer numberOfMatches = Table_getNumberOfRowsWhere (me, formula, interpreter);
+		autoBOOLVEC selection = Table_getRowSelectionWhere (me, formula, interpreter, 1);
+		integer numberOfMatches = 0;
+		for (integer irow = 1; irow <= selection.size; irow ++)
+			if (selection [irow])
+				numberOfMatches ++;
 		Melder_require (numberOfMatches > 0,
 			U"No rows selected.");
-		Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
-		Formula_Result result;
-		autoINTVEC selectedRows = newINTVECzero (numberOfMatches);
+		autoINTVEC selectedRows = newINTVECraw (numberOfMatches);
 		integer n = 0;
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			Formula_run (irow, 1, & result);
-			if (result. numericResult != 0.0)
-				selectedRows [ ++ n] = irow;
-		}
-		Melder_assert (n == numberOfMatches);
+		for (integer irow = 1; irow <= selection.size; irow ++)
+			if (selection [irow])
+				selectedRows [++ n] = irow;
 		return selectedRows;
 	} catch (MelderError) {
 		Melder_throw (me, U": cannot find matches.");
@@ -4521,14 +4779,12 @@ void Table_lagPlotWhere (Table me, Graphics g, integer column, integer lag, doub
 
 autoTable Table_extractRowsWhere (Table me, conststring32 formula, Interpreter interpreter) {
 	try {
-		Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
-		Formula_Result result;
+		autoBOOLVEC selection = Table_getRowSelectionWhere (me, formula, interpreter, 1);
 		autoTable thee = Table_create (0, my numberOfColumns);
 		for (integer icol = 1; icol <= my numberOfColumns; icol ++)
 			thy columnHeaders [icol]. label = Melder_dup (my columnHeaders [icol]. label.get());
 		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			Formula_run (irow, 1, & result);
-			if (result. numericResult != 0.0) {
+			if (selection [irow]) {
 				const TableRow row = my rows.at [irow];
 				autoTableRow newRow = Data_copy (row);
 				thy rows. addItem_move (newRow.move());
@@ -30,6 +30,12 @@
 #include "SSCP.h"
 #include "Table.h"
 
+/*
+	Evaluates the formula once for every row (with `col` equal to `columnNumber`);
+	simple comparisons of cells with literals are evaluated without the interpreter.
+*/
+autoBOOLVEC Table_getRowSelectionWhere (Table me, conststring32 formula, Interpreter interpreter, integer columnNumber);
+
 integer Table_getNumberOfRowsWhere (Table me, conststring32 formula, Interpreter interpreter);
 
 autoINTVEC Table_findRowsMatchingCriterion (Table me, conststring32 formula, Interpreter interpreter);
@@ -187,6 +187,34 @@ ENTRY (U"Settings & EM Algorithm")
 NORMAL (U"As decribed in @@TableOfReal: To GaussianMixture...@.")
 MAN_END
 
+MAN_BEGIN (U"GaussianMixture & TableOfReal: Improve likelihood (mini-batch)...", U"agent", 20261018)
+INTRO (U"Try to improve the likelihood of the parameters in the @@GaussianMixture@ with a stepwise @@expectation-maximization@ algorithm "
+	"that updates the parameters after every batch of rows instead of after every pass through all the data.")
+NORMAL (U"This converges in fewer passes through the data than @@GaussianMixture & TableOfReal: Improve likelihood...@ "
+	"if the table has very many rows, and only one batch needs to be in memory at a time.")
+ENTRY (U"Settings")
+TAG (U"##Batch size")
+DEFINITION (U"the number of rows that together make one update of the parameters. The rows are visited in a different random order in every epoch.")
+TAG (U"##Number of epochs")
+DEFINITION (U"the number of passes through all the rows.")
+TAG (U"##Step size exponent")
+DEFINITION (U"determines how fast earlier batches are forgotten. After batch %t, the sufficient statistics of the mixture are "
+	"(1 - \\et__%t_) times the previous statistics plus \\et__%t_ times those of the batch, with \\et__%t_ = %t^^-%\\al^, "
+	"where %\\al is the step size exponent, which should be larger than 0.5 and at most 1 (Cappé & Moulines, 2009).")
+TAG (U"##Stability coefficient lambda")
+DEFINITION (U"as in @@TableOfReal: To GaussianMixture...@.")
+MAN_END
+
+MAN_BEGIN (U"GaussianMixture: Improve likelihood from folder (mini-batch)...", U"agent", 20261018)
+INTRO (U"Improve the likelihood of the parameters in the selected @@GaussianMixture@ "
+	"as in @@GaussianMixture & TableOfReal: Improve likelihood (mini-batch)...@, "
+	"but with the data in the TableOfReal or Matrix files in a folder, so that the data together can be larger than the memory.")
+NORMAL (U"Only one file is read at a time. The files are visited in a different random order in every epoch, and the rows of each file in random order too. "
+	"For a Matrix file, the rows are the observations.")
+NORMAL (U"If the stability coefficient lambda is larger than zero, all the files are read once extra beforehand, "
+	"to compute the total covariance with @@Create SSCP from folder...@.")
+MAN_END
+
 MAN_BEGIN (U"GaussianMixture & TableOfReal: To Correlation (columns)", U"djmw", 20101111)
 INTRO (U"Create a @Correlation matrix from the selected @TableOfReal and the @GaussianMixture.")
 NORMAL (U"We start by calculating the ClassificationTable @@GaussianMixture & TableOfReal: To ClassificationTable|from "
@@ -307,6 +307,22 @@ ENTRY (U"Algorithm")
 NORMAL (U"The distance %d__%ij_ between objects %i and %j is calculated as:")
 FORMULA (U"%d__%ij_ = %d__%ji_ = (\\su__%k=1..%numberOfDimensions_ |%x__%ik_ "
 	"\\-- %x__%jk_|^2)^^1/2^")
+NORMAL (U"For a Configuration with another distance metric %m, e.g. from @@Dissimilarity: To Configuration (kruskal)...@, "
+	"and with dimension weights %w__%k_, the distance is the weighted Minkowski distance")
+FORMULA (U"%d__%ij_ = (\\su__%k=1..%numberOfDimensions_ %w__%k_ |%x__%ik_ "
+	"\\-- %x__%jk_|^^%m^)^^1/%m^")
+NORMAL (U"For large configurations the rows are divided over several threads. "
+	"Euclidean distances in 16 or more dimensions are computed from the inner products of the centred "
+	"points, as %d__%ij_^2 = |%x__%i_|^2 + |%x__%j_|^2 \\-- 2 %x__%i_\\.c%x__%j_; "
+	"pairs whose distance is small with respect to their norms are computed directly, "
+	"so that no precision is lost by cancellation.")
+MAN_END
+
+MAN_BEGIN (U"Configuration: List pairwise distances", U"agent", 20261018)
+INTRO (U"A command that gives the distances between all pairs of points of the selected @Configuration "
+	"as a vector, in the order (1,2), (1,3), ..., (1,%n), (2,3), ..., (%n\\--1,%n).")
+NORMAL (U"These are the values in the upper triangle of the @Distance that @@Configuration: To Distance@ would give, "
+	"in half the memory: a script can use the vector for large configurations, for which the full matrix would not fit.")
 MAN_END
 
 MAN_BEGIN (U"Configuration: To Similarity (cc)", U"djmw", 19980130)
@@ -1735,6 +1751,31 @@ FORMULA (U"%\\si__2_ = \\Vr ((%\\et__%d\\'p_^2 \\.c %\\et^2(#X) - "
 	"%w__%ij_(%d__%ij_(#X) - %averageDistance)^2))")
 MAN_END
 
+MAN_BEGIN (U"Table: To Configuration (sparse mds)...", U"agent", 20261018)
+INTRO (U"A command that creates a @Configuration from a @Table with dissimilarities between some of the pairs of a large number of points.")
+NORMAL (U"Each row of the table contains the numbers of two points, their dissimilarity, and optionally a weight. "
+	"Pairs that do not occur in the table do not count; every point should occur at least once. "
+	"Unlike a @Dissimilarity, which stores all the pairs, the table can therefore describe tens of thousands of points.")
+ENTRY (U"Settings")
+TAG (U"##First point column#, ##Second point column#")
+DEFINITION (U"the labels of the columns with the point numbers, which run from 1 to the number of points.")
+TAG (U"##Dissimilarity column#")
+DEFINITION (U"the label of the column with the dissimilarities.")
+TAG (U"##Weight column (optional)#")
+DEFINITION (U"the label of the column with the weights; if empty, all weights are 1.")
+TAG (U"##Number of landmarks#")
+DEFINITION (U"the number of randomly chosen points that determine the start configuration. "
+	"The shortest-path distances from these landmarks to all other points, via the known dissimilarities, "
+	"are scaled with classical MDS (De Silva & Tenenbaum 2004). With 0, the start configuration is random.")
+ENTRY (U"Algorithm")
+NORMAL (U"The stress sum %w__%ij_ (%\\de__%ij_ \\-- %d__%ij_)^2 over the given pairs is minimized with the @@smacof@ algorithm "
+	"of absolute MDS. The Guttman transform is not computed with a pseudo-inverse of %V, but solved with conjugate gradients, "
+	"so that memory and time per iteration are proportional to the number of pairs. "
+	"On computers with more than one processor core, the products with %B(%X) and %V are computed in parallel. "
+	"The iterations stop when the relative decrease of the normalized stress, sum %w (%\\de \\-- %d)^2 / sum %w %\\de^2, "
+	"is less than the %tolerance.")
+MAN_END
+
 MAN_BEGIN (U"TableOfReal: Centre columns", U"djmw", 19980422)
 INTRO (U"A command that centres the columns in the selected @TableOfReal "
 	"objects.")
@@ -1020,6 +1020,24 @@ TAG (U"##Number of observations")
 DEFINITION (U"defines the number of observations.")
 MAN_END
 
+MAN_BEGIN (U"Create SSCP from folder...", U"agent", 20261018)
+INTRO (U"A command that creates an @SSCP object from all the rows of all the @TableOfReal or @Matrix files in a folder, "
+	"as if the rows had been appended into one table before @@TableOfReal: To SSCP...@.")
+ENTRY (U"Settings")
+TAG (U"##Folder with data files")
+DEFINITION (U"the folder that contains the files.")
+TAG (U"##Data file extension")
+DEFINITION (U"only the files with this extension are read. All files should have the same number of columns. "
+	"The rows of a Matrix file are interpreted as observations, as in a TableOfReal.")
+ENTRY (U"Algorithm")
+NORMAL (U"Only one file is in memory at a time, so the files together can be much larger than the memory of your computer. "
+	"The rows of each file are added in blocks, each block with its own centroid; "
+	"a block is merged into the total with the update of Chan, Golub & LeVeque (1983), "
+	"which gives the same result as the direct computation to within rounding errors. "
+	"On computers with more than one processor core, the blocks of a large file are handled in parallel.")
+NORMAL (U"To add more data to an existing SSCP, select it together with a TableOfReal or Matrix and choose ##Add rows#.")
+MAN_END
+
 MAN_BEGIN (U"Create simple Covariance...", U"djmw", 20101125)
 INTRO (U"Create a @@Covariance@ matrix with its centroid.")
 ENTRY (U"Settings")
@@ -2743,12 +2761,30 @@ MAN_END
 
 MAN_BEGIN (U"Matrix: To NMF (m.u.)...", U"djmw", 20190409)
 INTRO (U"A command to get the @@non-negative matrix factorization@ of a matrix by means of a multiplicative update algorithm.")
+NORMAL (U"If fewer than one in ten cells of the matrix are non-zero, the updates only visit the non-zero cells. "
+	"For matrices that are too large to fit in memory as a whole, see @@Table: To NMF (m.u.)...@.")
 MAN_END
 
 MAN_BEGIN (U"Matrix: To NMF (ALS)...", U"djmw", 20190409)
 INTRO (U"A command to get the @@non-negative matrix factorization@ of a matrix by means of an Alternating Least Squares algorithm.")
 MAN_END
 
+MAN_BEGIN (U"Table: To NMF (m.u.)...", U"agent", 20261018)
+INTRO (U"A command to get the @@non-negative matrix factorization@ of a matrix of which most cells are zero, "
+	"by means of the multiplicative update algorithm of @@Matrix: To NMF (m.u.)...@.")
+NORMAL (U"Each row of the @Table gives one non-zero cell of the matrix: its row number, its column number and its value. "
+	"The number of rows and columns of the matrix are the largest row and column numbers in the table; "
+	"cells that occur more than once are added, for instance when the table contains co-occurrence counts. "
+	"The time and memory needed are proportional to the number of non-zero cells, "
+	"not to the size of the matrix. The starting factorization is random.")
+MAN_END
+
+MAN_BEGIN (U"Table: To NMF (ALS)...", U"agent", 20261018)
+INTRO (U"A command to get the @@non-negative matrix factorization@ of a matrix of which most cells are zero, "
+	"by means of the Alternating Least Squares algorithm of @@Matrix: To NMF (ALS)...@. "
+	"The table gives the non-zero cells as in @@Table: To NMF (m.u.)...@.")
+MAN_END
+
 MAN_BEGIN (U"Matrix: To NMF (IS)...", U"djmw", 20191025)
 INTRO (U"A command to get the @@non-negative matrix factorization@ of a matrix based on the Itakura-Saito distance as was described in @@Févotte, Bertin & Durrieu (2009)@.")
 MAN_END
@@ -5417,6 +5453,33 @@ INTRO (U"A command that creates a @PCA object from every selected "
 NORMAL (U"In @@Principal component analysis|the tutorial on PCA@ you will find more info on principal component analysis.")
 MAN_END
 
+MAN_BEGIN (U"TableOfReal: To PCA (randomized)...", U"agent", 20261018)
+INTRO (U"A command that creates a @PCA object with only the first principal components from every selected "
+	"@TableOfReal object, interpreted as row-oriented as in @@TableOfReal: To PCA@.")
+ENTRY (U"Settings")
+TAG (U"##Number of components")
+DEFINITION (U"the number of principal components to compute.")
+TAG (U"##Number of power iterations")
+DEFINITION (U"the number of times the approximation is refined; 2 is usually enough for data whose "
+	"eigenvalues decrease fast, more may be needed when they decrease slowly.")
+ENTRY (U"Algorithm")
+NORMAL (U"A randomized truncated singular value decomposition of the centred data (Halko, Martinsson & Tropp 2011): "
+	"the data are multiplied by a random matrix with 10 more columns than the number of components, "
+	"and the singular value decomposition is done only in the space spanned by the result. "
+	"For tables with many rows this is much faster than the full decomposition, and it needs no centred copy of the data.")
+MAN_END
+
+MAN_BEGIN (U"TableOfReal: To PCA (one pass)...", U"agent", 20261018)
+INTRO (U"A command that creates a @PCA object from every selected "
+	"@TableOfReal object, interpreted as row-oriented as in @@TableOfReal: To PCA@.")
+ENTRY (U"Settings")
+TAG (U"##Number of components")
+DEFINITION (U"the number of principal components to keep; 0 means all.")
+ENTRY (U"Algorithm")
+NORMAL (U"The covariance matrix is accumulated in a single pass over the rows, block by block, "
+	"without a copy of the data; the principal components are the eigenvectors of the covariance matrix.")
+MAN_END
+
 MAN_BEGIN (U"TableOfReal: To SSCP...", U"djmw", 19990218)
 INTRO (U"Calculates Sums of Squares and Cross Products (@SSCP) from the selected @TableOfReal.")
 ENTRY (U"Algorithm")
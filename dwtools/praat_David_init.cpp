@@ -125,6 +125,7 @@
 #include "Discriminant_PatternList_Categories.h"
 #include "DTW_and_TextGrid.h"
 #include "Matrix_and_NMF.h"
+#include "Table_and_NMF.h"
 #include "Permutation_and_Index.h"
 #include "Pitch_extensions.h"
 #include "Sound_and_Spectrogram_extensions.h"
@@ -3783,6 +3784,42 @@ DO
 	CONVERT_EACH_END (my name.get(), U"_als")
 }
 
+FORM (NEW_Table_to_NMF_mu, U"Table: To NMF (m.u.)", U"Table: To NMF (m.u.)...") {
+	SENTENCE (rowNumberColumnLabel, U"Row number column", U"row")
+	SENTENCE (columnNumberColumnLabel, U"Column number column", U"column")
+	SENTENCE (valueColumnLabel, U"Value column", U"value")
+	NATURAL (numberOfFeatures, U"Number of features", U"2")
+	INTEGER (maximumNumberOfIterations, U"Maximum number of iterations", U"400")
+	REAL (tolx, U"Change tolerance", U"1e-9")
+	REAL (told, U"Approximation tolerance", U"1e-9")
+	BOOLEAN (info, U"Info", 0)
+	OK
+DO
+	Melder_require (maximumNumberOfIterations >= 0, U"The maximum number of iterations should not be negative.");
+	CONVERT_EACH (Table)
+		autoNMF result = Table_to_NMF_mu (me, rowNumberColumnLabel, columnNumberColumnLabel, valueColumnLabel,
+				numberOfFeatures, maximumNumberOfIterations, tolx, told, info);
+	CONVERT_EACH_END (my name.get(), U"_mu")
+}
+
+FORM (NEW_Table_to_NMF_als, U"Table: To NMF (ALS)", U"Table: To NMF (ALS)...") {
+	SENTENCE (rowNumberColumnLabel, U"Row number column", U"row")
+	SENTENCE (columnNumberColumnLabel, U"Column number column", U"column")
+	SENTENCE (valueColumnLabel, U"Value column", U"value")
+	NATURAL (numberOfFeatures, U"Number of features", U"2")
+	INTEGER (maximumNumberOfIterations, U"Maximum number of iterations", U"20")
+	REAL (tolx, U"Change tolerance", U"1e-9")
+	REAL (told, U"Approximation tolerance", U"1e-9")
+	BOOLEAN (info, U"Info", 0)
+	OK
+DO
+	Melder_require (maximumNumberOfIterations >= 0, U"The maximum number of iterations should not be negative.");
+	CONVERT_EACH (Table)
+		autoNMF result = Table_to_NMF_als (me, rowNumberColumnLabel, columnNumberColumnLabel, valueColumnLabel,
+				numberOfFeatures, maximumNumberOfIterations, tolx, told, info);
+	CONVERT_EACH_END (my name.get(), U"_als")
+}
+
 DIRECT (REAL_NMF_Matrix_getEuclideanDistance) {
 	NUMBER_TWO (NMF, Matrix)
 		double result = NMF_getEuclideanDistance (me, your z.get());
@@ -6434,6 +6471,29 @@ DO
 	NUMBER_ONE_END (U" (= probability for chisq = ", chisq, U" and ndf = ", df, U")")
 }
 
+FORM (NEW1_SSCP_createFromFolder, U"Create SSCP from folder", U"Create SSCP from folder...") {
+	WORD (name, U"Name", U"total")
+	TEXTFIELD (folderWithDataFiles, U"Folder with data files:", U"")
+	WORD (dataFileExtension, U"Data file extension", U"TableOfReal")
+	OK
+DO
+	CREATE_ONE
+		autoSSCP result = SSCP_createFromFolder (folderWithDataFiles, dataFileExtension);
+	CREATE_ONE_END (name)
+}
+
+DIRECT (MODIFY_SSCP_TableOfReal_addRows) {
+	MODIFY_FIRST_OF_TWO (SSCP, TableOfReal)
+		SSCP_TableOfReal_addRows (me, you);
+	MODIFY_FIRST_OF_TWO_END
+}
+
+DIRECT (MODIFY_SSCP_Matrix_addRows) {
+	MODIFY_FIRST_OF_TWO (SSCP, Matrix)
+		SSCP_Matrix_addRows (me, you);
+	MODIFY_FIRST_OF_TWO_END
+}
+
 DIRECT (NEW_SSCP_to_Correlation) {
 	CONVERT_EACH (SSCP)
 		autoCorrelation result = SSCP_to_Correlation (me);
@@ -7412,6 +7472,25 @@ DIRECT (NEW_TableOfReal_to_PCA_byRows) {
 	CONVERT_EACH_END (my name.get())
 }
 
+FORM (NEW_TableOfReal_to_PCA_byRows_randomized, U"TableOfReal: To PCA (randomized)", U"TableOfReal: To PCA (randomized)...") {
+	NATURAL (numberOfComponents, U"Number of components", U"10")
+	INTEGER (numberOfPowerIterations, U"Number of power iterations", U"2")
+	OK
+DO
+	CONVERT_EACH (TableOfReal)
+		autoPCA result = TableOfReal_to_PCA_byRows_randomized (me, numberOfComponents, numberOfPowerIterations);
+	CONVERT_EACH_END (my name.get())
+}
+
+FORM (NEW_TableOfReal_to_PCA_byRows_onePass, U"TableOfReal: To PCA (one pass)", U"TableOfReal: To PCA (one pass)...") {
+	INTEGER (numberOfComponents, U"Number of components", U"0 (= all)")
+	OK
+DO
+	CONVERT_EACH (TableOfReal)
+		autoPCA result = TableOfReal_to_PCA_byRows_onePass (me, numberOfComponents);
+	CONVERT_EACH_END (my name.get())
+}
+
 FORM (NEW_TableOfReal_to_SSCP, U"TableOfReal: To SSCP", U"TableOfReal: To SSCP...") {
 	INTEGER (fromRow, U"Begin row", U"0")
 	INTEGER (toRow, U"End row", U"0")
@@ -7437,6 +7516,12 @@ DO
 	CONVERT_EACH_END (my name.get())
 }
 
+DIRECT (NEW1_TableOfReals_to_SSCP_allRows) {
+	CONVERT_TYPED_LIST (TableOfReal, TableOfRealList)
+		autoSSCP result = TableOfRealList_to_SSCP_allRows (list.get());
+	CONVERT_TYPED_LIST_END (U"total")
+}
+
 /* For the inheritors */
 DIRECT (NEW_TableOfReal_to_TableOfReal) {
 	CONVERT_EACH (TableOfReal)
@@ -7991,6 +8076,7 @@ void praat_uvafon_David_init () {
 		praat_addMenuCommand (U"Objects", U"New", U"Create simple Confusion...", U"Create TableOfReal (Weenink 1985)...", 1, NEW1_Confusion_createSimple);
 	praat_addMenuCommand (U"Objects", U"New", U"Create simple Covariance...", U"Create simple Confusion...", 1, NEW1_Covariance_createSimple);
 	praat_addMenuCommand (U"Objects", U"New", U"Create simple Correlation...", U"Create simple Covariance...", 1, NEW1_Correlation_createSimple);
+	praat_addMenuCommand (U"Objects", U"New", U"Create SSCP from folder...", U"Create simple Correlation...", 1, NEW1_SSCP_createFromFolder);
 	praat_addMenuCommand (U"Objects", U"New", U"Create empty EditCostsTable...", U"Create simple Covariance...", 1, NEW_EditCostsTable_createEmpty);
 
 	praat_addMenuCommand (U"Objects", U"New", U"Create KlattTable example", U"Create TableOfReal (Weenink 1985)...", praat_DEPTH_1 + praat_HIDDEN, NEW1_KlattTable_createExample);
@@ -8736,6 +8822,8 @@ void praat_uvafon_David_init () {
 	praat_addAction1 (classSSCP, 0, U"To PCA", nullptr, 0, NEW_SSCP_to_PCA);
 	praat_addAction1 (classSSCP, 0, U"To Correlation", nullptr, 0, NEW_SSCP_to_Correlation);
 	praat_addAction1 (classSSCP, 0, U"To Covariance...", nullptr, 0, NEW_SSCP_to_Covariance);
+	praat_addAction2 (classSSCP, 1, classTableOfReal, 1, U"Add rows", nullptr, 0, MODIFY_SSCP_TableOfReal_addRows);
+	praat_addAction2 (classSSCP, 1, classMatrix, 1, U"Add rows", nullptr, 0, MODIFY_SSCP_Matrix_addRows);
 
 	praat_addAction1 (classStrings, 0, U"To Categories", nullptr, 0, NEW_Strings_to_Categories);
 	praat_addAction1 (classStrings, 0, U"Append", nullptr, 0, NEW1_Strings_append);
@@ -8796,14 +8884,19 @@ void praat_uvafon_David_init () {
 	praat_addAction1 (classTable, 0, U"To KlattTable", nullptr, praat_HIDDEN, NEW_Table_to_KlattTable);
 	praat_addAction1 (classTable, 1, U"Get median absolute deviation...", U"Get standard deviation...", 1, REAL_Table_getMedianAbsoluteDeviation);
 	praat_addAction1 (classTable, 0, U"To StringsIndex (column)...", nullptr, praat_HIDDEN, NEW_Table_to_StringsIndex_column);
+	praat_addAction1 (classTable, 0, U"To NMF (m.u.)...", nullptr, praat_HIDDEN, NEW_Table_to_NMF_mu);
+	praat_addAction1 (classTable, 0, U"To NMF (ALS)...", nullptr, praat_HIDDEN, NEW_Table_to_NMF_als);
 
 	praat_addAction1 (classTableOfReal, 1, U"Report multivariate normality...", U"Get column stdev (label)...", praat_DEPTH_1 | praat_HIDDEN, INFO_TableOfReal_reportMultivariateNormality);
 	praat_addAction1 (classTableOfReal, 0, U"Append columns", U"Append", 1, NEW1_TableOfReal_appendColumns);
 	praat_addAction1 (classTableOfReal, 0, U"Multivariate statistics -", nullptr, 0, 0);
 	praat_addAction1 (classTableOfReal, 0, U"To Discriminant", nullptr, 1, NEW_TableOfReal_to_Discriminant);
 	praat_addAction1 (classTableOfReal, 0, U"To PCA", nullptr, 1, NEW_TableOfReal_to_PCA_byRows);
+	praat_addAction1 (classTableOfReal, 0, U"To PCA (randomized)...", U"To PCA", 1, NEW_TableOfReal_to_PCA_byRows_randomized);
+	praat_addAction1 (classTableOfReal, 0, U"To PCA (one pass)...", U"To PCA (randomized)...", 1, NEW_TableOfReal_to_PCA_byRows_onePass);
 	praat_addAction1 (classTableOfReal, 0, U"To SSCP...", nullptr, 1, NEW_TableOfReal_to_SSCP);
 	praat_addAction1 (classTableOfReal, 0, U"To SSCP (row weights)...", nullptr, 1, NEW_TableOfReal_to_SSCP_rowWeights);
+	praat_addAction1 (classTableOfReal, 0, U"To SSCP (all rows)", nullptr, 1, NEW1_TableOfReals_to_SSCP_allRows);
 	praat_addAction1 (classTableOfReal, 0, U"To Covariance", nullptr, 1, NEW_TableOfReal_to_Covariance);
 	praat_addAction1 (classTableOfReal, 0, U"To Correlation", nullptr, 1, NEW_TableOfReal_to_Correlation);
 	praat_addAction1 (classTableOfReal, 0, U"To Correlation (rank)", nullptr, 1, NEW_TableOfReal_to_Correlation_rank);
@@ -609,6 +609,32 @@ DO
 	MODIFY_FIRST_OF_TWO_END
 }
 
+FORM (MODIFY_GaussianMixture_TableOfReal_improveLikelihood_miniBatch, U"GaussianMixture & TableOfReal: Improve likelihood (mini-batch)", U"GaussianMixture & TableOfReal: Improve likelihood (mini-batch)...") {
+	NATURAL (batchSize, U"Batch size", U"1000")
+	NATURAL (numberOfEpochs, U"Number of epochs", U"10")
+	POSITIVE (stepSizeExponent, U"Step size exponent", U"0.7")
+	REAL (lambda, U"Stability coefficient lambda", U"0.001")
+	OK
+DO
+	MODIFY_FIRST_OF_TWO (GaussianMixture, TableOfReal)
+		GaussianMixture_TableOfReal_improveLikelihood_miniBatch (me, you, batchSize, numberOfEpochs, stepSizeExponent, lambda);
+	MODIFY_FIRST_OF_TWO_END
+}
+
+FORM (MODIFY_GaussianMixture_improveLikelihood_miniBatchFromFolder, U"GaussianMixture: Improve likelihood from folder (mini-batch)", U"GaussianMixture: Improve likelihood from folder (mini-batch)...") {
+	TEXTFIELD (folderWithDataFiles, U"Folder with data files:", U"")
+	WORD (dataFileExtension, U"Data file extension", U"TableOfReal")
+	NATURAL (batchSize, U"Batch size", U"1000")
+	NATURAL (numberOfEpochs, U"Number of epochs", U"10")
+	POSITIVE (stepSizeExponent, U"Step size exponent", U"0.7")
+	REAL (lambda, U"Stability coefficient lambda", U"0.001")
+	OK
+DO
+	MODIFY_EACH (GaussianMixture)
+		GaussianMixture_improveLikelihood_miniBatchFromFolder (me, folderWithDataFiles, dataFileExtension, batchSize, numberOfEpochs, stepSizeExponent, lambda);
+	MODIFY_EACH_END
+}
+
 FORM (NEW1_GaussianMixture_TableOfReal_to_GaussianMixture_CEMM, U"GaussianMixture & TableOfReal: To GaussianMixture (CEMM)", U"GaussianMixture & TableOfReal: To GaussianMixture (CEMM)...") {
 	INTEGER (minimumNumberOfComponents, U"Minimum number of components", U"1")
 	POSITIVE (tolerance, U"Tolerance of minimizer", U"0.001")
@@ -676,6 +702,7 @@ void praat_HMM_init () {
 	praat_addAction1 (classGaussianMixture, 1, U"Get probability at position...", nullptr, 1, REAL_GaussianMixture_getProbabilityAtPosition);
 	praat_addAction1 (classGaussianMixture, 0, U"Modify -", nullptr, 0, nullptr);
 	praat_addAction1 (classGaussianMixture, 1, U"Split component...", nullptr, 1, MODIFY_GaussianMixture_splitComponent);
+	praat_addAction1 (classGaussianMixture, 0, U"Improve likelihood from folder (mini-batch)...", nullptr, 1, MODIFY_GaussianMixture_improveLikelihood_miniBatchFromFolder);
 	praat_addAction1 (classGaussianMixture, 0, U"Extract -", nullptr, 0, nullptr);
 	praat_addAction1 (classGaussianMixture, 0, U"Extract mixing probabilities", nullptr, 1, NEW_GaussianMixture_extractMixingProbabilities);
 	praat_addAction1 (classGaussianMixture, 0, U"Extract component...", nullptr, 1, NEW_GaussianMixture_extractComponent);
@@ -688,6 +715,7 @@ void praat_HMM_init () {
 
 	praat_addAction2 (classGaussianMixture, 1, classTableOfReal, 1, U"Get likelihood value...", nullptr, 0, REAL_GaussianMixture_TableOfReal_getLikelihoodValue);
 	praat_addAction2 (classGaussianMixture, 1, classTableOfReal, 1, U"Improve likelihood...", nullptr, 0, MODIFY_GaussianMixture_TableOfReal_improveLikelihood);
+	praat_addAction2 (classGaussianMixture, 1, classTableOfReal, 1, U"Improve likelihood (mini-batch)...", nullptr, 0, MODIFY_GaussianMixture_TableOfReal_improveLikelihood_miniBatch);
 	praat_addAction2 (classGaussianMixture, 1, classTableOfReal, 1, U"To GaussianMixture (CEMM)...", nullptr, 0, NEW1_GaussianMixture_TableOfReal_to_GaussianMixture_CEMM);
 	praat_addAction2 (classGaussianMixture, 1, classTableOfReal, 1, U"To TableOfReal (probabilities)", nullptr, 0, NEW1_GaussianMixture_TableOfReal_to_TableOfReal_probabilities);
 	praat_addAction2 (classGaussianMixture, 1, classTableOfReal, 1, U"To TableOfReal (responsibilities)", nullptr, 0, NEW1_GaussianMixture_TableOfReal_to_TableOfReal_responsibilities);
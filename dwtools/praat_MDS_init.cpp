@@ -294,6 +294,12 @@ DIRECT (NEW_Configuration_to_Distance) {
 	CONVERT_EACH_END (my name.get())
 }
 
+DIRECT (NUMVEC_Configuration_listPairwiseDistances) {
+	NUMVEC_ONE (Configuration)
+		autoVEC result = Configuration_listPairwiseDistances (me);
+	NUMVEC_ONE_END
+}
+
 FORM (NEW_Configuration_varimax, U"Configuration: To Configuration (varimax)", U"Configuration: To Configuration (varimax)...") {
 	BOOLEAN (normalizeRows, U"Normalize rows", true)
 	BOOLEAN (useQuartimax, U"Quartimax", false)
@@ -1269,6 +1275,28 @@ DIRECT (NEW_TableOfReal_to_Confusion) {
 	CONVERT_EACH_END (my name.get())
 }
 
+/************************* Table ****************************************/
+
+FORM (NEW_Table_to_Configuration_sparseMds, U"Table: To Configuration (sparse mds)", U"Table: To Configuration (sparse mds)...") {
+	LABEL (U"Dissimilarities")
+	SENTENCE (firstPointColumn, U"First point column", U"i")
+	SENTENCE (secondPointColumn, U"Second point column", U"j")
+	SENTENCE (dissimilarityColumn, U"Dissimilarity column", U"dissimilarity")
+	SENTENCE (weightColumn, U"Weight column (optional)", U"")
+	LABEL (U"Configuration")
+	NATURAL (numberOfDimensions, U"Number of dimensions", U"2")
+	INTEGER (numberOfLandmarks, U"Number of landmarks", U"50 (= 0: random start)")
+	LABEL (U"Minimization parameters")
+	REAL (tolerance, U"Tolerance", U"1e-5")
+	NATURAL (maximumNumberOfIterations, U"Maximum number of iterations", U"500")
+	OK
+DO
+	CONVERT_EACH (Table)
+		autoConfiguration result = Table_to_Configuration_sparseMds (me, firstPointColumn, secondPointColumn, dissimilarityColumn,
+				weightColumn, numberOfDimensions, numberOfLandmarks, tolerance, maximumNumberOfIterations, true, nullptr);
+	CONVERT_EACH_END (my name.get(), U"_sparse")
+}
+
 static void praat_AffineTransform_init (ClassInfo klas) {
 	praat_addAction1 (klas, 0, QUERY_BUTTON, nullptr, 0, nullptr);
 	praat_addAction1 (klas, 1, U"Get transformation element...", QUERY_BUTTON, 1, REAL_AffineTransform_getTransformationElement);
@@ -1309,6 +1337,8 @@ void praat_uvafon_MDS_init () {
 	praat_AffineTransform_init (classAffineTransform);
 
 
+	praat_addAction1 (classTable, 0, U"To Configuration (sparse mds)...", U"To logistic regression...", praat_DEPTH_1, NEW_Table_to_Configuration_sparseMds);
+
 	praat_addAction1 (classConfiguration, 0, U"Configuration help", nullptr, 0, HELP_Configuration_help);
 	praat_TableOfReal_init2 (classConfiguration);
 	praat_TableOfReal_extras (classConfiguration);
@@ -1331,6 +1361,7 @@ void praat_uvafon_MDS_init () {
 	praat_addAction1 (classConfiguration, 0, U"Invert dimension...", U"Rotate (pc)", 1, MODIFY_Configuration_invertDimension);
 	praat_addAction1 (classConfiguration, 0, U"Analyse", nullptr, 0, nullptr);
 	praat_addAction1 (classConfiguration, 0, U"To Distance", nullptr, 0, NEW_Configuration_to_Distance);
+	praat_addAction1 (classConfiguration, 1, U"List pairwise distances", U"To Distance", 0, NUMVEC_Configuration_listPairwiseDistances);
 	praat_addAction1 (classConfiguration, 0, U"To Configuration (varimax)...", nullptr, 0, NEW_Configuration_varimax);
 	praat_addAction1 (classConfiguration, 0, U"To Similarity (cc)", nullptr, 0, NEW1_Configurations_to_Similarity_cc);
 
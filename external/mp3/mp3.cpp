@@ -55,7 +55,18 @@ extern "C" {
 }
 
 #define MP3F_BUFFER_SIZE (8 * 1024)
-#define MP3F_MAX_LOCATIONS 1024
+
+/*
+ * Layer III frames can take their main data from up to 511 bytes (MPEG-1)
+ * of earlier frames (the "bit reservoir"). A frame of which these bytes
+ * have not been fed to the decoder cannot be decoded, and the first frame
+ * that is decoded lacks the overlap from its predecessor. To seek, we therefore
+ * start decoding at least enough frames before the target frame that
+ * the frame before the target frame is decoded correctly.
+ * The overhead is the frame header, the CRC and the side info.
+ */
+#define MP3F_MAX_RESERVOIR_BYTES 511
+#define MP3F_FRAME_OVERHEAD_BYTES (4 + 2 + 32)
 
 /*
  * MP3 encoders and decoders add a number of silent samples at the beginning.
@@ -90,9 +101,8 @@ struct _MP3_FILE
 	unsigned samples_per_frame;
 	MP3F_OFFSET samples;
 
-	MP3F_OFFSET locations[MP3F_MAX_LOCATIONS]; 
-	unsigned num_locations;
-	unsigned frames_per_location;
+	MP3F_OFFSET *locations;   /* the file offset of every frame */
+	unsigned num_locations, max_locations;
 
 	unsigned delay;
 
@@ -103,6 +113,7 @@ struct _MP3_FILE
 	MP3F_OFFSET read_amount;
 	MP3F_OFFSET first_offset;
 	unsigned skip_amount;
+	MP3F_OFFSET seek_sample;   /* the sample we are seeking, including the delay */
 	int need_seek;
 	MP3F_OFFSET id3TagSize_bytes; /* David Weenink */
 };
@@ -117,6 +128,31 @@ static int mp3f_check_xing (MP3_FILE mp3f, struct mad_stream const *stream);
 static enum mad_flow mp3f_mad_scan_header (void *context, struct mad_header const *header);
 static enum mad_flow mp3f_mad_report_samples (void *context, struct mad_header const *header, struct mad_pcm *pcm);
 
+static void mp3f_add_location (MP3_FILE mp3f, MP3F_OFFSET offset)
+{
+	if (mp3f -> num_locations >= mp3f -> max_locations) {
+		/* We are in a libMAD callback, so we cannot throw */
+		unsigned new_max = mp3f -> max_locations ? 2 * mp3f -> max_locations : 1024;
+		mp3f -> locations = (MP3F_OFFSET *) Melder_realloc_f (mp3f -> locations, new_max * (int64) sizeof (MP3F_OFFSET));
+		mp3f -> max_locations = new_max;
+	}
+	mp3f -> locations [mp3f -> num_locations ++] = offset;
+}
+
+/* Returns the index of the frame that starts at the given offset, or -1 if there is no such frame */
+static long mp3f_find_location (MP3_FILE mp3f, MP3F_OFFSET offset)
+{
+	unsigned low = 0, high = mp3f -> num_locations;
+	while (low < high) {
+		unsigned mid = low + (high - low) / 2;
+		if (mp3f -> locations [mid] < offset)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low < mp3f -> num_locations && mp3f -> locations [low] == offset ? (long) low : -1;
+}
+
 int mp3_recognize (int nread, const char *data)
 {
 	const unsigned char *bytes = (const unsigned char *)data;
@@ -154,6 +190,8 @@ MP3_FILE mp3f_new ()
 
 void mp3f_delete (MP3_FILE mp3f)
 {
+	if (mp3f)
+		Melder_free (mp3f -> locations);
 	Melder_free (mp3f);
 }
 
@@ -239,7 +277,7 @@ int mp3f_analyze (MP3_FILE mp3f)
 	struct mad_decoder *decoder = & mp3f -> decoder;
 	int status;
 #ifdef MP3_DEBUG
-	unsigned estimate, last;
+	unsigned estimate;
 #endif /* MP3_DEBUG */
 
 	if (! mp3f || ! mp3f -> f)
@@ -292,18 +330,22 @@ int mp3f_analyze (MP3_FILE mp3f)
 		MP3_DPRINTF (("Estimated frames: %lu\n", (unsigned long)mp3f -> frames));
 	}
 
-	/* Calculate how many frames can fit in a "location" */
-	if (mp3f -> frames <= MP3F_MAX_LOCATIONS)
-		mp3f -> frames_per_location = 1;
-	else
-		mp3f -> frames_per_location = (mp3f -> frames + MP3F_MAX_LOCATIONS - 1) / MP3F_MAX_LOCATIONS;
-
-	MP3_DPRINTF (("MP3: Each location is %u frame(s) (%.3fs), each %u samples\n",
-				mp3f -> frames_per_location,
-				mp3f -> frames_per_location * mp3f -> samples_per_frame / (float)mp3f -> frequency,
-				mp3f -> samples_per_frame));
+	/*
+	 * We are going to remember the offset of every frame, so that we can seek in constant time.
+	 * Reserve room for the estimated number of frames (plus a margin, for VBR files without Xing),
+	 * but do not trust a corrupt Xing frame count for more than a few hours of audio.
+	 */
+	{
+		unsigned expected = mp3f -> frames + mp3f -> frames / 16 + 16;
+		if (expected > (1U << 20))
+			expected = 1U << 20;
+		if (expected > mp3f -> max_locations) {
+			mp3f -> locations = (MP3F_OFFSET *) Melder_realloc_f (mp3f -> locations, expected * (int64) sizeof (MP3F_OFFSET));
+			mp3f -> max_locations = expected;
+		}
+	}
 
-	/* Read all frames to get offsets*/
+	/* Read all frame headers to get offsets */
 #ifdef MP3_DEBUG
 	estimate = mp3f -> frames;
 #endif /* MP3_DEBUG */
@@ -327,13 +369,6 @@ int mp3f_analyze (MP3_FILE mp3f)
 		       	mp3f -> frames,
 		       	estimate,
 			MP3_PERCENT (mp3f -> frames, estimate)));
-#ifdef MP3_DEBUG
-	last = mp3f -> frames - (mp3f -> frames_per_location * (mp3f -> num_locations - 1));
-	MP3_DPRINTF (("MP3F: Last location frames = %u (%+.2f%%) = %.3fs\n",
-				last,
-				MP3_PERCENT (mp3f -> frames_per_location, last),
-				last * mp3f -> samples_per_frame / (float)mp3f -> frequency));
-#endif /* MP3_DEBUG */
 
 if(status!=-1)   // ppgb 2015-01-17
 	mp3f_seek (mp3f, 0);
@@ -368,47 +403,49 @@ void mp3f_set_callback (MP3_FILE mp3f,
 
 int mp3f_seek (MP3_FILE mp3f, MP3F_OFFSET sample)
 {
-	MP3F_OFFSET frame, location, base, offset;
+	MP3F_OFFSET target, frame, base, offset;
 
 	if (! mp3f || ! mp3f -> f)
 		return 0;
 
-	if (! mp3f -> frames_per_location)
+	if (! mp3f -> num_locations)
 		if (! mp3f_analyze (mp3f))
 			return 0;
+Melder_assert (mp3f -> num_locations > 0);
 
 	/* Compensate for initial empty frames */
 	sample += mp3f -> delay;
 
 	/* Calculate where we need to seek */
-	frame = sample / mp3f -> samples_per_frame;
+	target = sample / mp3f -> samples_per_frame;
+	if (target >= mp3f -> num_locations)
+		target = mp3f -> num_locations - 1;
+	frame = target;
 	if ( frame ) /* libMAD can skip the first frame... */
 		-- frame; 
 	if ( frame ) /* ...and the first frame it decodes is useless */
 		-- frame; 
-Melder_assert (mp3f -> frames_per_location > 0);
-Melder_assert (mp3f -> num_locations > 0);
-	location = frame / mp3f -> frames_per_location;
-	if (location >= mp3f -> num_locations)
-		location = mp3f -> num_locations - 1;
-	frame = location * mp3f -> frames_per_location;
+	/* ...and the frame before the target frame needs its bit reservoir */
+	while (frame > 0 && mp3f -> locations [target - 1] - mp3f -> locations [frame + 1] <
+			MP3F_MAX_RESERVOIR_BYTES + (target - frame - 2) * MP3F_FRAME_OVERHEAD_BYTES)
+		-- frame;
 	base = frame * mp3f -> samples_per_frame;
 
-Melder_assert (location >= 0);
-	offset = mp3f -> locations [location];
+	offset = mp3f -> locations [frame];
 	if (fseek (mp3f -> f, offset, SEEK_SET) < 0)
 		return 0;
 
 	mp3f -> first_offset = offset;
+	mp3f -> seek_sample = sample;
 	mp3f -> skip_amount = sample - base;
 	mp3f -> need_seek = 0;
 
-	MP3_DPRINTF (("SEEK to %lu (%lu + %u): Frame %lu, location %lu, offset %lu, base %lu, skip %u\n",
+	MP3_DPRINTF (("SEEK to %lu (%lu + %u): Frame %lu, target frame %lu, offset %lu, base %lu, skip %u\n",
 			(unsigned long)sample, 
 			(unsigned long)sample - mp3f -> delay,
 		       	mp3f -> delay,
 			(unsigned long)frame, 
-			(unsigned long)location, 
+			(unsigned long)target, 
 			(unsigned long)offset,
 			(unsigned long)base,
 		       	mp3f -> skip_amount));
@@ -456,10 +493,12 @@ static enum mad_flow mp3f_mad_report_samples (void *context, struct mad_header c
 		return MAD_FLOW_BREAK;
 	
 	if (mp3f -> first_offset) {
-		/* libMAD can decide to skip the first frame */
+		/* libMAD can decide to skip the first frame(s), so we look up which frame this is */
 		if (header -> offset > mp3f -> first_offset) {
-			MP3_DPRINTF (("Skip %u of %lu\n", length, mp3f -> skip_amount));
-			mp3f -> skip_amount -= length;
+			long frame = mp3f_find_location (mp3f, header -> offset);
+			MP3F_OFFSET base = frame >= 0 ? frame * mp3f -> samples_per_frame : mp3f -> seek_sample - mp3f -> skip_amount + length;
+			MP3_DPRINTF (("Skip to frame %ld\n", frame));
+			mp3f -> skip_amount = mp3f -> seek_sample > base ? mp3f -> seek_sample - base : 0;
 		}
 		mp3f -> first_offset = 0;
 	}
@@ -551,7 +590,7 @@ static enum mad_flow mp3f_mad_first_header(void *context, struct mad_header cons
 	mp3f -> frequency = header -> samplerate;
 	mp3f -> samples_per_frame = 32 * MAD_NSBSAMPLES (header);
 	/* Just in case there is no Xing header: */
-	mp3f -> locations [mp3f -> num_locations ++] = header -> offset;
+	mp3f_add_location (mp3f, header -> offset);
 
 	return MAD_FLOW_CONTINUE;
 }
@@ -588,10 +627,8 @@ static enum mad_flow mp3f_mad_scan_header(void *context, struct mad_header const
 	if (mp3f -> samples_per_frame != 32 * MAD_NSBSAMPLES (header))
 		return MAD_FLOW_BREAK;
 
-	/* Check whether to log this offset in the table */
-	if ((mp3f -> frames % mp3f -> frames_per_location) == 0 &&
-			mp3f -> num_locations < MP3F_MAX_LOCATIONS)
-		mp3f -> locations [mp3f -> num_locations ++] = header -> offset;
+	/* Log this offset in the table */
+	mp3f_add_location (mp3f, header -> offset);
 
 	/* Count this frame */
 	++ mp3f -> frames;
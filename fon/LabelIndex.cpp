@@ -0,0 +1,305 @@
+/* LabelIndex.cpp
+ *
+ * Copyright (C) 2026 Paul Boersma
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This code is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this work. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "LabelIndex.h"
+#include "Strings_.h"
+
+#include "oo_DESTROY.h"
+#include "LabelIndex_def.h"
+#include "oo_COPY.h"
+#include "LabelIndex_def.h"
+#include "oo_EQUAL.h"
+#include "LabelIndex_def.h"
+#include "oo_CAN_WRITE_AS_ENCODING.h"
+#include "LabelIndex_def.h"
+#include "oo_WRITE_TEXT.h"
+#include "LabelIndex_def.h"
+#include "oo_READ_TEXT.h"
+#include "LabelIndex_def.h"
+#include "oo_WRITE_BINARY.h"
+#include "LabelIndex_def.h"
+#include "oo_READ_BINARY.h"
+#include "LabelIndex_def.h"
+#include "oo_DESCRIPTION.h"
+#include "LabelIndex_def.h"
+
+Thing_implement (LabelIndex, Daata, 0);
+
+void structLabelIndex :: v_info () {
+	structDaata :: v_info ();
+	MelderInfo_writeLine (U"Folder: ", folder.get());
+	MelderInfo_writeLine (U"Number of files: ", numberOfFiles);
+	MelderInfo_writeLine (U"Number of tiers: ", numberOfTiers);
+	MelderInfo_writeLine (U"Number of different labels: ", numberOfLabels);
+	MelderInfo_writeLine (U"Number of intervals and points: ", numberOfHits);
+}
+
+/*
+	The folder as typed by the user may be relative to the default folder, just like a file name.
+*/
+static void relativePathToFolder (conststring32 path, MelderDir folder) {
+	structMelderFile folderAsFile { };
+	Melder_relativePathToFile (path, & folderAsFile);
+	Melder_pathToDir (Melder_fileToPath (& folderAsFile), folder);
+}
+
+static autoLabelIndex LabelIndex_create (conststring32 folder, constSTRVEC fileNames) {
+	autoLabelIndex me = Thing_new (LabelIndex);
+	my folder = Melder_dup (folder);
+	my numberOfFiles = fileNames.size;
+	my fileNames = newSTRVECcopy (fileNames);
+	/*
+		Collect the hits in corpus order, numbering the labels in the order in which they first occur.
+		The keys of the dictionary point into the label strings, so that looking up a label that we have seen before costs no allocation.
+	*/
+	std::vector <autostring32> labels;
+	std::unordered_map <std::u32string_view, integer> labelNumbers;
+	struct Hit {
+		integer label, tier, item;
+		double start, end;
+	};
+	std::vector <Hit> hits;
+	std::vector <autostring32> tierNames;
+	std::vector <integer> tierFiles;
+	auto addHit = [&] (conststring32 text, integer item, double start, double end) {
+		const std::u32string_view label = ( text ? text : U"" );
+		auto where = labelNumbers. find (label);
+		if (where == labelNumbers. end ()) {
+			labels. push_back (Melder_dup (label. data ()));
+			where = labelNumbers. emplace (std::u32string_view (labels. back (). get()), integer (labels. size ()) - 1). first;
+		}
+		hits. push_back ({ where -> second, integer (tierNames. size ()), item, start, end });   // base-0 label and tier numbers
+	};
+	structMelderDir folderAsDir { };
+	if (folder [0] != U'\0')
+		relativePathToFolder (folder, & folderAsDir);
+	for (integer ifile = 1; ifile <= fileNames.size; ifile ++) {
+		structMelderFile file { };
+		if (folder [0] == U'\0')
+			Melder_relativePathToFile (fileNames [ifile], & file);
+		else
+			MelderDir_relativePathToFile (& folderAsDir, fileNames [ifile], & file);
+		autoTextGrid textGrid = TextGrid_readFromFile (& file);
+		for (integer itier = 1; itier <= textGrid -> tiers -> size; itier ++) {
+			const Function anyTier = textGrid -> tiers -> at [itier];
+			if (anyTier -> classInfo == classIntervalTier) {
+				const IntervalTier tier = static_cast <IntervalTier> (anyTier);
+				for (integer iinterval = 1; iinterval <= tier -> intervals.size; iinterval ++) {
+					const TextInterval interval = tier -> intervals.at [iinterval];
+					addHit (interval -> text.get(), iinterval, interval -> xmin, interval -> xmax);
+				}
+			} else {
+				const TextTier tier = static_cast <TextTier> (anyTier);
+				for (integer ipoint = 1; ipoint <= tier -> points.size; ipoint ++) {
+					const TextPoint point = tier -> points.at [ipoint];
+					addHit (point -> mark.get(), ipoint, point -> number, point -> number);
+				}
+			}
+			tierNames. push_back (Melder_dup (anyTier -> name ? anyTier -> name.get() : U""));
+			tierFiles. push_back (ifile);
+		}
+	}
+	/*
+		Sort the labels, so that an "is equal to" search can do a binary search.
+	*/
+	const integer numberOfLabels = integer (labels. size ());
+	std::vector <integer> labelOrder ((size_t) numberOfLabels);
+	for (integer ilabel = 0; ilabel < numberOfLabels; ilabel ++)
+		labelOrder [(size_t) ilabel] = ilabel;
+	std::sort (labelOrder. begin (), labelOrder. end (), [&] (integer a, integer b) {
+		return str32cmp (labels [(size_t) a]. get(), labels [(size_t) b]. get()) < 0;
+	});
+	autoINTVEC rankOfLabel = newINTVECraw (numberOfLabels);   // base-0 in, base-1 out
+	my numberOfLabels = numberOfLabels;
+	my labels = autoSTRVEC (numberOfLabels);
+	for (integer irank = 1; irank <= numberOfLabels; irank ++) {
+		const integer ilabel = labelOrder [(size_t) irank - 1];
+		rankOfLabel [ilabel + 1] = irank;
+		my labels [irank] = labels [(size_t) ilabel]. move();
+	}
+	labelNumbers. clear ();   // its keys are gone
+	/*
+		Distribute the hits over the labels with a counting sort, which keeps them in corpus order within each label.
+	*/
+	my firstHits = newINTVECzero (numberOfLabels);
+	for (const Hit& hit : hits)
+		my firstHits [rankOfLabel [hit. label + 1]] += 1;
+	integer firstHit = 1;
+	for (integer ilabel = 1; ilabel <= numberOfLabels; ilabel ++) {
+		const integer numberOfHitsOfLabel = my firstHits [ilabel];
+		my firstHits [ilabel] = firstHit;
+		firstHit += numberOfHitsOfLabel;
+	}
+	const integer numberOfHits = integer (hits. size ());
+	my numberOfHits = numberOfHits;
+	my hitTiers = newINTVECraw (numberOfHits);
+	my hitItems = newINTVECraw (numberOfHits);
+	my hitStarts = newVECraw (numberOfHits);
+	my hitEnds = newVECraw (numberOfHits);
+	autoINTVEC nextHit = newINTVECcopy (my firstHits.get());
+	for (const Hit& hit : hits) {
+		const integer ihit = nextHit [rankOfLabel [hit. label + 1]] ++;
+		my hitTiers [ihit] = hit. tier + 1;
+		my hitItems [ihit] = hit. item;
+		my hitStarts [ihit] = hit. start;
+		my hitEnds [ihit] = hit. end;
+	}
+	my numberOfTiers = integer (tierNames. size ());
+	my tierNames = autoSTRVEC (my numberOfTiers);
+	my tierFiles = newINTVECraw (my numberOfTiers);
+	for (integer itier = 1; itier <= my numberOfTiers; itier ++) {
+		my tierNames [itier] = tierNames [(size_t) itier - 1]. move();
+		my tierFiles [itier] = tierFiles [(size_t) itier - 1];
+	}
+	return me;
+}
+
+autoLabelIndex LabelIndex_createFromFolder (conststring32 folderWithAnnotationFiles, conststring32 annotationFileExtension) {
+	try {
+		structMelderDir folder { };
+		relativePathToFolder (folderWithAnnotationFiles, & folder);
+		structMelderFile pattern { };
+		MelderDir_getFile (& folder, Melder_cat (U"*.", annotationFileExtension), & pattern);
+		autoStrings fileList = Strings_createAsFileList (Melder_fileToPath (& pattern));
+		if (fileList -> numberOfStrings == 0)
+			Melder_throw (U"No files found.");
+		return LabelIndex_create (folderWithAnnotationFiles, fileList -> strings.get());
+	} catch (MelderError) {
+		Melder_throw (U"LabelIndex not created from folder ", folderWithAnnotationFiles, U".");
+	}
+}
+
+autoLabelIndex Corpus_to_LabelIndex (Corpus me) {
+	try {
+		integer numberOfAnnotationFiles = 0;
+		for (integer irow = 1; irow <= my rows.size; irow ++)
+			if (Table_getStringValue_Assert (me, irow, 2) [0] != U'\0')
+				numberOfAnnotationFiles ++;
+		autoSTRVEC fileNames (numberOfAnnotationFiles);
+		integer ifile = 0;
+		for (integer irow = 1; irow <= my rows.size; irow ++) {
+			conststring32 annotationFileName = Table_getStringValue_Assert (me, irow, 2);
+			if (annotationFileName [0] != U'\0')
+				fileNames [++ ifile] = Melder_dup (annotationFileName);
+		}
+		return LabelIndex_create (my folderWithAnnotationFiles.get(), fileNames.get());
+	} catch (MelderError) {
+		Melder_throw (me, U": not converted to LabelIndex.");
+	}
+}
+
+static integer LabelIndex_endOfHits (LabelIndex me, integer ilabel) {
+	return ( ilabel < my numberOfLabels ? my firstHits [ilabel + 1] : my numberOfHits + 1 );
+}
+
+/*
+	The numbers of the labels that match the criterion.
+	Only "is equal to" can use the order of the labels; the other criteria are tried on each different label once.
+*/
+static autoINTVEC LabelIndex_findLabels (LabelIndex me, kMelder_string which, conststring32 criterion) {
+	if (which == kMelder_string::EQUAL_TO) {
+		integer left = 1, right = my numberOfLabels;
+		while (left <= right) {
+			const integer mid = (left + right) / 2;
+			const int comparison = str32cmp (my labels [mid].get(), criterion);
+			if (comparison == 0) {
+				autoINTVEC result = newINTVECraw (1);
+				result [1] = mid;
+				return result;
+			}
+			if (comparison < 0)
+				left = mid + 1;
+			else
+				right = mid - 1;
+		}
+		return newINTVECraw (0);
+	}
+	MelderStringMatcher matcher (which, criterion, true);
+	autoINTVEC result = newINTVECraw (my numberOfLabels);
+	integer numberOfMatchingLabels = 0;
+	for (integer ilabel = 1; ilabel <= my numberOfLabels; ilabel ++)
+		if (matcher.matches (my labels [ilabel].get()))
+			result [++ numberOfMatchingLabels] = ilabel;
+	result. resize (numberOfMatchingLabels);
+	return result;
+}
+
+static integer LabelIndex_countHitsOfLabels (LabelIndex me, constINTVEC const& labelNumbers) {
+	integer numberOfHits = 0;
+	for (integer i = 1; i <= labelNumbers.size; i ++)
+		numberOfHits += LabelIndex_endOfHits (me, labelNumbers [i]) - my firstHits [labelNumbers [i]];
+	return numberOfHits;
+}
+
+integer LabelIndex_countHits (LabelIndex me, kMelder_string which, conststring32 criterion) {
+	try {
+		autoINTVEC matchingLabels = LabelIndex_findLabels (me, which, criterion);
+		return LabelIndex_countHitsOfLabels (me, matchingLabels.get());
+	} catch (MelderError) {
+		Melder_throw (me, U": hits not counted.");
+	}
+}
+
+autoTable LabelIndex_tabulateHits (LabelIndex me, kMelder_string which, conststring32 criterion) {
+	try {
+		autoINTVEC matchingLabels = LabelIndex_findLabels (me, which, criterion);
+		const integer numberOfHits = LabelIndex_countHitsOfLabels (me, matchingLabels.get());
+		autoINTVEC hits = newINTVECraw (numberOfHits), labelOfHit = newINTVECraw (numberOfHits);
+		integer jhit = 0;
+		for (integer i = 1; i <= matchingLabels.size; i ++) {
+			const integer ilabel = matchingLabels [i];
+			for (integer ihit = my firstHits [ilabel]; ihit < LabelIndex_endOfHits (me, ilabel); ihit ++) {
+				hits [++ jhit] = ihit;
+				labelOfHit [jhit] = ilabel;
+			}
+		}
+		Melder_assert (jhit == numberOfHits);
+		/*
+			Put the hits of the different labels in corpus order.
+			The hit numbers are sorted along, so that the row order does not depend on the order of the labels.
+		*/
+		autoINTVEC rowOrder = newINTVECraw (numberOfHits);
+		for (integer irow = 1; irow <= numberOfHits; irow ++)
+			rowOrder [irow] = irow;
+		if (matchingLabels.size > 1)
+			std::sort (rowOrder.begin(), rowOrder.end(), [&] (integer a, integer b) {
+				const integer hitA = hits [a], hitB = hits [b];
+				return my hitTiers [hitA] < my hitTiers [hitB] ||
+					(my hitTiers [hitA] == my hitTiers [hitB] && my hitItems [hitA] < my hitItems [hitB]);
+			});
+		autoTable thee = Table_createWithColumnNames (numberOfHits, U"file tier interval start end text");
+		for (integer irow = 1; irow <= numberOfHits; irow ++) {
+			const integer ihit = hits [rowOrder [irow]], itier = my hitTiers [ihit];
+			Table_setStringValue (thee.get(), irow, 1, my fileNames [my tierFiles [itier]].get());
+			Table_setStringValue (thee.get(), irow, 2, my tierNames [itier].get());
+			Table_setNumericValue (thee.get(), irow, 3, my hitItems [ihit]);
+			Table_setNumericValue (thee.get(), irow, 4, my hitStarts [ihit]);
+			Table_setNumericValue (thee.get(), irow, 5, my hitEnds [ihit]);
+			Table_setStringValue (thee.get(), irow, 6, my labels [labelOfHit [rowOrder [irow]]].get());
+		}
+		return thee;
+	} catch (MelderError) {
+		Melder_throw (me, U": hits not tabulated.");
+	}
+}
+
+/* End of file LabelIndex.cpp */
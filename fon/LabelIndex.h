@@ -0,0 +1,45 @@
+#ifndef _LabelIndex_h_
+#define _LabelIndex_h_
+/* LabelIndex.h
+ *
+ * Copyright (C) 2026 Paul Boersma
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This code is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this work. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Corpus.h"
+#include "TextGrid.h"
+
+#include "LabelIndex_def.h"
+
+/*
+	An inverted index of the labels of all the intervals and points in a set of TextGrid files.
+	A search compares the criterion only with the different labels, of which there are usually a few hundred,
+	rather than with the millions of intervals in a large corpus;
+	each matching label then contributes all of its hits at once.
+*/
+
+autoLabelIndex LabelIndex_createFromFolder (conststring32 folderWithAnnotationFiles, conststring32 annotationFileExtension);
+autoLabelIndex Corpus_to_LabelIndex (Corpus me);
+
+integer LabelIndex_countHits (LabelIndex me, kMelder_string which, conststring32 criterion);
+autoTable LabelIndex_tabulateHits (LabelIndex me, kMelder_string which, conststring32 criterion);
+/*
+	One row per matching interval or point, with the columns "file", "tier", "interval", "start", "end" and "text"
+	(for a point tier, "interval" is the point number and "end" equals "start"),
+	sorted by file, tier and interval.
+*/
+
+#endif
+/* End of file LabelIndex.h */
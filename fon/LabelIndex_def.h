@@ -0,0 +1,50 @@
+/* LabelIndex_def.h
+ *
+ * Copyright (C) 2026 Paul Boersma
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This code is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this work. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#define ooSTRUCT LabelIndex
+oo_DEFINE_CLASS (LabelIndex, Daata)
+
+	oo_STRING (folder)
+	oo_INTEGER (numberOfFiles)
+	oo_STRING_VECTOR (fileNames, numberOfFiles)
+
+	oo_INTEGER (numberOfTiers)   // over all files
+	oo_STRING_VECTOR (tierNames, numberOfTiers)
+	oo_INTVEC (tierFiles, numberOfTiers)
+
+	oo_INTEGER (numberOfLabels)   // the different labels, in code-point order
+	oo_STRING_VECTOR (labels, numberOfLabels)
+	oo_INTVEC (firstHits, numberOfLabels)   // the hits of label i are firstHits [i] .. firstHits [i + 1] - 1
+
+	oo_INTEGER (numberOfHits)   // the intervals and points, grouped by label and in corpus order within each label
+	oo_INTVEC (hitTiers, numberOfHits)
+	oo_INTVEC (hitItems, numberOfHits)   // the interval or point number within the tier
+	oo_VEC (hitStarts, numberOfHits)
+	oo_VEC (hitEnds, numberOfHits)   // equal to the start time for a point
+
+	#if oo_DECLARING
+		void v_info ()
+			override;
+	#endif
+
+oo_END_CLASS (LabelIndex)
+#undef ooSTRUCT
+
+
+/* End of file LabelIndex_def.h */
@@ -46,6 +46,15 @@
 #include "flac_FLAC_stream_decoder.h"
 #include "mp3.h"
 
+#include <system_error>
+#include <thread>
+
+#if defined (UNIX) || defined (macintosh)
+	#define USE_READ_AHEAD  1   // needs fmemopen ()
+#else
+	#define USE_READ_AHEAD  0
+#endif
+
 Thing_implement (LongSound, Sampled, 0);
 Thing_implement (SoundAndLongSoundList, Ordered, 0);
 
@@ -70,12 +79,47 @@ void LongSound_setBufferSizePref_seconds (integer size) {
 	prefs_bufferLength = Melder_clipped (minimumBufferDuration, size, maximumBufferDuration);
 }
 
+/*
+	Read-ahead.
+	When a script extracts parts from an uncompressed LongSound in increasing time order,
+	we predict the next part from the last two, and read its bytes from disk in a separate thread
+	(through a file pointer of its own) while the caller is busy analysing the current part.
+	The thread does nothing but fseeko () and fread (), so it never touches Melder's global state;
+	converting the bytes to samples is done by the main thread, when the part is asked for.
+*/
+struct LongSound_ReadAhead {
+	FILE *f;
+	std::thread thread;
+	bool busy, succeeded;
+	integer previousFirstSample, previousNumberOfSamples;   // the last request
+	integer firstSample, numberOfSamples;   // the part being read ahead
+	std::vector <char> bytes;
+};
+
+static void LongSound_ReadAhead_stop (LongSound_ReadAhead *me) noexcept {
+	if (my busy) {
+		my thread.join ();
+		my busy = false;
+	}
+}
+
+static void LongSound_ReadAhead_delete (LongSound_ReadAhead *me) noexcept {
+	if (! me)
+		return;
+	LongSound_ReadAhead_stop (me);
+	if (my f)
+		fclose (my f);
+	delete me;
+}
+
 void structLongSound :: v_destroy () noexcept {
 	/*
 		The play callback may contain a pointer to my buffer.
 		That pointer is about to dangle, so kill the playback.
 	*/
 	MelderAudio_stopPlaying (MelderAudio_IMPLICIT);
+	LongSound_ReadAhead_delete (readAhead);
+	readAhead = nullptr;
 	if (mp3f)
 		mp3f_delete (mp3f);
 	if (flacDecoder) {
@@ -234,6 +278,7 @@ static void LongSound_init (LongSound me, MelderFile file) {
 	}
 	my imin = 1;
 	my imax = 0;
+	my readAhead = nullptr;   // not shared with a copy
 	my flacDecoder = nullptr;
 	if (my audioFileType == Melder_FLAC) {
 		my flacDecoder = FLAC__stream_decoder_new ();
@@ -255,6 +300,13 @@ void structLongSound :: v_copy (Daata thee_Daata) {
 	LongSound thee = static_cast <LongSound> (thee_Daata);
 	thy f = nullptr;
 	thy buffer.releaseToAmbiguousOwner();   // this may have been shallow-copied, so undangle and nullify
+	/*
+		The same goes for the read-ahead thread and the decoders,
+		which belong to the original and which the destructor of the copy would otherwise delete if LongSound_init () throws.
+	*/
+	thy readAhead = nullptr;
+	thy flacDecoder = nullptr;
+	thy mp3f = nullptr;
 	LongSound_init (thee, & our file);   // this recreates a new buffer
 }
 
@@ -268,9 +320,13 @@ autoLongSound LongSound_open (MelderFile file) {
 	}
 }
 
+/*
+	Decodes the samples firstSample (base-1) through firstSample + numberOfSamples - 1.
+	The decoders count their samples from 0.
+*/
 static void _LongSound_FLAC_process (LongSound me, integer firstSample, integer numberOfSamples) {
-	my compressedSamplesLeft = numberOfSamples - 1;
-	if (! FLAC__stream_decoder_seek_absolute (my flacDecoder, firstSample))
+	my compressedSamplesLeft = numberOfSamples;
+	if (! FLAC__stream_decoder_seek_absolute (my flacDecoder, (FLAC__uint64) (firstSample - 1)))
 		Melder_throw (U"Cannot seek in FLAC file ", & my file, U".");
 	while (my compressedSamplesLeft > 0) {
 		if (FLAC__stream_decoder_get_state (my flacDecoder) == FLAC__STREAM_DECODER_END_OF_STREAM)
@@ -287,12 +343,12 @@ static void _LongSound_FILE_seekSample (LongSound me, integer firstSample) {
 
 static void _LongSound_FLAC_readAudioToShort (LongSound me, int16 *buffer, integer firstSample, integer numberOfSamples) {
 	my compressedMode = COMPRESSED_MODE_READ_SHORT;
-	my compressedShorts = buffer + 1;
+	my compressedShorts = buffer;
 	_LongSound_FLAC_process (me, firstSample, numberOfSamples);
 }
 
 static void _LongSound_MP3_process (LongSound me, integer firstSample, integer numberOfSamples) {
-	if (! mp3f_seek (my mp3f, firstSample))
+	if (! mp3f_seek (my mp3f, (MP3F_OFFSET) (firstSample - 1)))
 		Melder_throw (U"Cannot seek in MP3 file ", & my file, U".");
 	my compressedSamplesLeft = numberOfSamples;
 	if (! mp3f_read (my mp3f, numberOfSamples))
@@ -301,10 +357,92 @@ static void _LongSound_MP3_process (LongSound me, integer firstSample, integer n
 
 static void _LongSound_MP3_readAudioToShort (LongSound me, int16 *buffer, integer firstSample, integer numberOfSamples) {
 	my compressedMode = COMPRESSED_MODE_READ_SHORT;
-	my compressedShorts = buffer + 1;
-	_LongSound_MP3_process (me, firstSample, numberOfSamples - 1);
+	my compressedShorts = buffer;
+	_LongSound_MP3_process (me, firstSample, numberOfSamples);
+}
+
+#if USE_READ_AHEAD
+
+static void LongSound_ReadAhead_run (LongSound_ReadAhead *me, off_t position) {
+	my succeeded = fseeko (my f, position, SEEK_SET) == 0 &&
+			fread (my bytes.data (), 1, my bytes.size (), my f) == my bytes.size ();
+}
+
+/*
+	Takes the samples from the part read ahead, if the part is there (otherwise reads them from my f),
+	and starts reading the next part, if the access pattern looks sequential.
+*/
+static void _LongSound_FILE_readAudioToFloat_withReadAhead (LongSound me, MAT buffer, integer firstSample) {
+	if (! my readAhead) {
+		my readAhead = new LongSound_ReadAhead ();
+		my readAhead -> previousFirstSample = INTEGER_MAX;   // nothing sequential yet
+	}
+	LongSound_ReadAhead *ra = my readAhead;
+	const integer numberOfSamples = buffer.ncol;
+	const integer bytesPerSample = my numberOfChannels * my numberOfBytesPerSamplePoint;
+	/*
+		Serve the request from the part read ahead, if possible.
+	*/
+	bool served = false;
+	if (ra -> busy) {
+		LongSound_ReadAhead_stop (ra);
+		if (ra -> succeeded && firstSample >= ra -> firstSample &&
+			firstSample + numberOfSamples <= ra -> firstSample + ra -> numberOfSamples)
+		{
+			FILE *memoryFile = fmemopen (ra -> bytes.data () + (firstSample - ra -> firstSample) * bytesPerSample,
+					(size_t) (numberOfSamples * bytesPerSample), "rb");
+			if (memoryFile) {
+				try {
+					Melder_readAudioToFloat (memoryFile, my encoding, buffer);
+					fclose (memoryFile);
+				} catch (MelderError) {
+					fclose (memoryFile);
+					throw;
+				}
+				served = true;
+			}
+		}
+	}
+	/*
+		Sequential access means: this part starts after the start of the previous one,
+		and not much more than one part length after its end.
+	*/
+	const integer stride = firstSample - ra -> previousFirstSample;
+	const bool sequential = stride > 0 && stride <= ra -> previousNumberOfSamples + numberOfSamples;
+	ra -> previousFirstSample = firstSample;
+	ra -> previousNumberOfSamples = numberOfSamples;
+	if (! served) {
+		_LongSound_FILE_seekSample (me, firstSample);
+		Melder_readAudioToFloat (my f, my encoding, buffer);
+	}
+	/*
+		Predict the next part, with a small margin for rounding differences in the window sizes,
+		and start reading it.
+	*/
+	if (sequential && numberOfSamples <= my nmax) {
+		const integer margin = numberOfSamples / 64 + 2;
+		const integer nextFirstSample = std::max (firstSample + stride - margin, integer (1));
+		const integer nextLastSample = std::min (firstSample + stride + numberOfSamples - 1 + margin, my nx);
+		if (nextLastSample >= nextFirstSample) {
+			if (! ra -> f)
+				ra -> f = Melder_fopen (& my file, "rb");
+			ra -> firstSample = nextFirstSample;
+			ra -> numberOfSamples = nextLastSample - nextFirstSample + 1;
+			ra -> bytes.resize ((size_t) (ra -> numberOfSamples * bytesPerSample));
+			ra -> succeeded = false;
+			try {
+				ra -> thread = std::thread (LongSound_ReadAhead_run, ra,
+						(off_t) my startOfData + (off_t) (nextFirstSample - 1) * bytesPerSample);
+				ra -> busy = true;
+			} catch (std::system_error&) {
+				// no thread, no read-ahead
+			}
+		}
+	}
 }
 
+#endif
+
 void LongSound_readAudioToFloat (LongSound me, MAT buffer, integer firstSample) {
 	Melder_assert (buffer.nrow == my numberOfChannels);
 	if (my encoding == Melder_FLAC_COMPRESSION_16) {
@@ -320,8 +458,12 @@ void LongSound_readAudioToFloat (LongSound me, MAT buffer, integer firstSample)
 		}
 		_LongSound_MP3_process (me, firstSample, buffer.ncol);
 	} else {
-		_LongSound_FILE_seekSample (me, firstSample);
-		Melder_readAudioToFloat (my f, my encoding, buffer);
+		#if USE_READ_AHEAD
+			_LongSound_FILE_readAudioToFloat_withReadAhead (me, buffer, firstSample);
+		#else
+			_LongSound_FILE_seekSample (me, firstSample);
+			Melder_readAudioToFloat (my f, my encoding, buffer);
+		#endif
 	}
 }
 
@@ -365,18 +507,48 @@ static void _LongSound_readSamples (LongSound me, int16 *buffer, integer imin, i
 	LongSound_readAudioToShort (me, buffer, imin, imax - imin + 1);
 }
 
-static void writePartToOpenFile (LongSound me, int audioFileType, integer imin, integer n, MelderFile file, int numberOfChannels_override, int numberOfBitsPerSamplePoint) {
-	integer ibuffer, offset, numberOfBuffers, numberOfSamplesInLastBuffer;
-	offset = imin;
-	numberOfBuffers = (n - 1) / my nmax + 1;
-	numberOfSamplesInLastBuffer = (n - 1) % my nmax + 1;
-	if (file -> filePointer) for (ibuffer = 1; ibuffer <= numberOfBuffers; ibuffer ++) {
-		integer numberOfSamplesToCopy = ( ibuffer < numberOfBuffers ? my nmax : numberOfSamplesInLastBuffer );
-		my invalidateBuffer();
-		LongSound_readAudioToShort (me, my buffer.asArgumentToFunctionThatExpectsZeroBasedArray(), offset, numberOfSamplesToCopy);
-		offset += numberOfSamplesToCopy;
-		MelderFile_writeShortToAudio (file, numberOfChannels_override ? numberOfChannels_override : my numberOfChannels, Melder_defaultAudioFileEncoding (audioFileType, numberOfBitsPerSamplePoint), my buffer.asArgumentToFunctionThatExpectsZeroBasedArray(), numberOfSamplesToCopy);
+/*
+	Writes samples imin through imin + n - 1 to an open audio file, block by block,
+	so that even very long files never have to be in memory as a whole.
+	If the file has the same encoding as the LongSound, and all channels are written,
+	the bytes are copied without decoding; otherwise, the samples go through a small floating-point buffer
+	(rather than through 16 bits, which would lose the precision of 24-bit and 32-bit files).
+	A negative numberOfChannels_override (-1 or -2) means that only the left or right channel is written.
+	Returns the number of clipped sample points, so that the caller can warn once for the whole file.
+*/
+static integer writePartToOpenFile (LongSound me, int audioFileType, integer imin, integer n, MelderFile file, int numberOfChannels_override, int numberOfBitsPerSamplePoint) {
+	if (! file -> filePointer)
+		return 0;
+	const int encoding = Melder_defaultAudioFileEncoding (audioFileType, numberOfBitsPerSamplePoint);
+	const bool isCompressed = ( my audioFileType == Melder_FLAC || my audioFileType == Melder_MP3 || audioFileType == Melder_FLAC );
+	if (numberOfChannels_override == 0 && encoding == my encoding && ! isCompressed) {
+		constexpr integer numberOfBytesPerBlock = 1 << 20;
+		const integer numberOfBytesPerSample = my numberOfChannels * my numberOfBytesPerSamplePoint;
+		autovector <char> bytes = newvectorraw <char> (numberOfBytesPerBlock);
+		_LongSound_FILE_seekSample (me, imin);
+		for (int64 numberOfBytesLeft = (int64) n * numberOfBytesPerSample; numberOfBytesLeft > 0; ) {
+			const size_t numberOfBytesToCopy = (size_t) std::min (numberOfBytesLeft, int64 (numberOfBytesPerBlock));
+			if (fread (& bytes [1], 1, numberOfBytesToCopy, my f) != numberOfBytesToCopy)
+				Melder_throw (U"Audio file ", & my file, U" too short.");
+			if (fwrite (& bytes [1], 1, numberOfBytesToCopy, file -> filePointer) != numberOfBytesToCopy)
+				Melder_throw (U"Error writing to ", file, U".");
+			numberOfBytesLeft -= numberOfBytesToCopy;
+		}
+		return 0;
+	}
+	constexpr integer numberOfSamplesPerBlock = 1 << 16;
+	const integer channel = - numberOfChannels_override;   // 1 or 2, if positive
+	autoMAT block = newMATraw (my numberOfChannels, std::min (n, numberOfSamplesPerBlock));
+	integer numberOfClippedSamples = 0;
+	for (integer offset = imin; offset < imin + n; offset += block.ncol) {
+		const integer numberOfSamplesToCopy = std::min (block.ncol, imin + n - offset);
+		if (numberOfSamplesToCopy < block.ncol)
+			block = newMATraw (my numberOfChannels, numberOfSamplesToCopy);   // the last block
+		LongSound_readAudioToFloat (me, block.get(), offset);
+		numberOfClippedSamples += MelderFile_writeFloatToAudio (file,
+			channel > 0 ? block.horizontalBand (channel, channel) : block.horizontalBand (1, block.nrow), encoding, false);
 	}
+	return numberOfClippedSamples;
 }
 
 void LongSound_savePartAsAudioFile (LongSound me, int audioFileType, double tmin, double tmax, MelderFile file, int numberOfBitsPerSamplePoint) {
@@ -392,9 +564,10 @@ void LongSound_savePartAsAudioFile (LongSound me, int audioFileType, double tmin
 			Melder_throw (U"Less than 1 sample selected.");
 		autoMelderFile mfile = MelderFile_create (file);
 		MelderFile_writeAudioFileHeader (file, audioFileType, my sampleRate, n, my numberOfChannels, numberOfBitsPerSamplePoint);
-		writePartToOpenFile (me, audioFileType, imin, n, file, 0, numberOfBitsPerSamplePoint);
+		const integer numberOfClippedSamples = writePartToOpenFile (me, audioFileType, imin, n, file, 0, numberOfBitsPerSamplePoint);
 		MelderFile_writeAudioFileTrailer (file, audioFileType, my sampleRate, n, my numberOfChannels, numberOfBitsPerSamplePoint);
 		mfile.close ();
+		Melder_warnAboutClippedSamples (numberOfClippedSamples, n);
 	} catch (MelderError) {
 		Melder_throw (me, U": not written to sound file ", file, U".");
 	}
@@ -407,9 +580,10 @@ void LongSound_saveChannelAsAudioFile (LongSound me, int audioFileType, integer
 		autoMelderFile mfile = MelderFile_create (file);
 		if (file -> filePointer)
 			MelderFile_writeAudioFileHeader (file, audioFileType, my sampleRate, my nx, 1, 8 * my numberOfBytesPerSamplePoint);
-		writePartToOpenFile (me, audioFileType, 1, my nx, file, channel == 0 ? -1 : -2, 8 * my numberOfBytesPerSamplePoint);
+		const integer numberOfClippedSamples = writePartToOpenFile (me, audioFileType, 1, my nx, file, channel == 0 ? -1 : -2, 8 * my numberOfBytesPerSamplePoint);
 		MelderFile_writeAudioFileTrailer (file, audioFileType, my sampleRate, my nx, 1, 8 * my numberOfBytesPerSamplePoint);
 		mfile.close ();
+		Melder_warnAboutClippedSamples (numberOfClippedSamples, my nx);
 	} catch (MelderError) {
 		Melder_throw (U"Channel ", channel, U" of ", me, U": not written to sound file ", file, U".");
 	}
@@ -703,21 +877,23 @@ void LongSound_concatenate (SoundAndLongSoundList me, MelderFile file, int audio
 		autoMelderFile mfile = MelderFile_create (file);
 		if (file -> filePointer)
 			MelderFile_writeAudioFileHeader (file, audioFileType, sampleRate, n, numberOfChannels, numberOfBitsPerSamplePoint);
+		integer numberOfClippedSamples = 0;
 		for (integer i = 1; i <= my size; i ++) {
 			data = my at [i];
 			if (data -> classInfo == classSound) {
 				Sound sound = (Sound) data;
 				if (file -> filePointer) {
-					MelderFile_writeFloatToAudio (file, sound -> z.get(),
-							Melder_defaultAudioFileEncoding (audioFileType, numberOfBitsPerSamplePoint), true);
+					numberOfClippedSamples += MelderFile_writeFloatToAudio (file, sound -> z.get(),
+							Melder_defaultAudioFileEncoding (audioFileType, numberOfBitsPerSamplePoint), false);
 				}
 			} else {
 				LongSound longSound = (LongSound) data;
-				writePartToOpenFile (longSound, audioFileType, 1, longSound -> nx, file, 0, numberOfBitsPerSamplePoint);
+				numberOfClippedSamples += writePartToOpenFile (longSound, audioFileType, 1, longSound -> nx, file, 0, numberOfBitsPerSamplePoint);
 			}
 		}
 		MelderFile_writeAudioFileTrailer (file, audioFileType, sampleRate, n, numberOfChannels, numberOfBitsPerSamplePoint);
 		mfile.close ();
+		Melder_warnAboutClippedSamples (numberOfClippedSamples, n);
 	} catch (MelderError) {
 		Melder_throw (U"Sounds not concatenated and not saved to ", file, U".");
 	}
@@ -27,6 +27,7 @@
 struct FLAC__StreamDecoder;
 struct FLAC__StreamEncoder;
 struct _MP3_FILE;
+struct LongSound_ReadAhead;
 
 Thing_define (LongSound, Sampled) {
 	structMelderFile file;
@@ -48,6 +49,7 @@ Thing_define (LongSound, Sampled) {
 	integer compressedSamplesLeft;
 	double *compressedFloats [2];
 	int16 *compressedShorts;
+	struct LongSound_ReadAhead *readAhead;   // for sequential extraction from uncompressed files
 
 	void v_destroy () noexcept
 		override;
@@ -465,6 +465,52 @@ int Praat_tests (kPraatTests itest, conststring32 arg1, conststring32 arg2, cons
 			MelderInfo_writeLine (sum);
 		} break;
 		case kPraatTests::TIME_MATMUL: {
+			if (arg2 [0] == U'\0') {
+				/*
+					Report the speed of MATmul_ and MATmul_fast_ across sizes and stride patterns,
+					spending about arg1 floating-point operations per measurement,
+					and check that the two agree.
+				*/
+				const integer sizes [] = { 1, 3, 10, 20, 50, 100, 200, 500, 1000 };
+				double largestRelativeDifference = 0.0, totalTime = 0.0, totalNumberOfComputations = 0.0;
+				for (const integer size : sizes) {
+					autoMAT const x = newMATrandomGauss (size, size, 0.0, 1.0);
+					autoMAT const y = newMATrandomGauss (size, size, 0.0, 1.0);
+					autoMAT const precise = newMATzero (size, size), fast = newMATzero (size, size);
+					const double numberOfComputations = 2.0 * size * size * size;
+					const integer numberOfIterations = std::max (integer (1), integer (n / numberOfComputations));
+					Melder_stopwatch ();
+					for (integer iteration = 1; iteration <= numberOfIterations; iteration ++)
+						MATmul_ (precise.all(), x.all(), y.all());
+					const double preciseSpeed = numberOfComputations * numberOfIterations / Melder_stopwatch () * 1e-9;
+					autoMelderString speeds;
+					for (integer pattern = 0; pattern < 4; pattern ++) {
+						constMATVU const xx = ( pattern & 1 ? x.transpose() : x.all() );
+						constMATVU const yy = ( pattern & 2 ? y.transpose() : y.all() );
+						MATmul_ (precise.all(), xx, yy);
+						Melder_stopwatch ();
+						for (integer iteration = 1; iteration <= numberOfIterations; iteration ++)
+							MATmul_fast_ (fast.all(), xx, yy);
+						const double time = Melder_stopwatch ();
+						if (pattern == 0) {
+							totalTime += time;
+							totalNumberOfComputations += numberOfComputations * numberOfIterations;
+						}
+						MelderString_append (& speeds, U" ", Melder_single (numberOfComputations * numberOfIterations / time * 1e-9));
+						const double largestValue = std::max (NUMextremum (precise.all()), 1e-300);
+						for (integer irow = 1; irow <= size; irow ++)
+							for (integer icol = 1; icol <= size; icol ++)
+								largestRelativeDifference = std::max (largestRelativeDifference,
+										fabs (fast [irow] [icol] - precise [irow] [icol]) / largestValue);
+					}
+					MelderInfo_writeLine (U"size ", size, U": MATmul ", Melder_single (preciseSpeed),
+							U" Gflop/s, MATmul_fast for X.Y X'.Y X.Y' X'.Y'", speeds.string, U" Gflop/s");
+				}
+				MelderInfo_writeLine (U"Largest relative difference: ", largestRelativeDifference);
+				n = 1;
+				t = totalTime / totalNumberOfComputations;   // the overall speed of MATmul_fast for X.Y
+				break;
+			}
 			const integer size1 = Melder_atoi (arg2);
 			integer size2 = Melder_atoi (arg3);
 			integer size3 = Melder_atoi (arg4);
@@ -18,6 +18,7 @@
 
 #include "TextGrid.h"
 #include "../kar/longchar.h"
+#include "../kar/UnicodeData.h"
 
 #include "oo_DESTROY.h"
 #include "TextGrid_def.h"
@@ -238,6 +239,131 @@ integer IntervalTier_hasBoundary (IntervalTier me, double t) {
 	return 0;   // not found
 }
 
+/*
+	The smallest i in [1, n] for which key (i) > t, or n + 1 if there is none;
+	key (i) has to be nondecreasing.
+	The search starts at `hint` and widens exponentially from there,
+	so that a series of times that increase in small steps costs constant time per time,
+	while the worst case is still logarithmic.
+*/
+template <typename KEY>
+static integer findFirstKeyAbove (integer n, KEY key, double t, integer hint) {
+	Melder_assert (n >= 1);
+	hint = Melder_clipped (integer (1), hint, n);
+	integer ileft, iright;   // invariant: key (ileft - 1) <= t < key (iright), with key (0) = -inf and key (n + 1) = +inf
+	if (key (hint) > t) {
+		iright = hint;
+		integer step = 1;
+		ileft = hint - step;
+		while (ileft >= 1 && key (ileft) > t) {
+			iright = ileft;
+			step *= 2;
+			ileft = hint - step;
+		}
+		ileft = std::max (ileft + 1, integer (1));
+	} else {
+		ileft = hint + 1;
+		integer step = 1;
+		iright = hint + step;
+		while (iright <= n && key (iright) <= t) {
+			ileft = iright + 1;
+			step *= 2;
+			iright = hint + step;
+		}
+		iright = std::min (iright, n + 1);
+	}
+	while (ileft < iright) {
+		const integer imid = (ileft + iright) / 2;
+		if (key (imid) > t)
+			iright = imid;
+		else
+			ileft = imid + 1;
+	}
+	return iright;
+}
+
+autoINTVEC IntervalTier_timesToIndices (IntervalTier me, constVECVU const& times) {
+	autoINTVEC result = newINTVECzero (times.size);
+	const integer numberOfIntervals = my intervals.size;
+	if (numberOfIntervals < 1)
+		return result;   // empty tier
+	const double tmin = my intervals.at [1] -> xmin, tmax = my intervals.at [numberOfIntervals] -> xmax;
+	auto endTime = [me] (integer i) { return my intervals.at [i] -> xmax; };
+	integer hint = 1;
+	for (integer itime = 1; itime <= times.size; itime ++) {
+		const double t = times [itime];
+		if (isundef (t) || t < tmin || t > tmax)
+			continue;   // 0, as in IntervalTier_timeToIndex ()
+		hint = ( t == tmax ? numberOfIntervals : findFirstKeyAbove (numberOfIntervals, endTime, t, hint) );
+		result [itime] = hint;
+	}
+	return result;
+}
+
+autoINTVEC TextTier_timesToLowIndices (TextTier me, constVECVU const& times) {
+	autoINTVEC result = newINTVECzero (times.size);
+	const integer numberOfPoints = my points.size;
+	if (numberOfPoints < 1)
+		return result;
+	auto pointTime = [me] (integer i) { return my points.at [i] -> number; };
+	integer hint = 1;
+	for (integer itime = 1; itime <= times.size; itime ++) {
+		const double t = times [itime];
+		if (isundef (t))
+			continue;
+		hint = findFirstKeyAbove (numberOfPoints, pointTime, t, hint);
+		result [itime] = hint - 1;   // as in AnyTier_timeToLowIndex ()
+	}
+	return result;
+}
+
+integer IntervalTier_getIntervalsOverlappingRange (IntervalTier me, double tmin, double tmax,
+	integer *out_firstInterval, integer *out_lastInterval)
+{
+	*out_firstInterval = 1;
+	*out_lastInterval = 0;
+	const integer numberOfIntervals = my intervals.size;
+	if (numberOfIntervals < 1 || ! (tmin < tmax))
+		return 0;
+	if (tmax <= my intervals.at [1] -> xmin || tmin >= my intervals.at [numberOfIntervals] -> xmax)
+		return 0;
+	auto startTime = [me] (integer i) { return my intervals.at [i] -> xmin; };
+	auto endTime = [me] (integer i) { return my intervals.at [i] -> xmax; };
+	*out_firstInterval = findFirstKeyAbove (numberOfIntervals, endTime, tmin, 1);   // the first interval that ends after tmin
+	*out_lastInterval = findFirstKeyAbove (numberOfIntervals, startTime, std::nextafter (tmax, - INFINITY), *out_firstInterval) - 1;   // the last that starts before tmax
+	return std::max (*out_lastInterval - *out_firstInterval + 1, integer (0));
+}
+
+autoTable TextGrid_tabulateLabelsAtTimes (TextGrid me, constVECVU const& times) {
+	try {
+		const integer numberOfTiers = my tiers->size;
+		autoTable thee = Table_createWithoutColumnNames (times.size, 1 + numberOfTiers);
+		Table_setColumnLabel (thee.get(), 1, U"time");
+		for (integer itime = 1; itime <= times.size; itime ++)
+			Table_setNumericValue (thee.get(), itime, 1, times [itime]);
+		for (integer itier = 1; itier <= numberOfTiers; itier ++) {
+			Function anyTier = my tiers->at [itier];
+			Table_setColumnLabel (thee.get(), 1 + itier, anyTier -> name.get());
+			if (anyTier -> classInfo == classIntervalTier) {
+				IntervalTier tier = static_cast <IntervalTier> (anyTier);
+				autoINTVEC intervalNumbers = IntervalTier_timesToIndices (tier, times);
+				for (integer itime = 1; itime <= times.size; itime ++)
+					if (intervalNumbers [itime] != 0)
+						Table_setStringValue (thee.get(), itime, 1 + itier, tier -> intervals.at [intervalNumbers [itime]] -> text.get());
+			} else {
+				TextTier tier = static_cast <TextTier> (anyTier);
+				autoINTVEC pointNumbers = TextTier_timesToLowIndices (tier, times);
+				for (integer itime = 1; itime <= times.size; itime ++)
+					if (pointNumbers [itime] != 0)
+						Table_setStringValue (thee.get(), itime, 1 + itier, tier -> points.at [pointNumbers [itime]] -> mark.get());
+			}
+		}
+		return thee;
+	} catch (MelderError) {
+		Melder_throw (me, U": labels not tabulated.");
+	}
+}
+
 void structTextGrid :: v_info () {
 	structDaata :: v_info ();
 
@@ -437,17 +563,84 @@ integer TextGrid_countLabels (TextGrid me, integer tierNumber, conststring32 tex
 	}
 }
 
-integer TextGrid_countIntervalsWhere (TextGrid me, integer tierNumber, kMelder_string which, conststring32 criterion) {
+autoINTVEC TextGrid_findIntervalsWhere (TextGrid me, integer tierNumber, kMelder_string which, conststring32 criterion) {
 	try {
-		integer count = 0;
 		IntervalTier tier = TextGrid_checkSpecifiedTierIsIntervalTier (me, tierNumber);
-		for (integer iinterval = 1; iinterval <= tier -> intervals.size; iinterval ++) {
-			TextInterval interval = tier -> intervals.at [iinterval];
-			if (Melder_stringMatchesCriterion (interval -> text.get(), which, criterion, true)) {
-				count ++;
-			}
+		MelderStringMatcher matcher (which, criterion, true);
+		autoINTVEC intervalNumbers = newINTVECraw (tier -> intervals.size);
+		integer numberOfMatches = 0;
+		for (integer iinterval = 1; iinterval <= tier -> intervals.size; iinterval ++)
+			if (matcher.matches (tier -> intervals.at [iinterval] -> text.get()))
+				intervalNumbers [++ numberOfMatches] = iinterval;
+		intervalNumbers. resize (numberOfMatches);
+		return intervalNumbers;
+	} catch (MelderError) {
+		Melder_throw (me, U": intervals not found.");
+	}
+}
+
+autoINTVEC TextGrid_findPointsWhere (TextGrid me, integer tierNumber, kMelder_string which, conststring32 criterion) {
+	try {
+		TextTier tier = TextGrid_checkSpecifiedTierIsPointTier (me, tierNumber);
+		MelderStringMatcher matcher (which, criterion, true);
+		autoINTVEC pointNumbers = newINTVECraw (tier -> points.size);
+		integer numberOfMatches = 0;
+		for (integer ipoint = 1; ipoint <= tier -> points.size; ipoint ++)
+			if (matcher.matches (tier -> points.at [ipoint] -> mark.get()))
+				pointNumbers [++ numberOfMatches] = ipoint;
+		pointNumbers. resize (numberOfMatches);
+		return pointNumbers;
+	} catch (MelderError) {
+		Melder_throw (me, U": points not found.");
+	}
+}
+
+autoVEC TextGrid_getTimesOfIntervalsWhere (TextGrid me, integer tierNumber, kMelder_string which, conststring32 criterion, double phase) {
+	IntervalTier tier = TextGrid_checkSpecifiedTierIsIntervalTier (me, tierNumber);
+	autoINTVEC intervalNumbers = TextGrid_findIntervalsWhere (me, tierNumber, which, criterion);
+	autoVEC times = newVECraw (intervalNumbers.size);
+	for (integer i = 1; i <= intervalNumbers.size; i ++) {
+		TextInterval interval = tier -> intervals.at [intervalNumbers [i]];
+		times [i] = (1.0 - phase) * interval -> xmin + phase * interval -> xmax;
+	}
+	return times;
+}
+
+autoVEC TextGrid_getTimesOfPointsWhere (TextGrid me, integer tierNumber, kMelder_string which, conststring32 criterion) {
+	TextTier tier = TextGrid_checkSpecifiedTierIsPointTier (me, tierNumber);
+	autoINTVEC pointNumbers = TextGrid_findPointsWhere (me, tierNumber, which, criterion);
+	autoVEC times = newVECraw (pointNumbers.size);
+	for (integer i = 1; i <= pointNumbers.size; i ++)
+		times [i] = tier -> points.at [pointNumbers [i]] -> number;
+	return times;
+}
+
+autoStrings TextGrid_getLabelsWhere (TextGrid me, integer tierNumber, kMelder_string which, conststring32 criterion) {
+	try {
+		Function anyTier = TextGrid_checkSpecifiedTierNumberWithinRange (me, tierNumber);
+		const bool isIntervalTier = ( anyTier -> classInfo == classIntervalTier );
+		autoINTVEC numbers = ( isIntervalTier ?
+				TextGrid_findIntervalsWhere (me, tierNumber, which, criterion) :
+				TextGrid_findPointsWhere (me, tierNumber, which, criterion) );
+		autoStrings thee = Thing_new (Strings);
+		thy numberOfStrings = numbers.size;
+		if (thy numberOfStrings > 0)
+			thy strings = autoSTRVEC (thy numberOfStrings);
+		for (integer i = 1; i <= numbers.size; i ++) {
+			conststring32 label = ( isIntervalTier ?
+					static_cast <IntervalTier> (anyTier) -> intervals.at [numbers [i]] -> text.get() :
+					static_cast <TextTier> (anyTier) -> points.at [numbers [i]] -> mark.get() );
+			thy strings [i] = Melder_dup (label ? label : U"");
 		}
-		return count;
+		return thee;
+	} catch (MelderError) {
+		Melder_throw (me, U": labels not extracted.");
+	}
+}
+
+integer TextGrid_countIntervalsWhere (TextGrid me, integer tierNumber, kMelder_string which, conststring32 criterion) {
+	try {
+		return TextGrid_findIntervalsWhere (me, tierNumber, which, criterion).size;
 	} catch (MelderError) {
 		Melder_throw (me, U": intervals not counted.");
 	}
@@ -455,15 +648,7 @@ integer TextGrid_countIntervalsWhere (TextGrid me, integer tierNumber, kMelder_s
 
 integer TextGrid_countPointsWhere (TextGrid me, integer tierNumber, kMelder_string which, conststring32 criterion) {
 	try {
-		integer count = 0;
-		TextTier tier = TextGrid_checkSpecifiedTierIsPointTier (me, tierNumber);
-		for (integer ipoint = 1; ipoint <= tier -> points.size; ipoint ++) {
-			TextPoint point = tier -> points.at [ipoint];
-			if (Melder_stringMatchesCriterion (point -> mark.get(), which, criterion, true)) {
-				count ++;
-			}
-		}
-		return count;
+		return TextGrid_findPointsWhere (me, tierNumber, which, criterion).size;
 	} catch (MelderError) {
 		Melder_throw (me, U": points not counted.");
 	}
@@ -664,14 +849,9 @@ autoPointProcess IntervalTier_getCentrePoints (IntervalTier me, conststring32 te
 
 autoPointProcess TextGrid_getStartingPoints (TextGrid me, integer tierNumber, kMelder_string which, conststring32 criterion) {
 	try {
-		IntervalTier tier = TextGrid_checkSpecifiedTierIsIntervalTier (me, tierNumber);
-		autoPointProcess thee = PointProcess_create (my xmin, my xmax, 10);
-		for (integer iinterval = 1; iinterval <= tier -> intervals.size; iinterval ++) {
-			TextInterval interval = tier -> intervals.at [iinterval];
-			if (Melder_stringMatchesCriterion (interval -> text.get(), which, criterion, true)) {
-				PointProcess_addPoint (thee.get(), interval -> xmin);
-			}
-		}
+		autoVEC times = TextGrid_getTimesOfIntervalsWhere (me, tierNumber, which, criterion, 0.0);
+		autoPointProcess thee = PointProcess_create (my xmin, my xmax, times.size);
+		PointProcess_addPoints (thee.get(), times.get());
 		return thee;
 	} catch (MelderError) {
 		Melder_throw (me, U": starting points not converted to PointProcess.");
@@ -680,14 +860,9 @@ autoPointProcess TextGrid_getStartingPoints (TextGrid me, integer tierNumber, kM
 
 autoPointProcess TextGrid_getEndPoints (TextGrid me, integer tierNumber, kMelder_string which, conststring32 criterion) {
 	try {
-		IntervalTier tier = TextGrid_checkSpecifiedTierIsIntervalTier (me, tierNumber);
-		autoPointProcess thee = PointProcess_create (my xmin, my xmax, 10);
-		for (integer iinterval = 1; iinterval <= tier -> intervals.size; iinterval ++) {
-			TextInterval interval = tier -> intervals.at [iinterval];
-			if (Melder_stringMatchesCriterion (interval -> text.get(), which, criterion, true)) {
-				PointProcess_addPoint (thee.get(), interval -> xmax);
-			}
-		}
+		autoVEC times = TextGrid_getTimesOfIntervalsWhere (me, tierNumber, which, criterion, 1.0);
+		autoPointProcess thee = PointProcess_create (my xmin, my xmax, times.size);
+		PointProcess_addPoints (thee.get(), times.get());
 		return thee;
 	} catch (MelderError) {
 		Melder_throw (me, U": end points not converted to PointProcess.");
@@ -696,14 +871,9 @@ autoPointProcess TextGrid_getEndPoints (TextGrid me, integer tierNumber, kMelder
 
 autoPointProcess TextGrid_getCentrePoints (TextGrid me, integer tierNumber, kMelder_string which, conststring32 criterion) {
 	try {
-		IntervalTier tier = TextGrid_checkSpecifiedTierIsIntervalTier (me, tierNumber);
-		autoPointProcess thee = PointProcess_create (my xmin, my xmax, 10);
-		for (integer iinterval = 1; iinterval <= tier -> intervals.size; iinterval ++) {
-			TextInterval interval = tier -> intervals.at [iinterval];
-			if (Melder_stringMatchesCriterion (interval -> text.get(), which, criterion, true)) {
-				PointProcess_addPoint (thee.get(), 0.5 * (interval -> xmin + interval -> xmax));
-			}
-		}
+		autoVEC times = TextGrid_getTimesOfIntervalsWhere (me, tierNumber, which, criterion, 0.5);
+		autoPointProcess thee = PointProcess_create (my xmin, my xmax, times.size);
+		PointProcess_addPoints (thee.get(), times.get());
 		return thee;
 	} catch (MelderError) {
 		Melder_throw (me, U": centre points not converted to PointProcess.");
@@ -712,14 +882,9 @@ autoPointProcess TextGrid_getCentrePoints (TextGrid me, integer tierNumber, kMel
 
 autoPointProcess TextGrid_getPoints (TextGrid me, integer tierNumber, kMelder_string which, conststring32 criterion) {
 	try {
-		TextTier tier = TextGrid_checkSpecifiedTierIsPointTier (me, tierNumber);
-		autoPointProcess thee = PointProcess_create (my xmin, my xmax, 10);
-		for (integer ipoint = 1; ipoint <= tier -> points.size; ipoint ++) {
-			TextPoint point = tier -> points.at [ipoint];
-			if (Melder_stringMatchesCriterion (point -> mark.get(), which, criterion, true)) {
-				PointProcess_addPoint (thee.get(), point -> number);
-			}
-		}
+		autoVEC times = TextGrid_getTimesOfPointsWhere (me, tierNumber, which, criterion);
+		autoPointProcess thee = PointProcess_create (my xmin, my xmax, times.size);
+		PointProcess_addPoints (thee.get(), times.get());
 		return thee;
 	} catch (MelderError) {
 		Melder_throw (me, U": points not converted to PointProcess.");
@@ -733,11 +898,12 @@ autoPointProcess TextGrid_getPoints_preceded (TextGrid me, integer tierNumber,
 	try {
 		TextTier tier = TextGrid_checkSpecifiedTierIsPointTier (me, tierNumber);
 		autoPointProcess thee = PointProcess_create (my xmin, my xmax, 10);
+		MelderStringMatcher matcher (which, criterion, true), matcher_precededBy (precededBy, criterion_precededBy, true);
 		for (integer ipoint = 1; ipoint <= tier -> points.size; ipoint ++) {
 			TextPoint point = tier -> points.at [ipoint];
-			if (Melder_stringMatchesCriterion (point -> mark.get(), which, criterion, true)) {
+			if (matcher.matches (point -> mark.get())) {
 				TextPoint preceding = ( ipoint <= 1 ? nullptr : tier -> points.at [ipoint - 1] );
-				if (Melder_stringMatchesCriterion (preceding -> mark.get(), precededBy, criterion_precededBy, true)) {
+				if (preceding && matcher_precededBy.matches (preceding -> mark.get())) {
 					PointProcess_addPoint (thee.get(), point -> number);
 				}
 			}
@@ -755,11 +921,12 @@ autoPointProcess TextGrid_getPoints_followed (TextGrid me, integer tierNumber,
 	try {
 		TextTier tier = TextGrid_checkSpecifiedTierIsPointTier (me, tierNumber);
 		autoPointProcess thee = PointProcess_create (my xmin, my xmax, 10);
+		MelderStringMatcher matcher (which, criterion, true), matcher_followedBy (followedBy, criterion_followedBy, true);
 		for (integer ipoint = 1; ipoint <= tier -> points.size; ipoint ++) {
 			TextPoint point = tier -> points.at [ipoint];
-			if (Melder_stringMatchesCriterion (point -> mark.get(), which, criterion, true)) {
+			if (matcher.matches (point -> mark.get())) {
 				TextPoint following = ( ipoint >= tier -> points.size ? nullptr : tier -> points.at [ipoint + 1] );
-				if (Melder_stringMatchesCriterion (following -> mark.get(), followedBy, criterion_followedBy, true)) {
+				if (following && matcher_followedBy.matches (following -> mark.get())) {
 					PointProcess_addPoint (thee.get(), point -> number);
 				}
 			}
@@ -1201,8 +1368,9 @@ void TextTier_removePoint (TextTier me, integer ipoint) {
 }
 
 void TextTier_removePoints (TextTier me, kMelder_string which, conststring32 criterion) {
+	MelderStringMatcher matcher (which, criterion, true);
 	for (integer i = my points.size; i > 0; i --)
-		if (Melder_stringMatchesCriterion (my points.at [i] -> mark.get(), which, criterion, true))
+		if (matcher.matches (my points.at [i] -> mark.get()))
 			my points. removeItem (i);
 }
 
@@ -1279,8 +1447,618 @@ static void sgmlToPraat (char *text) {
 	*praat = '\0';
 }
 
+/*
+	A dedicated reader for TextGrid text files in the long, short and chronological formats.
+	The file is read in one go, and its bytes (or, for UTF-16 files, its decoded characters) are scanned in place,
+	skipping labels such as "xmin =" and "intervals [3]:" in the same way as the texget... () functions,
+	but without going through MelderReadText_getChar () and without a temporary string per value:
+	texts and tier names are decoded directly into strings of their final length,
+	and the interval and point arrays are pre-sized from the counts in the file.
+	The scan uses none of Melder's shared conversion buffers and does not throw,
+	so that TextGrids_readFromFiles () can scan several files at the same time;
+	the objects are created afterwards, on the main thread.
+	Anything unusual (an 8-bit encoding other than UTF-8, null bytes, a non-ASCII character between the values,
+	an undefined or fractional number, an absent tier list, an unknown tier class, an early end of text...)
+	makes the scan give up, after which the general reader handles the file,
+	with its usual results and error messages.
+*/
+#include <string>
+#include <vector>
+#include "MelderThread.h"
+
+struct TextGridTextElement {
+	double xmin, xmax;   // for a point, xmin is its time
+	autostring32 text;
+};
+
+struct TextGridTextTier {
+	bool isIntervalTier;
+	autostring32 name;
+	double xmin, xmax;
+	std::vector <TextGridTextElement> elements;
+};
+
+struct TextGridText {   // the contents of a TextGrid text file, before there is a TextGrid
+	bool isChronological;
+	double xmin, xmax;
+	std::vector <TextGridTextTier> tiers;
+};
+
+static inline char32 textGridKar (const char *p) { return (char32) (char8) *p; }
+static inline char32 textGridKar (const char32 *p) { return *p; }
+
+static inline bool textGridKarEndsValue (char32 kar) {
+	return kar == U'\0' || Melder_isAsciiHorizontalOrVerticalSpace (kar);
+}
+
+static inline char32 textGridNextCharacter (const char32 **p) {
+	return * (*p) ++;
+}
+static inline char32 textGridNextCharacter (const char **p) {   // valid UTF-8
+	const char8 *q = (const char8 *) *p;
+	char32 kar = * q ++;   // convert up without sign extension
+	if (kar <= 0x00'007F) {
+		;
+	} else if (kar <= 0x00'00DF) {
+		kar = ((kar & 0x00'001F) << 6) | (q [0] & 0x00'003F);
+		q += 1;
+	} else if (kar <= 0x00'00EF) {
+		kar = ((kar & 0x00'000F) << 12) | ((q [0] & 0x00'003F) << 6) | (q [1] & 0x00'003F);
+		q += 2;
+	} else {
+		kar = ((kar & 0x00'0007) << 18) | ((q [0] & 0x00'003F) << 12) | ((q [1] & 0x00'003F) << 6) | (q [2] & 0x00'003F);
+		q += 3;
+	}
+	*p = (const char *) q;
+	return kar;
+}
+
+/*
+	Skip white space, end-of-line comments and labels, as the texget... () functions do.
+	Returns the first character of the next value, or a null character at the end of the text;
+	a non-ASCII character is returned as well, so that the caller gives up on it.
+*/
+template <typename CHAR>
+static char32 TextGridText_skipToValue (const CHAR **p_readPointer) {
+	const CHAR *p = *p_readPointer;
+	for (;;) {
+		while (Melder_isAsciiHorizontalOrVerticalSpace (textGridKar (p)))
+			p ++;
+		const char32 first = textGridKar (p);
+		if (first == U'\0' || first == U'-' || first == U'+' || Melder_isAsciiDecimalNumber (first) ||
+			first == U'\"' || first == U'<' || first > 127)
+		{
+			*p_readPointer = p;
+			return first;
+		}
+		if (first == U'!') {   // end-of-line comment
+			while (textGridKar (p) != U'\0' && textGridKar (p) != U'\n')
+				p ++;
+			continue;
+		}
+		do
+			p ++;
+		while (! textGridKarEndsValue (textGridKar (p)) && textGridKar (p) <= 127);
+	}
+}
+
+/*
+	Numbers are converted as in abcio's fast path: exactly with Clinger's algorithm
+	if the mantissa has at most 15 decimal digits and the power of ten is in the range -22 .. +22,
+	and with strtod () otherwise.
+*/
+template <typename CHAR>
+static bool TextGridText_getReal (const CHAR **p_readPointer, double *out_value) {
+	static const double powersOfTen [1 + 22] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+	const char32 first = TextGridText_skipToValue (p_readPointer);
+	if (first != U'-' && first != U'+' && ! Melder_isAsciiDecimalNumber (first))
+		return false;
+	const CHAR *const startOfNumber = *p_readPointer;
+	const CHAR *p = startOfNumber;
+	const bool isNegative = ( first == U'-' );
+	if (first == U'-' || first == U'+')
+		p ++;
+	if (! Melder_isAsciiDecimalNumber (textGridKar (p)))
+		return false;   // e.g. "--undefined--"
+	uint64 mantissa = 0;
+	int numberOfMantissaDigits = 0, exponent = 0;
+	for (; Melder_isAsciiDecimalNumber (textGridKar (p)); p ++) {
+		if (mantissa != 0 || textGridKar (p) != U'0')
+			numberOfMantissaDigits += 1;
+		mantissa = 10 * mantissa + (textGridKar (p) - U'0');   // overflow harmless: we check the number of digits below
+	}
+	if (textGridKar (p) == U'.') {
+		p ++;
+		for (; Melder_isAsciiDecimalNumber (textGridKar (p)); p ++) {
+			if (mantissa != 0 || textGridKar (p) != U'0')
+				numberOfMantissaDigits += 1;
+			mantissa = 10 * mantissa + (textGridKar (p) - U'0');
+			exponent -= 1;
+		}
+	}
+	if (textGridKar (p) == U'e' || textGridKar (p) == U'E') {
+		p ++;
+		const bool exponentIsNegative = ( textGridKar (p) == U'-' );
+		if (textGridKar (p) == U'-' || textGridKar (p) == U'+')
+			p ++;
+		if (! Melder_isAsciiDecimalNumber (textGridKar (p)))
+			return false;
+		int explicitExponent = 0;
+		for (; Melder_isAsciiDecimalNumber (textGridKar (p)); p ++)
+			if (explicitExponent < 100000)
+				explicitExponent = 10 * explicitExponent + (int) (textGridKar (p) - U'0');
+		exponent += ( exponentIsNegative ? - explicitExponent : explicitExponent );
+	}
+	if (! textGridKarEndsValue (textGridKar (p)))
+		return false;   // e.g. a fraction or a percentage
+	const integer numberOfNumberCharacters = p - startOfNumber;
+	if (numberOfNumberCharacters > 40)
+		return false;
+	double value;
+	if (numberOfMantissaDigits <= 15 && exponent >= -22 && exponent <= 22) {
+		value = (double) mantissa;   // exact, because mantissa < 10^15 < 2^53
+		value = ( exponent >= 0 ? value * powersOfTen [exponent] : value / powersOfTen [- exponent] );   // correctly rounded
+		if (isNegative)
+			value = - value;
+	} else {
+		char buffer [41];
+		for (integer i = 0; i < numberOfNumberCharacters; i ++)
+			buffer [i] = (char) (char8) textGridKar (startOfNumber + i);   // everything is ASCII
+		buffer [numberOfNumberCharacters] = '\0';
+		value = strtod (buffer, nullptr);
+		if (! isfinite (value))
+			return false;
+	}
+	*out_value = value;
+	*p_readPointer = p;
+	return true;
+}
+
+template <typename CHAR>
+static bool TextGridText_getInteger (const CHAR **p_readPointer, integer *out_value) {
+	const char32 first = TextGridText_skipToValue (p_readPointer);
+	if (first != U'+' && ! Melder_isAsciiDecimalNumber (first))
+		return false;   // the counts and tier numbers in a TextGrid are never negative
+	const CHAR *p = *p_readPointer;
+	if (first == U'+')
+		p ++;
+	integer value = 0, numberOfDigits = 0;
+	for (; Melder_isAsciiDecimalNumber (textGridKar (p)); p ++) {
+		value = 10 * value + (integer) (textGridKar (p) - U'0');
+		if (++ numberOfDigits > 9)
+			return false;
+	}
+	if (numberOfDigits == 0 || ! textGridKarEndsValue (textGridKar (p)))
+		return false;
+	*out_value = value;
+	*p_readPointer = p;
+	return true;
+}
+
+template <typename CHAR>
+static bool TextGridText_getString (const CHAR **p_readPointer, autostring32 *out_string) {
+	if (TextGridText_skipToValue (p_readPointer) != U'\"')
+		return false;
+	const CHAR *const start = *p_readPointer + 1;
+	/*
+		Find the closing quote, and count the characters in between.
+	*/
+	const CHAR *p = start;
+	integer length = 0;
+	for (;; p ++) {
+		const char32 kar = textGridKar (p);
+		if (kar == U'\0')
+			return false;
+		if (kar == U'\"') {
+			if (textGridKar (p + 1) != U'\"')
+				break;
+			p ++;   // a doubled quote stands for a single quote
+		}
+		if (sizeof (CHAR) == 1 && (kar & 0xC0) == 0x80)
+			continue;   // a UTF-8 continuation byte
+		length ++;
+	}
+	const CHAR *const closingQuote = p;
+	if (! textGridKarEndsValue (textGridKar (closingQuote + 1)))
+		return false;
+	autostring32 result (length);
+	char32 *q = result.get();
+	for (const CHAR *s = start; s < closingQuote; ) {
+		const char32 kar = textGridNextCharacter (& s);
+		*q ++ = kar;
+		if (kar == U'\"')
+			s ++;   // skip the second quote of the pair
+	}
+	Melder_assert (q - result.get() == length);
+	*p_readPointer = closingQuote + 1;
+	*out_string = result.move();
+	return true;
+}
+
+template <typename CHAR>
+static bool TextGridText_getExists (const CHAR **p_readPointer, bool *out_exists) {
+	if (TextGridText_skipToValue (p_readPointer) != U'<')
+		return false;
+	const CHAR *p = *p_readPointer + 1;
+	char word [8];
+	integer length = 0;
+	for (; textGridKar (p) != U'>'; p ++) {
+		const char32 kar = textGridKar (p);
+		if (kar < U'a' || kar > U'z' || length >= 7)
+			return false;
+		word [length ++] = (char) kar;
+	}
+	word [length] = '\0';
+	p ++;   // past the '>'
+	if (! textGridKarEndsValue (textGridKar (p)))
+		return false;
+	if (strequ (word, "exists"))
+		*out_exists = true;
+	else if (strequ (word, "absent"))
+		*out_exists = false;
+	else
+		return false;
+	*p_readPointer = p;
+	return true;
+}
+
+template <typename CHAR>
+static bool TextGridText_getElement (const CHAR **p_readPointer, TextGridTextTier *tier) {
+	TextGridTextElement element;
+	if (! TextGridText_getReal (p_readPointer, & element. xmin))
+		return false;
+	if (tier -> isIntervalTier) {
+		if (! TextGridText_getReal (p_readPointer, & element. xmax))
+			return false;
+	} else {
+		element. xmax = element. xmin;
+	}
+	if (! TextGridText_getString (p_readPointer, & element. text))
+		return false;
+	tier -> elements. push_back (std::move (element));
+	return true;
+}
+
+template <typename CHAR>
+static bool TextGridText_getTierHeader (const CHAR **p_readPointer, TextGridTextTier *tier) {
+	autostring32 className;
+	if (! TextGridText_getString (p_readPointer, & className))
+		return false;
+	if (str32equ (className.get(), U"IntervalTier"))
+		tier -> isIntervalTier = true;
+	else if (str32equ (className.get(), U"TextTier"))
+		tier -> isIntervalTier = false;
+	else
+		return false;
+	return TextGridText_getString (p_readPointer, & tier -> name) &&
+		TextGridText_getReal (p_readPointer, & tier -> xmin) &&
+		TextGridText_getReal (p_readPointer, & tier -> xmax);
+}
+
+template <typename CHAR>
+static bool TextGridText_parse (TextGridText *me, const CHAR *text, integer textLength) {
+	const CHAR *p = text;
+	/*
+		The first line tells us whether this is an "ooTextFile" (long or short) or a chronological file.
+	*/
+	const CHAR *endOfFirstLine = p;
+	while (textGridKar (endOfFirstLine) != U'\0' && textGridKar (endOfFirstLine) != U'\n')
+		endOfFirstLine ++;
+	auto firstLineContains = [&] (const char *word) {
+		const integer wordLength = (integer) strlen (word);
+		for (const CHAR *start = p; endOfFirstLine - start >= wordLength; start ++) {
+			integer i = 0;
+			while (i < wordLength && textGridKar (start + i) == (char32) word [i])
+				i ++;
+			if (i == wordLength)
+				return true;
+		}
+		return false;
+	};
+	if (firstLineContains ("ooText2File"))
+		return false;
+	my isChronological = ! firstLineContains ("ooTextFile");
+	if (! my isChronological)
+		p = endOfFirstLine;
+	autostring32 klas;
+	if (! TextGridText_getString (& p, & klas))
+		return false;
+	if (! str32equ (klas.get(), my isChronological ? U"Praat chronological TextGrid text file" : U"TextGrid"))
+		return false;
+	if (! TextGridText_getReal (& p, & my xmin) || ! TextGridText_getReal (& p, & my xmax))
+		return false;
+	if (! my isChronological) {
+		bool tiersExist;
+		if (! TextGridText_getExists (& p, & tiersExist) || ! tiersExist)
+			return false;
+	}
+	integer numberOfTiers;
+	if (! TextGridText_getInteger (& p, & numberOfTiers) || numberOfTiers > textLength)
+		return false;
+	my tiers. resize ((size_t) numberOfTiers);
+	if (my isChronological) {
+		for (TextGridTextTier& tier : my tiers)
+			if (! TextGridText_getTierHeader (& p, & tier))
+				return false;
+		for (;;) {
+			if (TextGridText_skipToValue (& p) == U'\0')
+				return true;
+			integer tierNumber;
+			if (! TextGridText_getInteger (& p, & tierNumber) || tierNumber < 1 || tierNumber > numberOfTiers)
+				return false;
+			if (! TextGridText_getElement (& p, & my tiers [(size_t) tierNumber - 1]))
+				return false;
+		}
+	}
+	for (TextGridTextTier& tier : my tiers) {
+		if (! TextGridText_getTierHeader (& p, & tier))
+			return false;
+		integer numberOfElements;
+		if (! TextGridText_getInteger (& p, & numberOfElements))
+			return false;
+		const integer minimumNumberOfCharactersPerElement = ( tier. isIntervalTier ? 8 : 6 );   // e.g. "0\n1\n\"\"\n"
+		if (numberOfElements > (textLength - (p - text)) / minimumNumberOfCharactersPerElement + 1)
+			return false;   // a corrupt count; do not reserve memory for it
+		tier. elements. reserve ((size_t) numberOfElements);
+		for (integer ielement = 1; ielement <= numberOfElements; ielement ++)
+			if (! TextGridText_getElement (& p, & tier))
+				return false;
+	}
+	return true;
+}
+
+/*
+	Thread-safe: no Melder_throw (), no shared buffers.
+	Returns false if the file could not be read or is not an ordinary TextGrid text file.
+*/
+static bool TextGridText_readFromFile (TextGridText *me, const char *path8, bool acceptNonAsciiUtf8) noexcept {
+	try {
+		FILE *f = fopen (path8, "rb");
+		if (! f)
+			return false;
+		std::string bytes;
+		bool ok = ( fseeko (f, 0, SEEK_END) == 0 );
+		const off_t length = ( ok ? ftello (f) : -1 );
+		ok = ok && length >= 0 && fseeko (f, 0, SEEK_SET) == 0;
+		if (ok) {
+			bytes. resize ((size_t) length);
+			ok = ( fread (& bytes [0], 1, (size_t) length, f) == (size_t) length );
+		}
+		fclose (f);
+		if (! ok)
+			return false;
+		if (length >= 2 && ((bytes [0] == '\xFE' && bytes [1] == '\xFF') || (bytes [0] == '\xFF' && bytes [1] == '\xFE'))) {
+			/*
+				UTF-16, decoded as in MelderFile_readText ().
+			*/
+			const bool isBigEndian = ( bytes [0] == '\xFE' );
+			const integer numberOfCodes = (integer) (length / 2 - 1);
+			std::u32string text;
+			text. reserve ((size_t) numberOfCodes);
+			auto code = [&] (integer i) -> char32 {
+				const char32 byte1 = (char8) bytes [(size_t) (2 + 2 * i)], byte2 = (char8) bytes [(size_t) (3 + 2 * i)];
+				return ( isBigEndian ? byte1 << 8 | byte2 : byte2 << 8 | byte1 );
+			};
+			for (integer i = 0; i < numberOfCodes; i ++) {
+				const char32 kar1 = code (i);
+				if (kar1 >= 0xD800 && kar1 < 0xDC00) {
+					const char32 kar2 = ( i + 1 < numberOfCodes ? code (++ i) : 0 );
+					if (kar2 >= 0xDC00 && kar2 <= 0xDFFF)
+						text. push_back (0x01'0000 + ((kar1 & 0x00'03FF) << 10) + (kar2 & 0x00'03FF));
+					else
+						text. push_back (UNICODE_REPLACEMENT_CHARACTER);
+				} else if (kar1 >= 0xDC00 && kar1 < 0xE000) {
+					text. push_back (UNICODE_REPLACEMENT_CHARACTER);
+				} else {
+					if (kar1 == U'\0')
+						return false;
+					text. push_back (kar1);
+				}
+			}
+			const integer textLength = Melder_killReturns_inplace (& text [0]);
+			return TextGridText_parse (me, text. c_str (), textLength);
+		}
+		integer offset = 0;
+		if (length >= 3 && bytes [0] == '\xEF' && bytes [1] == '\xBB' && bytes [2] == '\xBF')
+			offset = 3;   // UTF-8 byte-order mark
+		if (bytes. find ('\0', (size_t) offset) != std::string::npos)
+			return false;   // the general reader warns about null bytes
+		char *text = & bytes [(size_t) offset];
+		const integer textLength = Melder_killReturns_inplace (text);
+		if (! Melder_str8IsValidUtf8 (text))
+			return false;
+		if (! acceptNonAsciiUtf8)
+			for (integer i = 0; i < textLength; i ++)
+				if ((char8) text [i] > 127)
+					return false;
+		return TextGridText_parse (me, (const char *) text, textLength);
+	} catch (...) {
+		return false;   // e.g. out of memory
+	}
+}
+
+static bool TextGridText_canReadAsUtf8 () {
+	const kMelder_textInputEncoding inputEncoding = Melder_getInputEncoding ();
+	return inputEncoding != kMelder_textInputEncoding::ISO_LATIN1 &&
+		inputEncoding != kMelder_textInputEncoding::WINDOWS_LATIN1 &&
+		inputEncoding != kMelder_textInputEncoding::MACROMAN;
+}
+
+static bool TextGridText_getPath8 (MelderFile file, std::string *out_path8) {
+	if (str32str (file -> path, U"://"))
+		return false;   // a URL, which only Melder_fopen () can handle
+	char path8 [kMelder_MAXPATH+1];
+	Melder_32to8_fileSystem_inplace (file -> path, path8);
+	*out_path8 = path8;
+	return true;
+}
+
+/*
+	The domains are checked here, on the main thread, as the general reader checks them for every Function
+	(the TextGrid, its tiers and their intervals): xmin should not exceed xmax.
+	As in the general reader and in the old chronological reader,
+	intervals and points are not required to lie within the domains of their tiers.
+*/
+static autoTextGrid TextGrid_createFromText (TextGridText *text) {
+	Melder_require (text -> xmin <= text -> xmax,
+		U"Wrong xmin ", text -> xmin, U" and xmax ", text -> xmax, U".");
+	autoTextGrid me = Thing_new (TextGrid);
+	my xmin = text -> xmin;
+	my xmax = text -> xmax;
+	my tiers = FunctionList_create ();
+	my tiers -> _grow ((integer) text -> tiers. size ());
+	for (TextGridTextTier& textTier : text -> tiers) {
+		const integer numberOfElements = (integer) textTier. elements. size ();
+		Melder_require (textTier. xmin <= textTier. xmax,
+			U"Wrong xmin ", textTier. xmin, U" and xmax ", textTier. xmax, U" in tier \"", textTier. name.get(), U"\".");
+		if (textTier. isIntervalTier) {
+			autoIntervalTier tier = Thing_new (IntervalTier);
+			tier -> name = textTier. name. move();
+			tier -> xmin = textTier. xmin;
+			tier -> xmax = textTier. xmax;
+			tier -> intervals. _grow (numberOfElements);
+			for (TextGridTextElement& element : textTier. elements) {
+				Melder_require (element. xmin <= element. xmax,
+					U"Wrong xmin ", element. xmin, U" and xmax ", element. xmax, U" in tier \"", tier -> name.get(), U"\".");
+				autoTextInterval interval = Thing_new (TextInterval);
+				interval -> xmin = element. xmin;
+				interval -> xmax = element. xmax;
+				interval -> text = element. text. move();
+				tier -> intervals. addItem_move (interval.move());   // appends in constant time if the file was sorted
+			}
+			my tiers -> addItem_move (tier.move());
+		} else {
+			autoTextTier tier = Thing_new (TextTier);
+			tier -> name = textTier. name. move();
+			tier -> xmin = textTier. xmin;
+			tier -> xmax = textTier. xmax;
+			tier -> points. _grow (numberOfElements);
+			for (TextGridTextElement& element : textTier. elements) {
+				autoTextPoint point = Thing_new (TextPoint);
+				point -> number = element. xmin;
+				point -> mark = element. text. move();
+				tier -> points. addItem_move (point.move());
+			}
+			my tiers -> addItem_move (tier.move());
+		}
+		textTier. elements. clear ();
+		textTier. elements. shrink_to_fit ();
+	}
+	if (! text -> isChronological)
+		my v_repair ();   // as Data_readText () does
+	return me;
+}
+
+autoTextGrid TextGrid_readFromFile (MelderFile file) {
+	try {
+		std::string path8;
+		TextGridText text;
+		if (TextGridText_getPath8 (file, & path8) && TextGridText_readFromFile (& text, path8. c_str (), TextGridText_canReadAsUtf8 ()))
+			return TextGrid_createFromText (& text);
+		autoDaata object = Data_readFromFile (file);
+		if (! object || ! Thing_isa (object.get(), classTextGrid))
+			Melder_throw (U"The file does not contain a TextGrid.");
+		return object.static_cast_move <structTextGrid> ();
+	} catch (MelderError) {
+		Melder_throw (U"TextGrid not read from file ", file, U".");
+	}
+}
+
+autoCollection TextGrids_readFromFiles (conststring32 path) {
+	try {
+		autoStrings fileNames = Strings_createAsFileList (path);
+		const integer numberOfFiles = fileNames -> numberOfStrings;
+		if (numberOfFiles == 0)
+			Melder_throw (U"No files found.");
+		/*
+			The folder part of the path, as in Strings_createAsFileList ().
+		*/
+		autoMelderString folder;
+		MelderString_copy (& folder, path);
+		char32 *asterisk = str32chr (folder. string, U'*');
+		if (asterisk) {
+			*asterisk = U'\0';
+			char32 *lastSeparator = str32rchr (folder. string, Melder_DIRECTORY_SEPARATOR);
+			if (lastSeparator)
+				*lastSeparator = U'\0';
+			else
+				folder. string [0] = U'\0';
+			folder. length = str32len (folder. string);
+		}
+		const char32 separator [] = { Melder_DIRECTORY_SEPARATOR, U'\0' };
+		auto getFile = [&] (integer ifile, MelderFile file) {
+			conststring32 fileName = fileNames -> strings [ifile + 1].get();
+			if (folder. length == 0)
+				Melder_relativePathToFile (fileName, file);
+			else
+				Melder_relativePathToFile (Melder_cat (folder. string, separator, fileName), file);
+		};
+		std::vector <std::string> paths8 ((size_t) numberOfFiles);
+		for (integer ifile = 0; ifile < numberOfFiles; ifile ++) {
+			structMelderFile file { };
+			getFile (ifile, & file);
+			if (! TextGridText_getPath8 (& file, & paths8 [(size_t) ifile]))
+				paths8 [(size_t) ifile]. clear ();   // leave it to the general reader
+		}
+		/*
+			The sizes of the files are not known yet, so every file counts as worth a thread.
+		*/
+		const integer numberOfThreads = MelderThread_getNumberOfThreads (numberOfFiles, 1e6 * numberOfFiles);
+		/*
+			Scan the files in batches, so that not more than a batch of scanned texts waits for its TextGrid at any time.
+		*/
+		const integer numberOfFilesPerBatch = 64 * numberOfThreads;
+		const bool acceptNonAsciiUtf8 = TextGridText_canReadAsUtf8 ();
+		std::vector <TextGridText> texts ((size_t) numberOfFiles);
+		std::vector <unsigned char> succeeded ((size_t) numberOfFiles, false);   // not a vector <bool>, whose elements cannot be written from different threads
+		autoCollection result = Collection_create ();
+		for (integer firstFile = 0; firstFile < numberOfFiles; firstFile += numberOfFilesPerBatch) {
+			const integer lastFile = std::min (firstFile + numberOfFilesPerBatch, numberOfFiles) - 1;
+			const integer numberOfFilesInBatch = lastFile - firstFile + 1;
+			MelderThread_runStretches (std::min (numberOfThreads, numberOfFilesInBatch), numberOfFilesInBatch,
+				[&] (integer /* ithread */, integer firstFileInBatch, integer lastFileInBatch) {
+					for (integer ifile = firstFile + firstFileInBatch - 1; ifile <= firstFile + lastFileInBatch - 1; ifile ++) {
+						const std::string& path8 = paths8 [(size_t) ifile];
+						succeeded [(size_t) ifile] = ! path8. empty () &&
+							TextGridText_readFromFile (& texts [(size_t) ifile], path8. c_str (), acceptNonAsciiUtf8);
+					}
+				}
+			);
+			for (integer ifile = firstFile; ifile <= lastFile; ifile ++) {
+				structMelderFile file { };
+				getFile (ifile, & file);
+				autoTextGrid textGrid;
+				if (succeeded [(size_t) ifile]) {
+					try {
+						textGrid = TextGrid_createFromText (& texts [(size_t) ifile]);
+					} catch (MelderError) {
+						Melder_throw (U"TextGrid not read from file ", & file, U".");
+					}
+					texts [(size_t) ifile]. tiers. clear ();
+					texts [(size_t) ifile]. tiers. shrink_to_fit ();
+				} else {
+					textGrid = TextGrid_readFromFile (& file);
+				}
+				Thing_setName (textGrid.get(), MelderFile_name (& file));
+				result -> addItem_move (textGrid.move());
+			}
+		}
+		return result;
+	} catch (MelderError) {
+		Melder_throw (U"TextGrids not read from ", path, U".");
+	}
+}
+
 autoTextGrid TextGrid_readFromChronologicalTextFile (MelderFile file) {
 	try {
+		std::string path8;
+		TextGridText fastText;
+		if (TextGridText_getPath8 (file, & path8) && TextGridText_readFromFile (& fastText, path8. c_str (), TextGridText_canReadAsUtf8 ()) &&
+				fastText. isChronological)
+			return TextGrid_createFromText (& fastText);
 		int formatVersion = 0;
 		autoMelderReadText text = MelderReadText_createFromFile (file);
 		autostring32 tag = texgetw16 (text.get());
@@ -1355,9 +2133,9 @@ void TextGrid_writeToChronologicalTextFile (TextGrid me, MelderFile file) {
 		autoMelderFile mfile = file;
 		/*
 		 * The "elements" (intervals and points) are sorted primarily by time and secondarily by tier.
+		 * Within a tier they are already sorted by time, so we merge the tiers,
+		 * keeping for each tier the number of the first element that has not been written yet.
 		 */
-		double sortingTime = -1e308;
-		integer sortingTier = 0;
 		file -> verbose = false;
 		texindent (file);
 		MelderFile_write (file, U"\"Praat chronological TextGrid text file\"\n", my xmin, U" ", my xmax,
@@ -1370,60 +2148,48 @@ void TextGrid_writeToChronologicalTextFile (TextGrid me, MelderFile file) {
 			writeQuotedString (file, anyTier -> name.get());
 			MelderFile_write (file, U" ", anyTier -> xmin, U" ", anyTier -> xmax);
 		}
+		autoINTVEC firstRemainingElementOfTier = newINTVECraw (my tiers->size);
+		for (integer itier = 1; itier <= my tiers->size; itier ++)
+			firstRemainingElementOfTier [itier] = 1;
 		for (;;) {
-			double firstRemainingTime = +1e308;
-			integer firstRemainingTier = 2000000000, firstRemainingElement = 0;
-			for (integer itier = 1; itier <= my tiers->size; itier ++) {
+			double firstRemainingTime = undefined;
+			integer firstRemainingTier = 0;
+			for (integer itier = 1; itier <= my tiers->size; itier ++) {   // on equal times, the lowest tier number wins
 				Function anyTier = my tiers->at [itier];
+				const integer ielement = firstRemainingElementOfTier [itier];
+				double time;
 				if (anyTier -> classInfo == classIntervalTier) {
 					IntervalTier tier = static_cast <IntervalTier> (anyTier);
-					for (integer ielement = 1; ielement <= tier -> intervals.size; ielement ++) {
-						TextInterval interval = tier -> intervals.at [ielement];
-						if ((interval -> xmin > sortingTime ||   // sort primarily by time
-							 (interval -> xmin == sortingTime && itier > sortingTier)) &&   // sort secondarily by tier number
-							(interval -> xmin < firstRemainingTime ||   // sort primarily by time
-							 (interval -> xmin == firstRemainingTime && itier < firstRemainingTier)))   // sort secondarily by tier number
-						{
-							firstRemainingTime = interval -> xmin;
-							firstRemainingTier = itier;
-							firstRemainingElement = ielement;
-						}
-					}
+					if (ielement > tier -> intervals.size)
+						continue;
+					time = tier -> intervals.at [ielement] -> xmin;
 				} else {
 					TextTier tier = static_cast <TextTier> (anyTier);
-					for (integer ielement = 1; ielement <= tier -> points.size; ielement ++) {
-						TextPoint point = tier -> points.at [ielement];
-						if ((point -> number > sortingTime ||   // sort primarily by time
-							 (point -> number == sortingTime && itier > sortingTier)) &&   // sort secondarily by tier number
-							(point -> number < firstRemainingTime ||   // sort primarily by time
-							 (point -> number == firstRemainingTime && itier < firstRemainingTier)))   // sort secondarily by tier number
-						{
-							firstRemainingTime = point -> number;
-							firstRemainingTier = itier;
-							firstRemainingElement = ielement;
-						}
-					}
+					if (ielement > tier -> points.size)
+						continue;
+					time = tier -> points.at [ielement] -> number;
+				}
+				if (firstRemainingTier == 0 || time < firstRemainingTime) {
+					firstRemainingTime = time;
+					firstRemainingTier = itier;
 				}
 			}
-			if (firstRemainingElement == 0) {
+			if (firstRemainingTier == 0)
 				break;
+			const integer firstRemainingElement = firstRemainingElementOfTier [firstRemainingTier] ++;
+			Function anyTier = my tiers->at [firstRemainingTier];
+			if (anyTier -> classInfo == classIntervalTier) {
+				IntervalTier tier = static_cast <IntervalTier> (anyTier);
+				TextInterval interval = tier -> intervals.at [firstRemainingElement];
+				if (tier -> name) MelderFile_write (file, U"\n\n! ", tier -> name.get(), U":");
+				MelderFile_write (file, U"\n", firstRemainingTier, U" ", interval -> xmin, U" ", interval -> xmax);
+				texputw32 (file, interval -> text.get(), U"", 0,0,0,0,0);
 			} else {
-				Function anyTier = my tiers->at [firstRemainingTier];
-				if (anyTier -> classInfo == classIntervalTier) {
-					IntervalTier tier = static_cast <IntervalTier> (anyTier);
-					TextInterval interval = tier -> intervals.at [firstRemainingElement];
-					if (tier -> name) MelderFile_write (file, U"\n\n! ", tier -> name.get(), U":");
-					MelderFile_write (file, U"\n", firstRemainingTier, U" ", interval -> xmin, U" ", interval -> xmax);
-					texputw32 (file, interval -> text.get(), U"", 0,0,0,0,0);
-				} else {
-					TextTier tier = static_cast <TextTier> (anyTier);
-					TextPoint point = tier -> points.at [firstRemainingElement];
-					if (tier -> name) MelderFile_write (file, U"\n\n! ", tier -> name.get(), U":");
-					MelderFile_write (file, U"\n", firstRemainingTier, U" ", point -> number, U" ");
-					texputw32 (file, point -> mark.get(), U"", 0,0,0,0,0);
-				}
-				sortingTime = firstRemainingTime;
-				sortingTier = firstRemainingTier;
+				TextTier tier = static_cast <TextTier> (anyTier);
+				TextPoint point = tier -> points.at [firstRemainingElement];
+				if (tier -> name) MelderFile_write (file, U"\n\n! ", tier -> name.get(), U":");
+				MelderFile_write (file, U"\n", firstRemainingTier, U" ", point -> number, U" ");
+				texputw32 (file, point -> mark.get(), U"", 0,0,0,0,0);
 			}
 		}
 		texexdent (file);
@@ -1693,6 +2459,7 @@ autoTable TextGrid_downto_Table (TextGrid me, bool includeLineNumbers, int timeD
 
 autoTable TextGrid_tabulateOccurrences (TextGrid me, constVEC searchTiers, kMelder_string which, conststring32 criterion, bool caseSensitive) {
 	const int timeDecimals = 6;
+	MelderStringMatcher matcher (which, criterion, caseSensitive);
 	integer numberOfRows = 0;
 	for (integer itier = 1; itier <= searchTiers.size; itier ++) {
 		integer tierNumber = Melder_iround (searchTiers [itier]);
@@ -1702,7 +2469,7 @@ autoTable TextGrid_tabulateOccurrences (TextGrid me, constVEC searchTiers, kMeld
 			IntervalTier tier = static_cast <IntervalTier> (anyTier);
 			for (integer iinterval = 1; iinterval <= tier -> intervals.size; iinterval ++) {
 				TextInterval interval = tier -> intervals.at [iinterval];
-				if (Melder_stringMatchesCriterion (interval -> text.get(), which, criterion, caseSensitive)) {
+				if (matcher.matches (interval -> text.get())) {
 					numberOfRows ++;
 				}
 			}
@@ -1710,7 +2477,7 @@ autoTable TextGrid_tabulateOccurrences (TextGrid me, constVEC searchTiers, kMeld
 			TextTier tier = static_cast <TextTier> (anyTier);
 			for (integer ipoint = 1; ipoint <= tier -> points.size; ipoint ++) {
 				TextPoint point = tier -> points.at [ipoint];
-				if (Melder_stringMatchesCriterion (point -> mark.get(), which, criterion, caseSensitive)) {
+				if (matcher.matches (point -> mark.get())) {
 					numberOfRows ++;
 				}
 			}
@@ -1725,7 +2492,7 @@ autoTable TextGrid_tabulateOccurrences (TextGrid me, constVEC searchTiers, kMeld
 			IntervalTier tier = static_cast <IntervalTier> (anyTier);
 			for (integer iinterval = 1; iinterval <= tier -> intervals.size; iinterval ++) {
 				TextInterval interval = tier -> intervals.at [iinterval];
-				if (Melder_stringMatchesCriterion (interval -> text.get(), which, criterion, caseSensitive)) {
+				if (matcher.matches (interval -> text.get())) {
 					++ rowNumber;
 					Melder_assert (rowNumber <= numberOfRows);
 					double time = 0.5 * (interval -> xmin + interval -> xmax);
@@ -1738,7 +2505,7 @@ autoTable TextGrid_tabulateOccurrences (TextGrid me, constVEC searchTiers, kMeld
 			TextTier tier = static_cast <TextTier> (anyTier);
 			for (integer ipoint = 1; ipoint <= tier -> points.size; ipoint ++) {
 				TextPoint point = tier -> points.at [ipoint];
-				if (Melder_stringMatchesCriterion (point -> mark.get(), which, criterion, caseSensitive)) {
+				if (matcher.matches (point -> mark.get())) {
 					++ rowNumber;
 					Melder_assert (rowNumber <= numberOfRows);
 					double time = point -> number;
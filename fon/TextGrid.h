@@ -23,6 +23,7 @@
 #include "Graphics.h"
 #include "TableOfReal.h"
 #include "Table.h"
+#include "Strings_.h"
 
 Collection_define (FunctionList, OrderedOf, Function) {
 };
@@ -52,6 +53,20 @@ integer IntervalTier_timeToIndex (IntervalTier me, double t);   // obsolete
 integer IntervalTier_timeToHighIndex (IntervalTier me, double t);
 integer IntervalTier_hasTime (IntervalTier me, double t);
 integer IntervalTier_hasBoundary (IntervalTier me, double t);
+
+/*
+	The same as IntervalTier_timeToIndex () and AnyTier_timeToLowIndex () for many times at once;
+	fastest if the times are sorted. Undefined times yield 0.
+*/
+autoINTVEC IntervalTier_timesToIndices (IntervalTier me, constVECVU const& times);
+autoINTVEC TextTier_timesToLowIndices (TextTier me, constVECVU const& times);
+
+/*
+	The intervals that share more than a single time with (tmin, tmax); returns their number.
+*/
+integer IntervalTier_getIntervalsOverlappingRange (IntervalTier me, double tmin, double tmax,
+	integer *out_firstInterval, integer *out_lastInterval);
+
 autoPointProcess IntervalTier_getStartingPoints (IntervalTier me, conststring32 text);
 autoPointProcess IntervalTier_getEndPoints (IntervalTier me, conststring32 text);
 autoPointProcess IntervalTier_getCentrePoints (IntervalTier me, conststring32 text);
@@ -65,6 +80,11 @@ autoTextGrid TextGrid_createWithoutTiers (double tmin, double tmax);
 autoTextGrid TextGrid_create (double tmin, double tmax, conststring32 tierNames, conststring32 pointTiers);
 
 integer TextGrid_countLabels (TextGrid me, integer itier, conststring32 text);
+autoINTVEC TextGrid_findIntervalsWhere (TextGrid me, integer tierNumber, kMelder_string which, conststring32 criterion);
+autoINTVEC TextGrid_findPointsWhere (TextGrid me, integer tierNumber, kMelder_string which, conststring32 criterion);
+autoVEC TextGrid_getTimesOfIntervalsWhere (TextGrid me, integer tierNumber, kMelder_string which, conststring32 criterion, double phase);   // 0 = start, 1 = end
+autoVEC TextGrid_getTimesOfPointsWhere (TextGrid me, integer tierNumber, kMelder_string which, conststring32 criterion);
+autoStrings TextGrid_getLabelsWhere (TextGrid me, integer tierNumber, kMelder_string which, conststring32 criterion);
 integer TextGrid_countIntervalsWhere (TextGrid me, integer tierNumber, kMelder_string which, conststring32 criterion);
 integer TextGrid_countPointsWhere (TextGrid me, integer tierNumber, kMelder_string which, conststring32 criterion);
 autoPointProcess TextGrid_getStartingPoints (TextGrid me, integer tierNumber, kMelder_string which, conststring32 criterion);
@@ -121,10 +141,21 @@ void TextGrid_setPointText (TextGrid me, integer tierNumber, integer pointNumber
 
 void TextGrid_writeToChronologicalTextFile (TextGrid me, MelderFile file);
 autoTextGrid TextGrid_readFromChronologicalTextFile (MelderFile file);
+autoTextGrid TextGrid_readFromFile (MelderFile file);
+/*
+	Text files in the long, short and chronological formats are scanned by a dedicated reader;
+	other files go through Data_readFromFile ().
+*/
+autoCollection TextGrids_readFromFiles (conststring32 path);
+/*
+	`path` is a folder or a wildcarded path, as in Strings_createAsFileList ();
+	the files are scanned in parallel, and every TextGrid is named after its file.
+*/
 autoTextGrid TextGrid_readFromCgnSyntaxFile (MelderFile file);
 
 autoTable TextGrid_downto_Table (TextGrid me, bool includeLineNumbers, int timeDecimals, bool includeTierNames, bool includeEmptyIntervals);
 autoTable TextGrid_tabulateOccurrences (TextGrid me, constVEC searchTiers, kMelder_string which, conststring32 criterion, bool caseSensitive);
+autoTable TextGrid_tabulateLabelsAtTimes (TextGrid me, constVECVU const& times);
 void TextGrid_list (TextGrid me, bool includeLineNumbers, int timeDecimals, bool includeTierNames, bool includeEmptyIntervals);
 
 void TextGrid_correctRoundingErrors (TextGrid me);
@@ -2171,6 +2171,26 @@ MAN_BEGIN (U"Table", U"ppgb", 20030316)
 INTRO (U"One of the @@types of objects@ in Praat. See the @Statistics tutorial.")
 MAN_END
 
+MAN_BEGIN (U"Table: Sort rows (ascending or descending)...", U"agent", 20261018)
+INTRO (U"A command to sort the rows of every selected @Table object, "
+	"with a choice between ascending and descending order for each column.")
+ENTRY (U"Settings")
+TAG (U"##One or more column labels for sorting")
+DEFINITION (U"the columns by which the rows are sorted, separated by spaces: "
+	"the rows are sorted by the first column, rows with equal values in that column by the second column, and so on.")
+TAG (U"##Which of these to sort in descending order")
+DEFINITION (U"the columns, among those above, whose values should go from high to low; "
+	"the other columns go from low to high. This list can be empty.")
+ENTRY (U"Behaviour")
+NORMAL (U"A column that contains only numbers is sorted by value; any other column is sorted by the Unicode values of its characters. "
+	"Undefined values count as greater than all numbers, so they come last in ascending order and first in descending order.")
+NORMAL (U"The sort is stable: rows that have equal values in all the sorting columns keep their original order. "
+	"With an empty descending list, this command does the same as ##Sort rows...#.")
+ENTRY (U"Example")
+NORMAL (U"To sort a table of measurements by dialect and gender, with the longest durations first within each group:")
+CODE (U"Sort rows (ascending or descending): \"dialect gender duration\", \"duration\"")
+MAN_END
+
 MAN_BEGIN (U"TableOfReal", U"ppgb", 20030316)
 INTRO (U"One of the @@types of objects@ in Praat.")
 NORMAL (U"A TableOfReal object contains a number of %cells. Each cell belongs to a %row and a %column. "
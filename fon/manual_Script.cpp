@@ -869,6 +869,12 @@ DEFINITION (U"Generates a random numbers drawn from a Gamma distribution with sh
 	" %f(%x; %\\al, %\\be) = (1 / \\Ga (%\\al)) %\\be%^^%\\al^ %x^^%\\al\\-m1^ %e^^\\-m%\\be %x^),"
 	" for %x > 0, %\\al > 0 and %\\be > 0. "
 	" The method to generate these numbers is described in @@Marsaglia & Tsang (2000)@.")
+TAG (U"##random_initializeWithSeedUnsafelyButPredictably (%seed)")
+DEFINITION (U"makes all following random numbers predictable: after the same %seed, the random functions "
+	"(and commands that use random numbers, such as multiple repetitions of an MDS analysis) give the same results again. "
+	"Use this only for testing or for reproducing an earlier result, because the numbers are no longer unpredictable.")
+TAG (U"##random_initializeSafelyAndUnpredictably ()")
+DEFINITION (U"undoes the effect of ##random_initializeWithSeedUnsafelyButPredictably#")
 TAG (U"##lnGamma (%x)")
 DEFINITION (U"logarithm of the \\Ga function")
 TAG (U"##gaussP (%z)")
@@ -21,6 +21,27 @@
 void manual_annotation_init (ManPages me);
 void manual_annotation_init (ManPages me) {
 
+MAN_BEGIN (U"Corpus: To LabelIndex", U"agent", 20261018)
+INTRO (U"A command to create a @LabelIndex from every selected ##Corpus# object.")
+NORMAL (U"The index covers the annotation files of all the rows of the Corpus that have one; "
+	"rows without an annotation file are skipped.")
+MAN_END
+
+MAN_BEGIN (U"Create LabelIndex from folder...", U"agent", 20261018)
+INTRO (U"A command in the @@New menu@ to create a @LabelIndex from all the TextGrid files in a folder.")
+ENTRY (U"Settings")
+TAG (U"##Name")
+DEFINITION (U"the name of the new LabelIndex object.")
+TAG (U"##Folder with annotation files")
+DEFINITION (U"the folder that contains the TextGrid files.")
+TAG (U"##Annotation file extension")
+DEFINITION (U"the extension of the files that are read, without the dot; "
+	"with the standard value %TextGrid, all the files whose names end in \".TextGrid\" are read.")
+ENTRY (U"Behaviour")
+NORMAL (U"Every file is read once, and the labels of all its tiers go into the index; "
+	"the TextGrids themselves are not kept. If the folder contains no matching files, you get an error message.")
+MAN_END
+
 MAN_BEGIN (U"Create TextGrid...", U"ppgb", 20101228)
 INTRO (U"A command to create a @TextGrid from scratch.")
 ENTRY (U"Settings")
@@ -35,6 +56,49 @@ DEFINITION (U"a list of the names of the tiers that you want to be %%point tiers
 	"the rest of the tiers will be %%interval tiers%.")
 MAN_END
 
+MAN_BEGIN (U"LabelIndex", U"agent", 20261018)
+INTRO (U"One of the @@types of objects@ in Praat. "
+	"A LabelIndex is an index of the labels of all the intervals and points in a set of @TextGrid files, "
+	"made for searching large annotated corpora.")
+ENTRY (U"Creating a LabelIndex")
+LIST_ITEM (U"\\bu @@Create LabelIndex from folder...@")
+LIST_ITEM (U"\\bu @@Corpus: To LabelIndex@")
+ENTRY (U"Queries")
+LIST_ITEM (U"\\bu @@LabelIndex: Count hits...@")
+LIST_ITEM (U"\\bu @@LabelIndex: Tabulate hits...@")
+ENTRY (U"How it works")
+NORMAL (U"The index stores every different label only once, together with the places (file, tier, interval or point) "
+	"where it occurs. A search compares the criterion with each different label, "
+	"of which there are usually a few hundred, rather than with each of the possibly millions of intervals in the corpus. "
+	"A search with %%is equal to% is even faster, because the labels are kept in sorted order.")
+NORMAL (U"The index refers to the files by name. If you change the TextGrid files after creating the index, "
+	"create a new index.")
+MAN_END
+
+MAN_BEGIN (U"LabelIndex: Count hits...", U"agent", 20261018)
+INTRO (U"A command to ask the selected @LabelIndex object for the number of intervals and points "
+	"whose labels meet a criterion.")
+ENTRY (U"Settings")
+TAG (U"##Count intervals and points whose label...# and ##...the text")
+DEFINITION (U"the criterion, e.g. %%is equal to% \"a\" or %%matches (regex)% \"^[aeiou]\".")
+ENTRY (U"Scripting")
+CODE (U"selectObject: \"LabelIndex myIndex\"")
+CODE (U"numberOfVowels = Count hits: \"matches (regex)\", \"^[aeiou]\"")
+MAN_END
+
+MAN_BEGIN (U"LabelIndex: Tabulate hits...", U"agent", 20261018)
+INTRO (U"A command to create a @Table from every selected @LabelIndex object, "
+	"with one row for every interval and point whose label meets a criterion.")
+ENTRY (U"Settings")
+TAG (U"##List every interval and point whose label...# and ##...the text")
+DEFINITION (U"the criterion, as in @@LabelIndex: Count hits...@.")
+ENTRY (U"Behaviour")
+NORMAL (U"The Table has the columns %file, %tier, %interval, %start, %end and %text. "
+	"The column %tier contains the name of the tier. For a point tier, "
+	"%interval contains the number of the point, and %end equals %start.")
+NORMAL (U"The rows are sorted by file, then by tier, then by interval or point.")
+MAN_END
+
 MAN_BEGIN (U"PointProcess: To TextGrid...", U"ppgb", 19980113)
 INTRO (U"A command to create an empty @TextGrid from every selected @PointProcess.")
 NORMAL (U"The only information in the PointProcess that is used, is its starting and finishing times.")
@@ -185,6 +249,93 @@ CODE (U"selectObject: \"TextGrid hallo\"")
 CODE (U"number_of_a = Count labels: 1, \"a\"")
 NORMAL (U"In this case, the value will not be written into the Info window.")
 MAN_END
+
+MAN_BEGIN (U"TextGrid: Extract labels where...", U"agent", 20261018)
+INTRO (U"A command to create a @Strings object from every selected @TextGrid object, "
+	"containing the labels of the intervals or points of a tier that meet a criterion.")
+ENTRY (U"Settings")
+TAG (U"##Tier number")
+DEFINITION (U"the number (1, 2, 3...) of the tier whose labels you want to extract. This can be an interval tier or a point tier.")
+TAG (U"##Extract every label that...# and ##...the text")
+DEFINITION (U"the criterion, e.g. %%is equal to% \"a\" or %%starts with% \"ij\".")
+ENTRY (U"Behaviour")
+NORMAL (U"The Strings object contains the matching labels in the order of the intervals or points in the tier.")
+NORMAL (U"Commands can return numeric vectors to a script (as the ##List ... where...# commands do), "
+	"but not string vectors, which is why the labels come in a Strings object. "
+	"In a script, you get them into a string array with ##Get string...#:")
+CODE (U"selectObject: \"TextGrid hallo\"")
+CODE (U"labels = Extract labels where: 1, \"starts with\", \"a\"")
+CODE (U"numberOfLabels = Get number of strings")
+CODE (U"for i to numberOfLabels")
+	CODE1 (U"label$ [i] = Get string: i")
+CODE (U"endfor")
+CODE (U"removeObject: labels")
+MAN_END
+
+MAN_BEGIN (U"TextGrid: List end times of intervals where...", U"agent", 20261018)
+INTRO (U"A command to ask the selected @TextGrid object for the end times of all the intervals "
+	"of an interval tier whose labels meet a criterion.")
+NORMAL (U"The settings are the same as for @@TextGrid: List intervals where...@. "
+	"The times come in the order of the intervals in the tier.")
+ENTRY (U"Scripting")
+CODE (U"endTimes# = List end times of intervals where: 1, \"is equal to\", \"a\"")
+MAN_END
+
+MAN_BEGIN (U"TextGrid: List intervals where...", U"agent", 20261018)
+INTRO (U"A command to ask the selected @TextGrid object for the numbers of all the intervals "
+	"of an interval tier whose labels meet a criterion.")
+ENTRY (U"Settings")
+TAG (U"##Tier number")
+DEFINITION (U"the number (1, 2, 3...) of the interval tier whose labels you want to investigate.")
+TAG (U"##List intervals whose label...# and ##...the text")
+DEFINITION (U"the criterion, e.g. %%is equal to% \"a\" or %%contains a word equal to% \"the\".")
+ENTRY (U"Behaviour")
+NORMAL (U"The interval numbers (1, 2, 3...) are written into the @@Info window@ in increasing order. "
+	"If no interval meets the criterion, the list is empty; if the tier is not an interval tier, you get an error message. "
+	"This gives the same intervals as one ##Get label of interval...# per interval, "
+	"but with one command instead of as many commands as there are intervals, "
+	"and with a regular expression that is compiled only once.")
+ENTRY (U"Scripting")
+NORMAL (U"You can use this command to put the numbers into a vector variable:")
+CODE (U"selectObject: \"TextGrid hallo\"")
+CODE (U"intervals# = List intervals where: 1, \"is equal to\", \"a\"")
+NORMAL (U"In this case, the numbers will not be written into the Info window. "
+	"See also @@TextGrid: List start times of intervals where...@ and @@TextGrid: List end times of intervals where...@.")
+MAN_END
+
+MAN_BEGIN (U"TextGrid: List points where...", U"agent", 20261018)
+INTRO (U"A command to ask the selected @TextGrid object for the numbers of all the points "
+	"of a point tier whose labels meet a criterion.")
+ENTRY (U"Settings")
+TAG (U"##Tier number")
+DEFINITION (U"the number (1, 2, 3...) of the point tier whose labels you want to investigate.")
+TAG (U"##List points whose label...# and ##...the text")
+DEFINITION (U"the criterion, e.g. %%is equal to% \"H*\" or %%ends with% \"L\".")
+ENTRY (U"Behaviour")
+NORMAL (U"The point numbers (1, 2, 3...) are written into the @@Info window@ in increasing order. "
+	"If no point meets the criterion, the list is empty; if the tier is not a point tier, you get an error message.")
+ENTRY (U"Scripting")
+CODE (U"points# = List points where: 2, \"starts with\", \"H\"")
+NORMAL (U"See also @@TextGrid: List times of points where...@.")
+MAN_END
+
+MAN_BEGIN (U"TextGrid: List start times of intervals where...", U"agent", 20261018)
+INTRO (U"A command to ask the selected @TextGrid object for the start times of all the intervals "
+	"of an interval tier whose labels meet a criterion.")
+NORMAL (U"The settings are the same as for @@TextGrid: List intervals where...@. "
+	"The times come in the order of the intervals in the tier.")
+ENTRY (U"Scripting")
+CODE (U"startTimes# = List start times of intervals where: 1, \"is equal to\", \"a\"")
+MAN_END
+
+MAN_BEGIN (U"TextGrid: List times of points where...", U"agent", 20261018)
+INTRO (U"A command to ask the selected @TextGrid object for the times of all the points "
+	"of a point tier whose labels meet a criterion.")
+NORMAL (U"The settings are the same as for @@TextGrid: List points where...@. "
+	"The times come in the order of the points in the tier.")
+ENTRY (U"Scripting")
+CODE (U"times# = List times of points where: 2, \"starts with\", \"H\"")
+MAN_END
  
 MAN_BEGIN (U"TextGrids: Merge", U"ppgb", 20101230)
 INTRO (U"A command to merge all selected @TextGrid objects into a new @TextGrid.")
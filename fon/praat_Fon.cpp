@@ -30,6 +30,7 @@
 #include "Harmonicity.h"
 #include "IntensityTier.h"
 #include "IntensityTierEditor.h"
+#include "LabelIndex.h"
 #include "LongSound.h"
 #include "Ltas_to_SpectrumTier.h"
 #include "ManipulationEditor.h"
@@ -182,6 +183,55 @@ DIRECT (WINDOW_Corpus_edit) {
 	END
 }
 
+// MARK: Convert
+
+DIRECT (NEW_Corpus_to_LabelIndex) {
+	CONVERT_EACH (Corpus)
+		autoLabelIndex result = Corpus_to_LabelIndex (me);
+	CONVERT_EACH_END (my name.get())
+}
+
+// MARK: - LABELINDEX
+
+// MARK: New
+
+FORM (NEW1_LabelIndex_createFromFolder, U"Create LabelIndex from folder", U"Create LabelIndex from folder...") {
+	WORD (name, U"Name", U"myIndex")
+	TEXTFIELD (folderWithAnnotationFiles, U"Folder with annotation files:", U"")
+	WORD (annotationFileExtension, U"Annotation file extension", U"TextGrid")
+	OK
+DO
+	CREATE_ONE
+		autoLabelIndex result = LabelIndex_createFromFolder (folderWithAnnotationFiles, annotationFileExtension);
+	CREATE_ONE_END (name)
+}
+
+// MARK: Query
+
+FORM (INTEGER_LabelIndex_countHits, U"LabelIndex: Count hits", U"LabelIndex: Count hits...") {
+	OPTIONMENU_ENUM (kMelder_string, countIntervalsAndPointsWhoseLabel___,
+			U"Count intervals and points whose label...", kMelder_string::DEFAULT)
+	SENTENCE (___theText, U"...the text", U"hi")
+	OK
+DO
+	NUMBER_ONE (LabelIndex)
+		integer result = LabelIndex_countHits (me, countIntervalsAndPointsWhoseLabel___, ___theText);
+	NUMBER_ONE_END (U" intervals and points")
+}
+
+// MARK: Convert
+
+FORM (NEW_LabelIndex_tabulateHits, U"LabelIndex: Tabulate hits", U"LabelIndex: Tabulate hits...") {
+	OPTIONMENU_ENUM (kMelder_string, listEveryIntervalAndPointWhoseLabel___,
+			U"List every interval and point whose label...", kMelder_string::DEFAULT)
+	SENTENCE (___theText, U"...the text", U"hi")
+	OK
+DO
+	CONVERT_EACH (LabelIndex)
+		autoTable result = LabelIndex_tabulateHits (me, listEveryIntervalAndPointWhoseLabel___, ___theText);
+	CONVERT_EACH_END (my name.get(), U"_hits")
+}
+
 // MARK: - DISTRIBUTIONS
 
 FORM (NEW_Distributions_to_Transition, U"To Transition", nullptr) {
@@ -2686,6 +2736,28 @@ FORM_READ (READ1_Strings_readFromRawTextFile, U"Read Strings from raw text file"
 	READ_ONE_END
 }
 
+FORM (READMANY_TextGrids_readFromFiles, U"Read TextGrids from files", nullptr) {
+	static structMelderDir defaultDir { };
+	Melder_getHomeDir (& defaultDir);
+	static conststring32 homeDirectory = Melder_dirToPath (& defaultDir);
+	static char32 defaultPath [kMelder_MAXPATH+1];
+	#if defined (UNIX)
+		Melder_sprint (defaultPath,kMelder_MAXPATH+1, homeDirectory, U"/*.TextGrid");
+	#elif defined (_WIN32)
+	{
+		static int len = str32len (homeDirectory);
+		Melder_sprint (defaultPath,kMelder_MAXPATH+1, homeDirectory, len == 0 || homeDirectory [len - 1] != U'\\' ? U"\\" : U"", U"*.TextGrid");
+	}
+	#else
+		Melder_sprint (defaultPath,kMelder_MAXPATH+1, homeDirectory, U"/*.TextGrid");
+	#endif
+	TEXTFIELD (path, U"File path:", defaultPath)
+	OK
+DO
+	autoCollection result = TextGrids_readFromFiles (path);
+	praat_new (result.move());
+END }
+
 // MARK: Save
 
 FORM_SAVE (SAVE_Strings_writeToRawTextFile, U"Save Strings as text file", nullptr, U"txt") {
@@ -2974,7 +3046,7 @@ void praat_uvafon_init () {
 		classTransition,
 		classManipulation, classTextPoint, classTextInterval, classTextTier,
 		classIntervalTier, classTextGrid, classWordList, classSpellingChecker,
-		classCorpus,
+		classCorpus, classLabelIndex,
 		nullptr);
 	Thing_recognizeClassByOtherName (classManipulation, U"Psola");
 	Thing_recognizeClassByOtherName (classManipulation, U"Analysis");
@@ -3006,11 +3078,13 @@ void praat_uvafon_init () {
 	praat_addMenuCommand (U"Objects", U"New", U"-- new textgrid --", nullptr, 0, nullptr);
 	praat_addMenuCommand (U"Objects", U"New", U"Create TextGrid...", nullptr, 0, NEW1_TextGrid_create);
 	praat_addMenuCommand (U"Objects", U"New", U"Create Corpus...", nullptr, 0, NEW1_Corpus_create);
+	praat_addMenuCommand (U"Objects", U"New", U"Create LabelIndex from folder...", nullptr, 0, NEW1_LabelIndex_createFromFolder);
 	praat_addMenuCommand (U"Objects", U"New", U"Strings", nullptr, 0, nullptr);
 	praat_addMenuCommand (U"Objects", U"New", U"Create Strings as file list...", nullptr, 1, NEW1_Strings_createAsFileList);
 	praat_addMenuCommand (U"Objects", U"New", U"Create Strings as directory list...", nullptr, 1, NEW1_Strings_createAsDirectoryList);
 
 	praat_addMenuCommand (U"Objects", U"Open", U"-- read tier --", nullptr, 0, nullptr);
+	praat_addMenuCommand (U"Objects", U"Open", U"Read TextGrids from files...", nullptr, 0, READMANY_TextGrids_readFromFiles);
 	praat_addMenuCommand (U"Objects", U"Open", U"Read from special tier file...", nullptr, 0, nullptr);
 		praat_addMenuCommand (U"Objects", U"Open", U"Read TextTier from Xwaves...", nullptr, 1, READ1_TextTier_readFromXwaves);
 		praat_addMenuCommand (U"Objects", U"Open", U"Read IntervalTier from Xwaves...", nullptr, 1, READ1_IntervalTier_readFromXwaves);
@@ -3052,6 +3126,10 @@ praat_addAction1 (classCochleagram, 0, U"Hack", nullptr, 0, nullptr);
 	praat_addAction1 (classCochleagram, 0, U"To Matrix", nullptr, 0, NEW_Cochleagram_to_Matrix);
 
 	praat_addAction1 (classCorpus, 1, U"View & Edit", nullptr, praat_ATTRACTIVE, WINDOW_Corpus_edit);
+	praat_addAction1 (classCorpus, 0, U"To LabelIndex", nullptr, 0, NEW_Corpus_to_LabelIndex);
+
+	praat_addAction1 (classLabelIndex, 1, U"Count hits...", nullptr, 0, INTEGER_LabelIndex_countHits);
+	praat_addAction1 (classLabelIndex, 0, U"Tabulate hits...", nullptr, 0, NEW_LabelIndex_tabulateHits);
 
 praat_addAction1 (classDistributions, 0, U"Learn", nullptr, 0, nullptr);
 	praat_addAction1 (classDistributions, 1, U"To Transition...", nullptr, 0, NEW_Distributions_to_Transition);
@@ -201,6 +201,18 @@ FORM_SAVE (SAVE_LongSound_saveAsWavFile, U"Save as WAV file", nullptr, U"wav") {
 	SAVE_TYPED_LIST_END
 }
 
+FORM_SAVE (SAVE_LongSound_saveAs24BitWavFile, U"Save as 24-bit WAV file", nullptr, U"wav") {
+	SAVE_TYPED_LIST (Sampled, SoundAndLongSoundList)
+		LongSound_concatenate (list.get(), file, Melder_WAV, 24);
+	SAVE_TYPED_LIST_END
+}
+
+FORM_SAVE (SAVE_LongSound_saveAs32BitWavFile, U"Save as 32-bit WAV file", nullptr, U"wav") {
+	SAVE_TYPED_LIST (Sampled, SoundAndLongSoundList)
+		LongSound_concatenate (list.get(), file, Melder_WAV, 32);
+	SAVE_TYPED_LIST_END
+}
+
 FORM_SAVE (SAVE_LongSound_saveLeftChannelAsAifcFile, U"Save left channel as AIFC file", nullptr, U"aifc") {
 	SAVE_ONE (LongSound)
 		LongSound_saveChannelAsAudioFile (me, Melder_AIFC, 0, file);
@@ -2065,7 +2077,8 @@ static autoDaata macSoundOrEmptyFileRecognizer (integer nread, const char * /* h
 static autoDaata soundFileRecognizer (integer nread, const char *header, MelderFile file) {
 	if (nread < 16) return autoDaata ();
 	if (strnequ (header, "FORM", 4) && strnequ (header + 8, "AIF", 3)) return Sound_readFromSoundFile (file);
-	if (strnequ (header, "RIFF", 4) && (strnequ (header + 8, "WAVE", 4) || strnequ (header + 8, "CDDA", 4))) return Sound_readFromSoundFile (file);
+	if ((strnequ (header, "RIFF", 4) || strnequ (header, "RF64", 4) || strnequ (header, "BW64", 4)) &&
+		(strnequ (header + 8, "WAVE", 4) || strnequ (header + 8, "CDDA", 4))) return Sound_readFromSoundFile (file);
 	if (strnequ (header, ".snd", 4)) return Sound_readFromSoundFile (file);
 	if (strnequ (header, "NIST_1A", 7)) return Sound_readFromSoundFile (file);
 	if (strnequ (header, "fLaC", 4)) return Sound_readFromSoundFile (file);   // Erez Volk, March 2007
@@ -2219,6 +2232,8 @@ void praat_Sound_init () {
 	praat_addAction1 (classLongSound, 0, U"Concatenate?", nullptr, 0, INFO_LongSound_concatenate);
 	praat_addAction1 (classLongSound, 0, U"Save as WAV file...", nullptr, 0, SAVE_LongSound_saveAsWavFile);
 	praat_addAction1 (classLongSound, 0,   U"Write to WAV file...", U"*Save as WAV file...", praat_DEPRECATED_2011, SAVE_LongSound_saveAsWavFile);
+	praat_addAction1 (classLongSound, 0, U"Save as 24-bit WAV file...", nullptr, 0, SAVE_LongSound_saveAs24BitWavFile);
+	praat_addAction1 (classLongSound, 0, U"Save as 32-bit WAV file...", nullptr, 0, SAVE_LongSound_saveAs32BitWavFile);
 	praat_addAction1 (classLongSound, 0, U"Save as AIFF file...", nullptr, 0, SAVE_LongSound_saveAsAiffFile);
 	praat_addAction1 (classLongSound, 0,   U"Write to AIFF file...", U"*Save as AIFF file...", praat_DEPRECATED_2011, SAVE_LongSound_saveAsAiffFile);
 	praat_addAction1 (classLongSound, 0, U"Save as AIFC file...", nullptr, 0, SAVE_LongSound_saveAsAifcFile);
@@ -2450,6 +2465,8 @@ void praat_Sound_init () {
 
 	praat_addAction2 (classLongSound, 0, classSound, 0, U"Save as WAV file...", nullptr, 0, SAVE_LongSound_Sound_saveAsWavFile);
 	praat_addAction2 (classLongSound, 0, classSound, 0,   U"Write to WAV file...", U"*Save as WAV file...", praat_DEPRECATED_2011, SAVE_LongSound_Sound_saveAsWavFile);
+	praat_addAction2 (classLongSound, 0, classSound, 0, U"Save as 24-bit WAV file...", nullptr, 0, SAVE_LongSound_saveAs24BitWavFile);
+	praat_addAction2 (classLongSound, 0, classSound, 0, U"Save as 32-bit WAV file...", nullptr, 0, SAVE_LongSound_saveAs32BitWavFile);
 	praat_addAction2 (classLongSound, 0, classSound, 0, U"Save as AIFF file...", nullptr, 0, SAVE_LongSound_Sound_saveAsAiffFile);
 	praat_addAction2 (classLongSound, 0, classSound, 0,   U"Write to AIFF file...", U"*Save as AIFF file...", praat_DEPRECATED_2011, SAVE_LongSound_Sound_saveAsAiffFile);
 	praat_addAction2 (classLongSound, 0, classSound, 0, U"Save as AIFC file...", nullptr, 0, SAVE_LongSound_Sound_saveAsAifcFile);
@@ -850,6 +850,28 @@ DO
 }
 
 
+FORM (NEW_TextGrid_tabulateLabelsAtTimes, U"TextGrid: Tabulate labels at times", nullptr) {
+	NUMVEC (times, U"Times (s)", U"{ 0.5, 0.7, 2.0 }")
+	OK
+DO
+	CONVERT_EACH (TextGrid)
+		autoTable result = TextGrid_tabulateLabelsAtTimes (me, times);
+	CONVERT_EACH_END (my name.get())
+}
+
+
+FORM (NEW_TextGrid_extractLabelsWhere, U"TextGrid: Extract labels where", U"TextGrid: Extract labels where...") {
+	NATURAL (tierNumber, STRING_TIER_NUMBER, U"1")
+	OPTIONMENU_ENUM (kMelder_string, extractEveryLabelThat___,
+			U"Extract every label that...", kMelder_string::CONTAINS)
+	SENTENCE (___theText, U"...the text", U"")
+	OK
+DO
+	CONVERT_EACH (TextGrid)
+		autoStrings result = TextGrid_getLabelsWhere (me, tierNumber, extractEveryLabelThat___, ___theText);
+	CONVERT_EACH_END (my name.get())
+}
+
 // MARK: Query
 
 DIRECT (INTEGER_TextGrid_getNumberOfTiers) {
@@ -1001,6 +1023,40 @@ DO
 	NUMBER_ONE_END (U" (interval boundary)")
 }
 
+static autoVEC pr_indicesToVEC (constINTVEC const& indices) {
+	autoVEC result = newVECraw (indices.size);
+	for (integer i = 1; i <= indices.size; i ++)
+		result [i] = indices [i];
+	return result;
+}
+
+FORM (NUMVEC_TextGrid_listIntervalsAtTimes, U"TextGrid: List intervals at times", nullptr) {
+	NATURAL (tierNumber, STRING_TIER_NUMBER, U"1")
+	NUMVEC (times, U"Times (s)", U"{ 0.5, 0.7, 2.0 }")
+	OK
+DO
+	NUMVEC_ONE (TextGrid)
+		IntervalTier intervalTier = pr_TextGrid_peekIntervalTier (me, tierNumber);
+		autoVEC result = pr_indicesToVEC (IntervalTier_timesToIndices (intervalTier, times).get());
+	NUMVEC_ONE_END
+}
+
+FORM (NUMVEC_TextGrid_listIntervalsInTimeRange, U"TextGrid: List intervals in time range", nullptr) {
+	NATURAL (tierNumber, STRING_TIER_NUMBER, U"1")
+	REAL (fromTime, U"From time (s)", U"0.0")
+	REAL (toTime, U"To time (s)", U"1.0")
+	OK
+DO
+	NUMVEC_ONE (TextGrid)
+		IntervalTier intervalTier = pr_TextGrid_peekIntervalTier (me, tierNumber);
+		integer firstInterval, lastInterval;
+		const integer numberOfIntervals = IntervalTier_getIntervalsOverlappingRange (intervalTier, fromTime, toTime, & firstInterval, & lastInterval);
+		autoVEC result = newVECraw (numberOfIntervals);
+		for (integer i = 1; i <= numberOfIntervals; i ++)
+			result [i] = firstInterval + i - 1;
+	NUMVEC_ONE_END
+}
+
 FORM (INTEGER_TextGrid_countIntervalsWhere, U"Count intervals", U"TextGrid: Count intervals where...") {
 	INTEGER (tierNumber, STRING_TIER_NUMBER, U"1")
 	OPTIONMENU_ENUM (kMelder_string, countIntervalsWhoseLabel___,
@@ -1013,6 +1069,42 @@ DO
 	NUMBER_ONE_END (U" intervals containing ", ___theText);
 }
 
+FORM (NUMVEC_TextGrid_listIntervalsWhere, U"List intervals", U"TextGrid: List intervals where...") {
+	NATURAL (tierNumber, STRING_TIER_NUMBER, U"1")
+	OPTIONMENU_ENUM (kMelder_string, listIntervalsWhoseLabel___,
+			U"List intervals whose label...", kMelder_string::DEFAULT)
+	SENTENCE (___theText, U"...the text", U"hi")
+	OK
+DO
+	NUMVEC_ONE (TextGrid)
+		autoVEC result = pr_indicesToVEC (TextGrid_findIntervalsWhere (me, tierNumber, listIntervalsWhoseLabel___, ___theText).get());
+	NUMVEC_ONE_END
+}
+
+FORM (NUMVEC_TextGrid_listStartTimesOfIntervalsWhere, U"List start times of intervals", U"TextGrid: List start times of intervals where...") {
+	NATURAL (tierNumber, STRING_TIER_NUMBER, U"1")
+	OPTIONMENU_ENUM (kMelder_string, listIntervalsWhoseLabel___,
+			U"List intervals whose label...", kMelder_string::DEFAULT)
+	SENTENCE (___theText, U"...the text", U"hi")
+	OK
+DO
+	NUMVEC_ONE (TextGrid)
+		autoVEC result = TextGrid_getTimesOfIntervalsWhere (me, tierNumber, listIntervalsWhoseLabel___, ___theText, 0.0);
+	NUMVEC_ONE_END
+}
+
+FORM (NUMVEC_TextGrid_listEndTimesOfIntervalsWhere, U"List end times of intervals", U"TextGrid: List end times of intervals where...") {
+	NATURAL (tierNumber, STRING_TIER_NUMBER, U"1")
+	OPTIONMENU_ENUM (kMelder_string, listIntervalsWhoseLabel___,
+			U"List intervals whose label...", kMelder_string::DEFAULT)
+	SENTENCE (___theText, U"...the text", U"hi")
+	OK
+DO
+	NUMVEC_ONE (TextGrid)
+		autoVEC result = TextGrid_getTimesOfIntervalsWhere (me, tierNumber, listIntervalsWhoseLabel___, ___theText, 1.0);
+	NUMVEC_ONE_END
+}
+
 static TextTier pr_TextGrid_peekTextTier (TextGrid me, integer tierNumber) {
 	Function tier = pr_TextGrid_peekTier (me, tierNumber);
 	if (! tier) return nullptr;
@@ -1091,6 +1183,17 @@ DO
 	NUMBER_ONE_END (U" (nearest index)")
 }
 
+FORM (NUMVEC_TextGrid_listLowIndicesFromTimes, U"TextGrid: List low indices from times", nullptr) {
+	NATURAL (tierNumber, STRING_TIER_NUMBER, U"1")
+	NUMVEC (times, U"Times (s)", U"{ 0.5, 0.7, 2.0 }")
+	OK
+DO
+	NUMVEC_ONE (TextGrid)
+		TextTier textTier = pr_TextGrid_peekTextTier (me, tierNumber);
+		autoVEC result = pr_indicesToVEC (TextTier_timesToLowIndices (textTier, times).get());
+	NUMVEC_ONE_END
+}
+
 FORM (INTEGER_TextGrid_countPointsWhere, U"Count points", U"TextGrid: Count points where...") {
 	INTEGER (tierNumber, STRING_TIER_NUMBER, U"1")
 	OPTIONMENU_ENUM (kMelder_string, countPointsWhoseLabel___,
@@ -1103,6 +1206,30 @@ DO
 	NUMBER_ONE_END (U" points containing ", ___theText);
 }
 
+FORM (NUMVEC_TextGrid_listPointsWhere, U"List points", U"TextGrid: List points where...") {
+	NATURAL (tierNumber, STRING_TIER_NUMBER, U"1")
+	OPTIONMENU_ENUM (kMelder_string, listPointsWhoseLabel___,
+			U"List points whose label...", kMelder_string::DEFAULT)
+	SENTENCE (___theText, U"...the text", U"hi")
+	OK
+DO
+	NUMVEC_ONE (TextGrid)
+		autoVEC result = pr_indicesToVEC (TextGrid_findPointsWhere (me, tierNumber, listPointsWhoseLabel___, ___theText).get());
+	NUMVEC_ONE_END
+}
+
+FORM (NUMVEC_TextGrid_listTimesOfPointsWhere, U"List times of points", U"TextGrid: List times of points where...") {
+	NATURAL (tierNumber, STRING_TIER_NUMBER, U"1")
+	OPTIONMENU_ENUM (kMelder_string, listPointsWhoseLabel___,
+			U"List points whose label...", kMelder_string::DEFAULT)
+	SENTENCE (___theText, U"...the text", U"hi")
+	OK
+DO
+	NUMVEC_ONE (TextGrid)
+		autoVEC result = TextGrid_getTimesOfPointsWhere (me, tierNumber, listPointsWhoseLabel___, ___theText);
+	NUMVEC_ONE_END
+}
+
 FORM (INTEGER_TextGrid_countLabels, U"Count labels", U"TextGrid: Count labels...") {
 	INTEGER (tierNumber, STRING_TIER_NUMBER, U"1")
 	SENTENCE (labelText, U"Label text", U"a")
@@ -1599,6 +1726,8 @@ void praat_uvafon_TextGrid_init () {
 		praat_addAction1 (classTextGrid, 0, U"Down to Table...", nullptr, 1, NEW_TextGrid_downto_Table);
 		praat_addAction1 (classTextGrid, 1, U"List...", nullptr, 1, LIST_TextGrid_list);
 		praat_addAction1 (classTextGrid, 0, U"Tabulate occurrences...", nullptr, 1, NEW_TextGrid_tabulateOccurrences);
+		praat_addAction1 (classTextGrid, 0, U"Tabulate labels at times...", nullptr, 1, NEW_TextGrid_tabulateLabelsAtTimes);
+		praat_addAction1 (classTextGrid, 0, U"Extract labels where...", nullptr, 1, NEW_TextGrid_extractLabelsWhere);
 	praat_addAction1 (classTextGrid, 0, U"Query -", nullptr, 0, nullptr);
 		praat_TimeFunction_query_init (classTextGrid);
 		praat_addAction1 (classTextGrid, 1, U"-- query textgrid --", nullptr, 1, nullptr);
@@ -1620,8 +1749,13 @@ void praat_uvafon_TextGrid_init () {
 			praat_addAction1 (classTextGrid, 1, U"Get high interval at time...", nullptr, 2, INTEGER_TextGrid_getHighIntervalAtTime);
 			praat_addAction1 (classTextGrid, 1, U"Get interval edge from time...", nullptr, 2, INTEGER_TextGrid_getIntervalEdgeFromTime);
 			praat_addAction1 (classTextGrid, 1, U"Get interval boundary from time...", nullptr, 2, INTEGER_TextGrid_getIntervalBoundaryFromTime);
+			praat_addAction1 (classTextGrid, 1, U"List intervals at times...", nullptr, 2, NUMVEC_TextGrid_listIntervalsAtTimes);
+			praat_addAction1 (classTextGrid, 1, U"List intervals in time range...", nullptr, 2, NUMVEC_TextGrid_listIntervalsInTimeRange);
 			praat_addAction1 (classTextGrid, 1, U"-- query interval labels --", nullptr, 2, nullptr);
 			praat_addAction1 (classTextGrid, 1, U"Count intervals where...", nullptr, 2, INTEGER_TextGrid_countIntervalsWhere);
+			praat_addAction1 (classTextGrid, 1, U"List intervals where...", nullptr, 2, NUMVEC_TextGrid_listIntervalsWhere);
+			praat_addAction1 (classTextGrid, 1, U"List start times of intervals where...", nullptr, 2, NUMVEC_TextGrid_listStartTimesOfIntervalsWhere);
+			praat_addAction1 (classTextGrid, 1, U"List end times of intervals where...", nullptr, 2, NUMVEC_TextGrid_listEndTimesOfIntervalsWhere);
 		praat_addAction1 (classTextGrid, 1, U"Query point tier", nullptr, 1, nullptr);
 			praat_addAction1 (classTextGrid, 1, U"Get number of points...", nullptr, 2, INTEGER_TextGrid_getNumberOfPoints);
 			praat_addAction1 (classTextGrid, 1, U"Get time of point...", nullptr, 2, REAL_TextGrid_getTimeOfPoint);
@@ -1630,8 +1764,11 @@ void praat_uvafon_TextGrid_init () {
 			praat_addAction1 (classTextGrid, 1, U"Get low index from time...", nullptr, 2, INTEGER_TextGrid_getLowIndexFromTime);
 			praat_addAction1 (classTextGrid, 1, U"Get high index from time...", nullptr, 2, INTEGER_TextGrid_getHighIndexFromTime);
 			praat_addAction1 (classTextGrid, 1, U"Get nearest index from time...", nullptr, 2, INTEGER_TextGrid_getNearestIndexFromTime);
+			praat_addAction1 (classTextGrid, 1, U"List low indices from times...", nullptr, 2, NUMVEC_TextGrid_listLowIndicesFromTimes);
 			praat_addAction1 (classTextGrid, 1, U"-- query point labels --", nullptr, 2, nullptr);
 			praat_addAction1 (classTextGrid, 1, U"Count points where...", nullptr, 2, INTEGER_TextGrid_countPointsWhere);
+			praat_addAction1 (classTextGrid, 1, U"List points where...", nullptr, 2, NUMVEC_TextGrid_listPointsWhere);
+			praat_addAction1 (classTextGrid, 1, U"List times of points where...", nullptr, 2, NUMVEC_TextGrid_listTimesOfPointsWhere);
 		praat_addAction1 (classTextGrid, 1, U"-- query labels --", nullptr, praat_DEPTH_1 | praat_DEPRECATED_2015, nullptr);
 		praat_addAction1 (classTextGrid, 1, U"Count labels...", nullptr, praat_DEPTH_1 | praat_DEPRECATED_2015, INTEGER_TextGrid_countLabels);
 	praat_addAction1 (classTextGrid, 0, U"Modify -", nullptr, 0, nullptr);
@@ -18,6 +18,7 @@
 
 #include "melder.h"
 #include "../dwsys/NUM2.h"
+#include "../sys/MelderThread.h"
 //#include "../dwsys/NUMcblas.h"
 //#include "../external/gsl/gsl_blas.h"
 
@@ -45,9 +46,21 @@ void MATdoubleCentre_inplace (MATVU const& x) noexcept {
 	MATcentreEachColumn_inplace (x);
 }
 
+static bool MATmul_blocked_ (MATVU const& target, constMATVU const& x, constMATVU const& y, bool mayUseThreads) noexcept;
+
 void MATmtm (MATVU const& target, constMATVU const& x) noexcept {
 	Melder_assert (target.nrow == x.ncol);
 	Melder_assert (target.ncol == x.ncol);
+	/*
+		For larger matrices, the blocked multiplication is so much faster than the loops below
+		that it pays to compute both triangles.
+	*/
+	if (x.nrow > 0 && double (x.nrow) * double (x.ncol) * double (x.ncol) >= 2e5 && MATmul_blocked_ (target, x.transpose(), x, true)) {
+		for (integer irow = 2; irow <= target.nrow; irow ++)
+			for (integer icol = 1; icol < irow; icol ++)
+				target [irow] [icol] = target [icol] [irow];
+		return;
+	}
 	#if 0
 	for (integer irow = 1; irow <= target.nrow; irow ++) {
 		for (integer icol = irow; icol <= target.ncol; icol ++) {
@@ -342,6 +355,194 @@ void MATmul_allowAllocation_ (MATVU const& target, constMATVU x, constMATVU y) {
 	}
 }
 
+/*
+	Cache-blocked matrix multiplication, for MATmul_fast_ () on larger matrices
+	(the approach of Goto & Van de Geijn, and of BLIS and OpenBLAS):
+	a KC-deep slice of Y is packed into NR-wide column panels that stay in the L2 or L3 cache,
+	an MC-high block of that slice of X is packed into MR-high row panels that stay in the L1 or L2 cache,
+	and a micro-kernel keeps an MR x NR block of the target in registers while running through one pair of panels.
+	Packing reads X and Y with whatever strides they have, so that X.Y, X'.Y, X.Y' and X'.Y are equally fast;
+	it also pads the panels with zeroes, so that the micro-kernel never has to check bounds.
+	On x86 processors that have AVX2 and FMA (determined at run time), the micro-kernel uses these instructions;
+	the generic micro-kernel is plain C++ that the compiler can vectorize for any processor.
+	Large products are distributed over threads by target rows; every thread packs its own panels.
+*/
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+	#define MATMUL_HAS_AVX2  1
+	#include <immintrin.h>
+#else
+	#define MATMUL_HAS_AVX2  0
+#endif
+#include <memory>
+#include <new>
+
+constexpr integer MATmul_MR = 4, MATmul_NR = 8;   // the size of the block of the target that stays in registers
+constexpr integer MATmul_KC = 256, MATmul_MC = 128, MATmul_NC = 512;   // the sizes of the blocks that stay in cache
+
+typedef void (*MATmul_microKernel) (integer kc, const double *packedX, const double *packedY, double *ab);
+
+static void MATmul_microKernel_generic (integer kc, const double *packedX, const double *packedY, double *ab) {
+	double sums [MATmul_MR] [MATmul_NR] = { };
+	for (integer p = 0; p < kc; p ++) {
+		for (integer i = 0; i < MATmul_MR; i ++) {
+			const double xi = packedX [i];
+			for (integer j = 0; j < MATmul_NR; j ++)
+				sums [i] [j] += xi * packedY [j];
+		}
+		packedX += MATmul_MR;
+		packedY += MATmul_NR;
+	}
+	for (integer i = 0; i < MATmul_MR; i ++)
+		for (integer j = 0; j < MATmul_NR; j ++)
+			ab [i * MATmul_NR + j] = sums [i] [j];
+}
+
+#if MATMUL_HAS_AVX2
+__attribute__ ((target ("avx2,fma")))
+static void MATmul_microKernel_avx2 (integer kc, const double *packedX, const double *packedY, double *ab) {
+	__m256d sum00 = _mm256_setzero_pd (), sum01 = _mm256_setzero_pd ();
+	__m256d sum10 = _mm256_setzero_pd (), sum11 = _mm256_setzero_pd ();
+	__m256d sum20 = _mm256_setzero_pd (), sum21 = _mm256_setzero_pd ();
+	__m256d sum30 = _mm256_setzero_pd (), sum31 = _mm256_setzero_pd ();
+	for (integer p = 0; p < kc; p ++) {
+		const __m256d y0 = _mm256_loadu_pd (packedY), y1 = _mm256_loadu_pd (packedY + 4);
+		__m256d xi = _mm256_broadcast_sd (packedX);
+		sum00 = _mm256_fmadd_pd (xi, y0, sum00);
+		sum01 = _mm256_fmadd_pd (xi, y1, sum01);
+		xi = _mm256_broadcast_sd (packedX + 1);
+		sum10 = _mm256_fmadd_pd (xi, y0, sum10);
+		sum11 = _mm256_fmadd_pd (xi, y1, sum11);
+		xi = _mm256_broadcast_sd (packedX + 2);
+		sum20 = _mm256_fmadd_pd (xi, y0, sum20);
+		sum21 = _mm256_fmadd_pd (xi, y1, sum21);
+		xi = _mm256_broadcast_sd (packedX + 3);
+		sum30 = _mm256_fmadd_pd (xi, y0, sum30);
+		sum31 = _mm256_fmadd_pd (xi, y1, sum31);
+		packedX += MATmul_MR;
+		packedY += MATmul_NR;
+	}
+	_mm256_storeu_pd (ab, sum00);
+	_mm256_storeu_pd (ab + 4, sum01);
+	_mm256_storeu_pd (ab + 8, sum10);
+	_mm256_storeu_pd (ab + 12, sum11);
+	_mm256_storeu_pd (ab + 16, sum20);
+	_mm256_storeu_pd (ab + 20, sum21);
+	_mm256_storeu_pd (ab + 24, sum30);
+	_mm256_storeu_pd (ab + 28, sum31);
+}
+#endif
+
+static MATmul_microKernel MATmul_chooseMicroKernel () {
+	#if MATMUL_HAS_AVX2
+		static const bool hasAvx2 = __builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("fma");
+		if (hasAvx2)
+			return MATmul_microKernel_avx2;
+	#endif
+	return MATmul_microKernel_generic;
+}
+
+/*
+	Pack rows firstRow .. firstRow + mc - 1 and columns firstK .. firstK + kc - 1 of X
+	into panels of MR rows, each stored column after column.
+*/
+static void MATmul_packX (constMATVU const& x, integer firstRow, integer mc, integer firstK, integer kc, double *packed) {
+	for (integer ir = 0; ir < mc; ir += MATmul_MR) {
+		const integer numberOfRows = std::min (MATmul_MR, mc - ir);
+		for (integer p = 0; p < kc; p ++) {
+			const double *px = & x [firstRow + ir] [firstK + p];
+			integer i = 0;
+			for (; i < numberOfRows; i ++, px += x.rowStride)
+				*packed ++ = *px;
+			for (; i < MATmul_MR; i ++)
+				*packed ++ = 0.0;
+		}
+	}
+}
+
+/*
+	Pack rows firstK .. firstK + kc - 1 and columns firstColumn .. firstColumn + nc - 1 of Y
+	into panels of NR columns, each stored row after row.
+*/
+static void MATmul_packY (constMATVU const& y, integer firstK, integer kc, integer firstColumn, integer nc, double *packed) {
+	for (integer jr = 0; jr < nc; jr += MATmul_NR) {
+		const integer numberOfColumns = std::min (MATmul_NR, nc - jr);
+		for (integer p = 0; p < kc; p ++) {
+			const double *py = & y [firstK + p] [firstColumn + jr];
+			integer j = 0;
+			for (; j < numberOfColumns; j ++, py += y.colStride)
+				*packed ++ = *py;
+			for (; j < MATmul_NR; j ++)
+				*packed ++ = 0.0;
+		}
+	}
+}
+
+constexpr integer MATmul_packedXsize = MATmul_MC * MATmul_KC, MATmul_packedYsize = MATmul_KC * MATmul_NC;
+
+static void MATmul_blockedRows (MATVU const& target, constMATVU const& x, constMATVU const& y,
+	integer firstRow, integer lastRow, MATmul_microKernel microKernel, double *packedX, double *packedY) noexcept
+{
+	const integer numberOfColumns = target.ncol, depth = x.ncol;
+	for (integer jc = 1; jc <= numberOfColumns; jc += MATmul_NC) {
+		const integer nc = std::min (MATmul_NC, numberOfColumns - jc + 1);
+		for (integer pc = 1; pc <= depth; pc += MATmul_KC) {
+			const integer kc = std::min (MATmul_KC, depth - pc + 1);
+			MATmul_packY (y, pc, kc, jc, nc, packedY);
+			for (integer ic = firstRow; ic <= lastRow; ic += MATmul_MC) {
+				const integer mc = std::min (MATmul_MC, lastRow - ic + 1);
+				MATmul_packX (x, ic, mc, pc, kc, packedX);
+				for (integer jr = 0; jr < nc; jr += MATmul_NR) {
+					const integer numberOfColumnsInBlock = std::min (MATmul_NR, nc - jr);
+					for (integer ir = 0; ir < mc; ir += MATmul_MR) {
+						const integer numberOfRowsInBlock = std::min (MATmul_MR, mc - ir);
+						double ab [MATmul_MR * MATmul_NR];
+						microKernel (kc, packedX + ir * kc, packedY + jr * kc, ab);
+						for (integer i = 0; i < numberOfRowsInBlock; i ++) {
+							double *pt = & target [ic + ir + i] [jc + jr];
+							const double *pab = & ab [i * MATmul_NR];
+							if (pc == 1)
+								for (integer j = 0; j < numberOfColumnsInBlock; j ++, pt += target.colStride)
+									*pt = pab [j];
+							else
+								for (integer j = 0; j < numberOfColumnsInBlock; j ++, pt += target.colStride)
+									*pt += pab [j];
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+/*
+	Returns false if there is not enough memory for the packed panels;
+	the caller then uses an unblocked multiplication.
+*/
+static bool MATmul_blocked_ (MATVU const& target, constMATVU const& x, constMATVU const& y, bool mayUseThreads) noexcept {
+	Melder_assert (x.ncol > 0);
+	const MATmul_microKernel microKernel = MATmul_chooseMicroKernel ();
+	/*
+		Give each thread at least one MC-high block of rows.
+	*/
+	const double numberOfMultiplications = double (target.nrow) * double (target.ncol) * double (x.ncol);
+	const integer numberOfThreads = ( mayUseThreads ? MelderThread_getNumberOfThreads (target.nrow / MATmul_MC, numberOfMultiplications) : 1 );
+	const integer bufferSizePerThread = MATmul_packedXsize + MATmul_packedYsize;
+	std::unique_ptr <double []> buffer (new (std::nothrow) double [bufferSizePerThread * numberOfThreads]);
+	if (! buffer)
+		return false;
+	/*
+		Cut the target rows into stretches of whole MR-high panels.
+	*/
+	const integer numberOfRowPanels = (target.nrow + MATmul_MR - 1) / MATmul_MR;
+	MelderThread_runStretches (numberOfThreads, numberOfRowPanels, [&] (integer ithread, integer firstPanel, integer lastPanel) {
+		const integer firstRow = 1 + (firstPanel - 1) * MATmul_MR;
+		const integer lastRow = std::min (lastPanel * MATmul_MR, target.nrow);
+		double *packedX = & buffer [ithread * bufferSizePerThread];
+		MATmul_blockedRows (target, x, y, firstRow, lastRow, microKernel, packedX, packedX + MATmul_packedXsize);
+	});
+	return true;
+}
+
 static inline void MATmul_rough_naiveReferenceImplementation (MATVU const& target, constMATVU const& x, constMATVU const& y) noexcept {
 	/*
 		If x.colStride == size and y.colStride == 1,
@@ -355,7 +556,17 @@ static inline void MATmul_rough_naiveReferenceImplementation (MATVU const& targe
 		}
 	}
 }
-void MATmul_fast_ (MATVU const& target, constMATVU const& x, constMATVU const& y) noexcept {
+static void MATmul_fastWithOrWithoutThreads_ (MATVU const& target, constMATVU const& x, constMATVU const& y, bool mayUseThreads) noexcept {
+	/*
+		From about 50 x 50 x 50 on, the blocked version is faster than the simple loops below,
+		whatever the strides.
+		On one core with AVX2 and FMA, the speed of the blocked version for X.Y is
+		17.9, 28.7, 30.8, 26.3, 28.1 Gflop/s for size = 50, 100, 200, 500, 1000,
+		and about the same for X'.Y, X.Y' and X'.Y'.
+	*/
+	if (x.ncol > 0 && double (target.nrow) * double (target.ncol) * double (x.ncol) >= 1e5 &&
+		MATmul_blocked_ (target, x, y, mayUseThreads))
+		return;
 	if ((false)) {
 		MATmul_rough_naiveReferenceImplementation (target, x, y);
 	} else if (y.colStride == 1) {
@@ -440,7 +651,7 @@ void MATmul_fast_ (MATVU const& target, constMATVU const& x, constMATVU const& y
 				The speed is 0.064, 1.21, 1.41, 0.43 Gflop/s for size = 1,10,100,1000.
 
 				The trick is to have the inner loop run along two fastest indices;
-				for both target (in future) and y, this fastest index is the first index.
+				for both target (in future) and x, this fastest index is the first index.
 			*/
 			//target.rowStride = 1;
 			//target.colStride = target.nrow;
@@ -449,9 +660,10 @@ void MATmul_fast_ (MATVU const& target, constMATVU const& x, constMATVU const& y
 				for (integer irow = 1; irow <= target.nrow; irow ++)
 					targetcolumn [irow] = 0.0;
 				for (integer i = 1; i <= x.ncol; i ++) {
-					constVECVU const ycolumn = y.column (i);
+					constVECVU const xcolumn = x.column (i);
+					const double ycell = y [i] [icol];
 					for (integer irow = 1; irow <= target.nrow; irow ++)
-						targetcolumn [irow] += x [irow] [i] * ycolumn [irow];
+						targetcolumn [irow] += xcolumn [irow] * ycell;
 				}
 			}
 		}
@@ -463,6 +675,12 @@ void MATmul_fast_ (MATVU const& target, constMATVU const& x, constMATVU const& y
 		MATmul_rough_naiveReferenceImplementation (target, x, y);
 	}
 }
+void MATmul_fast_ (MATVU const& target, constMATVU const& x, constMATVU const& y) noexcept {
+	MATmul_fastWithOrWithoutThreads_ (target, x, y, true);
+}
+void MATmul_fast_singleThread_ (MATVU const& target, constMATVU const& x, constMATVU const& y) noexcept {
+	MATmul_fastWithOrWithoutThreads_ (target, x, y, false);
+}
 
 void MATmul_forceMetal_ (MATVU const& target, constMATVU const& x, constMATVU const& y) {
 #ifdef macintosh
@@ -388,7 +388,8 @@ inline autoMAT newMATmul_allowAllocation (constMATVU const& x, constMATVU const&
 	return result;
 }
 /*
-	Rough matrix multiplication, using an in-cache inner loop if that is faster.
+	Rough matrix multiplication, using an in-cache inner loop if that is faster;
+	for larger matrices, a cache-blocked multiplication that may use multiple threads.
 */
 extern void MATmul_fast_ (MATVU const& target, constMATVU const& x, constMATVU const& y) noexcept;
 inline void MATmul_fast  (MATVU const& target, constMATVU const& x, constMATVU const& y) noexcept {
@@ -402,6 +403,17 @@ inline autoMAT newMATmul_fast (constMATVU const& x, constMATVU const& y) {
 	MATmul_fast (result.all(), x, y);
 	return result;
 }
+/*
+	The same as MATmul_fast, but without starting any threads,
+	for work that has already been divided over threads.
+*/
+extern void MATmul_fast_singleThread_ (MATVU const& target, constMATVU const& x, constMATVU const& y) noexcept;
+inline void MATmul_fast_singleThread  (MATVU const& target, constMATVU const& x, constMATVU const& y) noexcept {
+	Melder_assert (target.nrow == x.nrow);
+	Melder_assert (target.ncol == y.ncol);
+	Melder_assert (x.ncol == y.nrow);
+	MATmul_fast_singleThread_ (target, x, y);
+}
 void MATmul_forceMetal_ (MATVU const& target, constMATVU const& x, constMATVU const& y);
 void MATmul_forceOpenCL_ (MATVU const& target, constMATVU const& x, constMATVU const& y);
 
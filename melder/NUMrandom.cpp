@@ -183,6 +183,26 @@ void NUMrandom_init () {
 	theInited = true;
 }
 
+void NUMrandom_initializeSafelyAndUnpredictably () {
+	NUMrandom_init ();
+}
+
+void NUMrandom_initializeWithSeed_mt (int threadNumber, uint64 seed) {
+	Melder_assert (threadNumber >= 0 && threadNumber <= 16);
+	const int numberOfKeys = 2;
+	uint64 keys [numberOfKeys];
+	keys [0] = seed;
+	keys [1] = UINT64_C (7320321686725470078) + (uint64) threadNumber;   // different sequences in different threads
+	states [threadNumber]. init_by_array64 (keys, numberOfKeys);
+	states [threadNumber]. secondAvailable = false;
+}
+
+void NUMrandom_initializeWithSeedUnsafelyButPredictably (uint64 seed) {
+	for (int threadNumber = 0; threadNumber <= 16; threadNumber ++)
+		NUMrandom_initializeWithSeed_mt (threadNumber, seed);
+	theInited = true;
+}
+
 /* Throughout the years, several versions for "zero or magic" have been proposed. Choose the fastest. */
 
 #define ZERO_OR_MAGIC_VERSION  3
@@ -266,6 +286,10 @@ double NUMrandomUniform (double lowest, double highest) {
 	return lowest + (highest - lowest) * NUMrandomFraction ();
 }
 
+double NUMrandomUniform_mt (int threadNumber, double lowest, double highest) {
+	return lowest + (highest - lowest) * NUMrandomFraction_mt (threadNumber);
+}
+
 integer NUMrandomInteger (integer lowest, integer highest) {
 	return lowest + (integer) ((highest - lowest + 1) * NUMrandomFraction ());   // round down by truncation, because positive
 }
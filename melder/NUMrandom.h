@@ -21,11 +21,21 @@
 /********** Random numbers **********/
 
 void NUMrandom_init ();
+void NUMrandom_initializeSafelyAndUnpredictably ();
+
+/*
+	Predictable sequences, e.g. for reproducible simulations. The _mt version restarts the sequence
+	of a single thread, so that work that is divided over threads can draw the same random numbers
+	whichever thread happens to do it.
+*/
+void NUMrandom_initializeWithSeedUnsafelyButPredictably (uint64 seed);
+void NUMrandom_initializeWithSeed_mt (int threadNumber, uint64 seed);
 
 double NUMrandomFraction ();
 double NUMrandomFraction_mt (int threadNumber);
 
 double NUMrandomUniform (double lowest, double highest);
+double NUMrandomUniform_mt (int threadNumber, double lowest, double highest);
 
 integer NUMrandomInteger (integer lowest, integer highest);
 
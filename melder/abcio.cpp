@@ -103,7 +103,113 @@ static uint64 getUnsigned (MelderReadText me) {
 	return strtoull (buffer, nullptr, 10);
 }
 
+/*
+	Fast path for reading a real number, used for the long numeric arrays in Pitch, Formant, Matrix and similar objects.
+	We scan the 32-bit or 8-bit buffer in place, without going through MelderReadText_getChar (),
+	and we skip ASCII labels such as "x [1] =" on the way.
+	The number itself is converted exactly with Clinger's algorithm if its mantissa has at most 15 decimal digits
+	and its power of ten is in the range -22 .. +22; other plain decimal numbers go to strtod ().
+	Anything unusual (a comment, a string, an enumerated value, a fraction, a percentage, "--undefined--",
+	a non-ASCII character, or a very long token) makes us return false without moving the read pointer,
+	so that the general getReal () below can handle it (or complain about it) with its usual messages.
+	Since all the 8-bit input encodings agree on ASCII, and UTF-8 bytes above 127 never encode ASCII characters,
+	the 8-bit buffer can be scanned bytewise whatever its encoding.
+*/
+static inline char32 fastKar (const char *p) { return (char32) (char8) *p; }
+static inline char32 fastKar (const char32 *p) { return *p; }
+
+template <typename T>
+static bool fastGetReal (T **p_readPointer, double *out_value) {
+	static const double powersOfTen [1 + 22] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+	const T *p = *p_readPointer;
+	/*
+		Skip white space and labels.
+	*/
+	for (;;) {
+		while (Melder_isAsciiHorizontalOrVerticalSpace (fastKar (p)))
+			p ++;
+		const char32 first = fastKar (p);
+		if (first == U'-' || first == U'+' || Melder_isAsciiDecimalNumber (first))
+			break;
+		if (first == U'\0' || first == U'!' || first == U'\"' || first == U'<')
+			return false;
+		do {
+			if (fastKar (p) == U'\0' || fastKar (p) > 127)
+				return false;
+			p ++;
+		} while (! Melder_isAsciiHorizontalOrVerticalSpace (fastKar (p)));
+	}
+	/*
+		Parse the number.
+	*/
+	const T *startOfNumber = p;
+	const bool isNegative = ( fastKar (p) == U'-' );
+	if (fastKar (p) == U'-' || fastKar (p) == U'+')
+		p ++;
+	if (! Melder_isAsciiDecimalNumber (fastKar (p)))
+		return false;   // e.g. "--undefined--" or a lone "+"
+	uint64 mantissa = 0;
+	int numberOfMantissaDigits = 0, exponent = 0;
+	for (; Melder_isAsciiDecimalNumber (fastKar (p)); p ++) {
+		if (mantissa != 0 || fastKar (p) != U'0')
+			numberOfMantissaDigits += 1;
+		mantissa = 10 * mantissa + (fastKar (p) - U'0');   // overflow harmless: we check the number of digits below
+	}
+	if (fastKar (p) == U'.') {
+		p ++;
+		for (; Melder_isAsciiDecimalNumber (fastKar (p)); p ++) {
+			if (mantissa != 0 || fastKar (p) != U'0')
+				numberOfMantissaDigits += 1;
+			mantissa = 10 * mantissa + (fastKar (p) - U'0');
+			exponent -= 1;
+		}
+	}
+	if (fastKar (p) == U'e' || fastKar (p) == U'E') {
+		p ++;
+		const bool exponentIsNegative = ( fastKar (p) == U'-' );
+		if (fastKar (p) == U'-' || fastKar (p) == U'+')
+			p ++;
+		if (! Melder_isAsciiDecimalNumber (fastKar (p)))
+			return false;
+		int explicitExponent = 0;
+		for (; Melder_isAsciiDecimalNumber (fastKar (p)); p ++)
+			if (explicitExponent < 100000)
+				explicitExponent = 10 * explicitExponent + (int) (fastKar (p) - U'0');
+		exponent += ( exponentIsNegative ? - explicitExponent : explicitExponent );
+	}
+	const char32 terminator = fastKar (p);
+	if (terminator != U'\0' && ! Melder_isAsciiHorizontalOrVerticalSpace (terminator))
+		return false;   // e.g. a fraction, a percentage, or a non-ASCII character
+	const integer numberOfNumberCharacters = p - startOfNumber;
+	if (numberOfNumberCharacters >= 40)
+		return false;   // let the general routine complain
+	double value;
+	if (numberOfMantissaDigits <= 15 && exponent >= -22 && exponent <= 22) {
+		value = (double) mantissa;   // exact, because mantissa < 10^15 < 2^53
+		value = ( exponent >= 0 ? value * powersOfTen [exponent] : value / powersOfTen [- exponent] );   // correctly rounded
+		if (isNegative)
+			value = - value;
+	} else if constexpr (sizeof (T) == 1) {
+		value = strtod (startOfNumber, nullptr);   // stops at the terminator, because the syntax has been checked
+	} else {
+		char buffer [41];
+		for (integer i = 0; i < numberOfNumberCharacters; i ++)
+			buffer [i] = (char) (char8) fastKar (startOfNumber + i);   // guarded conversion down: everything is ASCII
+		buffer [numberOfNumberCharacters] = '\0';
+		value = strtod (buffer, nullptr);
+	}
+	*p_readPointer = const_cast <T *> ( terminator == U'\0' ? p : p + 1 );   // like getReal (), consume the terminating space
+	*out_value = value;
+	return true;
+}
+
 static double getReal (MelderReadText me) {
+	double fastValue;
+	if (my string32 ? fastGetReal (& my readPointer32, & fastValue) : fastGetReal (& my readPointer8, & fastValue))
+		return fastValue;
 	int i;
 	char buffer [41], *slash;
 	char32 c;
@@ -19,9 +19,13 @@
 #include "melder.h"
 #include <wctype.h>
 #include <assert.h>
+#include <atomic>
 
-static int64 totalNumberOfAllocations = 0, totalNumberOfDeallocations = 0, totalAllocationSize = 0,
-	totalNumberOfMovingReallocs = 0, totalNumberOfReallocsInSitu = 0;
+/*
+	Atomic, because strings can be allocated and freed by several threads at the same time (e.g. when reading a Table).
+*/
+static std::atomic <int64> totalNumberOfAllocations { 0 }, totalNumberOfDeallocations { 0 }, totalAllocationSize { 0 },
+	totalNumberOfMovingReallocs { 0 }, totalNumberOfReallocsInSitu { 0 };
 
 /*
  * The rainy-day fund.
@@ -115,14 +115,29 @@ void MelderFile_writeAudioFileHeader (MelderFile file, int audioFileType, intege
 						Melder_throw (U"Cannot save data over the 9-petabyte limit.");
 					int64 dataSize = (int64) dataSize_f;
 
-					/* RIFF Chunk: contains all other chunks. */
-					if (fwrite ("RIFF", 1, 4, f) != 4) Melder_throw (U"Error in file while trying to write the RIFF statement.");
+					/*
+						RIFF Chunk: contains all other chunks.
+						If the file would be too big for the 32-bit sizes of RIFF,
+						we write an RF64 file (EBU Tech 3306), whose sizes are in a "ds64" chunk instead.
+					*/
 					int64 sizeOfRiffChunk_i64 = 4 + (12 + formatSize) + (4 + dataSize);
-					if (sizeOfRiffChunk_i64 > UINT32_MAX)
-						Melder_throw (U"Cannot save a WAV file with more than ", UINT32_MAX, U" bytes.");
-					uint32 sizeOfRiffChunk_u32 = (uint32) sizeOfRiffChunk_i64;
-					binputu32LE (sizeOfRiffChunk_u32, f);
+					const bool needRF64 = ( sizeOfRiffChunk_i64 > UINT32_MAX );
+					if (needRF64)
+						sizeOfRiffChunk_i64 += 8 + 28;   // the ds64 chunk
+					if (fwrite (needRF64 ? "RF64" : "RIFF", 1, 4, f) != 4) Melder_throw (U"Error in file while trying to write the RIFF statement.");
+					binputu32LE (needRF64 ? 0xFFFF'FFFF : (uint32) sizeOfRiffChunk_i64, f);
 					if (fwrite ("WAVE", 1, 4, f) != 4) Melder_throw (U"Error in file while trying to write the WAV file type.");
+					if (needRF64) {
+						if (fwrite ("ds64", 1, 4, f) != 4) Melder_throw (U"Error in file while trying to write the DS64 statement.");
+						binputu32LE (28, f);
+						binputu32LE ((uint32) (sizeOfRiffChunk_i64 & 0xFFFF'FFFF), f);
+						binputu32LE ((uint32) (sizeOfRiffChunk_i64 >> 32), f);
+						binputu32LE ((uint32) (dataSize & 0xFFFF'FFFF), f);
+						binputu32LE ((uint32) (dataSize >> 32), f);
+						binputu32LE ((uint32) ((int64) numberOfSamples & 0xFFFF'FFFF), f);   // sample count
+						binputu32LE ((uint32) ((int64) numberOfSamples >> 32), f);
+						binputu32LE (0, f);   // table length
+					}
 
 					/* Format Chunk: if 16-bits audio, then 8 + 16 bytes; else 8 + 40 bytes. */
 					if (fwrite ("fmt ", 1, 4, f) != 4) Melder_throw (U"Error in file while trying to write the FMT statement.");
@@ -144,7 +159,7 @@ void MelderFile_writeAudioFileHeader (MelderFile file, int audioFileType, intege
 
 					/* Data Chunk: 8 bytes + samples. */
 					if (fwrite ("data", 1, 4, f) != 4) Melder_throw (U"Error in file while trying to write the DATA statement.");
-					binputi32LE (dataSize, f);
+					binputu32LE (needRF64 ? 0xFFFF'FFFF : (uint32) dataSize, f);
 				} catch (MelderError) {
 					Melder_throw (U"WAV header not written.");
 				}
@@ -437,11 +452,12 @@ static void Melder_checkWavFile (FILE *f, integer *numberOfChannels, int *encodi
 	char data [14], chunkID [4];
 	bool formatChunkPresent = false, dataChunkPresent = false;
 	int numberOfBitsPerSamplePoint = -1;
-	uint32 dataChunkSize = 0xffffffff;
+	int64 dataChunkSize = -1;
+	int64 rf64DataSize = -1;   // from the ds64 chunk, if any
 
 	Melder_require (fread (data, 1, 4, f) == 4,
 		U"File too small: no RIFF statement.");
-	Melder_require (strnequ (data, "RIFF", 4),
+	Melder_require (strnequ (data, "RIFF", 4) || strnequ (data, "RF64", 4) || strnequ (data, "BW64", 4),
 		U"Not a WAV file (RIFF statement expected).");
 	Melder_require (fread (data, 1, 4, f) == 4,
 		U"File too small: no size of RIFF chunk.");
@@ -550,14 +566,31 @@ static void Melder_checkWavFile (FILE *f, integer *numberOfChannels, int *encodi
 			for (integer i = 17; i <= chunkSize; i ++)
 				Melder_require (fread (data, 1, 1, f) == 1,
 					U"File too small: expected ", chunkSize, U" bytes in fmt chunk, but found ", i, U".");
+		} else if (strnequ (chunkID, "ds64", 4)) {
+			/*
+				Found the 64-bit sizes of an RF64 file.
+			*/
+			Melder_require (chunkSize >= 24,
+				U"Not enough data in ds64 chunk.");
+			(void) bingetu32LE (f);   // RIFF size, low and high
+			(void) bingetu32LE (f);
+			const uint64 dataSizeLow = bingetu32LE (f), dataSizeHigh = bingetu32LE (f);
+			rf64DataSize = (int64) (dataSizeHigh << 32 | dataSizeLow);
+			if (chunkSize & 1)
+				chunkSize += 1;
+			for (integer i = 17; i <= chunkSize; i ++)
+				Melder_require (fread (data, 1, 1, f) == 1,
+					U"File too small: expected ", chunkSize, U" bytes in ds64 chunk, but found ", i, U".");
 		} else if (strnequ (chunkID, "data", 4)) {
 			/*
 				Found a Data Chunk.
 			*/
 			dataChunkPresent = true;
 			dataChunkSize = chunkSize;
-			*startOfData = ftell (f);
-			if (chunkSize > UINT32_MAX - 100) {   // incorrect data chunk (sometimes -1 or -44); assume that the data run till the end of the file
+			*startOfData = ftello (f);
+			if (chunkSize == 0xFFFF'FFFF && rf64DataSize >= 0) {
+				dataChunkSize = rf64DataSize;
+			} else if (chunkSize > UINT32_MAX - 100) {   // incorrect data chunk (sometimes -1 or -44); assume that the data run till the end of the file
 				fseeko (f, 0LL, SEEK_END);
 				off_t endOfData = ftello (f);
 				dataChunkSize = chunkSize = endOfData - *startOfData;
@@ -594,7 +627,7 @@ static void Melder_checkWavFile (FILE *f, integer *numberOfChannels, int *encodi
 	Melder_require (dataChunkPresent,
 		U"Found no Data Chunk.");
 	Melder_assert (numberOfBitsPerSamplePoint != -1);
-	Melder_assert (dataChunkSize != 0xffffffff);
+	Melder_assert (dataChunkSize >= 0);
 	*numberOfSamples = dataChunkSize / *numberOfChannels / ((numberOfBitsPerSamplePoint + 7) / 8);
 }
 
@@ -735,7 +768,9 @@ int MelderFile_checkSoundFile (MelderFile file, integer *numberOfChannels, int *
 		Melder_checkAiffFile (f, numberOfChannels, encoding, sampleRate, startOfData, numberOfSamples);
 		return Melder_AIFC;
 	}
-	if (strnequ (data, "RIFF", 4) && (strnequ (data + 8, "WAVE", 4) || strnequ (data + 8, "CDDA", 4))) {
+	if ((strnequ (data, "RIFF", 4) || strnequ (data, "RF64", 4) || strnequ (data, "BW64", 4)) &&
+		(strnequ (data + 8, "WAVE", 4) || strnequ (data + 8, "CDDA", 4)))
+	{
 		Melder_checkWavFile (f, numberOfChannels, encoding, sampleRate, startOfData, numberOfSamples);
 		return Melder_WAV;
 	}
@@ -836,7 +871,7 @@ static void Melder_DecodeFlac_error (const FLAC__StreamDecoder *decoder, FLAC__S
 	Melder_warning (U"FLAC decoder error: ", Melder_peek8to32 (FLAC__StreamDecoderErrorStatusString [status]));
 }
 
-static void Melder_readFlacFile (FILE *f, MAT buffer) {
+static void Melder_readFlacFile_serially (FILE *f, MAT buffer) {
 	int result = 0;
 
 	MelderDecodeFlacContext c;
@@ -864,6 +899,198 @@ end:
 		Melder_throw (U"Error decoding FLAC file.");
 }
 
+/*
+	Multi-threaded FLAC decoding.
+	FLAC frames can be decoded independently of each other, so we cut the file into contiguous stretches of samples,
+	and let each thread seek (with a decoder of its own) to the start of its stretch.
+	Every decoder reads the file with pread () from a file position of its own,
+	so that the threads disturb neither each other nor the position of the shared FILE pointer;
+	pread () is POSIX, hence the parallel decoding on Unix and Mac only.
+	The result is identical to that of Melder_readFlacFile_serially ().
+*/
+#if defined (UNIX) || defined (macintosh)
+	#define FLAC_DECODE_IN_PARALLEL  1
+	#include "../sys/MelderThread.h"
+	#include <sys/stat.h>
+	#include <unistd.h>
+#else
+	#define FLAC_DECODE_IN_PARALLEL  0
+#endif
+
+#if FLAC_DECODE_IN_PARALLEL
+
+typedef struct {
+	int fileDescriptor;
+	off_t position, length;
+	integer numberOfChannels;
+	FLAC__uint64 firstSample, endSample;   // zero-based, as in libFLAC; endSample is just beyond the stretch
+	FLAC__uint64 numberOfSamplesDecoded;
+	double *channels [FLAC__MAX_CHANNELS];   // pointing at firstSample
+	bool errorOccurred;
+} MelderDecodeFlacStretch;
+
+static FLAC__StreamDecoderReadStatus Melder_DecodeFlacStretch_read (const FLAC__StreamDecoder * /* decoder */,
+	FLAC__byte buffer [], size_t *bytes, void *client_data)
+{
+	MelderDecodeFlacStretch *c = (MelderDecodeFlacStretch *) client_data;
+	if (*bytes <= 0)
+		return FLAC__STREAM_DECODER_READ_STATUS_ABORT;
+	const ssize_t numberOfBytesRead = pread (c -> fileDescriptor, buffer, *bytes, c -> position);
+	if (numberOfBytesRead < 0)
+		return FLAC__STREAM_DECODER_READ_STATUS_ABORT;
+	*bytes = (size_t) numberOfBytesRead;
+	c -> position += numberOfBytesRead;
+	if (numberOfBytesRead == 0)
+		return FLAC__STREAM_DECODER_READ_STATUS_END_OF_STREAM;
+	return FLAC__STREAM_DECODER_READ_STATUS_CONTINUE;
+}
+
+static FLAC__StreamDecoderSeekStatus Melder_DecodeFlacStretch_seek (const FLAC__StreamDecoder * /* decoder */,
+	FLAC__uint64 absoluteByteOffset, void *client_data)
+{
+	MelderDecodeFlacStretch *c = (MelderDecodeFlacStretch *) client_data;
+	c -> position = (off_t) absoluteByteOffset;
+	return FLAC__STREAM_DECODER_SEEK_STATUS_OK;
+}
+
+static FLAC__StreamDecoderTellStatus Melder_DecodeFlacStretch_tell (const FLAC__StreamDecoder * /* decoder */,
+	FLAC__uint64 *absoluteByteOffset, void *client_data)
+{
+	MelderDecodeFlacStretch *c = (MelderDecodeFlacStretch *) client_data;
+	*absoluteByteOffset = (FLAC__uint64) c -> position;
+	return FLAC__STREAM_DECODER_TELL_STATUS_OK;
+}
+
+static FLAC__StreamDecoderLengthStatus Melder_DecodeFlacStretch_length (const FLAC__StreamDecoder * /* decoder */,
+	FLAC__uint64 *streamLength, void *client_data)
+{
+	MelderDecodeFlacStretch *c = (MelderDecodeFlacStretch *) client_data;
+	*streamLength = (FLAC__uint64) c -> length;
+	return FLAC__STREAM_DECODER_LENGTH_STATUS_OK;
+}
+
+static FLAC__bool Melder_DecodeFlacStretch_eof (const FLAC__StreamDecoder * /* decoder */, void *client_data) {
+	MelderDecodeFlacStretch *c = (MelderDecodeFlacStretch *) client_data;
+	return c -> position >= c -> length;
+}
+
+static FLAC__StreamDecoderWriteStatus Melder_DecodeFlacStretch_convert (const FLAC__StreamDecoder * /* decoder */,
+	const FLAC__Frame *frame, const FLAC__int32 *const buffer[], void *client_data)
+{
+	MelderDecodeFlacStretch *c = (MelderDecodeFlacStretch *) client_data;
+	const FLAC__FrameHeader *header = & frame -> header;
+	double multiplier;
+	switch (header -> bits_per_sample) {
+		case 8: multiplier = (1.0f / 128); break;
+		case 16: multiplier = (1.0f / 32768); break;
+		case 24: multiplier = (1.0f / 8388608); break;
+		case 32: multiplier = (1.0f / 32768 / 65536); break;
+		default: return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
+	}
+	/*
+		Copy only the part of the frame that lies within our stretch.
+	*/
+	const FLAC__uint64 frameStart = header -> number.sample_number, frameEnd = frameStart + header -> blocksize;
+	const FLAC__uint64 copyStart = std::max (frameStart, c -> firstSample), copyEnd = std::min (frameEnd, c -> endSample);
+	if (copyEnd > copyStart) {
+		const integer offsetInFrame = (integer) (copyStart - frameStart), offsetInStretch = (integer) (copyStart - c -> firstSample);
+		const integer count = (integer) (copyEnd - copyStart);
+		for (integer i = 0; i < c -> numberOfChannels; ++ i) {
+			const FLAC__int32 *input = buffer [i] + offsetInFrame;
+			double *output = c -> channels [i] + offsetInStretch;
+			for (integer j = 0; j < count; ++ j)
+				output [j] = ((integer) input [j]) * multiplier;
+		}
+		c -> numberOfSamplesDecoded += count;
+	}
+	return frameEnd >= c -> endSample ? FLAC__STREAM_DECODER_WRITE_STATUS_ABORT : FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;   // abort = done
+}
+
+static void Melder_DecodeFlacStretch_error (const FLAC__StreamDecoder * /* decoder */, FLAC__StreamDecoderErrorStatus /* status */, void *client_data) {
+	MelderDecodeFlacStretch *c = (MelderDecodeFlacStretch *) client_data;
+	c -> errorOccurred = true;   // no Melder_warning () from a non-main thread
+}
+
+static void Melder_DecodeFlacStretch_run (MelderDecodeFlacStretch *c) {
+	FLAC__StreamDecoder *decoder = FLAC__stream_decoder_new ();
+	if (! decoder) {
+		c -> errorOccurred = true;
+		return;
+	}
+	if (FLAC__stream_decoder_init_stream (decoder,
+		Melder_DecodeFlacStretch_read, Melder_DecodeFlacStretch_seek, Melder_DecodeFlacStretch_tell,
+		Melder_DecodeFlacStretch_length, Melder_DecodeFlacStretch_eof,
+		Melder_DecodeFlacStretch_convert, nullptr, Melder_DecodeFlacStretch_error, c) != FLAC__STREAM_DECODER_INIT_STATUS_OK)
+	{
+		c -> errorOccurred = true;
+	} else if (FLAC__stream_decoder_seek_absolute (decoder, c -> firstSample)) {   // this decodes the first part of the stretch
+		while (c -> numberOfSamplesDecoded < c -> endSample - c -> firstSample) {
+			if (! FLAC__stream_decoder_process_single (decoder))
+				break;   // this is where we normally get, because our write callback aborts after the last frame of the stretch
+			if (FLAC__stream_decoder_get_state (decoder) == FLAC__STREAM_DECODER_END_OF_STREAM)
+				break;
+		}
+	}
+	if (c -> numberOfSamplesDecoded != c -> endSample - c -> firstSample)
+		c -> errorOccurred = true;
+	FLAC__stream_decoder_delete (decoder);   // this also finishes
+}
+
+/*
+	Returns false if the file could not be decoded in parallel,
+	in which case the caller should fall back on serial decoding.
+*/
+static bool Melder_readFlacFile_inParallel (FILE *f, MAT buffer) {
+	constexpr integer minimumNumberOfSamplesPerThread = 1 << 20;   // about 24 seconds at 44.1 kHz; shorter files are not worth the thread overhead
+	const integer numberOfSamples = buffer.ncol;
+	const integer numberOfThreads = MelderThread_getNumberOfThreads (numberOfSamples / minimumNumberOfSamplesPerThread,
+			double (numberOfSamples) * double (buffer.nrow) * 10.0);
+	if (numberOfThreads < 2)
+		return false;
+	const int fileDescriptor = fileno (f);
+	/*
+		Get the length of the file without seeking,
+		because the serial fallback still has to read from the current position of f.
+	*/
+	struct stat fileStatus;
+	if (fstat (fileDescriptor, & fileStatus) != 0)
+		return false;
+	const off_t length = fileStatus.st_size;
+	if (length <= 0)
+		return false;
+	std::vector <MelderDecodeFlacStretch> stretches ((size_t) numberOfThreads);
+	for (MelderDecodeFlacStretch& stretch : stretches) {
+		stretch. fileDescriptor = fileDescriptor;
+		stretch. position = 0;
+		stretch. length = length;
+		stretch. numberOfChannels = buffer.nrow;
+		stretch. numberOfSamplesDecoded = 0;
+		stretch. errorOccurred = false;
+	}
+	MelderThread_runStretches (numberOfThreads, numberOfSamples, [&] (integer ithread, integer firstSample, integer lastSample) {
+		MelderDecodeFlacStretch *c = & stretches [(size_t) ithread];
+		c -> firstSample = (FLAC__uint64) (firstSample - 1);
+		c -> endSample = (FLAC__uint64) lastSample;
+		for (integer ichan = 1; ichan <= buffer.nrow; ichan ++)
+			c -> channels [ichan - 1] = & buffer [ichan] [firstSample];
+		Melder_DecodeFlacStretch_run (c);
+	});
+	for (MelderDecodeFlacStretch& stretch : stretches)
+		if (stretch. errorOccurred)
+			return false;
+	return true;
+}
+
+#endif
+
+static void Melder_readFlacFile (FILE *f, MAT buffer) {
+	#if FLAC_DECODE_IN_PARALLEL
+		if (Melder_readFlacFile_inParallel (f, buffer))
+			return;
+	#endif
+	Melder_readFlacFile_serially (f, buffer);
+}
+
 static void Melder_readMp3File (FILE *f, MAT buffer) {
 	int result = 0;
 	MelderDecodeMp3Context c;
@@ -1365,6 +1592,8 @@ void Melder_readAudioToShort (FILE *f, integer numberOfChannels, int encoding, s
 	}
 }
 
+#define FLAC_ENCODING_BLOCK_SIZE  1024
+
 void MelderFile_writeShortToAudio (MelderFile file, integer numberOfChannels, int encoding, const short *buffer, integer numberOfSamples) {
 	try {
 		FILE *f = file -> filePointer;
@@ -1421,12 +1650,23 @@ void MelderFile_writeShortToAudio (MelderFile file, integer numberOfChannels, in
 			case Melder_FLAC_COMPRESSION_32:
 				if (! file -> flacEncoder)
 					Melder_throw (U"FLAC encoder not initialized.");
-				for (i = start; i < n; i += step * numberOfChannels) {
-					FLAC__int32 samples [FLAC__MAX_CHANNELS];
-					for (int ichan = 1; ichan <= numberOfChannels; ichan ++)
-						samples [ichan - 1] = buffer [i + ichan - 1];
-					if (! FLAC__stream_encoder_process_interleaved (file -> flacEncoder, samples, 1))
-						Melder_throw (U"Error encoding FLAC stream.");
+				/*
+					Hand the samples to the encoder in blocks rather than one sample frame at a time,
+					which saves a lot of per-call overhead inside libFLAC; the resulting file is the same.
+				*/
+				{
+					FLAC__int32 samples [FLAC_ENCODING_BLOCK_SIZE * FLAC__MAX_CHANNELS];
+					integer numberOfSamplesInBlock = 0;
+					for (i = start; i < n; i += step * numberOfChannels) {
+						FLAC__int32 *frame = & samples [numberOfSamplesInBlock * numberOfChannels];
+						for (int ichan = 1; ichan <= numberOfChannels; ichan ++)
+							frame [ichan - 1] = buffer [i + ichan - 1];
+						if (++ numberOfSamplesInBlock == FLAC_ENCODING_BLOCK_SIZE || i + step * numberOfChannels >= n) {
+							if (! FLAC__stream_encoder_process_interleaved (file -> flacEncoder, samples, (unsigned) numberOfSamplesInBlock))
+								Melder_throw (U"Error encoding FLAC stream.");
+							numberOfSamplesInBlock = 0;
+						}
+					}
 				}
 			break; case Melder_MULAW: case Melder_ALAW: default:
 				Melder_throw (U"Unknown encoding ", encoding, U".");
@@ -1436,7 +1676,13 @@ void MelderFile_writeShortToAudio (MelderFile file, integer numberOfChannels, in
 	}
 }
 
-void MelderFile_writeFloatToAudio (MelderFile file, constMATVU const& buffer, int encoding, bool warnIfClipped) {
+void Melder_warnAboutClippedSamples (integer numberOfClippedSamples, integer numberOfSamples) {
+	if (numberOfClippedSamples > 0)
+		Melder_warning (U"Writing samples to audio file: ", numberOfClippedSamples, U" out of ", numberOfSamples, U" samples have been clipped.\n"
+			U"Advice: you could scale the amplitudes or write to a binary file.");
+}
+
+integer MelderFile_writeFloatToAudio (MelderFile file, constMATVU const& buffer, int encoding, bool warnIfClipped) {
 	try {
 		FILE *f = file -> filePointer;
 		if (! f) Melder_throw (U"File not open.");
@@ -1560,15 +1806,18 @@ void MelderFile_writeFloatToAudio (MelderFile file, constMATVU const& buffer, in
 			case Melder_FLAC_COMPRESSION_32:
 				if (! file -> flacEncoder)
 					Melder_throw (U"FLAC encoder not initialized.");
-				for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-					FLAC__int32 samples [FLAC__MAX_CHANNELS];
-					for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-						double value = round (buffer [ichan] [isamp] * 32768.0);
-						if (value < -32768.0) { value = -32768.0; nclipped ++; }
-						if (value > 32767.0) { value = 32767.0; nclipped ++; }
-						samples [ichan - 1] = (FLAC__int32) value;
+				for (integer firstSampleOfBlock = 1; firstSampleOfBlock <= numberOfSamples; firstSampleOfBlock += FLAC_ENCODING_BLOCK_SIZE) {
+					const integer numberOfSamplesInBlock = std::min (integer (FLAC_ENCODING_BLOCK_SIZE), numberOfSamples - firstSampleOfBlock + 1);
+					FLAC__int32 samples [FLAC_ENCODING_BLOCK_SIZE * FLAC__MAX_CHANNELS];
+					for (integer isamp = 0; isamp < numberOfSamplesInBlock; isamp ++) {
+						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
+							double value = round (buffer [ichan] [firstSampleOfBlock + isamp] * 32768.0);
+							if (value < -32768.0) { value = -32768.0; nclipped ++; }
+							if (value > 32767.0) { value = 32767.0; nclipped ++; }
+							samples [isamp * numberOfChannels + ichan - 1] = (FLAC__int32) value;
+						}
 					}
-					if (! FLAC__stream_encoder_process_interleaved (file -> flacEncoder, samples, 1))
+					if (! FLAC__stream_encoder_process_interleaved (file -> flacEncoder, samples, (unsigned) numberOfSamplesInBlock))
 						Melder_throw (U"Error encoding FLAC stream.");
 				}
 				break;
@@ -1577,9 +1826,9 @@ void MelderFile_writeFloatToAudio (MelderFile file, constMATVU const& buffer, in
 			default:
 				Melder_throw (U"Unknown format.");
 		}
-		if (nclipped > 0 && warnIfClipped)
-			Melder_warning (U"Writing samples to audio file: ", nclipped, U" out of ", numberOfSamples, U" samples have been clipped.\n"
-				U"Advice: you could scale the amplitudes or write to a binary file.");
+		if (warnIfClipped)
+			Melder_warnAboutClippedSamples (nclipped, numberOfSamples);
+		return nclipped;
 	} catch (MelderError) {
 		Melder_throw (U"Samples not written to audio file.");
 	}
@@ -72,7 +72,12 @@ void Melder_readAudioToShort (FILE *f, integer numberOfChannels, int encoding, s
 /* If stereo, buffer will contain alternating left and right values.
  * Buffer is base-0.
  */
-void MelderFile_writeFloatToAudio (MelderFile file, constMATVU const& buffer, int encoding, bool warnIfClipped);
+integer MelderFile_writeFloatToAudio (MelderFile file, constMATVU const& buffer, int encoding, bool warnIfClipped);
+/* Returns the number of sample points that had to be clipped.
+ * A file written in several calls should pass warnIfClipped = false,
+ * and call Melder_warnAboutClippedSamples () with the total after the last call.
+ */
+void Melder_warnAboutClippedSamples (integer numberOfClippedSamples, integer numberOfSamples);
 void MelderFile_writeShortToAudio (MelderFile file, integer numberOfChannels, int encoding, const short *buffer, integer numberOfSamples);
 
 /* End of file melder_audiofiles.h */
@@ -61,13 +61,26 @@ inline static char32 * str32str_word_optionallyCaseSensitive (conststring32 stri
 	return nullptr;   // can never occur
 }
 
-bool Melder_stringMatchesCriterion (conststring32 value, kMelder_string which, conststring32 criterion, bool caseSensitive) {
+MelderStringMatcher :: MelderStringMatcher (kMelder_string which, conststring32 criterion, bool caseSensitive) :
+	_which (which),
+	_criterion (criterion ? criterion : U""),   // regard null strings as empty strings, as is usual in Praat
+	_caseSensitive (caseSensitive)
+{
+	if (which == kMelder_string::MATCH_REGEXP)
+		_compiledRegexp = CompileRE_throwable (_criterion, ! REDFLT_CASE_INSENSITIVE);
+}
+
+MelderStringMatcher :: ~MelderStringMatcher () {
+	free (_compiledRegexp);
+}
+
+bool MelderStringMatcher :: matches (conststring32 value) {
 	if (! value) {
 		value = U"";   // regard null strings as empty strings, as is usual in Praat
 	}
-	if (! criterion) {
-		criterion = U"";   // regard null strings as empty strings, as is usual in Praat
-	}
+	const kMelder_string which = _which;
+	const conststring32 criterion = _criterion;
+	const bool caseSensitive = _caseSensitive;
 	switch (which)
 	{
 		case kMelder_string::UNDEFINED:
@@ -139,14 +152,16 @@ bool Melder_stringMatchesCriterion (conststring32 value, kMelder_string which, c
 		case kMelder_string::MATCH_REGEXP:
 		{
 			char32 *place = nullptr;
-			regexp *compiled_regexp = CompileRE_throwable (criterion, ! REDFLT_CASE_INSENSITIVE);
-			if (ExecRE (compiled_regexp, nullptr, value, nullptr, 0, U'\0', U'\0', nullptr, nullptr))
-				place = compiled_regexp -> startp [0];
-			free (compiled_regexp);
+			if (ExecRE (_compiledRegexp, nullptr, value, nullptr, 0, U'\0', U'\0', nullptr, nullptr))
+				place = _compiledRegexp -> startp [0];
 			return !! place;
 		}
 	}
 	//return false;   // should not occur
 }
 
+bool Melder_stringMatchesCriterion (conststring32 value, kMelder_string which, conststring32 criterion, bool caseSensitive) {
+	return MelderStringMatcher (which, criterion, caseSensitive). matches (value);
+}
+
 /* End of file melder_search.cpp */
@@ -23,5 +23,23 @@
 bool Melder_numberMatchesCriterion (double value, kMelder_number which, double criterion);
 bool Melder_stringMatchesCriterion (conststring32 value, kMelder_string which, conststring32 criterion, bool caseSensitive);
 
+/*
+	For matching many strings against the same criterion,
+	so that a regular expression is compiled only once.
+	The criterion string has to outlive the matcher.
+*/
+struct MelderStringMatcher {
+	MelderStringMatcher (kMelder_string which, conststring32 criterion, bool caseSensitive);
+	~MelderStringMatcher ();
+	MelderStringMatcher (const MelderStringMatcher&) = delete;
+	MelderStringMatcher& operator= (const MelderStringMatcher&) = delete;
+	bool matches (conststring32 value);
+private:
+	kMelder_string _which;
+	conststring32 _criterion;
+	bool _caseSensitive;
+	struct regexp *_compiledRegexp = nullptr;
+};
+
 /* End of file melder_search.h */
 #endif
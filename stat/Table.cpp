@@ -17,10 +17,14 @@
  */
 
 #include <ctype.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "Table.h"
 #include "NUM2.h"
 #include "Formula.h"
 #include "SSCP.h"
+#include "MelderThread.h"
 
 #include "oo_DESTROY.h"
 #include "Table_def.h"
@@ -351,13 +355,26 @@ void Table_setNumericValue (Table me, integer rowNumber, integer columnNumber, d
 	}
 }
 
-bool Table_isCellNumeric_ErrorFalse (Table me, integer rowNumber, integer columnNumber) {
-	if (rowNumber < 1 || rowNumber > my rows.size)
-		return false;
-	if (columnNumber < 1 || columnNumber > my numberOfColumns)
-		return false;
-	const TableRow row = my rows.at [rowNumber];
-	conststring32 cell = row -> cells [columnNumber]. string.get();
+double Table_cellStringToNumber (conststring32 cell) {
+	if (! cell || cell [0] == U'\0' || (cell [0] == U'?' && cell [1] == U'\0'))
+		return undefined;
+	/*
+		Numbers consist of ASCII characters only, so any other character can stand in for a non-ASCII one.
+	*/
+	char buffer [100];
+	std::string longBuffer;
+	char *narrow = buffer;
+	const integer length = str32len (cell);
+	if (length >= integer (sizeof buffer)) {
+		longBuffer. resize ((size_t) length + 1);
+		narrow = & longBuffer [0];
+	}
+	for (integer i = 0; i <= length; i ++)
+		narrow [i] = ( cell [i] <= 0x7F ? (char) cell [i] : '\x7F' );
+	return Melder_a8tof (narrow);
+}
+
+static bool isCellStringNumeric (conststring32 cell) {
 	if (! cell)
 		return true;   // namely the value --undefined--
 	/*
@@ -377,6 +394,15 @@ bool Table_isCellNumeric_ErrorFalse (Table me, integer rowNumber, integer column
 	return Melder_isStringNumeric (cell);
 }
 
+bool Table_isCellNumeric_ErrorFalse (Table me, integer rowNumber, integer columnNumber) {
+	if (rowNumber < 1 || rowNumber > my rows.size)
+		return false;
+	if (columnNumber < 1 || columnNumber > my numberOfColumns)
+		return false;
+	const TableRow row = my rows.at [rowNumber];
+	return isCellStringNumeric (row -> cells [columnNumber]. string.get());
+}
+
 bool Table_isColumnNumeric_ErrorFalse (Table me, integer columnNumber) {
 	if (columnNumber < 1 || columnNumber > my numberOfColumns)
 		return false;
@@ -676,11 +702,100 @@ static void Table_columns_checkCrossSectionEmpty (constSTRVEC factors, constSTRV
 				Melder_throw (U"Factor \"", factors [ifactor], U"\" is also used as dependent variable.");
 }
 
+/*
+	Hash-based grouping of rows.
+	Rows belong to the same group if they have the same numbers in all the given columns,
+	which should have been numericized (a string column then contains the ranks of its strings).
+	The groups are numbered in the order in which Table_sortRows_Assert () would sort them,
+	and within each group the rows keep their original order:
+	the rows of group igroup are out_groupedRows [out_groupStarts [igroup] .. out_groupStarts [igroup + 1] - 1].
+	This takes one hashing pass over the rows and a sort of the groups only, and leaves the order of the rows alone.
+	Returns the number of groups.
+*/
+static integer Table_groupRows_Assert (Table me, constINTVEC columns, autoINTVEC *out_groupStarts, autoINTVEC *out_groupedRows) {
+	const integer numberOfRows = my rows.size;
+	auto rowHash = [me, & columns] (integer irow) {
+		const TableRow row = my rows.at [irow];
+		size_t hash = 0;
+		for (integer icol = 1; icol <= columns.size; icol ++) {
+			double value = row -> cells [columns [icol]]. number;
+			if (value == 0.0)
+				value = 0.0;   // -0.0 and +0.0 are the same level
+			else if (isundef (value))
+				value = undefined;   // all undefined values are the same level
+			hash = hash * 1'000'003 ^ std::hash <double> () (value);
+		}
+		return hash;
+	};
+	auto rowsAreEqual = [me, & columns] (integer irow, integer jrow) {
+		const TableRow row = my rows.at [irow], otherRow = my rows.at [jrow];
+		for (integer icol = 1; icol <= columns.size; icol ++) {
+			const double value = row -> cells [columns [icol]]. number, otherValue = otherRow -> cells [columns [icol]]. number;
+			if (value != otherValue && ! (isundef (value) && isundef (otherValue)))
+				return false;
+		}
+		return true;
+	};
+	/*
+		Collect the groups, in the order of their first rows.
+	*/
+	std::unordered_map <integer, integer, decltype (rowHash), decltype (rowsAreEqual)> groupOfFirstRow (0, rowHash, rowsAreEqual);
+	std::vector <integer> firstRows;
+	autoINTVEC groupOfRow = newINTVECraw (numberOfRows);
+	for (integer irow = 1; irow <= numberOfRows; irow ++) {
+		const auto [where, isNew] = groupOfFirstRow. emplace (irow, integer (firstRows.size ()) + 1);
+		if (isNew)
+			firstRows. push_back (irow);
+		groupOfRow [irow] = where -> second;
+	}
+	const integer numberOfGroups = integer (firstRows.size ());
+	/*
+		Renumber the groups in sorted order (undefined values last).
+	*/
+	autoINTVEC order = newINTVECraw (numberOfGroups);
+	for (integer igroup = 1; igroup <= numberOfGroups; igroup ++)
+		order [igroup] = igroup;
+	std::sort (order.begin(), order.end(), [me, & columns, & firstRows] (integer a, integer b) {
+		const TableRow row = my rows.at [firstRows [size_t (a - 1)]], otherRow = my rows.at [firstRows [size_t (b - 1)]];
+		for (integer icol = 1; icol <= columns.size; icol ++) {
+			const double value = row -> cells [columns [icol]]. number, otherValue = otherRow -> cells [columns [icol]]. number;
+			if (isundef (value) || isundef (otherValue)) {
+				if (isundef (value) != isundef (otherValue))
+					return isundef (otherValue);
+				continue;
+			}
+			if (value < otherValue)
+				return true;
+			if (value > otherValue)
+				return false;
+		}
+		return false;
+	});
+	autoINTVEC rank = newINTVECraw (numberOfGroups);
+	for (integer igroup = 1; igroup <= numberOfGroups; igroup ++)
+		rank [order [igroup]] = igroup;
+	/*
+		Distribute the rows over the groups, keeping their order.
+	*/
+	autoINTVEC groupStarts = newINTVECzero (numberOfGroups + 1);
+	for (integer irow = 1; irow <= numberOfRows; irow ++)
+		groupStarts [rank [groupOfRow [irow]] + 1] ++;
+	groupStarts [1] = 1;
+	for (integer igroup = 2; igroup <= numberOfGroups + 1; igroup ++)
+		groupStarts [igroup] += groupStarts [igroup - 1];
+	autoINTVEC nextPosition = newINTVECcopy (groupStarts.get());
+	autoINTVEC groupedRows = newINTVECraw (numberOfRows);
+	for (integer irow = 1; irow <= numberOfRows; irow ++)
+		groupedRows [nextPosition [rank [groupOfRow [irow]]] ++] = irow;
+	*out_groupStarts = groupStarts.move();
+	*out_groupedRows = groupedRows.move();
+	return numberOfGroups;
+}
+
 autoTable Table_collapseRows (Table me, conststring32 factors_string, conststring32 columnsToSum_string,
 	conststring32 columnsToAverage_string, conststring32 columnsToMedianize_string,
 	conststring32 columnsToAverageLogarithmically_string, conststring32 columnsToMedianizeLogarithmically_string)
 {
-	bool originalChanged = false;
 	try {
 		Melder_assert (factors_string);
 
@@ -759,70 +874,41 @@ autoTable Table_collapseRows (Table me, conststring32 factors_string, conststrin
 			Table_numericize_checkDefined (me, columns [icol]);
 		}
 		/*
-			Remember the present sorting of the original table.
-			(This is safe: the sorting index may change only vacuously when numericizing.)
-			But this cannot be done before the previous block!
+			Find the groups of rows with identical factors (independent variables).
 		*/
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			const TableRow row = my rows.at [irow];
-			row -> sortingIndex = irow;
-		}
-		/*
-			We will now sort the original table temporarily, by the factors (independent variables) only.
-		*/
-		Table_sortRows_Assert (me, constINTVEC (columns.at, factors.size));   /* This works only because the factors come first. */
-		originalChanged = true;
-		/*
-			Find stretches of identical factors.
-		*/
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			integer rowmin = irow, rowmax = irow;
-			for (;;) {
-				bool identical = true;
-				if (++ rowmax > my rows.size)
-					break;
-				for (integer icol = 1; icol <= factors.size; icol ++) {
-					if (my rows.at [rowmax] -> cells [columns [icol]]. number !=
-						my rows.at [rowmin] -> cells [columns [icol]]. number)
-					{
-						identical = false;
-						break;
-					}
-				}
-				if (! identical)
-					break;
-			}
-			rowmax --;
-			/*
-				We have the stretch.
-			*/
+		autoINTVEC groupStarts, groupedRows;
+		const integer numberOfGroups = Table_groupRows_Assert (me, constINTVEC (columns.at, factors.size),
+				& groupStarts, & groupedRows);   // this works only because the factors come first
+		for (integer igroup = 1; igroup <= numberOfGroups; igroup ++) {
+			const constINTVEC rowsOfGroup = groupedRows.part (groupStarts [igroup], groupStarts [igroup + 1] - 1);
+			const integer numberOfRowsInGroup = rowsOfGroup.size;
 			Table_insertRow (thee.get(), thy rows.size + 1);
 			{// scope
 				integer icol = 0;
 				for (integer i = 1; i <= factors.size; i ++) {
 					++ icol;
 					Table_setStringValue (thee.get(), thy rows.size, icol,
-						my rows.at [rowmin] -> cells [columns [icol]]. string.get());
+						my rows.at [rowsOfGroup [1]] -> cells [columns [icol]]. string.get());
 				}
 				for (integer i = 1; i <= columnsToSum.size; i ++) {
 					++ icol;
 					longdouble sum = 0.0;
-					for (integer jrow = rowmin; jrow <= rowmax; jrow ++)
-						sum += my rows.at [jrow] -> cells [columns [icol]]. number;
+					for (integer k = 1; k <= numberOfRowsInGroup; k ++)
+						sum += my rows.at [rowsOfGroup [k]] -> cells [columns [icol]]. number;
 					Table_setNumericValue (thee.get(), thy rows.size, icol, double (sum));
 				}
 				for (integer i = 1; i <= columnsToAverage.size; i ++) {
 					++ icol;
 					longdouble sum = 0.0;
-					for (integer jrow = rowmin; jrow <= rowmax; jrow ++)
-						sum += my rows.at [jrow] -> cells [columns [icol]]. number;
-					Table_setNumericValue (thee.get(), thy rows.size, icol, double (sum) / (rowmax - rowmin + 1));
+					for (integer k = 1; k <= numberOfRowsInGroup; k ++)
+						sum += my rows.at [rowsOfGroup [k]] -> cells [columns [icol]]. number;
+					Table_setNumericValue (thee.get(), thy rows.size, icol, double (sum) / numberOfRowsInGroup);
 				}
 				for (integer i = 1; i <= columnsToMedianize.size; i ++) {
 					++ icol;
-					for (integer jrow = rowmin; jrow <= rowmax; jrow ++)
-						sortingColumn [jrow] = my rows.at [jrow] -> cells [columns [icol]]. number;
-					const VEC part = sortingColumn.part (rowmin, rowmax);
+					const VEC part = sortingColumn.part (1, numberOfRowsInGroup);
+					for (integer k = 1; k <= numberOfRowsInGroup; k ++)
+						part [k] = my rows.at [rowsOfGroup [k]] -> cells [columns [icol]]. number;
 					VECsort_inplace (part);
 					const double median = NUMquantile (part, 0.5);
 					Table_setNumericValue (thee.get(), thy rows.size, icol, median);
@@ -830,86 +916,58 @@ autoTable Table_collapseRows (Table me, conststring32 factors_string, conststrin
 				for (integer i = 1; i <= columnsToAverageLogarithmically.size; i ++) {
 					++ icol;
 					longdouble sum = 0.0;
-					for (integer jrow = rowmin; jrow <= rowmax; jrow ++) {
-						const double value = my rows.at [jrow] -> cells [columns [icol]]. number;
+					for (integer k = 1; k <= numberOfRowsInGroup; k ++) {
+						const double value = my rows.at [rowsOfGroup [k]] -> cells [columns [icol]]. number;
 						if (value <= 0.0) {
 							Melder_throw (
 								U"The cell in column \"", columnsToAverageLogarithmically [i].get(),
-								U"\" of row ", jrow, U" of ", me,
+								U"\" of row ", rowsOfGroup [k], U" of ", me,
 								U" is not positive.\nCannot average logarithmically."
 							);
 						}
 						sum += log (value);
 					}
-					Table_setNumericValue (thee.get(), thy rows.size, icol, exp (double (sum / (rowmax - rowmin + 1))));
+					Table_setNumericValue (thee.get(), thy rows.size, icol, exp (double (sum / numberOfRowsInGroup)));
 				}
 				for (integer i = 1; i <= columnsToMedianizeLogarithmically.size; i ++) {
 					++ icol;
-					for (integer jrow = rowmin; jrow <= rowmax; jrow ++) {
-						const double value = my rows.at [jrow] -> cells [columns [icol]]. number;
+					const VEC part = sortingColumn.part (1, numberOfRowsInGroup);
+					for (integer k = 1; k <= numberOfRowsInGroup; k ++) {
+						const double value = my rows.at [rowsOfGroup [k]] -> cells [columns [icol]]. number;
 						if (value <= 0.0) {
 							Melder_throw (
 								U"The cell in column \"", columnsToMedianizeLogarithmically [i].get(),
-								U"\" of row ", jrow, U" of ", me,
+								U"\" of row ", rowsOfGroup [k], U" of ", me,
 								U" is not positive.\nCannot medianize logarithmically."
 							);
 						}
-						sortingColumn [jrow] = log (value);
+						part [k] = log (value);
 					}
-					const VEC part = sortingColumn.part (rowmin, rowmax);
 					VECsort_inplace (part);
 					const double median = NUMquantile (part, 0.5);
 					Table_setNumericValue (thee.get(), thy rows.size, icol, exp (median));
 				}
 				Melder_assert (icol == thy numberOfColumns);
 			}
-			irow = rowmax;
 		}
-		if (originalChanged)
-			sortRowsByIndex_NoError (me);   // unsort the original table
 		return thee;
 	} catch (MelderError) {
-		if (originalChanged)
-			sortRowsByIndex_NoError (me);   // unsort the original table   // UGLY
-		throw;
+		Melder_throw (me, U": rows not collapsed.");
 	}
 }
 
 static autoSTRVEC Table_getLevels_ (Table me, integer column) {
-	try {
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			TableRow row = my rows.at [irow];
-			row -> sortingIndex = irow;
-		}
-		integer columns [2] = { 0, column };
-		Table_sortRows_Assert (me, constINTVEC (columns, 1));
-		integer numberOfLevels = 0;
-		integer irow = 1;
-		while (irow <= my rows.size) {
-			const double value = my rows.at [irow] -> cells [column]. number;
-			numberOfLevels ++;
-			while (++ irow <= my rows.size && my rows.at [irow] -> cells [column]. number == value) {
-				;
-			}
-		}
-		autoSTRVEC result (numberOfLevels);
-		numberOfLevels = 0;
-		irow = 1;
-		while (irow <= my rows.size) {
-			const double value = my rows.at [irow] -> cells [column]. number;
-			result [++ numberOfLevels] = Melder_dup (Table_getStringValue_Assert (me, irow, column));
-			while (++ irow <= my rows.size && my rows.at [irow] -> cells [column]. number == value) { }
-		}
-		sortRowsByIndex_NoError (me);   // unsort the original table
-		return result;
-	} catch (MelderError) {
-		sortRowsByIndex_NoError (me);   // unsort the original table   // UGLY
-		throw;
-	}
+	Table_numericize_Assert (me, column);
+	const integer columns [2] = { 0, column };
+	autoINTVEC groupStarts, groupedRows;
+	const integer numberOfLevels = Table_groupRows_Assert (me, constINTVEC (columns, 1), & groupStarts, & groupedRows);
+	autoSTRVEC result (numberOfLevels);
+	for (integer ilevel = 1; ilevel <= numberOfLevels; ilevel ++)
+		result [ilevel] = Melder_dup (Table_getStringValue_Assert (me, groupedRows [groupStarts [ilevel]], column));
+	return result;
 }
 
 autoTable Table_rowsToColumns (Table me, conststring32 factors_string, integer columnToTranspose, conststring32 columnsToExpand_string) {
-	bool originalChanged = false;
 	try {
 		Melder_assert (factors_string);
 
@@ -967,76 +1025,46 @@ autoTable Table_rowsToColumns (Table me, conststring32 factors_string, integer c
 			}
 		}
 		/*
-			Remember the present sorting of the original table.
-			(This is safe: the sorting index may change only vacuously when numericizing.)
-			But this cannot be done before the previous blocks that numericize!
-		*/
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			TableRow row = my rows.at [irow];
-			row -> sortingIndex = irow;
-		}
-		/*
-			We will now sort the original table temporarily, by the factors (independent variables) only.
+			Find the groups of rows with identical factors (independent variables).
 		*/
-		Table_sortRows_Assert (me, factorColumns.get());
-		originalChanged = true;
-		/*
-			Find stretches of identical factors.
-		*/
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			integer rowmin = irow, rowmax = irow;
-			for (;;) {
-				bool identical = true;
-				if (++ rowmax > my rows.size)
-					break;
-				for (integer ifactor = 1; ifactor <= numberOfFactors; ifactor ++) {
-					if (my rows.at [rowmax] -> cells [factorColumns [ifactor]]. number !=
-						my rows.at [rowmin] -> cells [factorColumns [ifactor]]. number)
-					{
-						identical = false;
-						break;
-					}
-				}
-				if (! identical) break;
-			}
-			#if 0
-			if (rowmax - rowmin > numberOfLevels && ! warned) {
-				Melder_warning (U"Some rows of the original table have not been included in the new table. "
-					U"You could perhaps add more factors.");
-				warned = true;
-			}
-			#endif
-			rowmax --;
-			/*
-				We have the stretch.
-			*/
+		autoINTVEC groupStarts, groupedRows;
+		const integer numberOfGroups = Table_groupRows_Assert (me, factorColumns.get(), & groupStarts, & groupedRows);
+		autoINTVEC lastRowOfLevel = newINTVECzero (numberOfLevels);
+		for (integer igroup = 1; igroup <= numberOfGroups; igroup ++) {
+			const constINTVEC rowsOfGroup = groupedRows.part (groupStarts [igroup], groupStarts [igroup + 1] - 1);
 			Table_insertRow (thee.get(), thy rows.size + 1);
-			TableRow thyRow = thy rows.at [thy rows.size];
 			for (integer ifactor = 1; ifactor <= numberOfFactors; ifactor ++) {
 				Table_setStringValue (thee.get(), thy rows.size, ifactor,
-					my rows.at [rowmin] -> cells [factorColumns [ifactor]]. string.get());
+					my rows.at [rowsOfGroup [1]] -> cells [factorColumns [ifactor]]. string.get());
 			}
-			for (integer iexpand = 1; iexpand <= numberToExpand; iexpand ++) {
-				for (integer jrow = rowmin; jrow <= rowmax; jrow ++) {
-					TableRow myRow = my rows.at [jrow];
-					const double value = myRow -> cells [columnsToExpand [iexpand]]. number;
-					const integer level = Melder_iround (myRow -> cells [columnToTranspose]. number);
-					const integer thyColumn = numberOfFactors + (iexpand - 1) * numberOfLevels + level;
-					if (thyRow -> cells [thyColumn]. string && ! warned) {
-						Melder_warning (U"Some information from the original table has not been included in the new table. "
-							U"You could perhaps add more factors.");
-						warned = true;
-					}
-					Table_setNumericValue (thee.get(), thy rows.size, thyColumn, value);
+			/*
+				If a level occurs more than once in the group, the last occurrence wins.
+			*/
+			for (integer k = 1; k <= rowsOfGroup.size; k ++) {
+				const integer level = Melder_iround (my rows.at [rowsOfGroup [k]] -> cells [columnToTranspose]. number);
+				if (level < 1 || level > numberOfLevels)
+					Melder_throw (U"The cell in row ", rowsOfGroup [k], U" of the column to transpose does not correspond to a level.");
+				if (lastRowOfLevel [level] != 0 && ! warned) {
+					Melder_warning (U"Some information from the original table has not been included in the new table. "
+						U"You could perhaps add more factors.");
+					warned = true;
+				}
+				lastRowOfLevel [level] = rowsOfGroup [k];
+			}
+			for (integer ilevel = 1; ilevel <= numberOfLevels; ilevel ++) {
+				if (lastRowOfLevel [ilevel] == 0)
+					continue;
+				const TableRow myRow = my rows.at [lastRowOfLevel [ilevel]];
+				for (integer iexpand = 1; iexpand <= numberToExpand; iexpand ++) {
+					const integer thyColumn = numberOfFactors + (iexpand - 1) * numberOfLevels + ilevel;
+					Table_setNumericValue (thee.get(), thy rows.size, thyColumn, myRow -> cells [columnsToExpand [iexpand]]. number);
 				}
+				lastRowOfLevel [ilevel] = 0;
 			}
-			irow = rowmax;
 		}
-		if (originalChanged) sortRowsByIndex_NoError (me);   // unsort the original table
 		return thee;
 	} catch (MelderError) {
-		if (originalChanged) sortRowsByIndex_NoError (me);   // unsort the original table   // UGLY
-		throw;
+		Melder_throw (me, U": rows not transposed to columns.");
 	}
 }
 
@@ -1054,29 +1082,96 @@ autoTable Table_transpose (Table me) {
 	}
 }
 
-static constINTVEC *cellCompare_columns;
-
-static int cellCompare (const void *first, const void *second) {
-	const TableRow me = * (TableRow *) first, thee = * (TableRow *) second;
-	const integer ncol = cellCompare_columns->size;
-	for (integer icol = 1; icol <= ncol; icol ++) {
-		const integer cellNumber = cellCompare_columns->at [icol];
-		if (my cells [cellNumber]. number < thy cells [cellNumber]. number)
-			return -1;
-		if (my cells [cellNumber]. number > thy cells [cellNumber]. number)
-			return +1;
+/*
+	Stable multi-key sort.
+	The numericized cells of the key columns (a string column thereby sorts by the ranks of its strings)
+	are copied into one contiguous array of unsigned integers that sort in the same order as the numbers
+	(or in the reverse order, for descending keys), with undefined values above all numbers.
+	Small tables are then sorted with a merge sort on these keys.
+	Larger tables are sorted with a least-significant-digit radix sort, one byte at a time,
+	from the last key to the first; every pass is a stable counting sort,
+	so rows with equal keys keep their relative order.
+*/
+static uint64 sortingKey (double value, bool descending) {
+	uint64 key;
+	if (isundef (value)) {
+		key = UINT64_MAX;
+	} else {
+		if (value == 0.0)
+			value = 0.0;   // -0.0 sorts as +0.0
+		memcpy (& key, & value, sizeof (double));
+		key = ( key & 0x8000'0000'0000'0000 ? ~ key : key | 0x8000'0000'0000'0000 );
 	}
-	return 0;
+	return descending ? ~ key : key;
 }
 
-void Table_sortRows_Assert (Table me, constINTVEC columns) {
+void Table_sortRows_Assert (Table me, constINTVEC columns, constBOOLVEC descending) {
+	Melder_assert (descending.size == 0 || descending.size == columns.size);
 	for (integer icol = 1; icol <= columns.size; icol ++)
 		Table_numericize_Assert (me, columns [icol]);
-	cellCompare_columns = & columns;
-	qsort (& my rows.at [1], (unsigned long) my rows.size, sizeof (TableRow), cellCompare);
+	const integer numberOfRows = my rows.size, numberOfKeys = columns.size;
+	if (numberOfRows < 2 || numberOfKeys < 1)
+		return;
+	std::vector <uint64> keys ((size_t) (numberOfRows * numberOfKeys));
+	for (integer irow = 1; irow <= numberOfRows; irow ++) {
+		const TableRow row = my rows.at [irow];
+		for (integer ikey = 1; ikey <= numberOfKeys; ikey ++)
+			keys [(size_t) ((irow - 1) * numberOfKeys + ikey - 1)] =
+					sortingKey (row -> cells [columns [ikey]]. number, descending.size > 0 && descending [ikey]);
+	}
+	std::vector <integer> order ((size_t) numberOfRows);   // zero-based row indexes, in sorted order
+	for (integer irow = 0; irow < numberOfRows; irow ++)
+		order [(size_t) irow] = irow;
+	constexpr integer minimumNumberOfRowsForRadixSort = 256;
+	if (numberOfRows < minimumNumberOfRowsForRadixSort) {
+		std::stable_sort (order.begin (), order.end (), [& keys, numberOfKeys] (integer a, integer b) {
+			const uint64 *aKeys = & keys [(size_t) (a * numberOfKeys)], *bKeys = & keys [(size_t) (b * numberOfKeys)];
+			return std::lexicographical_compare (aKeys, aKeys + numberOfKeys, bKeys, bKeys + numberOfKeys);
+		});
+	} else {
+		std::vector <integer> otherOrder ((size_t) numberOfRows);
+		std::vector <uint64> currentKeys ((size_t) numberOfRows), otherKeys ((size_t) numberOfRows);
+		for (integer ikey = numberOfKeys; ikey >= 1; ikey --) {
+			for (integer i = 0; i < numberOfRows; i ++)
+				currentKeys [(size_t) i] = keys [(size_t) (order [(size_t) i] * numberOfKeys + ikey - 1)];
+			std::vector <integer> counts (8 * 256, 0);
+			for (integer i = 0; i < numberOfRows; i ++)
+				for (int ibyte = 0; ibyte < 8; ibyte ++)
+					counts [(size_t) (ibyte * 256 + ((currentKeys [(size_t) i] >> (8 * ibyte)) & 0xFF))] ++;
+			for (int ibyte = 0; ibyte < 8; ibyte ++) {
+				integer *count = & counts [(size_t) (ibyte * 256)];
+				const int byteOfFirstKey = (currentKeys [0] >> (8 * ibyte)) & 0xFF;
+				if (count [byteOfFirstKey] == numberOfRows)
+					continue;   // all keys have the same value in this byte
+				integer offset = 0;
+				for (int value = 0; value < 256; value ++) {
+					const integer numberOfKeysWithThisValue = count [value];
+					count [value] = offset;
+					offset += numberOfKeysWithThisValue;
+				}
+				for (integer i = 0; i < numberOfRows; i ++) {
+					const uint64 key = currentKeys [(size_t) i];
+					const integer position = count [(key >> (8 * ibyte)) & 0xFF] ++;
+					otherKeys [(size_t) position] = key;
+					otherOrder [(size_t) position] = order [(size_t) i];
+				}
+				std::swap (currentKeys, otherKeys);
+				std::swap (order, otherOrder);
+			}
+		}
+	}
+	std::vector <TableRow> sortedRows ((size_t) numberOfRows);
+	for (integer i = 0; i < numberOfRows; i ++)
+		sortedRows [(size_t) i] = my rows.at [1 + order [(size_t) i]];
+	for (integer irow = 1; irow <= numberOfRows; irow ++)
+		my rows.at [irow] = sortedRows [(size_t) (irow - 1)];
 }
 
-void Table_sortRows_string (Table me, conststring32 columns_string) {
+void Table_sortRows_Assert (Table me, constINTVEC columns) {
+	Table_sortRows_Assert (me, columns, constBOOLVEC ());
+}
+
+void Table_sortRows_string (Table me, conststring32 columns_string, conststring32 descendingColumns_string) {
 	try {
 		autoSTRVEC columns_tokens = newSTRVECtokenize (columns_string);
 		integer numberOfColumns = columns_tokens.size;
@@ -1088,12 +1183,29 @@ void Table_sortRows_string (Table me, conststring32 columns_string) {
 			if (columns [icol] == 0)
 				Melder_throw (U"Column \"", columns_tokens [icol].get(), U"\" does not exist.");
 		}
-		Table_sortRows_Assert (me, columns.get());
+		autoSTRVEC descendingColumns_tokens = newSTRVECtokenize (descendingColumns_string);
+		autoBOOLVEC descending = newBOOLVECzero (numberOfColumns);
+		for (integer idescending = 1; idescending <= descendingColumns_tokens.size; idescending ++) {
+			bool found = false;
+			for (integer icol = 1; icol <= numberOfColumns; icol ++) {
+				if (str32equ (descendingColumns_tokens [idescending].get(), columns_tokens [icol].get())) {
+					descending [icol] = true;
+					found = true;
+				}
+			}
+			if (! found)
+				Melder_throw (U"Column \"", descendingColumns_tokens [idescending].get(), U"\" is not among the columns to sort by.");
+		}
+		Table_sortRows_Assert (me, columns.get(), descending.get());
 	} catch (MelderError) {
 		Melder_throw (me, U": rows not sorted.");
 	}
 }
 
+void Table_sortRows_string (Table me, conststring32 columns_string) {
+	Table_sortRows_string (me, columns_string, U"");
+}
+
 void Table_randomizeRows (Table me) noexcept {
 	for (integer irow = 1; irow <= my rows.size; irow ++) {
 		integer jrow = NUMrandomInteger (irow, my rows.size);
@@ -1961,202 +2073,436 @@ void Table_writeToSemicolonSeparatedFile (Table me, MelderFile file) {
 	}
 }
 
-autoTable Table_readFromTableFile (MelderFile file) {
-	try {
-		autostring32 string = MelderFile_readText (file);
-		/*
-			Count columns.
-		*/
-		integer numberOfColumns = 0;
-		char32 *p = & string [0];
-		for (;;) {
-			char32 kar = *p++;
-			if (kar == U'\n' || kar == U'\0')
-				break;
-			if (kar == U' ' || kar == U'\t')
-				continue;
-			numberOfColumns ++;
-			do { kar = *p++; } while (kar != U' ' && kar != U'\t' && kar != U'\n' && kar != U'\0');
-			if (kar == U'\n' || kar == U'\0')
-				break;
-		}
-		if (numberOfColumns < 1)
-			Melder_throw (U"No columns.");
-
-		/*
-			Count elements.
-		*/
-		p = & string [0];
-		integer numberOfElements = 0;
-		for (;;) {
-			char32 kar = *p++;
-			if (kar == U'\0')
-				break;
-			if (kar == U' ' || kar == U'\t' || kar == U'\n')
-				continue;
-			numberOfElements ++;
-			do { kar = *p++; } while (kar != U' ' && kar != U'\t' && kar != U'\n' && kar != U'\0');
-			if (kar == U'\0')
-				break;
+/*
+	Reading tables from text files.
+
+	The text is cut into rows in a single sequential pass
+	(this has to be sequential, because a newline between double quotes does not end a row),
+	after which stretches of rows are turned into cells by separate threads.
+	If the file is UTF-8 that needs no newline conversion, which is the usual case,
+	the cells are decoded directly from the bytes of the file, so that no UTF-32 copy of the whole text is made.
+	While parsing, every thread keeps track of which columns contain only numbers,
+	so that such columns are already numericized when the table appears.
+*/
+
+/*
+	The number of characters in a cell, without its double quotes if withoutQuotes is true.
+*/
+static integer cellLength (const char32 *begin, const char32 *end, bool withoutQuotes) {
+	if (! withoutQuotes)
+		return end - begin;
+	integer length = 0;
+	for (const char32 *p = begin; p < end; p ++)
+		if (*p != U'\"')
+			length ++;
+	return length;
+}
+static integer cellLength (const char *begin, const char *end, bool withoutQuotes) {   // valid UTF-8
+	integer length = 0;
+	for (const char *p = begin; p < end; p ++)
+		if ((*p & 0xC0) != 0x80 && ! (withoutQuotes && *p == '\"'))
+			length ++;
+	return length;
+}
+
+/*
+	Copy the characters of a cell to a string of length cellLength (begin, end, withoutQuotes).
+*/
+static void copyCell (const char32 *begin, const char32 *end, bool withoutQuotes, char32 *q) {
+	for (const char32 *p = begin; p < end; p ++)
+		if (! withoutQuotes || *p != U'\"')
+			*q ++ = *p;
+}
+static void copyCell (const char *begin, const char *end, bool withoutQuotes, char32 *q) {   // valid UTF-8
+	const char8 *p = (const char8 *) begin;
+	while (p < (const char8 *) end) {
+		const char32 kar1 = * p ++;   // convert up without sign extension
+		if (kar1 <= 0x00'007F) {
+			if (! withoutQuotes || kar1 != U'\"')   // a double quote cannot be part of a multibyte character
+				*q ++ = kar1;
+		} else if (kar1 <= 0x00'00DF) {
+			const char32 kar2 = * p ++;
+			*q ++ = ((kar1 & 0x00'001F) << 6) | (kar2 & 0x00'003F);
+		} else if (kar1 <= 0x00'00EF) {
+			const char32 kar2 = * p ++, kar3 = * p ++;
+			*q ++ = ((kar1 & 0x00'000F) << 12) | ((kar2 & 0x00'003F) << 6) | (kar3 & 0x00'003F);
+		} else {
+			const char32 kar2 = * p ++, kar3 = * p ++, kar4 = * p ++;
+			*q ++ = ((kar1 & 0x00'0007) << 18) | ((kar2 & 0x00'003F) << 12) | ((kar3 & 0x00'003F) << 6) | (kar4 & 0x00'003F);
 		}
+	}
+}
 
-		/*
-			Check if all columns are complete.
-		*/
-		if (numberOfElements == 0 || numberOfElements % numberOfColumns != 0)
-			Melder_throw (U"The number of elements (", numberOfElements, U") is not a multiple of the number of columns (", numberOfColumns, U").");
+template <typename CHAR>
+static autostring32 newCellString (const CHAR *begin, const CHAR *end) {
+	autostring32 result (cellLength (begin, end, false));
+	copyCell (begin, end, false, result.get());
+	return result;
+}
 
-		/*
-			Create empty table.
-		*/
-		const integer numberOfRows = numberOfElements / numberOfColumns - 1;
-		autoTable me = Table_create (numberOfRows, numberOfColumns);
+/*
+	Whether the bytes read from a file can be parsed as they are,
+	i.e. whether Melder_8to32 () would just decode them as UTF-8
+	and then find no form feeds, next-line characters or line or paragraph separators to convert into newlines.
+*/
+static bool isTextUtf8ThatNeedsNoConversion (conststring8 text) {
+	const kMelder_textInputEncoding inputEncoding = Melder_getInputEncoding ();
+	if (inputEncoding == kMelder_textInputEncoding::ISO_LATIN1 ||
+		inputEncoding == kMelder_textInputEncoding::WINDOWS_LATIN1 ||
+		inputEncoding == kMelder_textInputEncoding::MACROMAN)
+		return false;
+	if (! Melder_str8IsValidUtf8 (text))
+		return false;
+	for (const char8 *p = (const char8 *) text; *p != '\0'; p ++) {
+		if (*p == 0x0C)
+			return false;   // FormFeed
+		if (*p == 0xC2 && p [1] == 0x85)
+			return false;   // NextLine
+		if (*p == 0xE2 && p [1] == 0x80 && (p [2] == 0xA8 || p [2] == 0xA9))
+			return false;   // LineSeparator or ParagraphSeparator
+	}
+	return true;
+}
 
-		/*
-			Read elements.
-		*/
-		p = & string [0];
-		for (integer icol = 1; icol <= numberOfColumns; icol ++) {
-			while (*p == U' ' || *p == U'\t') {
-				Melder_assert (*p != U'\0');
-				p ++;
-			}
-			static MelderString buffer { };
-			MelderString_empty (& buffer);
-			while (*p != U' ' && *p != U'\t' && *p != U'\n') {
-				MelderString_appendCharacter (& buffer, *p);
-				p ++;
-			}
-			Table_setColumnLabel (me.get(), icol, buffer.string);
-			MelderString_empty (& buffer);
-		}
-		for (integer irow = 1; irow <= numberOfRows; irow ++) {
-			TableRow row = my rows.at [irow];
+struct TableTextStretch {   // the results of one thread
+	std::vector <bool> columnIsNumeric;
+	integer firstIncompleteRow, firstOverfullRow;
+	bool lastCellHasUnmatchedQuote, lastCellHasNewline, outOfMemory;
+};
+
+template <typename CHAR>
+struct TableText {   // what the threads share
+	Table table;
+	const CHAR * const *rowStarts;   // rowStarts [irow - 1] is the first character of row irow; rowStarts [numberOfRows] is the end of the text
+	bool whitespaceSeparated;
+	CHAR separator;
+	bool interpretQuotes;
+	std::vector <integer> cellLengths;   // [(irow - 1) * numberOfColumns + icol - 1], the number of characters without the quotes
+	std::vector <TableTextStretch> stretches;   // [ithread]
+};
+
+/*
+	Find the cells of rows firstRow .. lastRow.
+	When measuring, record the lengths of the cells, and any rows with too few or too many cells;
+	when not measuring (which happens only if there were no such rows),
+	copy the cells into the strings that the main thread has allocated in the meantime, and numericize them.
+	Allocates no memory, except in Table_cellStringToNumber () for very long cells,
+	so std::bad_alloc is the only thing that can go wrong.
+*/
+template <typename CHAR>
+static void TableText_runStretch (TableText <CHAR> *me, integer ithread, integer firstRow, integer lastRow, bool measuring) noexcept {
+	TableTextStretch *stretch = & my stretches [(size_t) ithread];
+	try {
+		const Table table = my table;
+		const integer numberOfColumns = table -> numberOfColumns;
+		const integer numberOfRows = table -> rows.size;
+		for (integer irow = firstRow; irow <= lastRow; irow ++) {
+			TableRow row = table -> rows.at [irow];
+			const CHAR *p = my rowStarts [irow - 1];
+			const CHAR *const limit = my rowStarts [irow];   // the newline that ends a row, if any, is at limit [-1]
 			for (integer icol = 1; icol <= numberOfColumns; icol ++) {
-				while (*p == U' ' || *p == U'\t' || *p == U'\n') { Melder_assert (*p != U'\0'); p ++; }
-				static MelderString buffer { };
-				MelderString_empty (& buffer);
-				while (*p != U' ' && *p != U'\t' && *p != U'\n' && *p != U'\0') {
-					MelderString_appendCharacter (& buffer, *p);
-					p ++;
+				const CHAR *cellStart, *cellEnd;
+				bool hasQuotes = false;
+				if (my whitespaceSeparated) {
+					while (*p == ' ' || *p == '\t' || *p == '\n')
+						p ++;
+					cellStart = p;
+					while (p < limit && *p != ' ' && *p != '\t' && *p != '\n')
+						p ++;
+					cellEnd = p;
+				} else {
+					cellStart = p;
+					bool withinQuotes = false;
+					while (p < limit && ((*p != my separator && *p != '\n') || withinQuotes)) {
+						if (my interpretQuotes && *p == '\"') {
+							withinQuotes = ! withinQuotes;
+							hasQuotes = true;
+						}
+						p ++;
+					}
+					cellEnd = p;
+					if (p == limit) {
+						if (icol != numberOfColumns) {
+							if (stretch -> firstIncompleteRow == 0)
+								stretch -> firstIncompleteRow = irow;
+							break;
+						}
+						if (withinQuotes) {
+							Melder_assert (irow == numberOfRows);   // earlier rows end in a newline outside quotes
+							stretch -> lastCellHasUnmatchedQuote = true;
+							stretch -> lastCellHasNewline = ( std::find (cellStart, cellEnd, '\n') != cellEnd );
+						}
+					} else if (*p == '\n') {
+						if (icol != numberOfColumns) {
+							if (stretch -> firstIncompleteRow == 0)
+								stretch -> firstIncompleteRow = irow;
+							break;
+						}
+						p ++;
+					} else {
+						Melder_assert (*p == my separator);
+						if (icol == numberOfColumns) {
+							if (stretch -> firstOverfullRow == 0)
+								stretch -> firstOverfullRow = irow;
+							break;
+						}
+						p ++;
+					}
+				}
+				if (measuring) {
+					my cellLengths [(size_t) ((irow - 1) * numberOfColumns + icol - 1)] = cellLength (cellStart, cellEnd, hasQuotes);
+					continue;
+				}
+				const mutablestring32 string = row -> cells [icol]. string.get();
+				copyCell (cellStart, cellEnd, hasQuotes, string);
+				if (stretch -> columnIsNumeric [(size_t) icol]) {
+					if (isCellStringNumeric (string))
+						row -> cells [icol]. number = Table_cellStringToNumber (string);
+					else
+						stretch -> columnIsNumeric [(size_t) icol] = false;
 				}
-				row -> cells [icol]. string = Melder_dup_f (buffer.string);
-				MelderString_empty (& buffer);
 			}
 		}
-		return me;
-	} catch (MelderError) {
-		Melder_throw (U"Table object not read from space-separated text file ", file, U".");
+	} catch (std::bad_alloc&) {
+		stretch -> outOfMemory = true;
 	}
 }
 
-autoTable Table_readFromCharacterSeparatedTextFile (MelderFile file, char32 separator, bool interpretQuotes) {
-	try {
-		autostring32 string = MelderFile_readText (file);
-
-		/*
-			Kill final new-line symbols.
-	 	*/
-		for (int64 length = str32len (string.get());
-		     length > 0 && string [length - 1] == U'\n';
-			 length = str32len (string.get()))
-		{
-			string [length - 1] = U'\0';
-		}
+/*
+	Two passes over the rows, both divided over threads:
+	the first pass measures the cells, after which the main thread allocates all the cell strings
+	(Melder_malloc () can throw, and counts the allocations, so it cannot run on other threads),
+	and the second pass fills in the strings.
+*/
+template <typename CHAR>
+static void Table_readCellsFromText (Table me, const std::vector <const CHAR *>& rowStarts,
+	bool whitespaceSeparated, CHAR separator, bool interpretQuotes)
+{
+	const integer numberOfRows = my rows.size, numberOfColumns = my numberOfColumns;
+	Melder_assert (integer (rowStarts.size ()) == numberOfRows + 1);
+	if (numberOfRows == 0)
+		return;
+	const integer numberOfCharacters = rowStarts.back () - rowStarts.front ();
+	const integer numberOfThreads = MelderThread_getNumberOfThreads (numberOfRows, double (numberOfCharacters));
+	TableText <CHAR> text;
+	text. table = me;
+	text. rowStarts = rowStarts.data ();
+	text. whitespaceSeparated = whitespaceSeparated;
+	text. separator = separator;
+	text. interpretQuotes = interpretQuotes;
+	text. cellLengths. resize ((size_t) (numberOfRows * numberOfColumns));
+	text. stretches. resize ((size_t) numberOfThreads);
+	for (TableTextStretch& stretch : text. stretches) {
+		stretch. columnIsNumeric. assign ((size_t) numberOfColumns + 1, true);
+		stretch. firstIncompleteRow = stretch. firstOverfullRow = 0;
+		stretch. lastCellHasUnmatchedQuote = stretch. lastCellHasNewline = stretch. outOfMemory = false;
+	}
+	MelderThread_runStretches (numberOfThreads, numberOfRows, [&] (integer ithread, integer firstRow, integer lastRow) {
+		TableText_runStretch (& text, ithread, firstRow, lastRow, true);
+	});
+	for (const TableTextStretch& stretch : text. stretches) {
+		if (stretch. firstIncompleteRow != 0) {
+			if (stretch. firstIncompleteRow == numberOfRows)
+				Melder_throw (U"Last row incomplete.");
+			Melder_throw (U"Row ", stretch. firstIncompleteRow, U" incomplete.");
+		}
+		if (stretch. firstOverfullRow != 0)
+			Melder_throw (U"Row ", stretch. firstOverfullRow, U" has more than ", numberOfColumns, U" cells.");
+	}
+	for (integer irow = 1; irow <= numberOfRows; irow ++) {
+		TableRow row = my rows.at [irow];
+		for (integer icol = 1; icol <= numberOfColumns; icol ++)
+			row -> cells [icol]. string = autostring32 (text. cellLengths [(size_t) ((irow - 1) * numberOfColumns + icol - 1)]);
+	}
+	text. cellLengths. clear ();
+	text. cellLengths. shrink_to_fit ();
+	MelderThread_runStretches (numberOfThreads, numberOfRows, [&] (integer ithread, integer firstRow, integer lastRow) {
+		TableText_runStretch (& text, ithread, firstRow, lastRow, false);
+	});
+	for (const TableTextStretch& stretch : text. stretches)
+		if (stretch. outOfMemory)
+			Melder_throw (U"Out of memory while reading the cells.");
+	const TableTextStretch& lastStretch = text. stretches.back ();
+	if (lastStretch. lastCellHasUnmatchedQuote) {
+		if (lastStretch. lastCellHasNewline)
+			Melder_warning (U"The last cell contains an unmatched double-quote (\") and also multiple lines, "
+					"so perhaps multiple lines were unintentionally combined into one cell. "
+					"The problem may be in row ", numberOfRows, U".");
+		else
+			Melder_warning (U"The last cell contains an unmatched double-quote (\"), "
+					"so perhaps multiple cells were unintentionally combined. "
+					"The problem is in row ", numberOfRows, U".");
+	}
+	for (integer icol = 1; icol <= numberOfColumns; icol ++) {
+		bool isNumeric = true;
+		for (const TableTextStretch& stretch : text. stretches)
+			isNumeric = isNumeric && stretch. columnIsNumeric [(size_t) icol];
+		my columnHeaders [icol]. numericized = isNumeric;
+	}
+}
+
+template <typename CHAR>
+static autoTable Table_readFromWhitespaceSeparatedText (const CHAR *text) {
+	/*
+		Count columns.
+	*/
+	integer numberOfColumns = 0;
+	const CHAR *p = & text [0];
+	for (;;) {
+		CHAR kar = *p++;
+		if (kar == '\n' || kar == '\0')
+			break;
+		if (kar == ' ' || kar == '\t')
+			continue;
+		numberOfColumns ++;
+		do { kar = *p++; } while (kar != ' ' && kar != '\t' && kar != '\n' && kar != '\0');
+		if (kar == '\n' || kar == '\0')
+			break;
+	}
+	if (numberOfColumns < 1)
+		Melder_throw (U"No columns.");
 
-		/*
-			Count columns.
- 		*/
-		integer numberOfColumns = 1;
-		const char32 *p = & string [0];
-		for (;;) {
-			char32 kar = *p++;
-			if (kar == U'\0') Melder_throw (U"No rows.");
-			if (kar == U'\n') break;
-			if (kar == separator) numberOfColumns ++;
-		}
+	/*
+		Count elements, and remember where every row starts.
+	*/
+	std::vector <const CHAR *> rowStarts;
+	p = & text [0];
+	integer numberOfElements = 0;
+	for (;;) {
+		while (*p == ' ' || *p == '\t' || *p == '\n')
+			p ++;
+		if (*p == '\0')
+			break;
+		if (numberOfElements % numberOfColumns == 0)
+			rowStarts. push_back (p);
+		numberOfElements ++;
+		do { p ++; } while (*p != ' ' && *p != '\t' && *p != '\n' && *p != '\0');
+	}
+	rowStarts. push_back (p);
 
-		/*
-			Count rows.
-	 	*/
-		integer numberOfRows = 1;
-	 	{// scope
-			bool withinQuotes = false;
-			for (;;) {
-				char32 kar = *p++;
-				if (interpretQuotes && kar == U'\"')
-					withinQuotes = ! withinQuotes;
-				if (! withinQuotes) {
-					if (kar == U'\0') break;
-					if (kar == U'\n') numberOfRows ++;
-				}
-			}
-		}
+	/*
+		Check if all columns are complete.
+	*/
+	if (numberOfElements == 0 || numberOfElements % numberOfColumns != 0)
+		Melder_throw (U"The number of elements (", numberOfElements, U") is not a multiple of the number of columns (", numberOfColumns, U").");
 
-		/*
-			Create empty table.
-		*/
-		autoTable me = Table_create (numberOfRows, numberOfColumns);
+	/*
+		Create empty table.
+	*/
+	const integer numberOfRows = numberOfElements / numberOfColumns - 1;
+	autoTable me = Table_create (numberOfRows, numberOfColumns);
 
-		/*
-			Read column names.
-	 	*/
-		autoMelderString buffer;
-		p = & string [0];
-		for (integer icol = 1; icol <= numberOfColumns; icol ++) {
-			MelderString_empty (& buffer);
-			while (*p != separator && *p != U'\n') {
-				Melder_assert (*p != U'\0');
-				MelderString_appendCharacter (& buffer, *p);
-				p ++;
-			}
+	/*
+		Read elements.
+	*/
+	p = & text [0];
+	std::basic_string <CHAR> label;
+	for (integer icol = 1; icol <= numberOfColumns; icol ++) {
+		while (*p == ' ' || *p == '\t')
 			p ++;
-			Table_setColumnLabel (me.get(), icol, buffer.string);
-		}
+		label. clear ();
+		while (*p != ' ' && *p != '\t' && *p != '\n' && *p != '\0')
+			label. push_back (* p ++);
+		Table_setColumnLabel (me.get(), icol, newCellString (label. data (), label. data () + label. length ()).get());
+	}
+	rowStarts. erase (rowStarts. begin ());   // the row of column labels
+	Table_readCellsFromText (me.get(), rowStarts, true, CHAR (' '), false);
+	return me;
+}
 
-		/*
-			Read cells.
-	 	*/
-		for (integer irow = 1; irow <= numberOfRows; irow ++) {
-			TableRow row = my rows.at [irow];
-			for (integer icol = 1; icol <= numberOfColumns; icol ++) {
-				MelderString_empty (& buffer);
-				bool withinQuotes = false;
-				while (*p != U'\0' && (*p != separator && *p != U'\n' || withinQuotes)) {
-					if (interpretQuotes && *p == U'\"') {
-						withinQuotes = ! withinQuotes;
-					} else {
-						MelderString_appendCharacter (& buffer, *p);
-					}
-					p ++;
-				}
-				if (*p == U'\0') {
-					if (irow != numberOfRows)
-						Melder_fatal (U"irow ", irow, U", nrow ", numberOfRows, U", icol ", icol, U", ncol ", numberOfColumns);
-					if (icol != numberOfColumns)
-						Melder_throw (U"Last row incomplete.");
-					if (withinQuotes) {
-						if (str32chr (buffer.string, U'\n'))
-							Melder_warning (U"The last cell contains an unmatched double-quote (\") and also multiple lines, "
-									"so perhaps multiple lines were unintentionally combined into one cell. "
-									"The problem may be in row ", irow, U".");
-						else
-							Melder_warning (U"The last cell contains an unmatched double-quote (\"), "
-									"so perhaps multiple cells were unintentionally combined. "
-									"The problem is in row ", irow, U".");
-					}
-				} else if (*p == U'\n') {
-					if (icol != numberOfColumns)
-						Melder_throw (U"Row ", irow, U" incomplete.");
-					p ++;
-				} else {
-					Melder_assert (*p == separator);
-					p ++;
-				}
-				row -> cells [icol]. string = Melder_dup (buffer.string);   // BUG? could be null
-			}
+template <typename CHAR>
+static autoTable Table_readFromCharacterSeparatedText (const CHAR *text, CHAR separator, bool interpretQuotes) {
+	/*
+		Ignore final new-line symbols.
+	*/
+	const CHAR *end = & text [0];
+	while (*end != '\0')
+		end ++;
+	while (end > text && end [-1] == '\n')
+		end --;
+
+	/*
+		Count columns.
+	*/
+	integer numberOfColumns = 1;
+	const CHAR *p = & text [0];
+	for (;;) {
+		if (p == end)
+			Melder_throw (U"No rows.");
+		const CHAR kar = *p++;
+		if (kar == '\n')
+			break;
+		if (kar == separator)
+			numberOfColumns ++;
+	}
+
+	/*
+		Count rows, and remember where every row starts.
+	*/
+	std::vector <const CHAR *> rowStarts;
+	rowStarts. push_back (p);
+	{// scope
+		bool withinQuotes = false;
+		for (; p < end; p ++) {
+			if (interpretQuotes && *p == '\"')
+				withinQuotes = ! withinQuotes;
+			else if (*p == '\n' && ! withinQuotes)
+				rowStarts. push_back (p + 1);
 		}
-		return me;
+	}
+	rowStarts. push_back (end);
+	const integer numberOfRows = integer (rowStarts.size ()) - 1;
+
+	/*
+		Create empty table.
+	*/
+	autoTable me = Table_create (numberOfRows, numberOfColumns);
+
+	/*
+		Read column names.
+	*/
+	p = & text [0];
+	std::basic_string <CHAR> label;
+	for (integer icol = 1; icol <= numberOfColumns; icol ++) {
+		label. clear ();
+		while (*p != separator && *p != '\n')
+			label. push_back (* p ++);
+		p ++;
+		Table_setColumnLabel (me.get(), icol, newCellString (label. data (), label. data () + label. length ()).get());
+	}
+
+	/*
+		Read cells.
+	*/
+	Table_readCellsFromText (me.get(), rowStarts, false, separator, interpretQuotes);
+	return me;
+}
+
+autoTable Table_readFromTableFile (MelderFile file) {
+	try {
+		autostring8 string8;
+		autostring32 string = MelderFile_readText (file, & string8);
+		if (! string && isTextUtf8ThatNeedsNoConversion (string8.get()))
+			return Table_readFromWhitespaceSeparatedText (string8.get());
+		if (! string)
+			string = Melder_8to32 (string8.get(), kMelder_textInputEncoding::UNDEFINED);
+		string8.reset ();
+		return Table_readFromWhitespaceSeparatedText (string.get());
+	} catch (MelderError) {
+		Melder_throw (U"Table object not read from space-separated text file ", file, U".");
+	}
+}
+
+autoTable Table_readFromCharacterSeparatedTextFile (MelderFile file, char32 separator, bool interpretQuotes) {
+	try {
+		autostring8 string8;
+		autostring32 string = MelderFile_readText (file, & string8);
+		if (! string && separator <= 0x7F && isTextUtf8ThatNeedsNoConversion (string8.get()))
+			return Table_readFromCharacterSeparatedText (string8.get(), char (separator), interpretQuotes);
+		if (! string)
+			string = Melder_8to32 (string8.get(), kMelder_textInputEncoding::UNDEFINED);
+		string8.reset ();
+		return Table_readFromCharacterSeparatedText (string.get(), separator, interpretQuotes);
 	} catch (MelderError) {
 		Melder_throw (U"Table object not read from character-separated text file ", file, U".");
 	}
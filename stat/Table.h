@@ -64,6 +64,12 @@ void Table_setNumericValue (Table me, integer row, integer column, double value)
 /* For optimizations only (e.g. conversion to Matrix or TableOfReal). */
 void Table_numericize_Assert (Table me, integer columnNumber);
 
+double Table_cellStringToNumber (conststring32 cell);
+/*
+	The value that Table_numericize_Assert () gives a cell:
+	Melder_atof () without its conversion buffer, so that it can be called from several threads at once.
+*/
+
 double Table_getQuantile (Table me, integer column, double quantile);
 double Table_getMean (Table me, integer column);
 double Table_getMaximum (Table me, integer icol);
@@ -93,7 +99,9 @@ void Table_formula (Table me, integer column, conststring32 formula, Interpreter
 void Table_formula_columnRange (Table me, integer column1, integer column2, conststring32 expression, Interpreter interpreter);
 
 void Table_sortRows_Assert (Table me, constINTVEC columns);
+void Table_sortRows_Assert (Table me, constINTVEC columns, constBOOLVEC descending);   // stable; descending may be empty
 void Table_sortRows_string (Table me, conststring32 columns_string);
+void Table_sortRows_string (Table me, conststring32 columns_string, conststring32 descendingColumns_string);
 void Table_randomizeRows (Table me) noexcept;
 void Table_reflectRows (Table me) noexcept;
 
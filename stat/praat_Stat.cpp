@@ -898,6 +898,16 @@ DO
 	MODIFY_EACH_END
 }
 
+FORM (MODIFY_Table_sortRows_ascendingOrDescending, U"Table: Sort rows (ascending or descending)", U"Table: Sort rows (ascending or descending)...") {
+	TEXTFIELD (columnLabels, U"One or more column labels for sorting:", U"dialect gender duration")
+	TEXTFIELD (descendingColumnLabels, U"Which of these to sort in descending order:", U"duration")
+	OK
+DO
+	MODIFY_EACH (Table)
+		Table_sortRows_string (me, columnLabels, descendingColumnLabels);
+	MODIFY_EACH_END
+}
+
 // MARK: Convert
 
 FORM (NEW_Table_collapseRows, U"Table: Collapse rows", nullptr) {
@@ -1153,6 +1163,7 @@ void praat_uvafon_stat_init () {
 		praat_addAction1 (classTable, 0, U"Formula...", nullptr, 1, MODIFY_Table_formula);
 		praat_addAction1 (classTable, 0, U"Formula (column range)...", nullptr, 1, MODIFY_Table_formula_columnRange);
 		praat_addAction1 (classTable, 0, U"Sort rows...", nullptr, 1, MODIFY_Table_sortRows);
+		praat_addAction1 (classTable, 0, U"Sort rows (ascending or descending)...", nullptr, 1, MODIFY_Table_sortRows_ascendingOrDescending);
 		praat_addAction1 (classTable, 0, U"Randomize rows", nullptr, 1, MODIFY_Table_randomizeRows);
 		praat_addAction1 (classTable, 0, U"Reflect rows", nullptr, 1, MODIFY_Table_reflectRows);
 		praat_addAction1 (classTable, 0, U"-- structure --", nullptr, 1, nullptr);
@@ -158,6 +158,7 @@ enum { NO_SYMBOL_,
 		VEC_RANDOM_GAMMA_, MAT_RANDOM_GAMMA_,
 		VEC_SOLVE_SPARSE_, VEC_SOLVE_NONNEGATIVE_,
 		MAT_PEAKS_,
+		RANDOM_INITIALIZE_WITH_SEED_UNSAFELY_BUT_PREDICTABLY_, RANDOM_INITIALIZE_SAFELY_AND_UNPREDICTABLY_,
 		SIZE_, NUMBER_OF_ROWS_, NUMBER_OF_COLUMNS_, EDITOR_, HASH_,
 	#define HIGH_FUNCTION_N  HASH_
 
@@ -281,6 +282,7 @@ static const conststring32 Formula_instructionNames [1 + highestSymbol] = { U"",
 	U"randomGauss#", U"randomGauss##",
 	U"randomGamma#", U"randomGamma##", U"solveSparse#", U"solveNonnegative#",
 	U"peaks##",
+	U"random_initializeWithSeedUnsafelyButPredictably", U"random_initializeSafelyAndUnpredictably",
 	U"size", U"numberOfRows", U"numberOfColumns", U"editor", U"hash",
 
 	U"length", U"number", U"fileReadable",	U"deleteFile", U"createDirectory", U"variableExists",
@@ -4522,6 +4524,24 @@ static void do_hash () {
 	}
 }
 
+static void do_random_initializeWithSeedUnsafelyButPredictably () {
+	Stackel n = pop;
+	if (n->number != 1)
+		Melder_throw (U"The function \"random_initializeWithSeedUnsafelyButPredictably\" requires 1 argument, not ", n->number, U".");
+	Stackel seed = pop;
+	if (seed->which != Stackel_NUMBER || isundef (seed->number))
+		Melder_throw (U"The function \"random_initializeWithSeedUnsafelyButPredictably\" requires a number, not ", seed->whichText(), U".");
+	NUMrandom_initializeWithSeedUnsafelyButPredictably ((uint64) (int64) round (seed->number));
+	pushNumber (1);
+}
+static void do_random_initializeSafelyAndUnpredictably () {
+	Stackel n = pop;
+	if (n->number != 0)
+		Melder_throw (U"The function \"random_initializeSafelyAndUnpredictably\" requires 0 arguments, not ", n->number, U".");
+	NUMrandom_initializeSafelyAndUnpredictably ();
+	pushNumber (1);
+}
+
 static void do_numericVectorElement () {
 	InterpreterVariable vector = parse [programPointer]. content.variable;
 	integer element = 1;   // default
@@ -7012,6 +7032,8 @@ case NUMBER_: { pushNumber (f [programPointer]. content.number);
 } break; case NUMBER_OF_ROWS_: { do_numberOfRows ();
 } break; case NUMBER_OF_COLUMNS_: { do_numberOfColumns ();
 } break; case EDITOR_: { do_editor ();
+} break; case RANDOM_INITIALIZE_WITH_SEED_UNSAFELY_BUT_PREDICTABLY_: { do_random_initializeWithSeedUnsafelyButPredictably ();
+} break; case RANDOM_INITIALIZE_SAFELY_AND_UNPREDICTABLY_: { do_random_initializeSafelyAndUnpredictably ();
 } break; case HASH_: { do_hash ();
 /********** String functions: **********/
 } break; case LENGTH_: { do_length ();
@@ -0,0 +1,120 @@
+/* MelderThread.cpp
+ *
+ * Copyright (C) 2026 Paul Boersma
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This code is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this work. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MelderThread.h"
+#if USE_PTHREADS
+	#include <unistd.h>
+#endif
+
+int MelderThread_getNumberOfProcessors () {
+	int numberOfProcessors = 1;
+	#if USE_WINTHREADS
+		SYSTEM_INFO systemInfo;
+		GetSystemInfo (& systemInfo);
+		numberOfProcessors = (int) systemInfo. dwNumberOfProcessors;
+	#elif USE_PTHREADS
+		numberOfProcessors = (int) sysconf (_SC_NPROCESSORS_ONLN);
+	#elif USE_CPPTHREADS
+		numberOfProcessors = (int) std::thread::hardware_concurrency ();
+	#endif
+	return std::max (numberOfProcessors, 1);
+}
+
+integer MelderThread_getNumberOfThreads (integer numberOfItems, double numberOfOperations) {
+	integer numberOfThreads = std::min (integer (MelderThread_getNumberOfProcessors ()), integer (16));   // as MelderThread_runStretches_ () allows
+	numberOfThreads = std::min (numberOfThreads, numberOfItems);
+	numberOfThreads = std::min (numberOfThreads, integer (numberOfOperations / 1e6));
+	return std::max (numberOfThreads, integer (1));
+}
+
+struct MelderThread_Stretch {
+	void (*work) (const void *closure, integer ithread, integer firstItem, integer lastItem);
+	const void *closure;
+	integer ithread, numberOfThreads, numberOfItems;
+	void run () const {
+		const integer firstItem = 1 + numberOfItems * ithread / numberOfThreads;
+		const integer lastItem = numberOfItems * (ithread + 1) / numberOfThreads;
+		if (firstItem <= lastItem)
+			work (closure, ithread, firstItem, lastItem);
+	}
+};
+
+#if USE_WINTHREADS
+	static DWORD WINAPI MelderThread_runStretch (void *stretch) {
+		((const MelderThread_Stretch *) stretch) -> run ();
+		return 0;
+	}
+#elif USE_PTHREADS
+	static void * MelderThread_runStretch (void *stretch) {
+		((const MelderThread_Stretch *) stretch) -> run ();
+		return nullptr;
+	}
+#endif
+
+void MelderThread_runStretches_ (integer numberOfThreads, integer numberOfItems,
+	void (*work) (const void *closure, integer ithread, integer firstItem, integer lastItem), const void *closure) noexcept
+{
+	constexpr integer maximumNumberOfThreads = 16;   // so that the bookkeeping needs no allocation
+	Melder_assert (numberOfThreads >= 1 && numberOfThreads <= maximumNumberOfThreads);
+	MelderThread_Stretch stretches [maximumNumberOfThreads];
+	for (integer ithread = 0; ithread < numberOfThreads; ithread ++)
+		stretches [ithread] = { work, closure, ithread, numberOfThreads, numberOfItems };
+	/*
+		A thread that cannot be started is not fatal:
+		the calling thread does its stretch after its own.
+	*/
+	bool started [maximumNumberOfThreads] = { };
+	#if USE_WINTHREADS
+		HANDLE threads [maximumNumberOfThreads];
+		for (integer ithread = 1; ithread < numberOfThreads; ithread ++) {
+			threads [ithread] = CreateThread (nullptr, 0, MelderThread_runStretch, & stretches [ithread], 0, nullptr);
+			started [ithread] = ( threads [ithread] != nullptr );
+		}
+	#elif USE_PTHREADS
+		pthread_t threads [maximumNumberOfThreads];
+		for (integer ithread = 1; ithread < numberOfThreads; ithread ++)
+			started [ithread] = ( pthread_create (& threads [ithread], nullptr, MelderThread_runStretch, & stretches [ithread]) == 0 );
+	#elif USE_CPPTHREADS
+		std::thread threads [maximumNumberOfThreads];
+		for (integer ithread = 1; ithread < numberOfThreads; ithread ++) {
+			try {
+				threads [ithread] = std::thread (& MelderThread_Stretch::run, & stretches [ithread]);
+				started [ithread] = true;
+			} catch (...) {
+				;
+			}
+		}
+	#endif
+	for (integer ithread = 0; ithread < numberOfThreads; ithread ++)
+		if (! started [ithread])
+			stretches [ithread]. run ();
+	for (integer ithread = 1; ithread < numberOfThreads; ithread ++) {
+		if (! started [ithread])
+			continue;
+		#if USE_WINTHREADS
+			WaitForSingleObject (threads [ithread], INFINITE);
+			CloseHandle (threads [ithread]);
+		#elif USE_PTHREADS
+			pthread_join (threads [ithread], nullptr);
+		#elif USE_CPPTHREADS
+			threads [ithread]. join ();
+		#endif
+	}
+}
+
+/* End of file MelderThread.cpp */
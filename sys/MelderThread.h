@@ -2,7 +2,7 @@
 #define _MelderThread_h_
 /* MelderThread.h
  *
- * Copyright (C) 2014-2017 Paul Boersma
+ * Copyright (C) 2014-2017,2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -79,17 +79,38 @@
 	#define MelderThread_UNLOCK(_mutex)  _mutex = 0
 #endif
 
-inline static int MelderThread_getNumberOfProcessors () {
-	#if USE_WINTHREADS
-		return 8;
-	#elif USE_PTHREADS
-		return 8;
-	#elif USE_CPPTHREADS
-		return std::thread::hardware_concurrency ();
-	#else
-		return 1;
-	#endif
+int MelderThread_getNumberOfProcessors ();
+
+integer MelderThread_getNumberOfThreads (integer numberOfItems, double numberOfOperations);
+/*
+	The number of threads worth starting for numberOfItems items that together take numberOfOperations operations:
+	not more than the number of processors (or 16), not more than the number of items,
+	and not so many that a thread gets less than about a million operations,
+	which is what it takes to make up for the cost of starting it. At least 1.
+*/
+
+void MelderThread_runStretches_ (integer numberOfThreads, integer numberOfItems,
+	void (*work) (const void *closure, integer ithread, integer firstItem, integer lastItem), const void *closure) noexcept;
+
+template <typename Work>
+void MelderThread_runStretches (integer numberOfThreads, integer numberOfItems, Work const& work) noexcept {
+	MelderThread_runStretches_ (numberOfThreads, numberOfItems,
+		[] (const void *closure, integer ithread, integer firstItem, integer lastItem) {
+			(* (const Work *) closure) (ithread, firstItem, lastItem);
+		},
+		& work
+	);
 }
+/*
+	Call work (ithread, firstItem, lastItem) for numberOfThreads (at most 16) consecutive stretches of the items 1 .. numberOfItems,
+	and return when all of them have been done. Stretch ithread (from 0) runs from item
+	1 + numberOfItems * ithread / numberOfThreads to item numberOfItems * (ithread + 1) / numberOfThreads;
+	empty stretches are skipped.
+	Stretch 0 is done by the calling thread, which also does the stretches of any threads that could not be started.
+	The work runs on other threads, so it should not throw, and therefore should not allocate memory;
+	nor should it create objects, whose number is counted without locking.
+	Anything the threads need is allocated beforehand, e.g. one work space per value of ithread.
+*/
 
 #if USE_WINTHREADS
 	template <class T> void MelderThread_run (DWORD (WINAPI *func) (T *), autoSomeThing <T> *args, int numberOfThreads) {